@@ -0,0 +1,1871 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0004-VirtualTexture";
+const char* windowClass = "0004-VirtualTexture";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Virtual texture layout: 4096x4096 texels in 128x128 pages, 6 mips (32x32 pages down to 1x1).
+const char* virtualTextureFile = "vt-checker.tiles";
+const UINT vtPageSize = 128;
+const UINT vtPagesPerSide = 32;
+const UINT vtMipCount = 6;
+const UINT vtPageBytes = vtPageSize * vtPageSize * 4;
+
+// Physical page cache: 16x16 slots in a 2048x2048 atlas.
+const UINT vtSlotsPerSide = 16;
+const UINT vtMaxUploadsPerFrame = 16;
+const UINT vtMaxPagesInFlight = 32;
+
+// The pixel shader writes one page request per 8x8 pixel block.
+const UINT feedbackScale = 8;
+const UINT feedbackWidth = (windowWidth + feedbackScale - 1) / feedbackScale;
+const UINT feedbackHeight = (windowHeight + feedbackScale - 1) / feedbackScale;
+const UINT feedbackCount = feedbackWidth * feedbackHeight;
+
+const UINT invalidPage = 0xffffffff;
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024] = { 0 };
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// Maps (mip, x, y) pages of the virtual texture to a dense linear index and back.
+// Mip 0 pages come first, the single page of the coarsest mip is the last one.
+class PageLayout {
+public:
+    void init(UINT pagesPerSide, UINT mipCount) {
+        mPagesPerSide = pagesPerSide;
+        mMipCount = mipCount;
+        mMipOffsets.resize(mipCount + 1);
+        UINT offset = 0;
+        for (UINT mip = 0; mip < mipCount; mip++) {
+            mMipOffsets[mip] = offset;
+            UINT side = this->pagesPerSide(mip);
+            offset += side * side;
+        }
+        mMipOffsets[mipCount] = offset;
+    }
+
+    UINT pagesPerSide(UINT mip) const { return std::max(mPagesPerSide >> mip, 1U); }
+    UINT mipCount() const { return mMipCount; }
+    UINT pageCount() const { return mMipOffsets[mMipCount]; }
+
+    UINT index(UINT mip, UINT x, UINT y) const {
+        return mMipOffsets[mip] + y * this->pagesPerSide(mip) + x;
+    }
+
+    void decode(UINT index, UINT& mip, UINT& x, UINT& y) const {
+        mip = 0;
+        while (index >= mMipOffsets[mip + 1]) {
+            mip++;
+        }
+        UINT local = index - mMipOffsets[mip];
+        UINT side = this->pagesPerSide(mip);
+        x = local % side;
+        y = local / side;
+    }
+
+    UINT parent(UINT index) const {
+        UINT mip, x, y;
+        this->decode(index, mip, x, y);
+        if (mip + 1 >= mMipCount) {
+            return invalidPage;
+        }
+        return this->index(mip + 1, x >> 1, y >> 1);
+    }
+
+private:
+    UINT mPagesPerSide = 0;
+    UINT mMipCount = 0;
+    std::vector<UINT> mMipOffsets;
+};
+
+// Tiled source data on disk: a small header followed by every page of every mip,
+// each stored as a tightly packed RGBA8 block of vtPageSize x vtPageSize texels.
+class TileFile {
+public:
+    struct Header {
+        UINT magic;
+        UINT pageSize;
+        UINT pagesPerSide;
+        UINT mipCount;
+    };
+    static const UINT magicValue = 0x31545456; // "VTT1"
+
+    static bool exists(const char* path) {
+        FILE* fd = NULL;
+        fopen_s(&fd, path, "rb");
+        if (fd == NULL) {
+            return false;
+        }
+        Header header = {};
+        size_t read = fread(&header, sizeof(header), 1, fd);
+        fclose(fd);
+        return read == 1 && header.magic == magicValue
+            && header.pageSize == vtPageSize
+            && header.pagesPerSide == vtPagesPerSide
+            && header.mipCount == vtMipCount;
+    }
+
+    // Writes a procedural checkerboard so the sample does not depend on external assets.
+    // Every mip is tinted differently and page edges are darkened to make streaming visible.
+    static void generate(const char* path, const PageLayout& layout) {
+        FILE* fd = NULL;
+        fopen_s(&fd, path, "wb");
+        if (fd == NULL) {
+            throw std::exception("Create tile file failed.");
+        }
+
+        Header header = { magicValue, vtPageSize, vtPagesPerSide, vtMipCount };
+        fwrite(&header, sizeof(header), 1, fd);
+
+        const UINT8 tints[][3] = {
+            { 0xff, 0xff, 0xff }, { 0xff, 0xc0, 0xc0 }, { 0xc0, 0xff, 0xc0 },
+            { 0xc0, 0xc0, 0xff }, { 0xff, 0xff, 0xc0 }, { 0xc0, 0xff, 0xff },
+        };
+
+        std::vector<UINT8> page(vtPageBytes);
+        for (UINT index = 0; index < layout.pageCount(); index++) {
+            UINT mip, px, py;
+            layout.decode(index, mip, px, py);
+            const UINT8* tint = tints[mip % _countof(tints)];
+
+            UINT8* pData = page.data();
+            for (UINT ty = 0; ty < vtPageSize; ty++) {
+                for (UINT tx = 0; tx < vtPageSize; tx++) {
+                    UINT gx = (px * vtPageSize + tx) << mip;
+                    UINT gy = (py * vtPageSize + ty) << mip;
+                    bool white = (((gx >> 6) ^ (gy >> 6)) & 1) != 0;
+                    bool edge = tx == 0 || ty == 0 || tx == vtPageSize - 1 || ty == vtPageSize - 1;
+                    UINT8 value = white ? 0xff : 0x40;
+                    if (edge) {
+                        value = 0x00;
+                    }
+                    pData[0] = (UINT8)(value * tint[0] / 0xff);    // R
+                    pData[1] = (UINT8)(value * tint[1] / 0xff);    // G
+                    pData[2] = (UINT8)(value * tint[2] / 0xff);    // B
+                    pData[3] = 0xff;                               // A
+                    pData += 4;
+                }
+            }
+            fwrite(page.data(), page.size(), 1, fd);
+        }
+        fclose(fd);
+    }
+
+    void open(const char* path) {
+        fopen_s(&mFile, path, "rb");
+        if (mFile == NULL) {
+            throw std::exception("Open tile file failed.");
+        }
+    }
+
+    void close() {
+        if (mFile != NULL) {
+            fclose(mFile);
+            mFile = NULL;
+        }
+    }
+
+    void readPage(UINT index, UINT8* dst) {
+        long offset = (long)(sizeof(Header) + (size_t)index * vtPageBytes);
+        fseek(mFile, offset, SEEK_SET);
+        if (fread(dst, vtPageBytes, 1, mFile) != 1) {
+            throw std::exception("Read tile file failed.");
+        }
+    }
+
+private:
+    FILE* mFile = NULL;
+};
+
+struct PageRequest {
+    UINT page;
+    UINT mip;
+    UINT count;
+};
+
+// Reduces one frame of GPU feedback to a list of unique page requests with pixel counts.
+// Entries are (frameTag << 24) | (mip << 20) | (y << 10) | x; stale entries left over from
+// earlier frames carry a different tag and are ignored, so the buffer is never cleared.
+class FeedbackAnalyzer {
+public:
+    void init(const PageLayout* layout) {
+        mLayout = layout;
+        mCounts.assign(layout->pageCount(), 0);
+        mTouched.reserve(layout->pageCount());
+        mRequests.reserve(layout->pageCount());
+    }
+
+    const std::vector<PageRequest>& analyze(const UINT* entries, size_t count, UINT frameTag) {
+        mTouched.clear();
+        mRequests.clear();
+
+        for (size_t i = 0; i < count; i++) {
+            UINT entry = entries[i];
+            if ((entry >> 24) != frameTag) {
+                continue;
+            }
+            UINT mip = (entry >> 20) & 0xf;
+            UINT y = (entry >> 10) & 0x3ff;
+            UINT x = entry & 0x3ff;
+            if (mip >= mLayout->mipCount() || x >= mLayout->pagesPerSide(mip) || y >= mLayout->pagesPerSide(mip)) {
+                continue;
+            }
+
+            UINT index = mLayout->index(mip, x, y);
+            if (mCounts[index]++ == 0) {
+                mTouched.push_back(index);
+            }
+        }
+
+        for (UINT index : mTouched) {
+            UINT mip, x, y;
+            mLayout->decode(index, mip, x, y);
+            mRequests.push_back({ index, mip, mCounts[index] });
+            mCounts[index] = 0;
+        }
+        return mRequests;
+    }
+
+private:
+    const PageLayout* mLayout = nullptr;
+    std::vector<UINT> mCounts;
+    std::vector<UINT> mTouched;
+    std::vector<PageRequest> mRequests;
+};
+
+// LRU cache of physical page slots. Slots form an intrusive doubly linked list ordered from
+// least to most recently used; pinned slots are unlinked and never evicted. Pages touched in
+// the current frame are never evicted either, since they are visible on screen right now.
+class PageCache {
+public:
+    void init(UINT slotCount, UINT pageCount) {
+        mSlotPage.assign(slotCount, invalidPage);
+        mSlotFrame.assign(slotCount, 0);
+        mPrev.resize(slotCount);
+        mNext.resize(slotCount);
+        mPageSlot.assign(pageCount, -1);
+
+        mHead = -1;
+        mTail = -1;
+        for (UINT slot = 0; slot < slotCount; slot++) {
+            this->link((INT)slot);
+        }
+    }
+
+    INT find(UINT page) const {
+        return mPageSlot[page];
+    }
+
+    bool touch(UINT page, UINT64 frame) {
+        INT slot = mPageSlot[page];
+        if (slot < 0) {
+            return false;
+        }
+        mSlotFrame[slot] = frame;
+        if (mPrev[slot] != -2) {
+            this->unlink(slot);
+            this->link(slot);
+        }
+        return true;
+    }
+
+    // Returns the slot for a new page, evicting the least recently used one if needed.
+    // Returns -1 when every slot is pinned or was used this frame.
+    INT allocate(UINT page, UINT64 frame, UINT& evicted) {
+        evicted = invalidPage;
+        INT slot = mHead;
+        if (slot < 0 || (mSlotPage[slot] != invalidPage && mSlotFrame[slot] == frame)) {
+            return -1;
+        }
+
+        if (mSlotPage[slot] != invalidPage) {
+            evicted = mSlotPage[slot];
+            mPageSlot[evicted] = -1;
+        }
+        mSlotPage[slot] = page;
+        mSlotFrame[slot] = frame;
+        mPageSlot[page] = slot;
+        this->unlink(slot);
+        this->link(slot);
+        return slot;
+    }
+
+    void pin(UINT page) {
+        INT slot = mPageSlot[page];
+        if (slot >= 0 && mPrev[slot] != -2) {
+            this->unlink(slot);
+            mPrev[slot] = -2;
+            mNext[slot] = -2;
+        }
+    }
+
+private:
+    void link(INT slot) {
+        mPrev[slot] = mTail;
+        mNext[slot] = -1;
+        if (mTail >= 0) {
+            mNext[mTail] = slot;
+        }
+        else {
+            mHead = slot;
+        }
+        mTail = slot;
+    }
+
+    void unlink(INT slot) {
+        if (mPrev[slot] >= 0) {
+            mNext[mPrev[slot]] = mNext[slot];
+        }
+        else {
+            mHead = mNext[slot];
+        }
+        if (mNext[slot] >= 0) {
+            mPrev[mNext[slot]] = mPrev[slot];
+        }
+        else {
+            mTail = mPrev[slot];
+        }
+    }
+
+private:
+    std::vector<UINT> mSlotPage;
+    std::vector<UINT64> mSlotFrame;
+    std::vector<INT> mPrev;
+    std::vector<INT> mNext;
+    std::vector<INT> mPageSlot;
+    INT mHead = -1;
+    INT mTail = -1;
+};
+
+// Turns page requests into a prioritized load list. A missing page also pulls in its
+// missing ancestors, and coarse mips load first so the indirection table always has a
+// nearby fallback. Within a mip, pages covering more pixels win.
+class PageScheduler {
+public:
+    void init(const PageLayout* layout) {
+        mLayout = layout;
+        mScheduled.assign(layout->pageCount(), 0);
+        mLoads.reserve(layout->pageCount());
+    }
+
+    const std::vector<PageRequest>& schedule(
+        const std::vector<PageRequest>& requests,
+        const PageCache& cache,
+        const std::vector<UINT8>& inFlight,
+        size_t budget)
+    {
+        mLoads.clear();
+        for (const PageRequest& request : requests) {
+            UINT page = request.page;
+            while (page != invalidPage && cache.find(page) < 0) {
+                if (!inFlight[page]) {
+                    if (mScheduled[page] == 0) {
+                        UINT mip, x, y;
+                        mLayout->decode(page, mip, x, y);
+                        mLoads.push_back({ page, mip, 0 });
+                    }
+                    mScheduled[page] += request.count;
+                }
+                page = mLayout->parent(page);
+            }
+        }
+
+        for (PageRequest& load : mLoads) {
+            load.count = mScheduled[load.page];
+            mScheduled[load.page] = 0;
+        }
+
+        std::sort(mLoads.begin(), mLoads.end(), [](const PageRequest& a, const PageRequest& b) {
+            if (a.mip != b.mip) {
+                return a.mip > b.mip;
+            }
+            return a.count > b.count;
+        });
+
+        if (mLoads.size() > budget) {
+            mLoads.resize(budget);
+        }
+        return mLoads;
+    }
+
+private:
+    const PageLayout* mLayout = nullptr;
+    std::vector<UINT> mScheduled;
+    std::vector<PageRequest> mLoads;
+};
+
+// Reads pages from the tile file on a background thread into a fixed pool of page buffers.
+class PageStreamer {
+public:
+    struct Completed {
+        UINT page;
+        UINT buffer;
+    };
+
+    void start(const char* path, UINT bufferCount) {
+        mFile.open(path);
+        mBuffers.resize(bufferCount);
+        for (UINT i = 0; i < bufferCount; i++) {
+            mBuffers[i].resize(vtPageBytes);
+            mFreeBuffers.push_back(i);
+        }
+        mRunning = true;
+        mThread = std::thread([this]() { this->run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRunning = false;
+        }
+        mCondition.notify_all();
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+        mFile.close();
+    }
+
+    bool request(UINT page) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mFreeBuffers.empty()) {
+                return false;
+            }
+            UINT buffer = mFreeBuffers.back();
+            mFreeBuffers.pop_back();
+            mPending.push_back({ page, buffer });
+        }
+        mCondition.notify_one();
+        return true;
+    }
+
+    void takeCompleted(std::vector<Completed>& completed, size_t maxCount) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        size_t count = std::min(maxCount, mCompleted.size());
+        completed.insert(completed.end(), mCompleted.begin(), mCompleted.begin() + count);
+        mCompleted.erase(mCompleted.begin(), mCompleted.begin() + count);
+    }
+
+    const UINT8* data(UINT buffer) const {
+        return mBuffers[buffer].data();
+    }
+
+    void release(UINT buffer) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFreeBuffers.push_back(buffer);
+    }
+
+private:
+    void run() {
+        for (;;) {
+            Completed job = {};
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this]() { return !mRunning || !mPending.empty(); });
+                if (!mRunning) {
+                    return;
+                }
+                job = mPending.front();
+                mPending.erase(mPending.begin());
+            }
+
+            mFile.readPage(job.page, mBuffers[job.buffer].data());
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCompleted.push_back(job);
+        }
+    }
+
+private:
+    TileFile mFile;
+    std::vector<std::vector<UINT8>> mBuffers;
+    std::vector<UINT> mFreeBuffers;
+    std::vector<Completed> mPending;
+    std::vector<Completed> mCompleted;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::thread mThread;
+    bool mRunning = false;
+};
+
+// Rebuilds the indirection table top-down: resident pages point at their own slot, missing
+// pages inherit the entry of their parent. Entries are RGBA8_UINT (slotX, slotY, mip, 1).
+void buildIndirectionTable(const PageLayout& layout, const PageCache& cache, std::vector<UINT>& table) {
+    table.resize(layout.pageCount());
+    for (UINT mip = layout.mipCount(); mip-- > 0; ) {
+        UINT side = layout.pagesPerSide(mip);
+        for (UINT y = 0; y < side; y++) {
+            for (UINT x = 0; x < side; x++) {
+                UINT index = layout.index(mip, x, y);
+                INT slot = cache.find(index);
+                if (slot >= 0) {
+                    table[index] = (slot % vtSlotsPerSide) | ((slot / vtSlotsPerSide) << 8) | (mip << 16) | (1 << 24);
+                }
+                else {
+                    table[index] = table[layout.parent(index)];
+                }
+            }
+        }
+    }
+}
+
+// CPU side of the virtual texture: feedback analysis, load scheduling, the physical page
+// cache and the indirection table. Holds no device objects.
+class VirtualTexture {
+public:
+    struct Upload {
+        UINT page;
+        UINT slot;
+        UINT buffer;
+    };
+
+    void init(const char* path) {
+        mLayout.init(vtPagesPerSide, vtMipCount);
+        if (!TileFile::exists(path)) {
+            TileFile::generate(path, mLayout);
+        }
+
+        mAnalyzer.init(&mLayout);
+        mScheduler.init(&mLayout);
+        mCache.init(vtSlotsPerSide * vtSlotsPerSide, mLayout.pageCount());
+        mInFlight.assign(mLayout.pageCount(), 0);
+        mIndirection.assign(mLayout.pageCount(), 0);
+        mCompleted.reserve(vtMaxPagesInFlight);
+
+        // The coarsest page is loaded synchronously and pinned, so every lookup resolves.
+        TileFile file;
+        file.open(path);
+        mRootPage.resize(vtPageBytes);
+        file.readPage(this->rootPage(), mRootPage.data());
+        file.close();
+
+        UINT evicted;
+        mRootSlot = (UINT)mCache.allocate(this->rootPage(), 0, evicted);
+        mCache.pin(this->rootPage());
+        mIndirectionDirty = true;
+
+        mStreamer.start(path, vtMaxPagesInFlight);
+    }
+
+    void shutdown() {
+        mStreamer.stop();
+    }
+
+    UINT rootPage() const { return mLayout.pageCount() - 1; }
+    UINT rootSlot() const { return mRootSlot; }
+    const UINT8* rootPageData() const { return mRootPage.data(); }
+    const PageLayout& layout() const { return mLayout; }
+
+    void processFeedback(const UINT* entries, size_t count, UINT frameTag, UINT64 frame) {
+        const std::vector<PageRequest>& requests = mAnalyzer.analyze(entries, count, frameTag);
+        for (const PageRequest& request : requests) {
+            mCache.touch(request.page, frame);
+        }
+
+        const std::vector<PageRequest>& loads = mScheduler.schedule(requests, mCache, mInFlight, vtMaxPagesInFlight);
+        for (const PageRequest& load : loads) {
+            if (!mStreamer.request(load.page)) {
+                break;
+            }
+            mInFlight[load.page] = 1;
+        }
+    }
+
+    // Moves streamed pages into cache slots. Pages that cannot get a slot this frame are dropped
+    // and will be requested again by later feedback.
+    void collectUploads(std::vector<Upload>& uploads, UINT64 frame) {
+        mCompleted.clear();
+        mStreamer.takeCompleted(mCompleted, vtMaxUploadsPerFrame);
+        for (const PageStreamer::Completed& completed : mCompleted) {
+            mInFlight[completed.page] = 0;
+
+            UINT evicted;
+            INT slot = mCache.allocate(completed.page, frame, evicted);
+            if (slot < 0) {
+                mStreamer.release(completed.buffer);
+                continue;
+            }
+            uploads.push_back({ completed.page, (UINT)slot, completed.buffer });
+            mIndirectionDirty = true;
+        }
+    }
+
+    const UINT8* pageData(UINT buffer) const {
+        return mStreamer.data(buffer);
+    }
+
+    void releasePage(UINT buffer) {
+        mStreamer.release(buffer);
+    }
+
+    bool indirectionDirty() const { return mIndirectionDirty; }
+
+    const std::vector<UINT>& buildIndirection() {
+        buildIndirectionTable(mLayout, mCache, mIndirection);
+        mIndirectionDirty = false;
+        return mIndirection;
+    }
+
+private:
+    PageLayout mLayout;
+    FeedbackAnalyzer mAnalyzer;
+    PageScheduler mScheduler;
+    PageCache mCache;
+    PageStreamer mStreamer;
+    std::vector<UINT8> mInFlight;
+    std::vector<UINT> mIndirection;
+    std::vector<PageStreamer::Completed> mCompleted;
+    std::vector<UINT8> mRootPage;
+    UINT mRootSlot = 0;
+    bool mIndirectionDirty = false;
+};
+
+// Headless benchmark of the CPU path: synthetic feedback from a camera zooming over the
+// virtual texture, run through analysis, scheduling and the cache with instant page loads.
+void benchmarkPageRequests() {
+    PageLayout layout;
+    layout.init(vtPagesPerSide, vtMipCount);
+    FeedbackAnalyzer analyzer;
+    analyzer.init(&layout);
+    PageScheduler scheduler;
+    scheduler.init(&layout);
+    PageCache cache;
+    cache.init(vtSlotsPerSide * vtSlotsPerSide, layout.pageCount());
+    std::vector<UINT8> inFlight(layout.pageCount(), 0);
+
+    const UINT frameCount = 2000;
+    std::vector<UINT> feedback(feedbackCount);
+    std::mt19937 random(1234);
+
+    double elapsed = 0.0;
+    size_t entryCount = 0;
+    size_t requestCount = 0;
+    size_t loadCount = 0;
+    size_t dropCount = 0;
+    for (UINT frame = 1; frame <= frameCount; frame++) {
+        UINT tag = (frame % 255) + 1;
+        UINT mip = (frame / 50) % vtMipCount;
+        UINT side = layout.pagesPerSide(mip);
+        UINT centerX = random() % side;
+        UINT centerY = random() % side;
+        for (UINT i = 0; i < feedbackCount; i++) {
+            UINT x = std::min(centerX + (i % feedbackWidth) * 6 / feedbackWidth, side - 1);
+            UINT y = std::min(centerY + (i / feedbackWidth) * 4 / feedbackHeight, side - 1);
+            feedback[i] = (tag << 24) | (mip << 20) | (y << 10) | x;
+        }
+
+        double start = secondsNow();
+        const std::vector<PageRequest>& requests = analyzer.analyze(feedback.data(), feedback.size(), tag);
+        for (const PageRequest& request : requests) {
+            cache.touch(request.page, frame);
+        }
+        const std::vector<PageRequest>& loads = scheduler.schedule(requests, cache, inFlight, vtMaxUploadsPerFrame);
+        for (const PageRequest& load : loads) {
+            UINT evicted;
+            if (cache.allocate(load.page, frame, evicted) < 0) {
+                dropCount++;
+            }
+        }
+        elapsed += secondsNow() - start;
+
+        entryCount += feedback.size();
+        requestCount += requests.size();
+        loadCount += loads.size();
+    }
+
+    double ms = elapsed * 1000.0;
+    char report[512];
+    snprintf(report, sizeof(report),
+        "Virtual texture benchmark: %u frames, %.3f ms total\n"
+        "  %.0f feedback entries/ms, %.0f unique requests/ms\n"
+        "  %zu loads scheduled, %zu dropped (cache full)\n",
+        frameCount, ms, entryCount / ms, requestCount / ms, loadCount, dropCount);
+    debugLog("%s", report);
+    MessageBoxA(NULL, report, windowTitle, 0);
+}
+
+// Checks the CPU path without a device or tile file: LRU eviction order, pinned and
+// visible pages surviving eviction, feedback de-duplication, load priorities, and the
+// indirection table after a fill and evict sequence. Reports each check.
+bool simulateVirtualTexture(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+
+    PageLayout layout;
+    layout.init(vtPagesPerSide, vtMipCount);
+    const UINT rootPage = layout.pageCount() - 1;
+
+    {
+        PageCache cache;
+        cache.init(3, layout.pageCount());
+        UINT evicted;
+        cache.allocate(0, 1, evicted);
+        cache.allocate(1, 1, evicted);
+        cache.allocate(2, 1, evicted);
+        check(evicted == invalidPage, "free slots are used before anything is evicted");
+        cache.touch(0, 2);
+        UINT order[3];
+        for (UINT i = 0; i < 3; i++) {
+            cache.allocate(3 + i, 3, order[i]);
+        }
+        check(order[0] == 1 && order[1] == 2 && order[2] == 0, "pages are evicted least recently used first");
+        check(cache.find(0) < 0 && cache.find(3) >= 0 && cache.find(5) >= 0, "evicted pages are no longer found");
+        check(cache.allocate(6, 3, evicted) < 0 && evicted == invalidPage && cache.find(3) >= 0,
+            "pages used this frame are not evicted");
+    }
+
+    {
+        PageCache cache;
+        cache.init(2, layout.pageCount());
+        UINT evicted;
+        cache.allocate(rootPage, 0, evicted);
+        cache.pin(rootPage);
+        bool rootKept = true;
+        for (UINT frame = 1; frame <= 100; frame++) {
+            cache.allocate(frame, frame, evicted);
+            rootKept = rootKept && evicted != rootPage && cache.find(rootPage) >= 0;
+        }
+        check(rootKept, "a pinned page is never evicted");
+
+        cache.allocate(200, 101, evicted);
+        cache.touch(200, 102);
+        check(cache.allocate(201, 102, evicted) < 0 && cache.find(200) >= 0,
+            "with one unpinned slot, a page visible this frame keeps it");
+    }
+
+    {
+        FeedbackAnalyzer analyzer;
+        analyzer.init(&layout);
+        const UINT tag = 7;
+        auto entry = [](UINT frameTag, UINT mip, UINT x, UINT y) {
+            return (frameTag << 24) | (mip << 20) | (y << 10) | x;
+        };
+        const UINT entries[] = {
+            entry(tag, 0, 3, 4), entry(tag, 2, 1, 1), entry(tag, 0, 3, 4), entry(tag - 1, 0, 5, 5),
+            entry(tag, 0, 3, 4), entry(tag, 2, 1, 1), entry(tag, 0, vtPagesPerSide, 0), entry(tag, vtMipCount, 0, 0),
+        };
+        const std::vector<PageRequest>& requests = analyzer.analyze(entries, _countof(entries), tag);
+        bool counted = requests.size() == 2
+            && requests[0].page == layout.index(0, 3, 4) && requests[0].count == 3 && requests[0].mip == 0
+            && requests[1].page == layout.index(2, 1, 1) && requests[1].count == 2 && requests[1].mip == 2;
+        check(counted, "feedback is reduced to one request per page with its pixel count");
+        check(analyzer.analyze(entries, _countof(entries), tag + 1).empty(), "stale and out of range entries are ignored");
+        check(analyzer.analyze(entries, _countof(entries), tag).size() == 2, "counts start over every frame");
+    }
+
+    {
+        PageScheduler scheduler;
+        scheduler.init(&layout);
+        PageCache cache;
+        cache.init(8, layout.pageCount());
+        UINT evicted;
+        cache.allocate(rootPage, 0, evicted);
+        cache.allocate(layout.index(4, 0, 0), 0, evicted);
+        std::vector<UINT8> inFlight(layout.pageCount(), 0);
+        inFlight[layout.index(3, 0, 0)] = 1;
+
+        // Two neighbouring mip 0 pages share every ancestor; the second covers more pixels.
+        std::vector<PageRequest> requests;
+        requests.push_back({ layout.index(0, 0, 0), 0, 10 });
+        requests.push_back({ layout.index(0, 1, 0), 0, 30 });
+        requests.push_back({ layout.index(1, 0, 0), 1, 5 });
+        const std::vector<PageRequest>& loads = scheduler.schedule(requests, cache, inFlight, 16);
+
+        const UINT expected[] = {
+            layout.index(2, 0, 0), layout.index(1, 0, 0), layout.index(0, 1, 0), layout.index(0, 0, 0),
+        };
+        bool ordered = loads.size() == _countof(expected);
+        for (size_t i = 0; ordered && i < loads.size(); i++) {
+            ordered = loads[i].page == expected[i];
+        }
+        check(ordered, "missing ancestors load once, coarse mips first, then by pixel count");
+        check(ordered && loads[0].count == 45 && loads[1].count == 45 && loads[2].count == 30,
+            "an ancestor is weighted by every request below it");
+
+        const std::vector<PageRequest>& limited = scheduler.schedule(requests, cache, inFlight, 2);
+        check(limited.size() == 2 && limited[0].page == expected[0] && limited[1].page == expected[1],
+            "the budget keeps the coarsest loads");
+    }
+
+    {
+        PageCache cache;
+        cache.init(4, layout.pageCount());
+        UINT evicted;
+        cache.allocate(rootPage, 0, evicted);
+        cache.pin(rootPage);
+        const UINT coarse = layout.index(4, 1, 1);
+        const UINT fine = layout.index(3, 2, 3);
+        const UINT other = layout.index(0, 31, 31);
+        const INT coarseSlot = cache.allocate(coarse, 1, evicted);
+        const INT fineSlot = cache.allocate(fine, 1, evicted);
+        cache.allocate(other, 1, evicted);
+        auto entryFor = [](INT slot, UINT mip) {
+            return (UINT)(slot % vtSlotsPerSide) | ((slot / vtSlotsPerSide) << 8) | (mip << 16) | (1 << 24);
+        };
+
+        std::vector<UINT> table;
+        buildIndirectionTable(layout, cache, table);
+        const UINT rootEntry = entryFor(cache.find(rootPage), vtMipCount - 1);
+        check(table[rootPage] == rootEntry && table[coarse] == entryFor(coarseSlot, 4) && table[fine] == entryFor(fineSlot, 3),
+            "resident pages point at their own slot");
+        check(table[layout.index(0, 17, 25)] == entryFor(fineSlot, 3) && table[layout.index(2, 6, 6)] == entryFor(coarseSlot, 4)
+            && table[layout.index(0, 0, 0)] == rootEntry,
+            "missing pages fall back to their nearest resident ancestor");
+
+        // Evict the mip 3 page: its area falls back to the mip 4 page, the rest is unchanged.
+        cache.touch(coarse, 2);
+        cache.touch(other, 2);
+        const INT reused = cache.allocate(layout.index(2, 0, 0), 2, evicted);
+        buildIndirectionTable(layout, cache, table);
+        check(evicted == fine && reused == fineSlot, "the least recently used page gives up its slot");
+        check(table[fine] == entryFor(coarseSlot, 4) && table[layout.index(0, 17, 25)] == entryFor(coarseSlot, 4)
+            && table[layout.index(2, 0, 0)] == entryFor(reused, 2) && table[other] == entryFor(cache.find(other), 0),
+            "after eviction the table falls back to the parent and keeps the other pages");
+    }
+
+    return passed;
+}
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+
+        // Create SRV Heap: physical texture SRV, indirection SRV, feedback UAV
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 3;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+
+        mStartTime = secondsNow();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        mVirtualTexture.shutdown();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+        mFrameCounter++;
+    }
+
+    void createAssets() {
+        mVirtualTexture.init(virtualTextureFile);
+
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[2] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 2;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+                descriptorRanges[0].OffsetInDescriptorsFromTableStart = 0;
+                descriptorRanges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+                descriptorRanges[1].NumDescriptors = 1;
+                descriptorRanges[1].BaseShaderRegister = 1;
+                descriptorRanges[1].RegisterSpace = 0;
+                descriptorRanges[1].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+                descriptorRanges[1].OffsetInDescriptorsFromTableStart = 2;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[0].Constants.ShaderRegister = 0;
+                parameters[0].Constants.RegisterSpace = 0;
+                parameters[0].Constants.Num32BitValues = sizeof(VTConstants) / 4;
+                parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[1].DescriptorTable.NumDescriptorRanges = 2;
+                parameters[1].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[2] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 2;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].OffsetInDescriptorsFromTableStart = 0;
+                descriptorRanges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+                descriptorRanges[1].NumDescriptors = 1;
+                descriptorRanges[1].BaseShaderRegister = 1;
+                descriptorRanges[1].RegisterSpace = 0;
+                descriptorRanges[1].OffsetInDescriptorsFromTableStart = 2;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[0].Constants.ShaderRegister = 0;
+                parameters[0].Constants.RegisterSpace = 0;
+                parameters[0].Constants.Num32BitValues = sizeof(VTConstants) / 4;
+                parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[1].DescriptorTable.NumDescriptorRanges = 2;
+                parameters[1].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/003-virtual-texture.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/003-virtual-texture.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+
+
+        // Create Vertex Buffer
+        {
+            Vertex triangleVertices[] = {
+                { { -0.75f, 0.75f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 0.0f} },
+                { { 0.75f, 0.75f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { 0.75f, -0.75f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 1.0f} },
+                { { -0.75f, -0.75f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 1.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Virtual Texture
+        {
+            this->createVirtualTextureResources();
+
+            // Upload the pinned root page and the initial indirection table.
+            UINT8* ring = mUploadRingPtrs[mFrameBufferIndex];
+            memcpy(ring, mVirtualTexture.rootPageData(), vtPageBytes);
+            this->recordPageCopy(mVirtualTexture.rootSlot(), 0);
+            this->recordIndirectionCopy(ring);
+            this->transitionVirtualTexture(D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void createVirtualTextureResources() {
+        D3D12_HEAP_PROPERTIES defaultHeapProps = {};
+        defaultHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+        // Physical page atlas
+        D3D12_RESOURCE_DESC physicalDesc = {};
+        physicalDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        physicalDesc.Width = vtSlotsPerSide * vtPageSize;
+        physicalDesc.Height = vtSlotsPerSide * vtPageSize;
+        physicalDesc.DepthOrArraySize = 1;
+        physicalDesc.MipLevels = 1;
+        physicalDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        physicalDesc.SampleDesc.Count = 1;
+        physicalDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        physicalDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &defaultHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &physicalDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&mPhysicalTexture)));
+
+        // Indirection texture: one texel per virtual page, one mip per virtual mip
+        D3D12_RESOURCE_DESC indirectionDesc = {};
+        indirectionDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        indirectionDesc.Width = vtPagesPerSide;
+        indirectionDesc.Height = vtPagesPerSide;
+        indirectionDesc.DepthOrArraySize = 1;
+        indirectionDesc.MipLevels = vtMipCount;
+        indirectionDesc.Format = DXGI_FORMAT_R8G8B8A8_UINT;
+        indirectionDesc.SampleDesc.Count = 1;
+        indirectionDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        indirectionDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &defaultHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &indirectionDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&mIndirectionTexture)));
+
+        UINT64 indirectionBytes = 0;
+        mDevice->GetCopyableFootprints(&indirectionDesc, 0, vtMipCount, 0,
+            mIndirectionFootprints, mIndirectionRows, mIndirectionRowSizes, &indirectionBytes);
+
+        // Feedback buffer written by the pixel shader
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = feedbackCount * sizeof(UINT);
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &defaultHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+            nullptr,
+            IID_PPV_ARGS(&mFeedbackBuffer)));
+
+        // Per-frame readback copies of the feedback and persistently mapped upload rings
+        D3D12_HEAP_PROPERTIES readbackHeapProps = {};
+        readbackHeapProps.Type = D3D12_HEAP_TYPE_READBACK;
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        mIndirectionRingOffset = vtMaxUploadsPerFrame * vtPageBytes;
+        D3D12_RESOURCE_DESC ringDesc = bufferDesc;
+        ringDesc.Width = mIndirectionRingOffset + indirectionBytes;
+        ringDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &readbackHeapProps,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_COPY_DEST,
+                nullptr,
+                IID_PPV_ARGS(&mFeedbackReadbacks[i])));
+            _ThrowIfFailed(mFeedbackReadbacks[i]->Map(0, nullptr, (void**)&mFeedbackReadbackPtrs[i]));
+            mFeedbackTags[i] = 0;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &uploadHeapProps,
+                D3D12_HEAP_FLAG_NONE,
+                &ringDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mUploadRings[i])));
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mUploadRings[i]->Map(0, &readRange, (void**)&mUploadRingPtrs[i]));
+        }
+
+        // Descriptors
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = mSRVHeap->GetCPUDescriptorHandleForHeapStart();
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = physicalDesc.Format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        mDevice->CreateShaderResourceView(mPhysicalTexture.Get(), &srvDesc, handle);
+        handle.ptr += mSRVHeapStride;
+
+        srvDesc.Format = indirectionDesc.Format;
+        srvDesc.Texture2D.MipLevels = vtMipCount;
+        mDevice->CreateShaderResourceView(mIndirectionTexture.Get(), &srvDesc, handle);
+        handle.ptr += mSRVHeapStride;
+
+        D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+        uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+        uavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+        uavDesc.Buffer.FirstElement = 0;
+        uavDesc.Buffer.NumElements = feedbackCount;
+        uavDesc.Buffer.StructureByteStride = sizeof(UINT);
+        mDevice->CreateUnorderedAccessView(mFeedbackBuffer.Get(), nullptr, &uavDesc, handle);
+    }
+
+    void transitionVirtualTexture(D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after) {
+        D3D12_RESOURCE_BARRIER barriers[2] = {};
+        ID3D12Resource* resources[2] = { mPhysicalTexture.Get(), mIndirectionTexture.Get() };
+        for (UINT i = 0; i < 2; i++) {
+            barriers[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            barriers[i].Transition.pResource = resources[i];
+            barriers[i].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            barriers[i].Transition.StateBefore = before;
+            barriers[i].Transition.StateAfter = after;
+        }
+        mCommandList->ResourceBarrier(2, barriers);
+    }
+
+    // Pages are stored tightly with a 512 byte row pitch, which already satisfies the
+    // placed footprint alignment, so each page is one region copy straight from the ring.
+    void recordPageCopy(UINT slot, UINT ringIndex) {
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = mUploadRings[mFrameBufferIndex].Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint.Offset = (UINT64)ringIndex * vtPageBytes;
+        srcLocation.PlacedFootprint.Footprint.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        srcLocation.PlacedFootprint.Footprint.Width = vtPageSize;
+        srcLocation.PlacedFootprint.Footprint.Height = vtPageSize;
+        srcLocation.PlacedFootprint.Footprint.Depth = 1;
+        srcLocation.PlacedFootprint.Footprint.RowPitch = vtPageSize * 4;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = mPhysicalTexture.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        UINT x = (slot % vtSlotsPerSide) * vtPageSize;
+        UINT y = (slot / vtSlotsPerSide) * vtPageSize;
+        mCommandList->CopyTextureRegion(&dstLocation, x, y, 0, &srcLocation, nullptr);
+    }
+
+    void recordIndirectionCopy(UINT8* ring) {
+        const std::vector<UINT>& table = mVirtualTexture.buildIndirection();
+        const PageLayout& layout = mVirtualTexture.layout();
+
+        for (UINT mip = 0; mip < vtMipCount; mip++) {
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = mIndirectionFootprints[mip];
+            UINT8* dstPtr = ring + mIndirectionRingOffset + footprint.Offset;
+            const UINT8* srcPtr = (const UINT8*)&table[layout.index(mip, 0, 0)];
+            for (UINT row = 0; row < mIndirectionRows[mip]; row++) {
+                memcpy(dstPtr, srcPtr, (size_t)mIndirectionRowSizes[mip]);
+                dstPtr += footprint.Footprint.RowPitch;
+                srcPtr += mIndirectionRowSizes[mip];
+            }
+
+            D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+            srcLocation.pResource = mUploadRings[mFrameBufferIndex].Get();
+            srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            srcLocation.PlacedFootprint = footprint;
+            srcLocation.PlacedFootprint.Offset += mIndirectionRingOffset;
+
+            D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+            dstLocation.pResource = mIndirectionTexture.Get();
+            dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            dstLocation.SubresourceIndex = mip;
+
+            mCommandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+        }
+    }
+
+    void updateVirtualTexture() {
+        // The fence for this back buffer has completed, so its feedback readback is ready.
+        UINT& tag = mFeedbackTags[mFrameBufferIndex];
+        if (tag != 0) {
+            mVirtualTexture.processFeedback(mFeedbackReadbackPtrs[mFrameBufferIndex], feedbackCount, tag, mFrameCounter);
+        }
+        tag = (UINT)(mFrameCounter % 255) + 1;
+
+        mUploads.clear();
+        mVirtualTexture.collectUploads(mUploads, mFrameCounter);
+        if (mUploads.empty() && !mVirtualTexture.indirectionDirty()) {
+            return;
+        }
+
+        this->transitionVirtualTexture(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+
+        UINT8* ring = mUploadRingPtrs[mFrameBufferIndex];
+        for (UINT i = 0; i < (UINT)mUploads.size(); i++) {
+            memcpy(ring + (size_t)i * vtPageBytes, mVirtualTexture.pageData(mUploads[i].buffer), vtPageBytes);
+            mVirtualTexture.releasePage(mUploads[i].buffer);
+            this->recordPageCopy(mUploads[i].slot, i);
+        }
+        this->recordIndirectionCopy(ring);
+
+        this->transitionVirtualTexture(D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        this->updateVirtualTexture();
+
+        // Zoom in and out over the virtual texture so every mip gets streamed.
+        float time = (float)(secondsNow() - mStartTime);
+        float zoom = powf(2.0f, -5.0f * (0.5f - 0.5f * cosf(time * 0.3f)));
+        float centerX = 0.5f + 0.3f * sinf(time * 0.11f);
+        float centerY = 0.5f + 0.3f * cosf(time * 0.07f);
+
+        VTConstants constants = {};
+        constants.pagesPerSide = vtPagesPerSide;
+        constants.pageSize = vtPageSize;
+        constants.slotsPerSide = vtSlotsPerSide;
+        constants.maxMip = vtMipCount - 1;
+        constants.feedbackWidth = feedbackWidth;
+        constants.feedbackScale = feedbackScale;
+        constants.frameTag = mFeedbackTags[mFrameBufferIndex];
+        constants.uvScale = zoom;
+        constants.uvOffset[0] = std::min(std::max(centerX - 0.5f * zoom, 0.0f), 1.0f - zoom);
+        constants.uvOffset[1] = std::min(std::max(centerY - 0.5f * zoom, 0.0f), 1.0f - zoom);
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+        mCommandList->SetGraphicsRoot32BitConstants(0, sizeof(VTConstants) / 4, &constants, 0);
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(1, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+
+        // Copy this frame's feedback out; it is read back once this back buffer comes around again.
+        D3D12_RESOURCE_BARRIER toCopy = {};
+        toCopy.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        toCopy.Transition.pResource = mFeedbackBuffer.Get();
+        toCopy.Transition.Subresource = 0;
+        toCopy.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        toCopy.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        mCommandList->ResourceBarrier(1, &toCopy);
+
+        mCommandList->CopyBufferRegion(mFeedbackReadbacks[mFrameBufferIndex].Get(), 0, mFeedbackBuffer.Get(), 0, feedbackCount * sizeof(UINT));
+
+        D3D12_RESOURCE_BARRIER fromCopy = toCopy;
+        fromCopy.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        fromCopy.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+
+        D3D12_RESOURCE_BARRIER endBarriers[] = { fromCopy, onEnd };
+        mCommandList->ResourceBarrier(_countof(endBarriers), endBarriers);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 4096;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+private:
+    // Mirrors the VTConstants cbuffer in 003-virtual-texture.hlsl, passed as root constants.
+    struct VTConstants {
+        UINT pagesPerSide;
+        UINT pageSize;
+        UINT slotsPerSide;
+        UINT maxMip;
+        UINT feedbackWidth;
+        UINT feedbackScale;
+        UINT frameTag;
+        float uvScale;
+        float uvOffset[2];
+    };
+
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    UINT64 mFrameCounter = 1;
+    double mStartTime = 0.0;
+
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+
+    VirtualTexture mVirtualTexture;
+    std::vector<VirtualTexture::Upload> mUploads;
+    ComPtr<ID3D12Resource> mPhysicalTexture;
+    ComPtr<ID3D12Resource> mIndirectionTexture;
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT mIndirectionFootprints[vtMipCount];
+    UINT mIndirectionRows[vtMipCount];
+    UINT64 mIndirectionRowSizes[vtMipCount];
+    UINT64 mIndirectionRingOffset = 0;
+    ComPtr<ID3D12Resource> mFeedbackBuffer;
+    ComPtr<ID3D12Resource> mFeedbackReadbacks[frameBufferCount];
+    UINT* mFeedbackReadbackPtrs[frameBufferCount];
+    UINT mFeedbackTags[frameBufferCount];
+    ComPtr<ID3D12Resource> mUploadRings[frameBufferCount];
+    UINT8* mUploadRingPtrs[frameBufferCount];
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        // Run the CPU page request benchmark without creating a window.
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            benchmarkPageRequests();
+            return 0;
+        }
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateVirtualTexture(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
@@ -0,0 +1,1178 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0005-FrameAllocator";
+const char* windowClass = "0005-FrameAllocator";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// Linear allocator over one persistently mapped UPLOAD buffer, split into one region per
+// frame in flight. Allocating is a single pointer bump; reset() rewinds a region once the
+// fence of the frame that last used it has completed. Nothing is mapped or freed per draw.
+class FrameAllocator {
+public:
+    struct Allocation {
+        UINT8* cpu;
+        D3D12_GPU_VIRTUAL_ADDRESS gpu;
+    };
+
+    void init(ID3D12Device* device, UINT64 bytesPerFrame) {
+        mBytesPerFrame = bytesPerFrame;
+
+        D3D12_HEAP_PROPERTIES heapProperties = {};
+        heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = bytesPerFrame * frameBufferCount;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&mBuffer)));
+
+        // Upload heaps may stay mapped for their whole lifetime.
+        D3D12_RANGE readRange = { 0, 0 };
+        _ThrowIfFailed(mBuffer->Map(0, &readRange, (void**)&mCpuBase));
+        mGpuBase = mBuffer->GetGPUVirtualAddress();
+    }
+
+    void reset(UINT frameIndex) {
+        mBegin = frameIndex * mBytesPerFrame;
+        mOffset = mBegin;
+        mEnd = mBegin + mBytesPerFrame;
+    }
+
+    Allocation allocate(UINT64 size, UINT64 alignment) {
+        UINT64 offset = (mOffset + alignment - 1) & ~(alignment - 1);
+        if (offset + size > mEnd) {
+            throw std::exception("Frame allocator is out of memory.");
+        }
+        mOffset = offset + size;
+        mHighWater = std::max(mHighWater, mOffset - mBegin);
+        return { mCpuBase + offset, mGpuBase + offset };
+    }
+
+    // Constant buffer views must start on and span a multiple of 256 bytes.
+    Allocation allocateConstants(const void* data, UINT size) {
+        UINT alignedSize = (size + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+        Allocation allocation = this->allocate(alignedSize, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+        memcpy(allocation.cpu, data, size);
+        return allocation;
+    }
+
+    D3D12_VERTEX_BUFFER_VIEW allocateVertices(UINT count, UINT stride, void** data) {
+        Allocation allocation = this->allocate((UINT64)count * stride, 16);
+        *data = allocation.cpu;
+
+        D3D12_VERTEX_BUFFER_VIEW view = {};
+        view.BufferLocation = allocation.gpu;
+        view.StrideInBytes = stride;
+        view.SizeInBytes = count * stride;
+        return view;
+    }
+
+    D3D12_INDEX_BUFFER_VIEW allocateIndices(UINT count, UINT** data) {
+        Allocation allocation = this->allocate((UINT64)count * sizeof(UINT), sizeof(UINT));
+        *data = (UINT*)allocation.cpu;
+
+        D3D12_INDEX_BUFFER_VIEW view = {};
+        view.BufferLocation = allocation.gpu;
+        view.Format = DXGI_FORMAT_R32_UINT;
+        view.SizeInBytes = count * sizeof(UINT);
+        return view;
+    }
+
+    UINT64 highWater() const { return mHighWater; }
+
+private:
+    ComPtr<ID3D12Resource> mBuffer;
+    UINT8* mCpuBase = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS mGpuBase = 0;
+    UINT64 mBytesPerFrame = 0;
+    UINT64 mBegin = 0;
+    UINT64 mOffset = 0;
+    UINT64 mEnd = 0;
+    UINT64 mHighWater = 0;
+};
+
+enum class ConstantBinding {
+    RootConstants,
+    RootCBV,
+    TableCBV,
+};
+
+// Decides how each cbuffer of a shader is bound, from its size. The smallest blocks become
+// root constants (no memory at all), the next ones root CBVs (2 DWORDs of root space each),
+// and whatever does not fit the root budget is gathered into one descriptor table of CBVs,
+// which costs a single root DWORD however many buffers it holds.
+class ConstantBindingPlan {
+public:
+    struct Block {
+        const char* name;
+        UINT shaderRegister;
+        UINT size;
+        ConstantBinding binding;
+        UINT rootParameter;
+        UINT tableOffset;
+    };
+
+    UINT add(const char* name, UINT shaderRegister, UINT size) {
+        mBlocks.push_back({ name, shaderRegister, size, ConstantBinding::TableCBV, 0, 0 });
+        return (UINT)mBlocks.size() - 1;
+    }
+
+    void build(UINT maxRootConstantDWords, UINT maxRootCBVs) {
+        std::vector<UINT> order(mBlocks.size());
+        for (UINT i = 0; i < (UINT)order.size(); i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this](UINT a, UINT b) { return mBlocks[a].size < mBlocks[b].size; });
+
+        UINT rootConstantDWords = 0;
+        UINT rootCBVs = 0;
+        mTableSize = 0;
+        for (UINT i : order) {
+            Block& block = mBlocks[i];
+            UINT dwords = (block.size + 3) / 4;
+            if (rootConstantDWords + dwords <= maxRootConstantDWords) {
+                block.binding = ConstantBinding::RootConstants;
+                rootConstantDWords += dwords;
+            }
+            else if (rootCBVs < maxRootCBVs) {
+                block.binding = ConstantBinding::RootCBV;
+                rootCBVs++;
+            }
+            else {
+                block.binding = ConstantBinding::TableCBV;
+                block.tableOffset = mTableSize++;
+            }
+        }
+
+        // Root parameters in declaration order, the shared CBV table (if any) last.
+        mParameters.clear();
+        for (Block& block : mBlocks) {
+            D3D12_ROOT_PARAMETER1 parameter = {};
+            parameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+            if (block.binding == ConstantBinding::RootConstants) {
+                parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameter.Constants.ShaderRegister = block.shaderRegister;
+                parameter.Constants.RegisterSpace = 0;
+                parameter.Constants.Num32BitValues = (block.size + 3) / 4;
+            }
+            else if (block.binding == ConstantBinding::RootCBV) {
+                parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+                parameter.Descriptor.ShaderRegister = block.shaderRegister;
+                parameter.Descriptor.RegisterSpace = 0;
+                parameter.Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE;
+            }
+            else {
+                continue;
+            }
+            block.rootParameter = (UINT)mParameters.size();
+            mParameters.push_back(parameter);
+        }
+
+        mRanges.clear();
+        for (Block& block : mBlocks) {
+            if (block.binding != ConstantBinding::TableCBV) {
+                continue;
+            }
+            D3D12_DESCRIPTOR_RANGE1 range = {};
+            range.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+            range.NumDescriptors = 1;
+            range.BaseShaderRegister = block.shaderRegister;
+            range.RegisterSpace = 0;
+            range.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE;
+            range.OffsetInDescriptorsFromTableStart = block.tableOffset;
+            mRanges.push_back(range);
+        }
+
+        mTableParameter = (UINT)mParameters.size();
+        if (!mRanges.empty()) {
+            D3D12_ROOT_PARAMETER1 parameter = {};
+            parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+            parameter.DescriptorTable.NumDescriptorRanges = (UINT)mRanges.size();
+            parameter.DescriptorTable.pDescriptorRanges = mRanges.data();
+            parameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+            mParameters.push_back(parameter);
+        }
+    }
+
+    const Block& block(UINT index) const { return mBlocks[index]; }
+    UINT blockCount() const { return (UINT)mBlocks.size(); }
+    UINT tableSize() const { return mTableSize; }
+    UINT tableParameter() const { return mTableParameter; }
+    const std::vector<D3D12_ROOT_PARAMETER1>& parameters() const { return mParameters; }
+
+private:
+    std::vector<Block> mBlocks;
+    std::vector<D3D12_ROOT_PARAMETER1> mParameters;
+    std::vector<D3D12_DESCRIPTOR_RANGE1> mRanges;
+    UINT mTableSize = 0;
+    UINT mTableParameter = 0;
+};
+
+// Applies constant data at draw time following a ConstantBindingPlan. Root CBV and table CBV
+// data goes through the FrameAllocator; table descriptors are written into a per-frame
+// region of the shader-visible heap and the table is only rebound when one of them changed.
+class ConstantBinder {
+public:
+    void init(const ConstantBindingPlan* plan, ID3D12Device* device, ID3D12DescriptorHeap* heap,
+        UINT firstDescriptor, UINT descriptorsPerFrame)
+    {
+        mPlan = plan;
+        mDevice = device;
+        mHeap = heap;
+        mStride = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        mFirstDescriptor = firstDescriptor;
+        mDescriptorsPerFrame = descriptorsPerFrame;
+        mTable.resize(plan->tableSize());
+    }
+
+    void reset(UINT frameIndex) {
+        mNextDescriptor = mFirstDescriptor + frameIndex * mDescriptorsPerFrame;
+        mEndDescriptor = mNextDescriptor + mDescriptorsPerFrame;
+        mTableDirty = false;
+    }
+
+    void set(ID3D12GraphicsCommandList* commandList, FrameAllocator& allocator, UINT blockIndex, const void* data) {
+        const ConstantBindingPlan::Block& block = mPlan->block(blockIndex);
+        switch (block.binding) {
+        case ConstantBinding::RootConstants:
+            commandList->SetGraphicsRoot32BitConstants(block.rootParameter, (block.size + 3) / 4, data, 0);
+            break;
+        case ConstantBinding::RootCBV:
+            commandList->SetGraphicsRootConstantBufferView(block.rootParameter, allocator.allocateConstants(data, block.size).gpu);
+            break;
+        case ConstantBinding::TableCBV: {
+            D3D12_CONSTANT_BUFFER_VIEW_DESC& view = mTable[block.tableOffset];
+            view.BufferLocation = allocator.allocateConstants(data, block.size).gpu;
+            view.SizeInBytes = (block.size + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+            mTableDirty = true;
+            break;
+        }
+        }
+    }
+
+    // Call before each draw; writes and binds a fresh table only if a table CBV changed.
+    void commit(ID3D12GraphicsCommandList* commandList) {
+        if (!mTableDirty) {
+            return;
+        }
+        if (mNextDescriptor + mTable.size() > mEndDescriptor) {
+            throw std::exception("Constant binder is out of descriptors.");
+        }
+
+        D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = mHeap->GetCPUDescriptorHandleForHeapStart();
+        D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle = mHeap->GetGPUDescriptorHandleForHeapStart();
+        cpuHandle.ptr += (SIZE_T)mNextDescriptor * mStride;
+        gpuHandle.ptr += (UINT64)mNextDescriptor * mStride;
+        for (const D3D12_CONSTANT_BUFFER_VIEW_DESC& view : mTable) {
+            mDevice->CreateConstantBufferView(&view, cpuHandle);
+            cpuHandle.ptr += mStride;
+        }
+        commandList->SetGraphicsRootDescriptorTable(mPlan->tableParameter(), gpuHandle);
+
+        mNextDescriptor += (UINT)mTable.size();
+        mTableDirty = false;
+    }
+
+private:
+    const ConstantBindingPlan* mPlan = nullptr;
+    ID3D12Device* mDevice = nullptr;
+    ID3D12DescriptorHeap* mHeap = nullptr;
+    UINT mStride = 0;
+    UINT mFirstDescriptor = 0;
+    UINT mDescriptorsPerFrame = 0;
+    UINT mNextDescriptor = 0;
+    UINT mEndDescriptor = 0;
+    std::vector<D3D12_CONSTANT_BUFFER_VIEW_DESC> mTable;
+    bool mTableDirty = false;
+};
+
+// Mirrors the cbuffers in 004-frame-constants.hlsl.
+struct DrawConstants {
+    XMFLOAT2 offset;
+    float scale;
+    float rotation;
+    UINT paletteIndex;
+};
+
+struct FrameConstants {
+    XMFLOAT4X4 projection;
+    float time;
+    float padding[3];
+};
+
+const UINT paletteSize = 16;
+
+struct PaletteConstants {
+    XMFLOAT4 colors[paletteSize];
+};
+
+const UINT quadCount = 32;
+const UINT waveSegments = 64;
+
+// Root budget for the binding plan: up to 8 DWORDs of root constants and one root CBV.
+const UINT maxRootConstantDWords = 8;
+const UINT maxRootCBVs = 1;
+
+const UINT64 frameAllocatorBytes = 256 * 1024;
+const UINT tableDescriptorsPerFrame = 256;
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap: the texture SRV, then one region of table CBVs per frame
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1 + tableDescriptorsPerFrame * frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+
+        mStartTime = secondsNow();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            mConstantPlan = ConstantBindingPlan();
+            mDrawConstantsBlock = mConstantPlan.add("DrawConstants", 0, sizeof(DrawConstants));
+            mFrameConstantsBlock = mConstantPlan.add("FrameConstants", 1, sizeof(FrameConstants));
+            mPaletteBlock = mConstantPlan.add("PaletteConstants", 2, sizeof(PaletteConstants));
+            mConstantPlan.build(maxRootConstantDWords, maxRootCBVs);
+
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            // The constant parameters come from the plan, the texture table follows them.
+            // The description is always 1.1; the serializer converts it when only 1.0 is supported.
+            std::vector<D3D12_ROOT_PARAMETER1> parameters = mConstantPlan.parameters();
+
+            D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+            descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+            descriptorRanges[0].NumDescriptors = 1;
+            descriptorRanges[0].BaseShaderRegister = 0;
+            descriptorRanges[0].RegisterSpace = 0;
+            descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+            D3D12_ROOT_PARAMETER1 textureParameter = {};
+            textureParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+            textureParameter.DescriptorTable.NumDescriptorRanges = 1;
+            textureParameter.DescriptorTable.pDescriptorRanges = descriptorRanges;
+            textureParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+            mTextureParameter = (UINT)parameters.size();
+            parameters.push_back(textureParameter);
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+            rootSignatureDesc.Desc_1_1.NumParameters = (UINT)parameters.size();
+            rootSignatureDesc.Desc_1_1.pParameters = parameters.data();
+            rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+            rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+            rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/004-frame-constants.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/004-frame-constants.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Frame Allocator and Constant Binder
+        {
+            mFrameAllocator.init(mDevice.Get(), frameAllocatorBytes);
+            mConstantBinder.init(&mConstantPlan, mDevice.Get(), mSRVHeap.Get(), 1, tableDescriptorsPerFrame);
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0x00;    // R
+                        pData[n + 1] = 0x00;    // G
+                        pData[n + 2] = 0x00;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        // The fence for this back buffer has completed, so its allocator region can be reused.
+        mFrameAllocator.reset(mFrameBufferIndex);
+        mConstantBinder.reset(mFrameBufferIndex);
+
+        float time = (float)(secondsNow() - mStartTime);
+        float aspect = windowWidth / (windowHeight + 0.0f);
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(mTextureParameter, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        // Per-frame constants
+        {
+            FrameConstants frameConstants = {};
+            XMStoreFloat4x4(&frameConstants.projection, XMMatrixTranspose(XMMatrixOrthographicLH(2.0f * aspect, 2.0f, 0.0f, 1.0f)));
+            frameConstants.time = time;
+            mConstantBinder.set(mCommandList.Get(), mFrameAllocator, mFrameConstantsBlock, &frameConstants);
+
+            PaletteConstants palette = {};
+            for (UINT i = 0; i < paletteSize; i++) {
+                float phase = time + i * 0.4f;
+                palette.colors[i] = XMFLOAT4(0.5f + 0.5f * sinf(phase), 0.5f + 0.5f * sinf(phase + 2.1f), 0.5f + 0.5f * sinf(phase + 4.2f), 1.0f);
+            }
+            mConstantBinder.set(mCommandList.Get(), mFrameAllocator, mPaletteBlock, &palette);
+        }
+
+        // Transient geometry, rebuilt every frame straight into mapped memory
+        Vertex* quadVertices = nullptr;
+        UINT* quadIndices = nullptr;
+        D3D12_VERTEX_BUFFER_VIEW quadVBV = mFrameAllocator.allocateVertices(4, sizeof(Vertex), (void**)&quadVertices);
+        D3D12_INDEX_BUFFER_VIEW quadIBV = mFrameAllocator.allocateIndices(6, &quadIndices);
+        {
+            quadVertices[0] = { { -0.5f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f } };
+            quadVertices[1] = { { 0.5f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 0.0f } };
+            quadVertices[2] = { { 0.5f, -0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f } };
+            quadVertices[3] = { { -0.5f, -0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 1.0f } };
+            const UINT indices[] = { 0, 1, 2, 2, 3, 0 };
+            memcpy(quadIndices, indices, sizeof(indices));
+        }
+
+        Vertex* waveVertices = nullptr;
+        UINT* waveIndices = nullptr;
+        D3D12_VERTEX_BUFFER_VIEW waveVBV = mFrameAllocator.allocateVertices((waveSegments + 1) * 2, sizeof(Vertex), (void**)&waveVertices);
+        D3D12_INDEX_BUFFER_VIEW waveIBV = mFrameAllocator.allocateIndices(waveSegments * 6, &waveIndices);
+        for (UINT i = 0; i <= waveSegments; i++) {
+            float u = i / (float)waveSegments;
+            float x = (u * 2.0f - 1.0f) * aspect * 0.9f;
+            float y = 0.08f * sinf(u * 12.0f + time * 3.0f);
+            waveVertices[i * 2 + 0] = { { x, y + 0.05f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { u, 0.0f } };
+            waveVertices[i * 2 + 1] = { { x, y - 0.05f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { u, 1.0f } };
+        }
+        for (UINT i = 0; i < waveSegments; i++) {
+            UINT v = i * 2;
+            UINT* dst = waveIndices + i * 6;
+            dst[0] = v + 0; dst[1] = v + 2; dst[2] = v + 1;
+            dst[3] = v + 1; dst[4] = v + 2; dst[5] = v + 3;
+        }
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        // A ring of quads, each with its own per-draw constants
+        mCommandList->IASetVertexBuffers(0, 1, &quadVBV);
+        mCommandList->IASetIndexBuffer(&quadIBV);
+        for (UINT i = 0; i < quadCount; i++) {
+            float angle = time * 0.5f + i * XM_2PI / quadCount;
+            DrawConstants drawConstants = {};
+            drawConstants.offset = XMFLOAT2(0.6f * cosf(angle), 0.6f * sinf(angle) + 0.2f);
+            drawConstants.scale = 0.12f + 0.04f * sinf(time * 2.0f + i);
+            drawConstants.rotation = -angle;
+            drawConstants.paletteIndex = i % paletteSize;
+            mConstantBinder.set(mCommandList.Get(), mFrameAllocator, mDrawConstantsBlock, &drawConstants);
+            mConstantBinder.commit(mCommandList.Get());
+            mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+        }
+
+        // The wave strip
+        {
+            DrawConstants drawConstants = {};
+            drawConstants.offset = XMFLOAT2(0.0f, -0.75f);
+            drawConstants.scale = 1.0f;
+            drawConstants.rotation = 0.0f;
+            drawConstants.paletteIndex = 0;
+            mConstantBinder.set(mCommandList.Get(), mFrameAllocator, mDrawConstantsBlock, &drawConstants);
+            mConstantBinder.commit(mCommandList.Get());
+            mCommandList->IASetVertexBuffers(0, 1, &waveVBV);
+            mCommandList->IASetIndexBuffer(&waveIBV);
+            mCommandList->DrawIndexedInstanced(waveSegments * 6, 1, 0, 0, 0);
+        }
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 4096;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    FrameAllocator mFrameAllocator;
+    ConstantBindingPlan mConstantPlan;
+    ConstantBinder mConstantBinder;
+    UINT mDrawConstantsBlock = 0;
+    UINT mFrameConstantsBlock = 0;
+    UINT mPaletteBlock = 0;
+    UINT mTextureParameter = 0;
+    double mStartTime = 0.0;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+        UNREFERENCED_PARAMETER(lpCmdLine);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
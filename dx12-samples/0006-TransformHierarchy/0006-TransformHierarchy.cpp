@@ -0,0 +1,1299 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0006-TransformHierarchy";
+const char* windowClass = "0006-TransformHierarchy";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024] = { 0 };
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// Linear allocator over one persistently mapped UPLOAD buffer, split into one region per
+// frame in flight. Allocating is a single pointer bump; reset() rewinds a region once the
+// fence of the frame that last used it has completed. Nothing is mapped or freed per draw.
+class FrameAllocator {
+public:
+    struct Allocation {
+        UINT8* cpu;
+        D3D12_GPU_VIRTUAL_ADDRESS gpu;
+    };
+
+    void init(ID3D12Device* device, UINT64 bytesPerFrame) {
+        mBytesPerFrame = bytesPerFrame;
+
+        D3D12_HEAP_PROPERTIES heapProperties = {};
+        heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = bytesPerFrame * frameBufferCount;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&mBuffer)));
+
+        // Upload heaps may stay mapped for their whole lifetime.
+        D3D12_RANGE readRange = { 0, 0 };
+        _ThrowIfFailed(mBuffer->Map(0, &readRange, (void**)&mCpuBase));
+        mGpuBase = mBuffer->GetGPUVirtualAddress();
+    }
+
+    void reset(UINT frameIndex) {
+        mBegin = frameIndex * mBytesPerFrame;
+        mOffset = mBegin;
+        mEnd = mBegin + mBytesPerFrame;
+    }
+
+    Allocation allocate(UINT64 size, UINT64 alignment) {
+        UINT64 offset = (mOffset + alignment - 1) & ~(alignment - 1);
+        if (offset + size > mEnd) {
+            throw std::exception("Frame allocator is out of memory.");
+        }
+        mOffset = offset + size;
+        mHighWater = std::max(mHighWater, mOffset - mBegin);
+        return { mCpuBase + offset, mGpuBase + offset };
+    }
+
+    // Constant buffer views must start on and span a multiple of 256 bytes.
+    Allocation allocateConstants(const void* data, UINT size) {
+        UINT alignedSize = (size + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+        Allocation allocation = this->allocate(alignedSize, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+        memcpy(allocation.cpu, data, size);
+        return allocation;
+    }
+
+    D3D12_VERTEX_BUFFER_VIEW allocateVertices(UINT count, UINT stride, void** data) {
+        Allocation allocation = this->allocate((UINT64)count * stride, 16);
+        *data = allocation.cpu;
+
+        D3D12_VERTEX_BUFFER_VIEW view = {};
+        view.BufferLocation = allocation.gpu;
+        view.StrideInBytes = stride;
+        view.SizeInBytes = count * stride;
+        return view;
+    }
+
+    D3D12_INDEX_BUFFER_VIEW allocateIndices(UINT count, UINT** data) {
+        Allocation allocation = this->allocate((UINT64)count * sizeof(UINT), sizeof(UINT));
+        *data = (UINT*)allocation.cpu;
+
+        D3D12_INDEX_BUFFER_VIEW view = {};
+        view.BufferLocation = allocation.gpu;
+        view.Format = DXGI_FORMAT_R32_UINT;
+        view.SizeInBytes = count * sizeof(UINT);
+        return view;
+    }
+
+    UINT64 highWater() const { return mHighWater; }
+
+private:
+    ComPtr<ID3D12Resource> mBuffer;
+    UINT8* mCpuBase = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS mGpuBase = 0;
+    UINT64 mBytesPerFrame = 0;
+    UINT64 mBegin = 0;
+    UINT64 mOffset = 0;
+    UINT64 mEnd = 0;
+    UINT64 mHighWater = 0;
+};
+
+// Small fork-join pool. run() splits [0, count) into chunks that the workers and the calling
+// thread pull from an atomic counter, and returns once every chunk is done. The job is passed
+// as a function pointer plus context, so dispatching allocates nothing.
+class ParallelFor {
+public:
+    void start(UINT workerCount) {
+        for (UINT i = 0; i < workerCount; i++) {
+            mWorkers.push_back(std::thread([this]() { this->worker(); }));
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+        for (std::thread& worker : mWorkers) {
+            worker.join();
+        }
+        mWorkers.clear();
+    }
+
+    UINT workerCount() const { return (UINT)mWorkers.size(); }
+
+    template<typename F>
+    void run(UINT count, UINT chunkSize, const F& fn) {
+        if (mWorkers.empty() || count <= chunkSize) {
+            fn(0, count);
+            return;
+        }
+        this->dispatch(count, chunkSize, [](const void* context, UINT begin, UINT end) { (*(const F*)context)(begin, end); }, &fn);
+    }
+
+private:
+    typedef void (*JobFunction)(const void* context, UINT begin, UINT end);
+
+    void dispatch(UINT count, UINT chunkSize, JobFunction function, const void* context) {
+        {
+            // Wait for stragglers of the previous job before the job fields are replaced.
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait(lock, [this]() { return mActive == 0; });
+            mFunction = function;
+            mContext = context;
+            mCount = count;
+            mChunkSize = chunkSize;
+            mNextChunk = 0;
+            mGeneration++;
+        }
+        mWake.notify_all();
+
+        this->work();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mActive == 0; });
+    }
+
+    void work() {
+        UINT chunkCount = (mCount + mChunkSize - 1) / mChunkSize;
+        for (;;) {
+            UINT chunk = mNextChunk++;
+            if (chunk >= chunkCount) {
+                return;
+            }
+            UINT begin = chunk * mChunkSize;
+            mFunction(mContext, begin, std::min(begin + mChunkSize, mCount));
+        }
+    }
+
+    void worker() {
+        UINT64 seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [&]() { return mStop || mGeneration != seen; });
+                if (mStop) {
+                    return;
+                }
+                seen = mGeneration;
+                mActive++;
+            }
+
+            this->work();
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mActive == 0) {
+                mDone.notify_all();
+            }
+        }
+    }
+
+private:
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    JobFunction mFunction = nullptr;
+    const void* mContext = nullptr;
+    UINT mCount = 0;
+    UINT mChunkSize = 1;
+    std::atomic<UINT> mNextChunk;
+    UINT64 mGeneration = 0;
+    UINT mActive = 0;
+    bool mStop = false;
+};
+
+// Scene transforms in structure-of-arrays form. Nodes are sorted by hierarchy depth, so every
+// parent precedes its children and each depth level is a contiguous range that can be updated
+// in parallel once the level above it is done. Local translation, rotation and scale live in
+// separate arrays; world matrices are recomputed only for nodes whose local transform changed
+// or whose parent's world changed, and levels without any change are skipped outright.
+class TransformHierarchy {
+public:
+    // Adds a node under parent (a handle returned earlier, or -1 for a root). Call build()
+    // after adding nodes and before setting or updating them.
+    UINT add(INT parent, const XMFLOAT3& translation, const XMFLOAT4& rotation, const XMFLOAT3& scale) {
+        UINT depth = parent < 0 ? 0 : mAddedDepth[parent] + 1;
+        mAddedParent.push_back(parent);
+        mAddedDepth.push_back(depth);
+        mAddedTranslation.push_back(translation);
+        mAddedRotation.push_back(rotation);
+        mAddedScale.push_back(scale);
+        return (UINT)mAddedParent.size() - 1;
+    }
+
+    void build() {
+        UINT count = (UINT)mAddedParent.size();
+        UINT levelCount = 0;
+        for (UINT depth : mAddedDepth) {
+            levelCount = std::max(levelCount, depth + 1);
+        }
+
+        // Counting sort by depth keeps insertion order within a level.
+        mLevelStart.assign(levelCount + 1, 0);
+        for (UINT depth : mAddedDepth) {
+            mLevelStart[depth + 1]++;
+        }
+        for (UINT level = 0; level < levelCount; level++) {
+            mLevelStart[level + 1] += mLevelStart[level];
+        }
+
+        std::vector<UINT> cursor(mLevelStart.begin(), mLevelStart.end() - 1);
+        mHandleToIndex.resize(count);
+        mIndexToHandle.resize(count);
+        for (UINT handle = 0; handle < count; handle++) {
+            UINT index = cursor[mAddedDepth[handle]]++;
+            mHandleToIndex[handle] = index;
+            mIndexToHandle[index] = handle;
+        }
+
+        mParent.resize(count);
+        mTranslation.resize(count);
+        mRotation.resize(count);
+        mScale.resize(count);
+        mWorld.resize(count);
+        mLocalDirty.assign(count, 1);
+        mWorldChanged.assign(count, 0);
+        mLevelDirty.assign(levelCount, 1);
+        mLevelChanged.assign(levelCount, 0);
+        for (UINT index = 0; index < count; index++) {
+            UINT handle = mIndexToHandle[index];
+            INT parent = mAddedParent[handle];
+            mParent[index] = parent < 0 ? -1 : (INT)mHandleToIndex[parent];
+            mTranslation[index] = mAddedTranslation[handle];
+            mRotation[index] = mAddedRotation[handle];
+            mScale[index] = mAddedScale[handle];
+        }
+    }
+
+    void setTranslation(UINT handle, const XMFLOAT3& translation) {
+        UINT index = mHandleToIndex[handle];
+        mTranslation[index] = translation;
+        this->markDirty(index);
+    }
+
+    void setRotation(UINT handle, const XMFLOAT4& rotation) {
+        UINT index = mHandleToIndex[handle];
+        mRotation[index] = rotation;
+        this->markDirty(index);
+    }
+
+    void setScale(UINT handle, const XMFLOAT3& scale) {
+        UINT index = mHandleToIndex[handle];
+        mScale[index] = scale;
+        this->markDirty(index);
+    }
+
+    // Recomputes world matrices level by level; pool may be null for a serial update.
+    void update(ParallelFor* pool) {
+        mUpdatedCount = 0;
+        bool parentLevelChanged = false;
+        for (UINT level = 0; level + 1 < (UINT)mLevelStart.size(); level++) {
+            UINT begin = mLevelStart[level];
+            UINT end = mLevelStart[level + 1];
+
+            if (!mLevelDirty[level] && !parentLevelChanged) {
+                // Nothing in this level moves; clear change flags left from the last update.
+                if (mLevelChanged[level]) {
+                    memset(&mWorldChanged[begin], 0, end - begin);
+                    mLevelChanged[level] = 0;
+                }
+                continue;
+            }
+
+            std::atomic<UINT> updated(0);
+            auto updateRange = [this, begin, &updated](UINT first, UINT last) {
+                UINT count = this->updateNodes(begin + first, begin + last);
+                if (count > 0) {
+                    updated += count;
+                }
+            };
+            if (pool != nullptr) {
+                pool->run(end - begin, updateChunkSize, updateRange);
+            }
+            else {
+                updateRange(0, end - begin);
+            }
+
+            mLevelDirty[level] = 0;
+            mLevelChanged[level] = updated > 0 ? 1 : 0;
+            parentLevelChanged = updated > 0;
+            mUpdatedCount += updated;
+        }
+    }
+
+    const XMFLOAT4X4& world(UINT handle) const { return mWorld[mHandleToIndex[handle]]; }
+    const XMFLOAT4X4* worlds() const { return mWorld.data(); }
+    UINT count() const { return (UINT)mParent.size(); }
+    UINT levelCount() const { return (UINT)mLevelStart.size() - 1; }
+    UINT updatedCount() const { return mUpdatedCount; }
+
+private:
+    static const UINT updateChunkSize = 1024;
+
+    void markDirty(UINT index) {
+        mLocalDirty[index] = 1;
+        mLevelDirty[this->levelOf(index)] = 1;
+    }
+
+    UINT levelOf(UINT index) const {
+        return (UINT)(std::upper_bound(mLevelStart.begin(), mLevelStart.end(), index) - mLevelStart.begin()) - 1;
+    }
+
+    UINT updateNodes(UINT begin, UINT end) {
+        UINT updated = 0;
+        for (UINT i = begin; i < end; i++) {
+            INT parent = mParent[i];
+            bool dirty = mLocalDirty[i] || (parent >= 0 && mWorldChanged[parent]);
+            mWorldChanged[i] = dirty ? 1 : 0;
+            if (!dirty) {
+                continue;
+            }
+
+            XMMATRIX local = XMMatrixAffineTransformation(
+                XMLoadFloat3(&mScale[i]),
+                XMVectorZero(),
+                XMLoadFloat4(&mRotation[i]),
+                XMLoadFloat3(&mTranslation[i]));
+            if (parent >= 0) {
+                local = XMMatrixMultiply(local, XMLoadFloat4x4(&mWorld[parent]));
+            }
+            XMStoreFloat4x4(&mWorld[i], local);
+            mLocalDirty[i] = 0;
+            updated++;
+        }
+        return updated;
+    }
+
+private:
+    // Build input, in handle order
+    std::vector<INT> mAddedParent;
+    std::vector<UINT> mAddedDepth;
+    std::vector<XMFLOAT3> mAddedTranslation;
+    std::vector<XMFLOAT4> mAddedRotation;
+    std::vector<XMFLOAT3> mAddedScale;
+
+    // Sorted by depth
+    std::vector<UINT> mLevelStart;
+    std::vector<UINT> mHandleToIndex;
+    std::vector<UINT> mIndexToHandle;
+    std::vector<INT> mParent;
+    std::vector<XMFLOAT3> mTranslation;
+    std::vector<XMFLOAT4> mRotation;
+    std::vector<XMFLOAT3> mScale;
+    std::vector<XMFLOAT4X4> mWorld;
+    std::vector<UINT8> mLocalDirty;
+    std::vector<UINT8> mWorldChanged;
+    std::vector<UINT8> mLevelDirty;
+    std::vector<UINT8> mLevelChanged;
+    UINT mUpdatedCount = 0;
+};
+
+// Headless benchmark: random 6-ary trees of 10k, 100k and 1M nodes, measuring a full update
+// serially and in parallel, a partial update with 1% of the nodes moved, and a clean update.
+void benchmarkTransforms() {
+    ParallelFor pool;
+    pool.start(std::max(std::thread::hardware_concurrency(), 2U) - 1);
+
+    std::string report = "Transform hierarchy benchmark:\n";
+    const UINT nodeCounts[] = { 10000, 100000, 1000000 };
+    for (UINT nodeCount : nodeCounts) {
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> angle(0.0f, XM_2PI);
+
+        TransformHierarchy hierarchy;
+        for (UINT i = 0; i < nodeCount; i++) {
+            INT parent = i == 0 ? -1 : (INT)((i - 1) / 6);
+            XMFLOAT4 rotation;
+            XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(0.0f, 0.0f, angle(random)));
+            hierarchy.add(parent, XMFLOAT3(1.0f, 0.0f, 0.0f), rotation, XMFLOAT3(0.5f, 0.5f, 0.5f));
+        }
+        hierarchy.build();
+
+        auto dirtyAll = [&]() {
+            for (UINT i = 0; i < nodeCount; i++) {
+                hierarchy.setScale(i, XMFLOAT3(0.5f, 0.5f, 0.5f));
+            }
+        };
+        auto measure = [&](ParallelFor* p) -> double {
+            double start = secondsNow();
+            hierarchy.update(p);
+            return (secondsNow() - start) * 1000.0;
+        };
+
+        dirtyAll();
+        double serialMs = measure(nullptr);
+        dirtyAll();
+        double parallelMs = measure(&pool);
+
+        // Move 1% of the nodes, picked among the leaves so each change stays local.
+        for (UINT i = nodeCount / 6 + 1; i < nodeCount; i += 83) {
+            hierarchy.setRotation(i, XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+        }
+        double partialMs = measure(&pool);
+        UINT partialUpdated = hierarchy.updatedCount();
+        double cleanMs = measure(&pool);
+
+        char line[512];
+        snprintf(line, sizeof(line),
+            "  %7u nodes, %u levels: full %.3f ms serial, %.3f ms parallel (%.1f Mnodes/s), "
+            "1%% moved %.3f ms (%u updated), clean %.3f ms\n",
+            nodeCount, hierarchy.levelCount(), serialMs, parallelMs, nodeCount / parallelMs / 1000.0,
+            partialMs, partialUpdated, cleanMs);
+        report += line;
+    }
+    pool.stop();
+
+    debugLog("%s", report.c_str());
+    MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+}
+
+// Fractal scene: every node carries fanOut children orbiting it at a smaller scale.
+const UINT sceneDepth = 5;
+const UINT sceneFanOut = 6;
+
+const UINT64 frameAllocatorBytes = 1024 * 1024;
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+
+        mStartTime = secondsNow();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        mPool.stop();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            // The description is always 1.1; the serializer converts it when only 1.0 is supported.
+            D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+            descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+            descriptorRanges[0].NumDescriptors = 1;
+            descriptorRanges[0].BaseShaderRegister = 0;
+            descriptorRanges[0].RegisterSpace = 0;
+            descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+            D3D12_ROOT_PARAMETER1 parameters[2] = {};
+            parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+            parameters[0].Constants.ShaderRegister = 0;
+            parameters[0].Constants.RegisterSpace = 0;
+            parameters[0].Constants.Num32BitValues = 16;
+            parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+            parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+            parameters[1].DescriptorTable.NumDescriptorRanges = 1;
+            parameters[1].DescriptorTable.pDescriptorRanges = descriptorRanges;
+            parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+            rootSignatureDesc.Desc_1_1.NumParameters = _countof(parameters);
+            rootSignatureDesc.Desc_1_1.pParameters = parameters;
+            rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+            rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+            rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/005-transform-hierarchy.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/005-transform-hierarchy.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Frame Allocator
+        mFrameAllocator.init(mDevice.Get(), frameAllocatorBytes);
+
+        // Build Scene Hierarchy
+        {
+            XMFLOAT4 identity(0.0f, 0.0f, 0.0f, 1.0f);
+            std::vector<UINT> level(1, mHierarchy.add(-1, XMFLOAT3(0.0f, 0.0f, 0.0f), identity, XMFLOAT3(0.3f, 0.3f, 0.3f)));
+            for (UINT depth = 1; depth < sceneDepth; depth++) {
+                std::vector<UINT> next;
+                for (UINT parent : level) {
+                    for (UINT i = 0; i < sceneFanOut; i++) {
+                        float angle = i * XM_2PI / sceneFanOut;
+                        XMFLOAT3 translation(2.2f * cosf(angle), 2.2f * sinf(angle), 0.0f);
+                        next.push_back(mHierarchy.add((INT)parent, translation, identity, XMFLOAT3(0.4f, 0.4f, 0.4f)));
+                    }
+                }
+                level.swap(next);
+            }
+            mHierarchy.build();
+            mPool.start(std::max(std::thread::hardware_concurrency(), 2U) - 1);
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0x00;    // R
+                        pData[n + 1] = 0x00;    // G
+                        pData[n + 2] = 0x00;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        // The fence for this back buffer has completed, so its allocator region can be reused.
+        mFrameAllocator.reset(mFrameBufferIndex);
+
+        float time = (float)(secondsNow() - mStartTime);
+        float aspect = windowWidth / (windowHeight + 0.0f);
+
+        // Spin the upper levels only; everything below follows through its parents, and the
+        // static handles stay clean.
+        for (UINT handle = 0; handle < 1 + sceneFanOut + sceneFanOut * sceneFanOut; handle++) {
+            XMFLOAT4 rotation;
+            XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(0.0f, 0.0f, time * (0.3f + 0.05f * (handle % 7))));
+            mHierarchy.setRotation(handle, rotation);
+        }
+        mHierarchy.update(&mPool);
+
+        // Quad geometry and one world matrix per node, straight into mapped memory
+        Vertex* quadVertices = nullptr;
+        UINT* quadIndices = nullptr;
+        D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[2] = {};
+        vertexBufferViews[0] = mFrameAllocator.allocateVertices(4, sizeof(Vertex), (void**)&quadVertices);
+        D3D12_INDEX_BUFFER_VIEW quadIBV = mFrameAllocator.allocateIndices(6, &quadIndices);
+        {
+            quadVertices[0] = { { -0.5f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f } };
+            quadVertices[1] = { { 0.5f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 0.0f } };
+            quadVertices[2] = { { 0.5f, -0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f } };
+            quadVertices[3] = { { -0.5f, -0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 1.0f } };
+            const UINT indices[] = { 0, 1, 2, 2, 3, 0 };
+            memcpy(quadIndices, indices, sizeof(indices));
+        }
+
+        XMFLOAT4X4* instances = nullptr;
+        vertexBufferViews[1] = mFrameAllocator.allocateVertices(mHierarchy.count(), sizeof(XMFLOAT4X4), (void**)&instances);
+        memcpy(instances, mHierarchy.worlds(), sizeof(XMFLOAT4X4) * mHierarchy.count());
+
+        XMFLOAT4X4 projection;
+        XMStoreFloat4x4(&projection, XMMatrixTranspose(XMMatrixOrthographicLH(2.0f * aspect, 2.0f, 0.0f, 1.0f)));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+        mCommandList->SetGraphicsRoot32BitConstants(0, 16, &projection, 0);
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(1, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, _countof(vertexBufferViews), vertexBufferViews);
+        mCommandList->IASetIndexBuffer(&quadIBV);
+        mCommandList->DrawIndexedInstanced(6, mHierarchy.count(), 0, 0, 0);
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 4096;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    FrameAllocator mFrameAllocator;
+    TransformHierarchy mHierarchy;
+    ParallelFor mPool;
+    double mStartTime = 0.0;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        // Run the transform update benchmark without creating a window.
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            benchmarkTransforms();
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
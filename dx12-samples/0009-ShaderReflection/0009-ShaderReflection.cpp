@@ -0,0 +1,1501 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0009-ShaderReflection";
+const char* windowClass = "0009-ShaderReflection";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+const UINT textureCount = 2;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024] = { 0 };
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+bool readTextFile(const std::string& path, std::string& text) {
+    FILE* fd = NULL;
+    fopen_s(&fd, path.c_str(), "rb");
+    if (fd == NULL) {
+        return false;
+    }
+    fseek(fd, 0, SEEK_END);
+    long size = ftell(fd);
+    fseek(fd, 0, SEEK_SET);
+    text.resize(size > 0 ? (size_t)size : 0);
+    size_t read = size > 0 ? fread(&text[0], (size_t)size, 1, fd) : 1;
+    fclose(fd);
+    return read == 1;
+}
+
+// FNV-1a, used to tell whether a cache still matches its shader source. Passing the previous
+// result as hash extends it, so several inputs can be folded into one key.
+UINT64 hashBytes(const void* data, size_t size, UINT64 hash = 14695981039346656037ULL) {
+    const UINT8* bytes = (const UINT8*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+const UINT shaderStageVertex = 1;
+const UINT shaderStagePixel = 2;
+
+// Constant buffers up to this size are bound as root constants instead of root CBVs.
+const UINT maxRootConstantDWords = 16;
+
+// Bump whenever PipelineLayout or the cache file changes shape; it is part of the cache key,
+// so files written by an older build are recompiled instead of misread.
+const UINT shaderCacheVersion = 2;
+
+// Everything a pipeline needs that can be derived from its compiled shaders: the root
+// signature, where each binding lives in it, and the vertex input layout. Bindings the
+// compiler stripped never show up in reflection, so they cost nothing at draw time.
+//
+// Layout rules: small cbuffers become root constants, larger ones root CBVs, and every
+// SRV/UAV of the pipeline goes into one descriptor table whose ranges merge consecutive
+// registers. Samplers become static samplers built from a template.
+class PipelineLayout {
+public:
+    enum ParameterKind {
+        ParameterRootConstants = 0,
+        ParameterRootCBV = 1,
+        ParameterDescriptorTable = 2,
+    };
+
+    struct Parameter {
+        std::string name;
+        UINT kind;
+        UINT num32BitValues;
+    };
+
+    struct TableEntry {
+        std::string name;
+        UINT offset;
+    };
+
+    struct InputElement {
+        std::string semantic;
+        UINT semanticIndex;
+        DXGI_FORMAT format;
+        UINT offset;
+    };
+
+    // Reflects the shaders and serializes the root signature.
+    void reflect(D3D12_SHADER_BYTECODE vs, D3D12_SHADER_BYTECODE ps, const D3D12_STATIC_SAMPLER_DESC& samplerTemplate) {
+        std::vector<Binding> bindings;
+        this->reflectStage(vs, shaderStageVertex, bindings);
+        this->reflectStage(ps, shaderStagePixel, bindings);
+        std::sort(bindings.begin(), bindings.end(), [](const Binding& a, const Binding& b) {
+            return a.rangeType != b.rangeType ? a.rangeType < b.rangeType : a.space != b.space ? a.space < b.space : a.bindPoint < b.bindPoint;
+        });
+
+        std::vector<D3D12_ROOT_PARAMETER1> parameters;
+        std::vector<D3D12_DESCRIPTOR_RANGE1> ranges;
+        std::vector<D3D12_STATIC_SAMPLER_DESC> samplers;
+        UINT tableStages = 0;
+        mParameters.clear();
+        mTable.clear();
+
+        // Root constants first: they change per draw and are cheapest to set.
+        for (int pass = 0; pass < 2; pass++) {
+            for (const Binding& binding : bindings) {
+                if (binding.rangeType != D3D12_DESCRIPTOR_RANGE_TYPE_CBV) {
+                    continue;
+                }
+                bool small = binding.size / 4 <= maxRootConstantDWords;
+                if (small != (pass == 0)) {
+                    continue;
+                }
+                D3D12_ROOT_PARAMETER1 parameter = {};
+                parameter.ShaderVisibility = visibility(binding.stages);
+                if (small) {
+                    parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                    parameter.Constants.ShaderRegister = binding.bindPoint;
+                    parameter.Constants.RegisterSpace = binding.space;
+                    parameter.Constants.Num32BitValues = binding.size / 4;
+                    mParameters.push_back({ binding.name, ParameterRootConstants, binding.size / 4 });
+                } else {
+                    parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+                    parameter.Descriptor.ShaderRegister = binding.bindPoint;
+                    parameter.Descriptor.RegisterSpace = binding.space;
+                    mParameters.push_back({ binding.name, ParameterRootCBV, 2 });
+                }
+                parameters.push_back(parameter);
+            }
+        }
+
+        // One table for every SRV and UAV, consecutive registers merged into one range.
+        UINT tableOffset = 0;
+        for (const Binding& binding : bindings) {
+            if (binding.rangeType == D3D12_DESCRIPTOR_RANGE_TYPE_SRV || binding.rangeType == D3D12_DESCRIPTOR_RANGE_TYPE_UAV) {
+                D3D12_DESCRIPTOR_RANGE1* last = ranges.empty() ? nullptr : &ranges.back();
+                if (last != nullptr && last->RangeType == binding.rangeType && last->RegisterSpace == binding.space
+                    && last->BaseShaderRegister + last->NumDescriptors == binding.bindPoint) {
+                    last->NumDescriptors += binding.bindCount;
+                } else {
+                    D3D12_DESCRIPTOR_RANGE1 range = {};
+                    range.RangeType = binding.rangeType;
+                    range.NumDescriptors = binding.bindCount;
+                    range.BaseShaderRegister = binding.bindPoint;
+                    range.RegisterSpace = binding.space;
+                    range.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+                    ranges.push_back(range);
+                }
+                mTable.push_back({ binding.name, tableOffset });
+                tableOffset += binding.bindCount;
+                tableStages |= binding.stages;
+            } else if (binding.rangeType == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER) {
+                D3D12_STATIC_SAMPLER_DESC sampler = samplerTemplate;
+                sampler.ShaderRegister = binding.bindPoint;
+                sampler.RegisterSpace = binding.space;
+                sampler.ShaderVisibility = visibility(binding.stages);
+                samplers.push_back(sampler);
+            }
+        }
+        if (!ranges.empty()) {
+            D3D12_ROOT_PARAMETER1 parameter = {};
+            parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+            parameter.DescriptorTable.NumDescriptorRanges = (UINT)ranges.size();
+            parameter.DescriptorTable.pDescriptorRanges = ranges.data();
+            parameter.ShaderVisibility = visibility(tableStages);
+            parameters.push_back(parameter);
+            mParameters.push_back({ "", ParameterDescriptorTable, 1 });
+        }
+
+        // Deny the stages that bind nothing so the driver can skip them.
+        UINT usedStages = tableStages;
+        for (const Binding& binding : bindings) {
+            usedStages |= binding.stages;
+        }
+        D3D12_ROOT_SIGNATURE_FLAGS flags = D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS
+            | D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS
+            | D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
+        if (!mInputElements.empty()) {
+            flags |= D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+        }
+        if (!(usedStages & shaderStageVertex)) {
+            flags |= D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS;
+        }
+        if (!(usedStages & shaderStagePixel)) {
+            flags |= D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS;
+        }
+
+        // The description is always 1.1; the serializer converts it when only 1.0 is supported.
+        D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+        rootSignatureDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+        rootSignatureDesc.Desc_1_1.NumParameters = (UINT)parameters.size();
+        rootSignatureDesc.Desc_1_1.pParameters = parameters.data();
+        rootSignatureDesc.Desc_1_1.NumStaticSamplers = (UINT)samplers.size();
+        rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers.data();
+        rootSignatureDesc.Desc_1_1.Flags = flags;
+
+        ComPtr<ID3DBlob> rootSignatureBlob;
+        ComPtr<ID3DBlob> errorBlob;
+        HRESULT hr = D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, mRootSignatureVersion, &rootSignatureBlob, &errorBlob);
+        if (errorBlob != nullptr) {
+            std::string str((const char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+        _ThrowIfFailed(hr);
+        const UINT8* bytes = (const UINT8*)rootSignatureBlob->GetBufferPointer();
+        mRootSignature.assign(bytes, bytes + rootSignatureBlob->GetBufferSize());
+    }
+
+    void setRootSignatureVersion(D3D_ROOT_SIGNATURE_VERSION version) {
+        mRootSignatureVersion = version;
+    }
+
+    UINT parameterIndex(const std::string& name) const {
+        for (UINT i = 0; i < mParameters.size(); i++) {
+            if (mParameters[i].name == name) {
+                return i;
+            }
+        }
+        throw std::exception("Root parameter not found.");
+    }
+
+    UINT tableParameterIndex() const {
+        for (UINT i = 0; i < mParameters.size(); i++) {
+            if (mParameters[i].kind == ParameterDescriptorTable) {
+                return i;
+            }
+        }
+        throw std::exception("The pipeline has no descriptor table.");
+    }
+
+    // Offset of a texture or UAV from the start of the descriptor table, or -1 when the
+    // shaders do not use it.
+    int tableOffset(const std::string& name) const {
+        for (const TableEntry& entry : mTable) {
+            if (entry.name == name) {
+                return (int)entry.offset;
+            }
+        }
+        return -1;
+    }
+
+    UINT tableSize() const {
+        UINT size = 0;
+        for (const TableEntry& entry : mTable) {
+            size = std::max(size, entry.offset + 1);
+        }
+        return size;
+    }
+
+    // Root signature cost in DWORDs of the 64 available.
+    UINT rootSignatureDWords() const {
+        UINT total = 0;
+        for (const Parameter& parameter : mParameters) {
+            total += parameter.num32BitValues;
+        }
+        return total;
+    }
+
+    UINT parameterCount() const { return (UINT)mParameters.size(); }
+
+    const std::vector<UINT8>& rootSignature() const { return mRootSignature; }
+
+    // The returned elements point into this object.
+    std::vector<D3D12_INPUT_ELEMENT_DESC> inputLayout() const {
+        std::vector<D3D12_INPUT_ELEMENT_DESC> elements;
+        for (const InputElement& element : mInputElements) {
+            elements.push_back({ element.semantic.c_str(), element.semanticIndex, element.format, 0, element.offset,
+                D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 });
+        }
+        return elements;
+    }
+
+    UINT vertexStride() const { return mVertexStride; }
+
+    void write(FILE* fd) const {
+        writeBytes(fd, mRootSignature);
+        UINT count = (UINT)mParameters.size();
+        fwrite(&count, sizeof(count), 1, fd);
+        for (const Parameter& parameter : mParameters) {
+            writeString(fd, parameter.name);
+            fwrite(&parameter.kind, sizeof(UINT), 1, fd);
+            fwrite(&parameter.num32BitValues, sizeof(UINT), 1, fd);
+        }
+        count = (UINT)mTable.size();
+        fwrite(&count, sizeof(count), 1, fd);
+        for (const TableEntry& entry : mTable) {
+            writeString(fd, entry.name);
+            fwrite(&entry.offset, sizeof(UINT), 1, fd);
+        }
+        count = (UINT)mInputElements.size();
+        fwrite(&count, sizeof(count), 1, fd);
+        for (const InputElement& element : mInputElements) {
+            writeString(fd, element.semantic);
+            fwrite(&element.semanticIndex, sizeof(UINT), 1, fd);
+            fwrite(&element.format, sizeof(DXGI_FORMAT), 1, fd);
+            fwrite(&element.offset, sizeof(UINT), 1, fd);
+        }
+        fwrite(&mVertexStride, sizeof(UINT), 1, fd);
+    }
+
+    bool read(FILE* fd) {
+        UINT count = 0;
+        if (!readBytes(fd, mRootSignature) || fread(&count, sizeof(count), 1, fd) != 1) {
+            return false;
+        }
+        mParameters.resize(count);
+        for (Parameter& parameter : mParameters) {
+            if (!readString(fd, parameter.name) || fread(&parameter.kind, sizeof(UINT), 1, fd) != 1
+                || fread(&parameter.num32BitValues, sizeof(UINT), 1, fd) != 1) {
+                return false;
+            }
+        }
+        if (fread(&count, sizeof(count), 1, fd) != 1) {
+            return false;
+        }
+        mTable.resize(count);
+        for (TableEntry& entry : mTable) {
+            if (!readString(fd, entry.name) || fread(&entry.offset, sizeof(UINT), 1, fd) != 1) {
+                return false;
+            }
+        }
+        if (fread(&count, sizeof(count), 1, fd) != 1) {
+            return false;
+        }
+        mInputElements.resize(count);
+        for (InputElement& element : mInputElements) {
+            if (!readString(fd, element.semantic) || fread(&element.semanticIndex, sizeof(UINT), 1, fd) != 1
+                || fread(&element.format, sizeof(DXGI_FORMAT), 1, fd) != 1 || fread(&element.offset, sizeof(UINT), 1, fd) != 1) {
+                return false;
+            }
+        }
+        return fread(&mVertexStride, sizeof(UINT), 1, fd) == 1;
+    }
+
+    static void writeBytes(FILE* fd, const std::vector<UINT8>& bytes) {
+        UINT size = (UINT)bytes.size();
+        fwrite(&size, sizeof(size), 1, fd);
+        fwrite(bytes.data(), 1, size, fd);
+    }
+
+    static bool readBytes(FILE* fd, std::vector<UINT8>& bytes) {
+        UINT size = 0;
+        if (fread(&size, sizeof(size), 1, fd) != 1 || size > (64U << 20)) {
+            return false;
+        }
+        bytes.resize(size);
+        return fread(bytes.data(), 1, size, fd) == size;
+    }
+
+    static void writeString(FILE* fd, const std::string& text) {
+        writeBytes(fd, std::vector<UINT8>(text.begin(), text.end()));
+    }
+
+    static bool readString(FILE* fd, std::string& text) {
+        std::vector<UINT8> bytes;
+        if (!readBytes(fd, bytes)) {
+            return false;
+        }
+        text.assign(bytes.begin(), bytes.end());
+        return true;
+    }
+
+private:
+    struct Binding {
+        std::string name;
+        D3D12_DESCRIPTOR_RANGE_TYPE rangeType;
+        UINT bindPoint;
+        UINT bindCount;
+        UINT space;
+        UINT size;
+        UINT stages;
+    };
+
+    static D3D12_SHADER_VISIBILITY visibility(UINT stages) {
+        if (stages == shaderStageVertex) {
+            return D3D12_SHADER_VISIBILITY_VERTEX;
+        }
+        if (stages == shaderStagePixel) {
+            return D3D12_SHADER_VISIBILITY_PIXEL;
+        }
+        return D3D12_SHADER_VISIBILITY_ALL;
+    }
+
+    void reflectStage(D3D12_SHADER_BYTECODE code, UINT stage, std::vector<Binding>& bindings) {
+        ComPtr<ID3D12ShaderReflection> reflection;
+        _ThrowIfFailed(D3DReflect(code.pShaderBytecode, code.BytecodeLength, IID_PPV_ARGS(&reflection)));
+        D3D12_SHADER_DESC shaderDesc = {};
+        _ThrowIfFailed(reflection->GetDesc(&shaderDesc));
+
+        for (UINT i = 0; i < shaderDesc.BoundResources; i++) {
+            D3D12_SHADER_INPUT_BIND_DESC bindDesc = {};
+            _ThrowIfFailed(reflection->GetResourceBindingDesc(i, &bindDesc));
+
+            Binding binding = {};
+            binding.name = bindDesc.Name;
+            binding.bindPoint = bindDesc.BindPoint;
+            binding.bindCount = bindDesc.BindCount;
+            binding.space = bindDesc.Space;
+            binding.stages = stage;
+            switch (bindDesc.Type) {
+            case D3D_SIT_CBUFFER: {
+                binding.rangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+                D3D12_SHADER_BUFFER_DESC bufferDesc = {};
+                _ThrowIfFailed(reflection->GetConstantBufferByName(bindDesc.Name)->GetDesc(&bufferDesc));
+                binding.size = bufferDesc.Size;
+                break;
+            }
+            case D3D_SIT_SAMPLER:
+                binding.rangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
+                break;
+            case D3D_SIT_UAV_RWTYPED:
+            case D3D_SIT_UAV_RWSTRUCTURED:
+            case D3D_SIT_UAV_RWBYTEADDRESS:
+            case D3D_SIT_UAV_APPEND_STRUCTURED:
+            case D3D_SIT_UAV_CONSUME_STRUCTURED:
+            case D3D_SIT_UAV_RWSTRUCTURED_WITH_COUNTER:
+                binding.rangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+                break;
+            default:
+                binding.rangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                break;
+            }
+
+            // The same binding seen from another stage widens its visibility.
+            bool merged = false;
+            for (Binding& existing : bindings) {
+                if (existing.rangeType == binding.rangeType && existing.bindPoint == binding.bindPoint && existing.space == binding.space) {
+                    existing.stages |= stage;
+                    existing.size = std::max(existing.size, binding.size);
+                    merged = true;
+                }
+            }
+            if (!merged) {
+                bindings.push_back(binding);
+            }
+        }
+
+        if (stage != shaderStageVertex) {
+            return;
+        }
+
+        // Vertex inputs, packed in declaration order; system values are not fetched.
+        mInputElements.clear();
+        mVertexStride = 0;
+        for (UINT i = 0; i < shaderDesc.InputParameters; i++) {
+            D3D12_SIGNATURE_PARAMETER_DESC parameterDesc = {};
+            _ThrowIfFailed(reflection->GetInputParameterDesc(i, &parameterDesc));
+            if (parameterDesc.SystemValueType != D3D_NAME_UNDEFINED) {
+                continue;
+            }
+
+            UINT components = 0;
+            for (BYTE mask = parameterDesc.Mask; mask != 0; mask >>= 1) {
+                components += mask & 1;
+            }
+            static const DXGI_FORMAT floatFormats[] = { DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT };
+            static const DXGI_FORMAT uintFormats[] = { DXGI_FORMAT_R32_UINT, DXGI_FORMAT_R32G32_UINT, DXGI_FORMAT_R32G32B32_UINT, DXGI_FORMAT_R32G32B32A32_UINT };
+            static const DXGI_FORMAT sintFormats[] = { DXGI_FORMAT_R32_SINT, DXGI_FORMAT_R32G32_SINT, DXGI_FORMAT_R32G32B32_SINT, DXGI_FORMAT_R32G32B32A32_SINT };
+
+            InputElement element;
+            element.semantic = parameterDesc.SemanticName;
+            element.semanticIndex = parameterDesc.SemanticIndex;
+            element.format = parameterDesc.ComponentType == D3D_REGISTER_COMPONENT_UINT32 ? uintFormats[components - 1]
+                : parameterDesc.ComponentType == D3D_REGISTER_COMPONENT_SINT32 ? sintFormats[components - 1]
+                : floatFormats[components - 1];
+            element.offset = mVertexStride;
+            mInputElements.push_back(element);
+            mVertexStride += components * 4;
+        }
+    }
+
+private:
+    D3D_ROOT_SIGNATURE_VERSION mRootSignatureVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    std::vector<UINT8> mRootSignature;
+    std::vector<Parameter> mParameters;
+    std::vector<TableEntry> mTable;
+    std::vector<InputElement> mInputElements;
+    UINT mVertexStride = 0;
+};
+
+// Compile flags shared by every shader of the sample; part of the cache key, so Debug and
+// Release builds never load each other's bytecode.
+UINT shaderCompileFlags() {
+    UINT compileFlags = 0;
+#if defined(_DEBUG)
+    compileFlags |= D3DCOMPILE_DEBUG;
+    compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+    return compileFlags;
+}
+
+// Resolves #include "..." against the shader directory and remembers each file it opened
+// with a hash of its contents, so the cache can tell when an include changed.
+class IncludeTracker : public ID3DInclude {
+public:
+    IncludeTracker(const std::string& directory) : mDirectory(directory) {}
+
+    HRESULT __stdcall Open(D3D_INCLUDE_TYPE type, LPCSTR fileName, LPCVOID parentData, LPCVOID* data, UINT* bytes) override {
+        std::string path = mDirectory + fileName;
+        std::string text;
+        if (!readTextFile(path, text)) {
+            return E_FAIL;
+        }
+        char* copy = new char[text.size()];
+        memcpy(copy, text.data(), text.size());
+        *data = copy;
+        *bytes = (UINT)text.size();
+        mIncludes.push_back({ path, hashBytes(text.data(), text.size()) });
+        return S_OK;
+    }
+
+    HRESULT __stdcall Close(LPCVOID data) override {
+        delete[] (const char*)data;
+        return S_OK;
+    }
+
+    const std::vector<std::pair<std::string, UINT64>>& includes() const { return mIncludes; }
+
+private:
+    std::string mDirectory;
+    std::vector<std::pair<std::string, UINT64>> mIncludes;
+};
+
+// Compiled shaders of one pipeline together with their reflected layout. The cache file
+// stores both, keyed by a hash of the source, compile flags, targets, entry points, root
+// signature version, static sampler template, root constant limit and cache version, plus
+// the hash of every included file. Any mismatch means a recompile; a warm start neither
+// compiles nor reflects.
+class ReflectedShaders {
+public:
+    bool loadCache(const std::string& path, UINT64 key) {
+        FILE* fd = NULL;
+        fopen_s(&fd, path.c_str(), "rb");
+        if (fd == NULL) {
+            return false;
+        }
+        char magic[4] = {};
+        UINT64 hash = 0;
+        UINT includeCount = 0;
+        bool ok = fread(magic, 4, 1, fd) == 1 && memcmp(magic, "RSC2", 4) == 0
+            && fread(&hash, sizeof(hash), 1, fd) == 1 && hash == key
+            && fread(&includeCount, sizeof(includeCount), 1, fd) == 1;
+        mIncludes.clear();
+        for (UINT i = 0; ok && i < includeCount; i++) {
+            std::string include;
+            std::string text;
+            ok = PipelineLayout::readString(fd, include) && fread(&hash, sizeof(hash), 1, fd) == 1
+                && readTextFile(include, text) && hashBytes(text.data(), text.size()) == hash;
+            mIncludes.push_back({ include, hash });
+        }
+        ok = ok && PipelineLayout::readBytes(fd, mVS) && PipelineLayout::readBytes(fd, mPS)
+            && mLayout.read(fd);
+        fclose(fd);
+        return ok;
+    }
+
+    bool saveCache(const std::string& path, UINT64 key) const {
+        FILE* fd = NULL;
+        fopen_s(&fd, path.c_str(), "wb");
+        if (fd == NULL) {
+            return false;
+        }
+        fwrite("RSC2", 4, 1, fd);
+        fwrite(&key, sizeof(key), 1, fd);
+        UINT includeCount = (UINT)mIncludes.size();
+        fwrite(&includeCount, sizeof(includeCount), 1, fd);
+        for (const std::pair<std::string, UINT64>& include : mIncludes) {
+            PipelineLayout::writeString(fd, include.first);
+            fwrite(&include.second, sizeof(include.second), 1, fd);
+        }
+        PipelineLayout::writeBytes(fd, mVS);
+        PipelineLayout::writeBytes(fd, mPS);
+        mLayout.write(fd);
+        bool ok = ferror(fd) == 0;
+        fclose(fd);
+        return ok;
+    }
+
+    void setBytecode(ID3DBlob* vs, ID3DBlob* ps) {
+        const UINT8* bytes = (const UINT8*)vs->GetBufferPointer();
+        mVS.assign(bytes, bytes + vs->GetBufferSize());
+        bytes = (const UINT8*)ps->GetBufferPointer();
+        mPS.assign(bytes, bytes + ps->GetBufferSize());
+    }
+
+    void setIncludes(const std::vector<std::pair<std::string, UINT64>>& includes) {
+        mIncludes = includes;
+    }
+
+    D3D12_SHADER_BYTECODE vs() const { return { mVS.data(), mVS.size() }; }
+    D3D12_SHADER_BYTECODE ps() const { return { mPS.data(), mPS.size() }; }
+    PipelineLayout& layout() { return mLayout; }
+
+private:
+    std::vector<UINT8> mVS;
+    std::vector<UINT8> mPS;
+    std::vector<std::pair<std::string, UINT64>> mIncludes;
+    PipelineLayout mLayout;
+};
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// Must match DrawConstants and PaletteConstants in 008-reflection.hlsl.
+struct DrawConstants {
+    XMFLOAT2 offset;
+    float scale;
+    float blend;
+};
+
+const UINT paletteSize = 16;
+
+struct PaletteConstants {
+    XMFLOAT4 colors[paletteSize];
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = textureCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Load Shaders and their Layout, compiling and reflecting when the cache is stale
+        {
+            const std::string shaderDirectory = "../shaders/";
+            const std::string shaderFile = shaderDirectory + "008-reflection.hlsl";
+            const std::string cacheFile = "008-reflection.cache";
+            std::string source;
+            if (!readTextFile(shaderFile, source)) {
+                throw std::exception("Open shader file failed.");
+            }
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_STATIC_SAMPLER_DESC sampler = {};
+            sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            sampler.MaxLOD = D3D12_FLOAT32_MAX;
+            sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            sampler.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+
+            // Everything that changes the compiled bytecode or the reflected layout goes into the key.
+            const char* stages[] = { "vs_5_0", "VSMain", "ps_5_0", "PSMain" };
+            const UINT compileFlags = shaderCompileFlags();
+            UINT64 key = hashBytes(&shaderCacheVersion, sizeof(shaderCacheVersion));
+            key = hashBytes(source.data(), source.size(), key);
+            key = hashBytes(&compileFlags, sizeof(compileFlags), key);
+            for (const char* stage : stages) {
+                key = hashBytes(stage, strlen(stage) + 1, key);
+            }
+            key = hashBytes(&featureData.HighestVersion, sizeof(featureData.HighestVersion), key);
+            key = hashBytes(&sampler, sizeof(sampler), key);
+            key = hashBytes(&maxRootConstantDWords, sizeof(maxRootConstantDWords), key);
+
+            double start = secondsNow();
+            bool cached = mShaders.loadCache(cacheFile, key);
+            if (!cached) {
+                IncludeTracker includes(shaderDirectory);
+                ComPtr<ID3DBlob> vsCode;
+                ComPtr<ID3DBlob> psCode;
+                this->compileShader(shaderFile, source, stages[0], stages[1], &includes, &vsCode);
+                this->compileShader(shaderFile, source, stages[2], stages[3], &includes, &psCode);
+                mShaders.setBytecode(vsCode.Get(), psCode.Get());
+                mShaders.setIncludes(includes.includes());
+                mShaders.layout().setRootSignatureVersion(featureData.HighestVersion);
+                mShaders.layout().reflect(mShaders.vs(), mShaders.ps(), sampler);
+
+                if (!mShaders.saveCache(cacheFile, key)) {
+                    debugLog("Writing %s failed\n", cacheFile.c_str());
+                }
+            }
+
+            const PipelineLayout& layout = mShaders.layout();
+            debugLog("Pipeline layout %s in %.2f ms: %u root parameters, %u DWORDs, %u table descriptors, %u byte vertices\n",
+                cached ? "loaded from cache" : "reflected", (secondsNow() - start) * 1000.0,
+                layout.parameterCount(), layout.rootSignatureDWords(), layout.tableSize(), layout.vertexStride());
+            if (layout.vertexStride() != sizeof(Vertex)) {
+                throw std::exception("The vertex shader inputs do not match struct Vertex.");
+            }
+        }
+
+        // Create Root Signature
+        {
+            const std::vector<UINT8>& rootSignature = mShaders.layout().rootSignature();
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignature.data(), rootSignature.size(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Create Pipeline State
+        {
+            std::vector<D3D12_INPUT_ELEMENT_DESC> inputElementDescs = mShaders.layout().inputLayout();
+
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs.data();
+            psoDesc.InputLayout.NumElements = (UINT)inputElementDescs.size();
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = mShaders.vs();
+            psoDesc.PS = mShaders.ps();
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+        // Root parameter indices come from the layout, not from hand-written constants
+        mDrawConstantsParameter = mShaders.layout().parameterIndex("DrawConstants");
+        mPaletteParameter = mShaders.layout().parameterIndex("PaletteConstants");
+        mTableParameter = mShaders.layout().tableParameterIndex();
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            float aspect = windowWidth / (windowHeight + 0.0f);
+            Vertex triangleVertices[] = {
+                { { -0.25f, 0.25f * aspect, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f }, {0.0f, 1.0f} },
+                { { 0.25f, 0.25f * aspect, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f }, {1.0f, 1.0f} },
+                { { 0.25f, -0.25f * aspect, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { -0.25f, -0.25f * aspect, 0.0f }, { 1.0f, 1.0f, 0.0f, 1.0f }, {0.0f, 0.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Create Palette Constant Buffer
+        {
+            PaletteConstants palette = {};
+            for (UINT i = 0; i < paletteSize; i++) {
+                float t = i / (float)(paletteSize - 1);
+                palette.colors[i] = XMFLOAT4(1.0f - t * 0.5f, 0.5f + t * 0.5f, 0.25f + t * 0.75f, 1.0f);
+            }
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC cbDesc = {};
+            cbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            cbDesc.Width = (sizeof(PaletteConstants) + 255) & ~255;
+            cbDesc.Height = 1;
+            cbDesc.DepthOrArraySize = 1;
+            cbDesc.MipLevels = 1;
+            cbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            cbDesc.SampleDesc.Count = 1;
+            cbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &cbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mPaletteBuffer)));
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mPaletteBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, &palette, sizeof(palette));
+            mPaletteBuffer->Unmap(0, nullptr);
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0x00;    // R
+                        pData[n + 1] = 0x00;    // G
+                        pData[n + 2] = 0x00;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            // Each texture goes to the table slot reflection assigned; unused ones are skipped.
+            int checkerOffset = mShaders.layout().tableOffset("gCheckerTexture");
+            if (checkerOffset >= 0) {
+                this->createTextureFromData(
+                    mDevice.Get(), mCommandList.Get(),
+                    image, width, height, format,
+                    mTextureResources[0], mTextureBuffers[0], checkerOffset);
+            }
+
+            for (UINT y = 0; y < height; y++) {
+                for (UINT x = 0; x < width; x++) {
+                    UINT8* texel = &image[(y * width + x) * 4];
+                    texel[0] = (UINT8)(x * 255 / (width - 1));
+                    texel[1] = (UINT8)(y * 255 / (height - 1));
+                    texel[2] = 0x80;
+                    texel[3] = 0xff;
+                }
+            }
+
+            int gradientOffset = mShaders.layout().tableOffset("gGradientTexture");
+            if (gradientOffset >= 0) {
+                this->createTextureFromData(
+                    mDevice.Get(), mCommandList.Get(),
+                    image, width, height, format,
+                    mTextureResources[1], mTextureBuffers[1], gradientOffset);
+            }
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(mTableParameter, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+        mCommandList->SetGraphicsRootConstantBufferView(mPaletteParameter, mPaletteBuffer->GetGPUVirtualAddress());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+
+        const DrawConstants draws[] = {
+            { XMFLOAT2(-0.55f, 0.0f), 0.8f, 0.0f },
+            { XMFLOAT2(0.0f, 0.0f), 0.8f, 0.5f },
+            { XMFLOAT2(0.55f, 0.0f), 0.8f, 1.0f },
+        };
+        for (const DrawConstants& draw : draws) {
+            mCommandList->SetGraphicsRoot32BitConstants(mDrawConstantsParameter, sizeof(DrawConstants) / 4, &draw, 0);
+            mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+        }
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DInclude* includes, ID3DBlob** code) {
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, includes, entry, target, shaderCompileFlags(), 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer,
+        UINT descriptorIndex)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = mSRVHeap->GetCPUDescriptorHandleForHeapStart();
+        srvHandle.ptr += descriptorIndex * mSRVHeapStride;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, srvHandle);
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResources[textureCount];
+    ComPtr<ID3D12Resource> mTextureBuffers[textureCount];
+    ComPtr<ID3D12Resource> mPaletteBuffer;
+
+    ReflectedShaders mShaders;
+    UINT mDrawConstantsParameter = 0;
+    UINT mPaletteParameter = 0;
+    UINT mTableParameter = 0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+        UNREFERENCED_PARAMETER(lpCmdLine);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
@@ -0,0 +1,1197 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <timeapi.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+#pragma comment(lib, "winmm.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <random>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0010-FrameClock";
+const char* windowClass = "0010-FrameClock";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024] = { 0 };
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Where FrameClock gets time from and how it waits. Injected so the timing logic can be
+// driven by a scripted clock instead of the wall clock.
+class TimeSource {
+public:
+    virtual ~TimeSource() {}
+    virtual double now() = 0;
+    virtual void sleepUntil(double time) = 0;
+};
+
+// QueryPerformanceCounter for time; waits block on a high resolution waitable timer, or a
+// regular one with 1 ms scheduler granularity where that is not available, never spinning.
+class SystemTimeSource : public TimeSource {
+public:
+    SystemTimeSource() {
+        mTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (mTimer == nullptr) {
+            timeBeginPeriod(1);
+            mCoarse = true;
+            mTimer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        }
+    }
+
+    ~SystemTimeSource() {
+        if (mTimer != nullptr) {
+            CloseHandle(mTimer);
+        }
+        if (mCoarse) {
+            timeEndPeriod(1);
+        }
+    }
+
+    double now() override {
+        return secondsNow();
+    }
+
+    void sleepUntil(double time) override {
+        double remaining = time - secondsNow();
+        if (remaining <= 0.0 || mTimer == nullptr) {
+            return;
+        }
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)(remaining * 1e7); // Relative, in 100 ns units
+        if (SetWaitableTimer(mTimer, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(mTimer, INFINITE);
+        }
+    }
+
+private:
+    HANDLE mTimer = nullptr;
+    bool mCoarse = false;
+};
+
+// Scripted time: sleeping jumps straight to the deadline.
+class ManualTimeSource : public TimeSource {
+public:
+    double now() override {
+        return mTime;
+    }
+
+    void sleepUntil(double time) override {
+        if (time > mTime) {
+            mSlept += time - mTime;
+            mTime = time;
+        }
+    }
+
+    void advance(double seconds) { mTime += seconds; }
+    double slept() const { return mSlept; }
+
+private:
+    double mTime = 0.0;
+    double mSlept = 0.0;
+};
+
+// Frame timing for a fixed-step simulation rendered at a variable rate.
+//
+//   clock.beginFrame();
+//   while (clock.step()) update(clock.fixedStep());
+//   render(clock.alpha());
+//   clock.endFrame();
+//
+// Frame deltas are clamped so a long stall does not trigger a burst of catch-up steps, and
+// averaged over a few frames for anything that wants a steady delta. With a frame-rate
+// cap endFrame() sleeps until the next deadline; deadlines advance by whole periods so the
+// average rate does not drift.
+class FrameClock {
+public:
+    FrameClock(TimeSource& source, double fixedStep = 1.0 / 60.0, double maxDelta = 0.25)
+        : mSource(source), mFixedStep(fixedStep), mMaxDelta(maxDelta)
+    {
+        mLastFrame = mSource.now();
+        mNextDeadline = mLastFrame;
+    }
+
+    // 0 disables the cap.
+    void setFrameRateCap(double framesPerSecond) {
+        mCapPeriod = framesPerSecond > 0.0 ? 1.0 / framesPerSecond : 0.0;
+        mNextDeadline = mSource.now() + mCapPeriod;
+    }
+
+    void beginFrame() {
+        double time = mSource.now();
+        mDelta = std::min(time - mLastFrame, mMaxDelta);
+        mLastFrame = time;
+
+        mHistory[mFrameIndex % smoothingFrames] = mDelta;
+        mFrameIndex++;
+        UINT samples = (UINT)std::min<UINT64>(mFrameIndex, smoothingFrames);
+        double sum = 0.0;
+        for (UINT i = 0; i < samples; i++) {
+            sum += mHistory[i];
+        }
+        mSmoothedDelta = sum / samples;
+
+        mAccumulator += mDelta;
+    }
+
+    // Call after an idle pause so the time spent waiting is not simulated.
+    void resume() {
+        mLastFrame = mSource.now();
+        mNextDeadline = mLastFrame + mCapPeriod;
+    }
+
+    // True while another fixed step is due this frame.
+    bool step() {
+        if (mAccumulator < mFixedStep) {
+            return false;
+        }
+        mAccumulator -= mFixedStep;
+        mSimulationTime += mFixedStep;
+        mStepCount++;
+        return true;
+    }
+
+    void endFrame() {
+        if (mCapPeriod <= 0.0) {
+            return;
+        }
+        double time = mSource.now();
+        if (time > mNextDeadline + mCapPeriod) {
+            mNextDeadline = time; // Fell more than a frame behind; do not try to catch up.
+        } else {
+            mSource.sleepUntil(mNextDeadline);
+        }
+        mNextDeadline += mCapPeriod;
+    }
+
+    // How far the render time is between the last two simulation states, in [0, 1).
+    double alpha() const { return mAccumulator / mFixedStep; }
+
+    double fixedStep() const { return mFixedStep; }
+    double maxDelta() const { return mMaxDelta; }
+    double delta() const { return mDelta; }
+    double smoothedDelta() const { return mSmoothedDelta; }
+    double simulationTime() const { return mSimulationTime; }
+    UINT64 frameIndex() const { return mFrameIndex; }
+    UINT64 stepCount() const { return mStepCount; }
+
+private:
+    static const UINT smoothingFrames = 8;
+
+    TimeSource& mSource;
+    double mFixedStep;
+    double mMaxDelta;
+    double mCapPeriod = 0.0;
+    double mLastFrame = 0.0;
+    double mNextDeadline = 0.0;
+    double mDelta = 0.0;
+    double mSmoothedDelta = 0.0;
+    double mAccumulator = 0.0;
+    double mSimulationTime = 0.0;
+    double mHistory[smoothingFrames] = {};
+    UINT64 mFrameIndex = 0;
+    UINT64 mStepCount = 0;
+};
+
+// Runs FrameClock on a scripted clock: frames with jittered work, a few short stalls, one
+// stall longer than the delta clamp, and a 60 fps cap. Checks that simulation time tracks
+// the unclamped elapsed time, that the cap holds, and that stalls do not cause step bursts.
+bool simulateFrameClock(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+
+    ManualTimeSource source;
+    FrameClock clock(source, 1.0 / 120.0);
+    const double capPeriod = 1.0 / 60.0;
+    clock.setFrameRateCap(60.0);
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> work(0.002, 0.014);
+    const UINT frameCount = 6000;
+    const UINT longStallFrame = 3500;
+    const UINT maxStepsPerFrame = (UINT)ceil(clock.maxDelta() / clock.fixedStep());
+    UINT stalls = 0;
+    UINT maxSteps = 0;
+    UINT maxStepsAfterStall = 0;
+    UINT lastStall = 0;
+    double maxDrift = 0.0;
+    double dropped = 0.0;
+    double minFrame = 1e9;
+    double maxFrame = 0.0;
+    double lastBegin = 0.0;
+
+    for (UINT frame = 0; frame < frameCount; frame++) {
+        clock.beginFrame();
+        if (frame > 0) {
+            double frameTime = source.now() - lastBegin;
+            minFrame = std::min(minFrame, frameTime);
+            maxFrame = std::max(maxFrame, frameTime);
+            dropped += frameTime - clock.delta();
+        }
+        lastBegin = source.now();
+
+        UINT steps = 0;
+        while (clock.step()) {
+            steps++;
+        }
+        maxSteps = std::max(maxSteps, steps);
+        if (stalls > 0 && frame > lastStall + 1 && frame <= lastStall + 4) {
+            maxStepsAfterStall = std::max(maxStepsAfterStall, steps);
+        }
+
+        // Simulation time plus the interpolation fraction should track elapsed time, less
+        // whatever the delta clamp dropped.
+        double rendered = clock.simulationTime() + clock.alpha() * clock.fixedStep();
+        maxDrift = std::max(maxDrift, fabs(rendered - (source.now() - dropped)));
+
+        source.advance(work(random));
+        if (frame % 1000 == 500 || frame == longStallFrame) {
+            source.advance(frame == longStallFrame ? 1.0 : 0.1); // Stalls longer than a frame
+            stalls++;
+            lastStall = frame;
+        }
+        clock.endFrame();
+    }
+
+    char summary[512];
+    snprintf(summary, sizeof(summary),
+        "Frame clock simulation: %u frames, %u fixed steps of %.2f ms, %u stalls\n"
+        "Frame time %.2f .. %.2f ms, %.1f fps average, up to %u steps per frame\n"
+        "Simulation drift %.3f ms, %.1f s slept instead of spinning\n",
+        frameCount, (UINT)clock.stepCount(), clock.fixedStep() * 1000.0, stalls,
+        minFrame * 1000.0, maxFrame * 1000.0, frameCount / source.now(), maxSteps,
+        maxDrift * 1000.0, source.slept());
+    report += summary;
+
+    check(maxDrift <= clock.fixedStep(), "simulation time stays within one fixed step of elapsed time");
+    check(minFrame >= capPeriod - 1e-9, "the 60 fps cap never lets a frame run short");
+    check(fabs(dropped - (1.0 - clock.maxDelta())) < 0.02, "only the long stall is clamped away");
+    check(maxSteps <= maxStepsPerFrame, "steps per frame are bounded by the delta clamp");
+    check(maxStepsAfterStall <= 3, "frames after a stall go back to a couple of steps");
+    return passed;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    // One fixed simulation step: the quad bounces between the window edges.
+    void update(double step) {
+        mPreviousPosition = mPosition;
+        mPosition.x += mVelocity.x * (float)step;
+        mPosition.y += mVelocity.y * (float)step;
+        if (fabsf(mPosition.x) > 0.75f) {
+            mVelocity.x = -mVelocity.x;
+            mPosition.x = mPosition.x > 0.0f ? 0.75f : -0.75f;
+        }
+        if (fabsf(mPosition.y) > 0.6f) {
+            mVelocity.y = -mVelocity.y;
+            mPosition.y = mPosition.y > 0.0f ? 0.6f : -0.6f;
+        }
+    }
+
+    // Renders the state alpha of the way from the previous simulation step to the current one.
+    void tick(float alpha) {
+        mRenderPosition.x = mPreviousPosition.x + (mPosition.x - mPreviousPosition.x) * alpha;
+        mRenderPosition.y = mPreviousPosition.y + (mPosition.y - mPreviousPosition.y) * alpha;
+
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 2;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 2;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/009-frame-clock.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/009-frame-clock.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            float aspect = windowWidth / (windowHeight + 0.0f);
+            Vertex triangleVertices[] = {
+                { { -0.25f, 0.25f * aspect, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f }, {0.0f, 1.0f} },
+                { { 0.25f, 0.25f * aspect, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f }, {1.0f, 1.0f} },
+                { { 0.25f, -0.25f * aspect, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { -0.25f, -0.25f * aspect, 0.0f }, { 1.0f, 1.0f, 0.0f, 1.0f }, {0.0f, 0.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0x00;    // R
+                        pData[n + 1] = 0x00;    // G
+                        pData[n + 2] = 0x00;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+        mCommandList->SetGraphicsRoot32BitConstants(1, 2, &mRenderPosition, 0);
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+
+    XMFLOAT2 mPosition = XMFLOAT2(0.0f, 0.0f);
+    XMFLOAT2 mPreviousPosition = XMFLOAT2(0.0f, 0.0f);
+    XMFLOAT2 mVelocity = XMFLOAT2(0.9f, 0.55f);
+    XMFLOAT2 mRenderPosition = XMFLOAT2(0.0f, 0.0f);
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateFrameClock(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        // -fps=N caps the frame rate below the display refresh rate.
+        SystemTimeSource timeSource;
+        FrameClock clock(timeSource);
+        const char* cap = strstr(lpCmdLine, "-fps=");
+        if (cap != nullptr) {
+            clock.setFrameRateCap(atof(cap + 5));
+        }
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            // Drain the pending messages, then render one frame.
+            while (msg.message != WM_QUIT && PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            if (msg.message == WM_QUIT)
+            {
+                break;
+            }
+
+            // Nothing to show while minimized: block until a message arrives.
+            if (IsIconic(hWnd))
+            {
+                WaitMessage();
+                clock.resume();
+                continue;
+            }
+
+            clock.beginFrame();
+            while (clock.step())
+            {
+                graphics.update(clock.fixedStep());
+            }
+            graphics.tick((float)clock.alpha());
+            clock.endFrame();
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
@@ -0,0 +1,1461 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <random>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0012-TextureAtlas";
+const char* windowClass = "0012-TextureAtlas";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024] = { 0 };
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+struct AtlasRect {
+    UINT x;
+    UINT y;
+    UINT width;
+    UINT height;
+};
+
+// Skyline bottom-left packer: the packed area is described by its top edge, a list of
+// horizontal segments. A rect goes where its top ends lowest, ties broken by the narrower
+// segment. Fast and compact for rects of similar height.
+class SkylinePacker {
+public:
+    void init(UINT width, UINT height) {
+        mWidth = width;
+        mHeight = height;
+        mUsedArea = 0;
+        mSkyline.clear();
+        mSkyline.push_back({ 0, 0, width });
+    }
+
+    bool insert(UINT width, UINT height, AtlasRect& rect) {
+        UINT bestIndex = UINT_MAX;
+        UINT bestTop = UINT_MAX;
+        UINT bestSegmentWidth = UINT_MAX;
+        UINT bestY = 0;
+        for (UINT i = 0; i < mSkyline.size(); i++) {
+            UINT y = 0;
+            if (!this->fits(i, width, height, y)) {
+                continue;
+            }
+            if (y + height < bestTop || (y + height == bestTop && mSkyline[i].width < bestSegmentWidth)) {
+                bestIndex = i;
+                bestTop = y + height;
+                bestSegmentWidth = mSkyline[i].width;
+                bestY = y;
+            }
+        }
+        if (bestIndex == UINT_MAX) {
+            return false;
+        }
+
+        rect = { mSkyline[bestIndex].x, bestY, width, height };
+        this->addSegment(bestIndex, rect);
+        mUsedArea += (UINT64)width * height;
+        return true;
+    }
+
+    double occupancy() const {
+        return mUsedArea / ((double)mWidth * mHeight);
+    }
+
+private:
+    struct Segment {
+        UINT x;
+        UINT y;
+        UINT width;
+    };
+
+    // Lowest y at which a rect starting at segment index fits on top of the skyline.
+    bool fits(UINT index, UINT width, UINT height, UINT& y) const {
+        UINT x = mSkyline[index].x;
+        if (x + width > mWidth) {
+            return false;
+        }
+        y = 0;
+        UINT remaining = width;
+        for (UINT i = index; remaining > 0; i++) {
+            y = std::max(y, mSkyline[i].y);
+            if (y + height > mHeight) {
+                return false;
+            }
+            remaining -= std::min(remaining, mSkyline[i].width);
+        }
+        return true;
+    }
+
+    void addSegment(UINT index, const AtlasRect& rect) {
+        mSkyline.insert(mSkyline.begin() + index, { rect.x, rect.y + rect.height, rect.width });
+
+        // Trim or drop the segments now covered by the new one.
+        UINT right = rect.x + rect.width;
+        for (UINT i = index + 1; i < mSkyline.size(); ) {
+            Segment& segment = mSkyline[i];
+            if (segment.x >= right) {
+                break;
+            }
+            UINT segmentRight = segment.x + segment.width;
+            if (segmentRight <= right) {
+                mSkyline.erase(mSkyline.begin() + i);
+                continue;
+            }
+            segment.width = segmentRight - right;
+            segment.x = right;
+            break;
+        }
+
+        // Merge neighbours at the same height.
+        for (UINT i = 0; i + 1 < mSkyline.size(); ) {
+            if (mSkyline[i].y == mSkyline[i + 1].y) {
+                mSkyline[i].width += mSkyline[i + 1].width;
+                mSkyline.erase(mSkyline.begin() + i + 1);
+            } else {
+                i++;
+            }
+        }
+    }
+
+private:
+    UINT mWidth = 0;
+    UINT mHeight = 0;
+    UINT64 mUsedArea = 0;
+    std::vector<Segment> mSkyline;
+};
+
+// MaxRects packer with the best-short-side-fit heuristic: keeps every maximal free
+// rectangle, places a rect in the one leaving the smallest leftover side, then splits the
+// free rectangles it overlaps. Only the newly split pieces are checked for containment,
+// which keeps pruning from going quadratic in the free list.
+class MaxRectsPacker {
+public:
+    void init(UINT width, UINT height) {
+        mWidth = width;
+        mHeight = height;
+        mUsedArea = 0;
+        mFree.clear();
+        mFree.push_back({ 0, 0, width, height });
+    }
+
+    // Score of the best placement, lower is better; UINT64_MAX when the rect does not fit.
+    UINT64 score(UINT width, UINT height, AtlasRect& rect) const {
+        UINT64 best = UINT64_MAX;
+        for (const AtlasRect& free : mFree) {
+            if (width > free.width || height > free.height) {
+                continue;
+            }
+            UINT leftoverX = free.width - width;
+            UINT leftoverY = free.height - height;
+            UINT64 value = ((UINT64)std::min(leftoverX, leftoverY) << 32) | std::max(leftoverX, leftoverY);
+            if (value < best) {
+                best = value;
+                rect = { free.x, free.y, width, height };
+            }
+        }
+        return best;
+    }
+
+    void place(const AtlasRect& rect) {
+        std::vector<AtlasRect> pieces;
+        for (size_t i = mFree.size(); i-- > 0; ) {
+            if (split(mFree[i], rect, pieces)) {
+                mFree[i] = mFree.back();
+                mFree.pop_back();
+            }
+        }
+
+        for (size_t i = 0; i < pieces.size(); i++) {
+            bool contained = false;
+            for (const AtlasRect& free : mFree) {
+                if (contains(free, pieces[i])) {
+                    contained = true;
+                    break;
+                }
+            }
+            for (size_t j = 0; j < pieces.size() && !contained; j++) {
+                // Of two identical pieces keep the first.
+                if (i != j && contains(pieces[j], pieces[i]) && (!contains(pieces[i], pieces[j]) || j < i)) {
+                    contained = true;
+                }
+            }
+            if (!contained) {
+                mFree.push_back(pieces[i]);
+            }
+        }
+        mUsedArea += (UINT64)rect.width * rect.height;
+    }
+
+    bool insert(UINT width, UINT height, AtlasRect& rect) {
+        if (this->score(width, height, rect) == UINT64_MAX) {
+            return false;
+        }
+        this->place(rect);
+        return true;
+    }
+
+    double occupancy() const {
+        return mUsedArea / ((double)mWidth * mHeight);
+    }
+
+private:
+    static bool contains(const AtlasRect& outer, const AtlasRect& inner) {
+        return inner.x >= outer.x && inner.y >= outer.y
+            && inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+    }
+
+    // Splits free around used; returns false when they do not overlap.
+    static bool split(const AtlasRect& free, const AtlasRect& used, std::vector<AtlasRect>& pieces) {
+        if (used.x >= free.x + free.width || used.x + used.width <= free.x
+            || used.y >= free.y + free.height || used.y + used.height <= free.y) {
+            return false;
+        }
+        if (used.x > free.x) {
+            pieces.push_back({ free.x, free.y, used.x - free.x, free.height });
+        }
+        if (used.x + used.width < free.x + free.width) {
+            pieces.push_back({ used.x + used.width, free.y, free.x + free.width - (used.x + used.width), free.height });
+        }
+        if (used.y > free.y) {
+            pieces.push_back({ free.x, free.y, free.width, used.y - free.y });
+        }
+        if (used.y + used.height < free.y + free.height) {
+            pieces.push_back({ free.x, used.y + used.height, free.width, free.y + free.height - (used.y + used.height) });
+        }
+        return true;
+    }
+
+private:
+    UINT mWidth = 0;
+    UINT mHeight = 0;
+    UINT64 mUsedArea = 0;
+    std::vector<AtlasRect> mFree;
+};
+
+enum AtlasHeuristic {
+    AtlasSkyline = 0,
+    AtlasMaxRects,
+};
+
+struct AtlasSettings {
+    UINT pageSize = 2048;
+    UINT gutter = 2;       // Pixels of edge extrusion around every image at mip 0
+    UINT mipLevels = 1;    // Rects are aligned so mips up to this level stay separate
+    AtlasHeuristic heuristic = AtlasMaxRects;
+};
+
+struct AtlasImage {
+    UINT width;
+    UINT height;
+    std::vector<UINT8> pixels; // RGBA8
+};
+
+// Where an image ended up. Sampling the page at uv * scale + offset reads the image at uv.
+struct AtlasEntry {
+    UINT page;
+    AtlasRect rect;
+    AtlasRect slot;         // The aligned cell around rect, gutter and padding included
+    XMFLOAT4 uvScaleOffset;
+};
+
+struct AtlasPage {
+    std::vector<std::vector<UINT8>> mips; // RGBA8, pageSize >> level square
+};
+
+struct AtlasStats {
+    UINT images = 0;
+    UINT pages = 0;
+    double packSeconds = 0.0;
+    double imageArea = 0.0;     // Image pixels over page pixels
+    double paddedArea = 0.0;    // Including gutters and alignment
+};
+
+// Packs many small images into a few large pages. Images are sorted largest first and
+// placed in the open page where they score best, opening a page when none fits. Each image
+// is surrounded by an extruded gutter and its slot aligned to 2^(mipLevels-1) pixels, so
+// neither bilinear filtering nor the generated mips bleed between neighbours.
+class TextureAtlasBuilder {
+public:
+    TextureAtlasBuilder(const AtlasSettings& settings) : mSettings(settings) {}
+
+    // Places the rects only; the entries index the sizes in input order.
+    AtlasStats pack(const std::vector<std::pair<UINT, UINT>>& sizes, std::vector<AtlasEntry>& entries) {
+        AtlasStats stats;
+        double start = secondsNow();
+
+        const UINT alignment = 1U << (mSettings.mipLevels - 1);
+        const UINT pageSize = mSettings.pageSize;
+        std::vector<UINT> order(sizes.size());
+        for (UINT i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](UINT a, UINT b) {
+            UINT sideA = std::max(sizes[a].first, sizes[a].second);
+            UINT sideB = std::max(sizes[b].first, sizes[b].second);
+            return sideA != sideB ? sideA > sideB : sizes[a].first * sizes[a].second > sizes[b].first * sizes[b].second;
+        });
+
+        std::vector<SkylinePacker> skylines;
+        std::vector<MaxRectsPacker> maxRects;
+        entries.assign(sizes.size(), AtlasEntry());
+        UINT64 paddedPixels = 0;
+        UINT64 imagePixels = 0;
+        for (UINT index : order) {
+            UINT width = alignUp(sizes[index].first + 2 * mSettings.gutter, alignment);
+            UINT height = alignUp(sizes[index].second + 2 * mSettings.gutter, alignment);
+            if (width > pageSize || height > pageSize) {
+                throw std::exception("An image does not fit into an atlas page.");
+            }
+
+            AtlasRect slot = {};
+            UINT page = UINT_MAX;
+            if (mSettings.heuristic == AtlasSkyline) {
+                for (UINT p = 0; p < skylines.size() && page == UINT_MAX; p++) {
+                    if (skylines[p].insert(width, height, slot)) {
+                        page = p;
+                    }
+                }
+                if (page == UINT_MAX) {
+                    skylines.push_back(SkylinePacker());
+                    skylines.back().init(pageSize, pageSize);
+                    skylines.back().insert(width, height, slot);
+                    page = (UINT)skylines.size() - 1;
+                }
+            } else {
+                UINT64 bestScore = UINT64_MAX;
+                for (UINT p = 0; p < maxRects.size(); p++) {
+                    AtlasRect candidate;
+                    UINT64 score = maxRects[p].score(width, height, candidate);
+                    if (score < bestScore) {
+                        bestScore = score;
+                        slot = candidate;
+                        page = p;
+                    }
+                }
+                if (page == UINT_MAX) {
+                    maxRects.push_back(MaxRectsPacker());
+                    maxRects.back().init(pageSize, pageSize);
+                    page = (UINT)maxRects.size() - 1;
+                    maxRects[page].score(width, height, slot);
+                }
+                maxRects[page].place(slot);
+            }
+
+            AtlasEntry& entry = entries[index];
+            entry.page = page;
+            entry.rect = { slot.x + mSettings.gutter, slot.y + mSettings.gutter, sizes[index].first, sizes[index].second };
+            entry.slot = { slot.x, slot.y, width, height };
+            entry.uvScaleOffset = XMFLOAT4(
+                entry.rect.width / (float)pageSize, entry.rect.height / (float)pageSize,
+                entry.rect.x / (float)pageSize, entry.rect.y / (float)pageSize);
+            paddedPixels += (UINT64)width * height;
+            imagePixels += (UINT64)sizes[index].first * sizes[index].second;
+        }
+
+        stats.images = (UINT)sizes.size();
+        stats.pages = (UINT)std::max(skylines.size(), maxRects.size());
+        stats.packSeconds = secondsNow() - start;
+        double pagePixels = (double)stats.pages * pageSize * pageSize;
+        stats.imageArea = stats.pages > 0 ? imagePixels / pagePixels : 0.0;
+        stats.paddedArea = stats.pages > 0 ? paddedPixels / pagePixels : 0.0;
+        return stats;
+    }
+
+    // Packs the images and composes the pages, gutters and mips included.
+    AtlasStats build(const std::vector<AtlasImage>& images, std::vector<AtlasEntry>& entries, std::vector<AtlasPage>& pages) {
+        std::vector<std::pair<UINT, UINT>> sizes;
+        for (const AtlasImage& image : images) {
+            sizes.push_back({ image.width, image.height });
+        }
+        AtlasStats stats = this->pack(sizes, entries);
+
+        const UINT pageSize = mSettings.pageSize;
+        pages.assign(stats.pages, AtlasPage());
+        for (AtlasPage& page : pages) {
+            page.mips.resize(mSettings.mipLevels);
+            page.mips[0].assign((size_t)pageSize * pageSize * 4, 0);
+        }
+
+        // Copy each image with its edge pixels extruded over the whole slot, gutter and
+        // alignment padding alike, so no mip level averages in texels from outside the image.
+        for (UINT i = 0; i < images.size(); i++) {
+            const AtlasImage& image = images[i];
+            const AtlasEntry& entry = entries[i];
+            UINT8* page = pages[entry.page].mips[0].data();
+            for (UINT y = entry.slot.y; y < entry.slot.y + entry.slot.height; y++) {
+                int sourceY = std::min(std::max((int)y - (int)entry.rect.y, 0), (int)image.height - 1);
+                for (UINT x = entry.slot.x; x < entry.slot.x + entry.slot.width; x++) {
+                    int sourceX = std::min(std::max((int)x - (int)entry.rect.x, 0), (int)image.width - 1);
+                    memcpy(page + (((size_t)y * pageSize + x) * 4),
+                        &image.pixels[((size_t)sourceY * image.width + sourceX) * 4], 4);
+                }
+            }
+        }
+
+        // Box-filtered mips; the slot alignment keeps every 2x2 footprint inside one slot.
+        for (AtlasPage& page : pages) {
+            for (UINT level = 1; level < mSettings.mipLevels; level++) {
+                UINT size = pageSize >> level;
+                const std::vector<UINT8>& source = page.mips[level - 1];
+                std::vector<UINT8>& target = page.mips[level];
+                target.resize((size_t)size * size * 4);
+                for (UINT y = 0; y < size; y++) {
+                    for (UINT x = 0; x < size; x++) {
+                        for (UINT c = 0; c < 4; c++) {
+                            UINT sum = source[(((size_t)y * 2) * size * 2 + x * 2) * 4 + c]
+                                + source[(((size_t)y * 2) * size * 2 + x * 2 + 1) * 4 + c]
+                                + source[(((size_t)y * 2 + 1) * size * 2 + x * 2) * 4 + c]
+                                + source[(((size_t)y * 2 + 1) * size * 2 + x * 2 + 1) * 4 + c];
+                            target[((size_t)y * size + x) * 4 + c] = (UINT8)((sum + 2) / 4);
+                        }
+                    }
+                }
+            }
+        }
+        return stats;
+    }
+
+private:
+    static UINT alignUp(UINT value, UINT alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+private:
+    AtlasSettings mSettings;
+};
+
+// Packs 10k random rects between 8 and 128 pixels with both heuristics.
+std::string benchmarkAtlasPacking() {
+    std::mt19937 random(11);
+    std::uniform_int_distribution<UINT> side(8, 128);
+    std::vector<std::pair<UINT, UINT>> sizes(10000);
+    for (auto& size : sizes) {
+        size.first = side(random);
+        size.second = side(random);
+    }
+
+    std::string report = "Atlas packing, 10000 rects of 8..128 px into 2048 px pages\n";
+    const AtlasHeuristic heuristics[] = { AtlasSkyline, AtlasMaxRects };
+    const char* names[] = { "Skyline", "MaxRects" };
+    const UINT mipLevels[] = { 1, 4 };
+    for (UINT h = 0; h < _countof(heuristics); h++) {
+        for (UINT m = 0; m < _countof(mipLevels); m++) {
+            AtlasSettings settings;
+            settings.heuristic = heuristics[h];
+            settings.mipLevels = mipLevels[m];
+            TextureAtlasBuilder builder(settings);
+            std::vector<AtlasEntry> entries;
+            AtlasStats stats = builder.pack(sizes, entries);
+
+            char line[256];
+            snprintf(line, sizeof(line), "%-8s %u mips: %u pages, %.1f%% image / %.1f%% padded occupancy, %.1f ms\n",
+                names[h], mipLevels[m], stats.pages, stats.imageArea * 100.0, stats.paddedArea * 100.0, stats.packSeconds * 1000.0);
+            report += line;
+        }
+    }
+    return report;
+}
+
+// Builds a mipped atlas from solid sprites of awkward sizes packed next to each other and
+// checks that every texel a sprite covers, at every mip, still has the sprite's colour.
+// Padding or neighbours leaking into the box filter would show up at the edges first.
+bool simulateTextureAtlas(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+
+    std::mt19937 random(5);
+    std::uniform_int_distribution<UINT> side(1, 37);
+    std::vector<AtlasImage> images(200);
+    for (UINT i = 0; i < images.size(); i++) {
+        AtlasImage& image = images[i];
+        image.width = side(random);
+        image.height = side(random);
+        image.pixels.resize((size_t)image.width * image.height * 4);
+        for (size_t t = 0; t < image.pixels.size(); t += 4) {
+            image.pixels[t + 0] = (UINT8)(40 + i);
+            image.pixels[t + 1] = (UINT8)(255 - i);
+            image.pixels[t + 2] = (UINT8)(i * 7);
+            image.pixels[t + 3] = 0xff;
+        }
+    }
+
+    const AtlasHeuristic heuristics[] = { AtlasSkyline, AtlasMaxRects };
+    const char* names[] = { "skyline", "maxrects" };
+    for (UINT h = 0; h < _countof(heuristics); h++) {
+        AtlasSettings settings;
+        settings.pageSize = 512;
+        settings.mipLevels = 4;
+        settings.heuristic = heuristics[h];
+        TextureAtlasBuilder builder(settings);
+        std::vector<AtlasEntry> entries;
+        std::vector<AtlasPage> pages;
+        builder.build(images, entries, pages);
+
+        UINT bleeding = 0;
+        UINT lastMipBleeding = 0;
+        for (UINT i = 0; i < images.size(); i++) {
+            const AtlasEntry& entry = entries[i];
+            const UINT8* color = images[i].pixels.data();
+            for (UINT level = 0; level < settings.mipLevels; level++) {
+                const UINT size = settings.pageSize >> level;
+                const std::vector<UINT8>& mip = pages[entry.page].mips[level];
+                for (UINT y = entry.rect.y >> level; y <= (entry.rect.y + entry.rect.height - 1) >> level; y++) {
+                    for (UINT x = entry.rect.x >> level; x <= (entry.rect.x + entry.rect.width - 1) >> level; x++) {
+                        if (memcmp(&mip[((size_t)y * size + x) * 4], color, 4) != 0) {
+                            bleeding++;
+                            lastMipBleeding += level == settings.mipLevels - 1 ? 1 : 0;
+                        }
+                    }
+                }
+            }
+        }
+
+        char line[256];
+        snprintf(line, sizeof(line), "  %-8s %u pages, %u texels off colour, %u at the last mip\n",
+            names[h], (UINT)pages.size(), bleeding, lastMipBleeding);
+        report += line;
+        snprintf(line, sizeof(line), "%s: sprite texels keep their colour at the last mip", names[h]);
+        check(lastMipBleeding == 0, line);
+        snprintf(line, sizeof(line), "%s: nothing bleeds into a sprite at any mip", names[h]);
+        check(bleeding == 0, line);
+    }
+    return passed;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// Per-sprite data in vertex buffer slot 1.
+struct SpriteInstance {
+    XMFLOAT4 rect;          // Left, top, width, height in clip space
+    XMFLOAT4 uvScaleOffset; // From the atlas entry
+    UINT page;
+};
+
+const UINT spriteCount = 160;
+const UINT atlasPageSize = 512;
+const UINT atlasMipLevels = 4;
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 1;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 1;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "RECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "UVREMAP", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "PAGE", 0, DXGI_FORMAT_R32_UINT, 1, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/010-texture-atlas.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/010-texture-atlas.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+            psoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+            psoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+            psoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+            psoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+            psoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+            psoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            // A unit quad; every sprite stretches it over its rect.
+            Vertex triangleVertices[] = {
+                { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 0.0f} },
+                { { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 1.0f} },
+                { { 0.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 1.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Sprite Images and Atlas
+        std::vector<AtlasEntry> entries;
+        {
+            // Procedural sprites: discs, rings and striped tiles in random colors.
+            std::mt19937 random(5);
+            std::uniform_int_distribution<UINT> side(16, 56);
+            std::uniform_int_distribution<UINT> channel(64, 255);
+            std::vector<AtlasImage> images(spriteCount);
+            for (UINT i = 0; i < spriteCount; i++) {
+                AtlasImage& image = images[i];
+                image.width = side(random);
+                image.height = i % 3 == 2 ? side(random) : image.width;
+                image.pixels.resize(image.width * image.height * 4);
+                UINT8 color[3] = { (UINT8)channel(random), (UINT8)channel(random), (UINT8)channel(random) };
+                for (UINT y = 0; y < image.height; y++) {
+                    for (UINT x = 0; x < image.width; x++) {
+                        float u = (x + 0.5f) / image.width * 2.0f - 1.0f;
+                        float v = (y + 0.5f) / image.height * 2.0f - 1.0f;
+                        float radius = sqrtf(u * u + v * v);
+                        bool inside = i % 3 == 0 ? radius < 1.0f
+                            : i % 3 == 1 ? radius < 1.0f && radius > 0.6f
+                            : ((x + y) / 6) % 2 == 0;
+                        UINT8* texel = &image.pixels[(y * image.width + x) * 4];
+                        texel[0] = color[0];
+                        texel[1] = color[1];
+                        texel[2] = color[2];
+                        texel[3] = inside ? 0xff : 0x00;
+                    }
+                }
+            }
+
+            AtlasSettings settings;
+            settings.pageSize = atlasPageSize;
+            settings.mipLevels = atlasMipLevels;
+            TextureAtlasBuilder builder(settings);
+            std::vector<AtlasPage> pages;
+            AtlasStats stats = builder.build(images, entries, pages);
+            debugLog("Atlas: %u images in %u pages, %.1f%% occupancy, packed in %.2f ms\n",
+                stats.images, stats.pages, stats.imageArea * 100.0, stats.packSeconds * 1000.0);
+
+            this->createAtlasTexture(pages);
+        }
+
+        // Create Instance Buffer, laying the sprites out left to right at their pixel size
+        {
+            std::vector<SpriteInstance> instances(spriteCount);
+            UINT x = 8;
+            UINT y = 8;
+            UINT rowHeight = 0;
+            for (UINT i = 0; i < spriteCount; i++) {
+                const AtlasEntry& entry = entries[i];
+                if (x + entry.rect.width + 8 > windowWidth) {
+                    x = 8;
+                    y += rowHeight + 4;
+                    rowHeight = 0;
+                }
+                instances[i].rect = XMFLOAT4(
+                    x * 2.0f / windowWidth - 1.0f, 1.0f - y * 2.0f / windowHeight,
+                    entry.rect.width * 2.0f / windowWidth, -(entry.rect.height * 2.0f / windowHeight));
+                instances[i].uvScaleOffset = entry.uvScaleOffset;
+                instances[i].page = entry.page;
+                x += entry.rect.width + 4;
+                rowHeight = std::max(rowHeight, entry.rect.height);
+            }
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC bufferDesc = {};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = instances.size() * sizeof(SpriteInstance);
+            bufferDesc.Height = 1;
+            bufferDesc.DepthOrArraySize = 1;
+            bufferDesc.MipLevels = 1;
+            bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mInstanceBuffer)));
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mInstanceBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, instances.data(), bufferDesc.Width);
+            mInstanceBuffer->Unmap(0, nullptr);
+
+            mInstanceBufferView.BufferLocation = mInstanceBuffer->GetGPUVirtualAddress();
+            mInstanceBufferView.StrideInBytes = sizeof(SpriteInstance);
+            mInstanceBufferView.SizeInBytes = (UINT)bufferDesc.Width;
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[] = { mVertexBufferView, mInstanceBufferView };
+        mCommandList->IASetVertexBuffers(0, _countof(vertexBufferViews), vertexBufferViews);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+
+        // Every sprite samples the same atlas, so one table and one draw cover them all.
+        mCommandList->DrawIndexedInstanced(6, spriteCount, 0, 0, 0);
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    // Uploads all pages as one Texture2DArray through a single staging buffer: each page
+    // is written with one memcpy per mip and copied with one CopyTextureRegion per mip.
+    void createAtlasTexture(const std::vector<AtlasPage>& pages) {
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        textureDesc.Width = atlasPageSize;
+        textureDesc.Height = atlasPageSize;
+        textureDesc.DepthOrArraySize = (UINT16)pages.size();
+        textureDesc.MipLevels = atlasMipLevels;
+        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&mTextureResource)));
+
+        const UINT subresourceCount = (UINT)pages.size() * atlasMipLevels;
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(subresourceCount);
+        std::vector<UINT> numRows(subresourceCount);
+        std::vector<UINT64> rowSizes(subresourceCount);
+        UINT64 uploadBufferSize = 0;
+        mDevice->GetCopyableFootprints(&textureDesc, 0, subresourceCount, 0,
+            footprints.data(), numRows.data(), rowSizes.data(), &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&mTextureBuffer)));
+
+        UINT8* uploadPtr = nullptr;
+        _ThrowIfFailed(mTextureBuffer->Map(0, nullptr, (void**)&uploadPtr));
+        for (UINT page = 0; page < pages.size(); page++) {
+            for (UINT level = 0; level < atlasMipLevels; level++) {
+                // Subresources of an array are ordered mip first within each slice.
+                const UINT subresource = page * atlasMipLevels + level;
+                const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = footprints[subresource];
+                const UINT8* srcPtr = pages[page].mips[level].data();
+                UINT8* dstPtr = uploadPtr + footprint.Offset;
+                if (footprint.Footprint.RowPitch == rowSizes[subresource]) {
+                    memcpy(dstPtr, srcPtr, rowSizes[subresource] * numRows[subresource]);
+                } else {
+                    for (UINT row = 0; row < numRows[subresource]; row++) {
+                        memcpy(dstPtr + (size_t)row * footprint.Footprint.RowPitch, srcPtr + row * rowSizes[subresource], rowSizes[subresource]);
+                    }
+                }
+
+                D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+                srcLocation.pResource = mTextureBuffer.Get();
+                srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+                srcLocation.PlacedFootprint = footprint;
+
+                D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+                dstLocation.pResource = mTextureResource.Get();
+                dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+                dstLocation.SubresourceIndex = subresource;
+
+                mCommandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+            }
+        }
+        mTextureBuffer->Unmap(0, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = mTextureResource.Get();
+        onFinish.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = textureDesc.Format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2DArray.MipLevels = atlasMipLevels;
+        srvDesc.Texture2DArray.ArraySize = (UINT)pages.size();
+        mDevice->CreateShaderResourceView(mTextureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+    ComPtr<ID3D12Resource> mInstanceBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mInstanceBufferView;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkAtlasPacking();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateTextureAtlas(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
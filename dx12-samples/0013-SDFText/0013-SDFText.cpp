@@ -0,0 +1,1414 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0013-SDFText";
+const char* windowClass = "0013-SDFText";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+const wchar_t* fontName = L"Consolas";
+const int fontEmPixels = 48;
+const UINT fontSpread = 6;
+const wchar_t firstGlyph = 32;
+const wchar_t lastGlyph = 126;
+const UINT glyphAtlasSize = 1024;
+const UINT maxGlyphsPerFrame = 8192;
+const UINT sensorCount = 36;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024] = { 0 };
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// A glyph outline flattened to line segments, in pixels at the em size, y up from the
+// baseline.
+struct GlyphOutline {
+    std::vector<XMFLOAT4> segments; // x0, y0, x1, y1
+    float advance = 0.0f;
+};
+
+// Reads TrueType outlines through GDI. GDI is not thread-safe per DC, so outlines are
+// fetched up front on one thread and only distance field generation runs in parallel.
+class GlyphOutlineSource {
+public:
+    GlyphOutlineSource(const wchar_t* fontName, int emPixels) : mEmPixels(emPixels) {
+        mDC = CreateCompatibleDC(nullptr);
+        mFont = CreateFontW(-emPixels, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
+            OUT_OUTLINE_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, fontName);
+        if (mDC == nullptr || mFont == nullptr) {
+            throw std::exception("Create font failed.");
+        }
+        mPreviousFont = SelectObject(mDC, mFont);
+    }
+
+    ~GlyphOutlineSource() {
+        SelectObject(mDC, mPreviousFont);
+        DeleteObject(mFont);
+        DeleteDC(mDC);
+    }
+
+    int emPixels() const { return mEmPixels; }
+
+    bool outline(wchar_t codepoint, GlyphOutline& glyph) {
+        GLYPHMETRICS metrics = {};
+        const MAT2 identity = { { 0, 1 }, { 0, 0 }, { 0, 0 }, { 0, 1 } };
+        const UINT format = GGO_NATIVE | GGO_UNHINTED;
+        DWORD size = GetGlyphOutlineW(mDC, codepoint, format, &metrics, 0, nullptr, &identity);
+        if (size == GDI_ERROR) {
+            return false;
+        }
+        glyph.advance = (float)metrics.gmCellIncX;
+        glyph.segments.clear();
+        if (size == 0) {
+            return true; // Blank glyph such as space
+        }
+
+        std::vector<BYTE> buffer(size);
+        if (GetGlyphOutlineW(mDC, codepoint, format, &metrics, size, buffer.data(), &identity) == GDI_ERROR) {
+            return false;
+        }
+
+        // A list of closed contours, each made of line, quadratic and cubic records.
+        const BYTE* cursor = buffer.data();
+        const BYTE* end = cursor + size;
+        while (cursor < end) {
+            const TTPOLYGONHEADER* header = (const TTPOLYGONHEADER*)cursor;
+            const XMFLOAT2 start = toPoint(header->pfxStart);
+            XMFLOAT2 current = start;
+            const BYTE* curveCursor = cursor + sizeof(TTPOLYGONHEADER);
+            const BYTE* curveEnd = cursor + header->cb;
+            while (curveCursor < curveEnd) {
+                const TTPOLYCURVE* curve = (const TTPOLYCURVE*)curveCursor;
+                if (curve->wType == TT_PRIM_LINE) {
+                    for (WORD i = 0; i < curve->cpfx; i++) {
+                        XMFLOAT2 point = toPoint(curve->apfx[i]);
+                        addLine(glyph, current, point);
+                        current = point;
+                    }
+                } else if (curve->wType == TT_PRIM_QSPLINE) {
+                    // Consecutive off-curve points imply on-curve midpoints between them.
+                    for (WORD i = 0; i + 1 < curve->cpfx; i++) {
+                        XMFLOAT2 control = toPoint(curve->apfx[i]);
+                        XMFLOAT2 next = toPoint(curve->apfx[i + 1]);
+                        XMFLOAT2 point = i + 2 == curve->cpfx ? next : XMFLOAT2((control.x + next.x) * 0.5f, (control.y + next.y) * 0.5f);
+                        addQuadratic(glyph, current, control, point);
+                        current = point;
+                    }
+                } else if (curve->wType == TT_PRIM_CSPLINE) {
+                    for (WORD i = 0; i + 2 < curve->cpfx; i += 3) {
+                        XMFLOAT2 point = toPoint(curve->apfx[i + 2]);
+                        addCubic(glyph, current, toPoint(curve->apfx[i]), toPoint(curve->apfx[i + 1]), point);
+                        current = point;
+                    }
+                }
+                curveCursor += sizeof(TTPOLYCURVE) + (curve->cpfx - 1) * sizeof(POINTFX);
+            }
+            addLine(glyph, current, start);
+            cursor += header->cb;
+        }
+        return true;
+    }
+
+private:
+    static XMFLOAT2 toPoint(const POINTFX& point) {
+        return XMFLOAT2(point.x.value + point.x.fract / 65536.0f, point.y.value + point.y.fract / 65536.0f);
+    }
+
+    static void addLine(GlyphOutline& glyph, XMFLOAT2 a, XMFLOAT2 b) {
+        if (a.x != b.x || a.y != b.y) {
+            glyph.segments.push_back(XMFLOAT4(a.x, a.y, b.x, b.y));
+        }
+    }
+
+    static void addQuadratic(GlyphOutline& glyph, XMFLOAT2 a, XMFLOAT2 b, XMFLOAT2 c) {
+        const int steps = 8;
+        XMFLOAT2 previous = a;
+        for (int i = 1; i <= steps; i++) {
+            float t = i / (float)steps;
+            float s = 1.0f - t;
+            XMFLOAT2 point(s * s * a.x + 2 * s * t * b.x + t * t * c.x, s * s * a.y + 2 * s * t * b.y + t * t * c.y);
+            addLine(glyph, previous, point);
+            previous = point;
+        }
+    }
+
+    static void addCubic(GlyphOutline& glyph, XMFLOAT2 a, XMFLOAT2 b, XMFLOAT2 c, XMFLOAT2 d) {
+        const int steps = 12;
+        XMFLOAT2 previous = a;
+        for (int i = 1; i <= steps; i++) {
+            float t = i / (float)steps;
+            float s = 1.0f - t;
+            float wa = s * s * s, wb = 3 * s * s * t, wc = 3 * s * t * t, wd = t * t * t;
+            XMFLOAT2 point(wa * a.x + wb * b.x + wc * c.x + wd * d.x, wa * a.y + wb * b.y + wc * c.y + wd * d.y);
+            addLine(glyph, previous, point);
+            previous = point;
+        }
+    }
+
+private:
+    int mEmPixels;
+    HDC mDC = nullptr;
+    HFONT mFont = nullptr;
+    HGDIOBJ mPreviousFont = nullptr;
+};
+
+// Single-channel signed distance field of one glyph. 0.5 is the outline; spread pixels
+// outside map to 0 and spread pixels inside to 1. left/top place the bitmap relative to
+// the pen position, in pixels at the em size with y up.
+struct GlyphField {
+    UINT width = 0;
+    UINT height = 0;
+    float left = 0.0f;
+    float top = 0.0f;
+    std::vector<UINT8> distances;
+};
+
+void generateGlyphField(const GlyphOutline& outline, UINT spread, GlyphField& field) {
+    field.distances.clear();
+    if (outline.segments.empty()) {
+        field.width = field.height = 0;
+        return;
+    }
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (const XMFLOAT4& segment : outline.segments) {
+        minX = std::min(minX, std::min(segment.x, segment.z));
+        maxX = std::max(maxX, std::max(segment.x, segment.z));
+        minY = std::min(minY, std::min(segment.y, segment.w));
+        maxY = std::max(maxY, std::max(segment.y, segment.w));
+    }
+    field.left = floorf(minX) - spread;
+    field.top = ceilf(maxY) + spread;
+    field.width = (UINT)(ceilf(maxX) + spread - field.left);
+    field.height = (UINT)(field.top - (floorf(minY) - spread));
+    field.distances.resize(field.width * field.height);
+
+    for (UINT row = 0; row < field.height; row++) {
+        const float y = field.top - row - 0.5f;
+        for (UINT column = 0; column < field.width; column++) {
+            const float x = field.left + column + 0.5f;
+            float nearest = FLT_MAX;
+            int winding = 0;
+            for (const XMFLOAT4& segment : outline.segments) {
+                // Squared distance to the segment
+                float dx = segment.z - segment.x;
+                float dy = segment.w - segment.y;
+                float px = x - segment.x;
+                float py = y - segment.y;
+                float t = std::min(std::max((px * dx + py * dy) / (dx * dx + dy * dy), 0.0f), 1.0f);
+                float ex = px - t * dx;
+                float ey = py - t * dy;
+                nearest = std::min(nearest, ex * ex + ey * ey);
+
+                // Non-zero winding: count signed crossings of a ray towards +x.
+                float side = dx * py - dy * px;
+                if (segment.y <= y && segment.w > y && side > 0.0f) {
+                    winding++;
+                } else if (segment.y > y && segment.w <= y && side < 0.0f) {
+                    winding--;
+                }
+            }
+            float distance = sqrtf(nearest) * (winding != 0 ? 1.0f : -1.0f);
+            float value = 0.5f + distance / (2.0f * spread);
+            field.distances[row * field.width + column] = (UINT8)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+}
+
+// Where a glyph's field sits in the atlas and how to place it, in pixels at the em size.
+struct GlyphInfo {
+    float advance = 0.0f;
+    float left = 0.0f;
+    float top = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    XMFLOAT4 uvRect = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f); // u0, v0, u1, v1
+};
+
+struct GlyphAtlasStats {
+    UINT glyphs = 0;
+    UINT threads = 0;
+    double outlineSeconds = 0.0;
+    double fieldSeconds = 0.0;
+};
+
+// Distance field atlas for a range of codepoints. Fields are generated on all cores and
+// shelf-packed, tallest first, into one R8 page.
+class GlyphAtlas {
+public:
+    GlyphAtlasStats build(GlyphOutlineSource& source, wchar_t first, wchar_t last, UINT spread, UINT pageSize, UINT threadCount) {
+        GlyphAtlasStats stats;
+        double start = secondsNow();
+
+        const UINT count = last - first + 1;
+        std::vector<GlyphOutline> outlines(count);
+        for (UINT i = 0; i < count; i++) {
+            if (!source.outline((wchar_t)(first + i), outlines[i])) {
+                outlines[i] = GlyphOutline();
+            }
+        }
+        stats.outlineSeconds = secondsNow() - start;
+
+        start = secondsNow();
+        std::vector<GlyphField> fields(count);
+        std::atomic<UINT> next(0);
+        std::vector<std::thread> workers;
+        for (UINT t = 0; t < std::max(threadCount, 1U); t++) {
+            workers.push_back(std::thread([&]() {
+                for (UINT i = next++; i < count; i = next++) {
+                    generateGlyphField(outlines[i], spread, fields[i]);
+                }
+            }));
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        stats.fieldSeconds = secondsNow() - start;
+        stats.glyphs = count;
+        stats.threads = (UINT)workers.size();
+
+        // Shelf packing, tallest first, one texel apart.
+        std::vector<UINT> order(count);
+        for (UINT i = 0; i < count; i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](UINT a, UINT b) { return fields[a].height > fields[b].height; });
+
+        mPageSize = pageSize;
+        mPixels.assign(pageSize * pageSize, 0);
+        mFirst = first;
+        mGlyphs.assign(count, GlyphInfo());
+        UINT x = 0, y = 0, shelfHeight = 0;
+        for (UINT index : order) {
+            const GlyphField& field = fields[index];
+            GlyphInfo& glyph = mGlyphs[index];
+            glyph.advance = outlines[index].advance;
+            if (field.width == 0) {
+                continue;
+            }
+            if (x + field.width > pageSize) {
+                x = 0;
+                y += shelfHeight + 1;
+                shelfHeight = 0;
+            }
+            if (y + field.height > pageSize) {
+                throw std::exception("The glyph atlas page is too small.");
+            }
+            for (UINT row = 0; row < field.height; row++) {
+                memcpy(&mPixels[(y + row) * pageSize + x], &field.distances[row * field.width], field.width);
+            }
+            glyph.left = field.left;
+            glyph.top = field.top;
+            glyph.width = (float)field.width;
+            glyph.height = (float)field.height;
+            glyph.uvRect = XMFLOAT4(x / (float)pageSize, y / (float)pageSize,
+                (x + field.width) / (float)pageSize, (y + field.height) / (float)pageSize);
+            x += field.width + 1;
+            shelfHeight = std::max(shelfHeight, field.height);
+        }
+        mEmPixels = (float)source.emPixels();
+        return stats;
+    }
+
+    const GlyphInfo* glyph(wchar_t codepoint) const {
+        UINT index = (UINT)(codepoint - mFirst);
+        return codepoint >= mFirst && index < mGlyphs.size() ? &mGlyphs[index] : nullptr;
+    }
+
+    float emPixels() const { return mEmPixels; }
+    UINT pageSize() const { return mPageSize; }
+    const std::vector<UINT8>& pixels() const { return mPixels; }
+
+private:
+    wchar_t mFirst = 0;
+    float mEmPixels = 1.0f;
+    UINT mPageSize = 0;
+    std::vector<GlyphInfo> mGlyphs;
+    std::vector<UINT8> mPixels;
+};
+
+// Glyph quads of a string at the em size, y down from the top of the first line.
+struct LaidGlyph {
+    XMFLOAT4 rect;   // x, y, width, height
+    XMFLOAT4 uvRect;
+};
+
+struct TextLayout {
+    std::vector<LaidGlyph> glyphs;
+    float width = 0.0f;
+};
+
+// Lays strings out once and keeps the result; live text mostly repeats labels, so only
+// the strings that actually changed are laid out again. Layouts are at the em size and
+// scaled when emitted, so one entry serves every text size. Text that changes every frame,
+// like counters and readings, goes through transient() so it never enters the cache.
+class TextLayoutCache {
+public:
+    TextLayoutCache(const GlyphAtlas& atlas) : mAtlas(atlas) {}
+
+    const TextLayout& layout(const std::string& text) {
+        auto it = mLayouts.find(text);
+        if (it != mLayouts.end()) {
+            mHits++;
+            return it->second;
+        }
+        mMisses++;
+        if (mLayouts.size() >= maxEntries) {
+            mLayouts.clear();
+        }
+        TextLayout& layout = mLayouts[text];
+        layoutText(text, layout);
+        return layout;
+    }
+
+    // Lays out into a scratch layout that stays valid until the next call.
+    const TextLayout& transient(const std::string& text) {
+        layoutText(text, mScratch);
+        return mScratch;
+    }
+
+    void layoutText(const std::string& text, TextLayout& layout) const {
+        const float em = mAtlas.emPixels();
+        const float lineHeight = em * 1.25f;
+        float penX = 0.0f;
+        float baseline = em;
+        layout.glyphs.clear();
+        layout.width = 0.0f;
+        for (char c : text) {
+            if (c == '\n') {
+                penX = 0.0f;
+                baseline += lineHeight;
+                continue;
+            }
+            const GlyphInfo* glyph = mAtlas.glyph((wchar_t)(unsigned char)c);
+            if (glyph == nullptr) {
+                glyph = mAtlas.glyph(L'?');
+                if (glyph == nullptr) {
+                    continue;
+                }
+            }
+            if (glyph->width > 0.0f) {
+                LaidGlyph laid;
+                laid.rect = XMFLOAT4(penX + glyph->left, baseline - glyph->top, glyph->width, glyph->height);
+                laid.uvRect = glyph->uvRect;
+                layout.glyphs.push_back(laid);
+            }
+            penX += glyph->advance;
+            layout.width = std::max(layout.width, penX);
+        }
+    }
+
+    UINT64 hits() const { return mHits; }
+    UINT64 misses() const { return mMisses; }
+
+private:
+    static const size_t maxEntries = 4096;
+
+    const GlyphAtlas& mAtlas;
+    std::unordered_map<std::string, TextLayout> mLayouts;
+    TextLayout mScratch;
+    UINT64 mHits = 0;
+    UINT64 mMisses = 0;
+};
+
+// One glyph quad in the instance buffer.
+struct GlyphInstance {
+    XMFLOAT4 rect;   // Left, top, width, height in clip space
+    XMFLOAT4 uvRect;
+    XMFLOAT4 color;
+};
+
+// Appends the glyphs of a layout at (x, y) in pixels, scaled to pixelSize. Returns how many
+// were written; the rest is dropped when the batch is full.
+UINT emitText(const TextLayout& layout, float x, float y, float pixelSize, float emPixels, const XMFLOAT4& color,
+    float viewportWidth, float viewportHeight, GlyphInstance* instances, UINT capacity)
+{
+    const float scale = pixelSize / emPixels;
+    const float toClipX = 2.0f / viewportWidth;
+    const float toClipY = 2.0f / viewportHeight;
+    UINT count = std::min(capacity, (UINT)layout.glyphs.size());
+    for (UINT i = 0; i < count; i++) {
+        const LaidGlyph& glyph = layout.glyphs[i];
+        GlyphInstance& instance = instances[i];
+        instance.rect = XMFLOAT4(
+            (x + glyph.rect.x * scale) * toClipX - 1.0f, 1.0f - (y + glyph.rect.y * scale) * toClipY,
+            glyph.rect.z * scale * toClipX, -glyph.rect.w * scale * toClipY);
+        instance.uvRect = glyph.uvRect;
+        instance.color = color;
+    }
+    return count;
+}
+
+// Distance field generation on one thread and on all, then layout and emission of 10k
+// strings drawn from 500 distinct ones, with and without the layout cache.
+std::string benchmarkText() {
+    GlyphOutlineSource source(fontName, fontEmPixels);
+    GlyphAtlas atlas;
+    GlyphAtlasStats serial = atlas.build(source, firstGlyph, lastGlyph, fontSpread, glyphAtlasSize, 1);
+    GlyphAtlasStats parallel = atlas.build(source, firstGlyph, lastGlyph, fontSpread, glyphAtlasSize, std::thread::hardware_concurrency());
+
+    const UINT distinctCount = 500;
+    const UINT stringCount = 10000;
+    std::vector<std::string> strings;
+    for (UINT i = 0; i < distinctCount; i++) {
+        char text[64];
+        snprintf(text, sizeof(text), "Sensor %03u  %8.2f kPa  OK", i, i * 3.17f);
+        strings.push_back(text);
+    }
+
+    std::vector<GlyphInstance> instances(stringCount * 32);
+    TextLayoutCache cache(atlas);
+    TextLayout scratch;
+    double timings[2] = {};
+    UINT64 glyphCounts[2] = {};
+    for (UINT pass = 0; pass < 2; pass++) {
+        double start = secondsNow();
+        UINT written = 0;
+        for (UINT i = 0; i < stringCount; i++) {
+            const std::string& text = strings[(i * 7919) % distinctCount];
+            const TextLayout* layout = &scratch;
+            if (pass == 0) {
+                cache.layoutText(text, scratch);
+            } else {
+                layout = &cache.layout(text);
+            }
+            written += emitText(*layout, 10.0f, 10.0f + (i % 40) * 14.0f, 12.0f, atlas.emPixels(), XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f),
+                (float)windowWidth, (float)windowHeight, &instances[written], (UINT)instances.size() - written);
+        }
+        timings[pass] = secondsNow() - start;
+        glyphCounts[pass] = written;
+    }
+
+    char report[768];
+    snprintf(report, sizeof(report),
+        "Glyph atlas: %u glyphs, outlines %.2f ms\n"
+        "Distance fields: %.1f glyphs/ms on 1 thread, %.1f glyphs/ms on %u threads\n"
+        "Layout + emit, 10000 strings: %.0f glyphs/ms uncached, %.0f glyphs/ms cached (%llu misses)\n",
+        parallel.glyphs, parallel.outlineSeconds * 1000.0,
+        serial.glyphs / (serial.fieldSeconds * 1000.0), parallel.glyphs / (parallel.fieldSeconds * 1000.0), parallel.threads,
+        glyphCounts[0] / (timings[0] * 1000.0), glyphCounts[1] / (timings[1] * 1000.0), cache.misses());
+    return report;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->buildText();
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 1;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 1;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "RECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "UVRECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "GLYPHCOLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/011-sdf-text.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/011-sdf-text.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+            psoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+            psoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+            psoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+            psoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+            psoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+            psoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            // A unit quad; every glyph stretches it over its rect.
+            Vertex triangleVertices[] = {
+                { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 0.0f} },
+                { { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 1.0f} },
+                { { 0.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 1.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Glyph Atlas
+        {
+            GlyphOutlineSource source(fontName, fontEmPixels);
+            GlyphAtlasStats stats = mGlyphAtlas.build(source, firstGlyph, lastGlyph, fontSpread, glyphAtlasSize, std::thread::hardware_concurrency());
+            debugLog("Glyph atlas: %u glyphs on %u threads, %.2f ms outlines, %.2f ms distance fields\n",
+                stats.glyphs, stats.threads, stats.outlineSeconds * 1000.0, stats.fieldSeconds * 1000.0);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(),
+                mGlyphAtlas.pixels(), glyphAtlasSize, glyphAtlasSize, DXGI_FORMAT_R8_UNORM,
+                mTextureResource, mTextureBuffer);
+        }
+
+        // Create Glyph Instance Buffer, one region per frame in flight, mapped for good
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC bufferDesc = {};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = (UINT64)frameBufferCount * maxGlyphsPerFrame * sizeof(GlyphInstance);
+            bufferDesc.Height = 1;
+            bufferDesc.DepthOrArraySize = 1;
+            bufferDesc.MipLevels = 1;
+            bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mInstanceBuffer)));
+
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mInstanceBuffer->Map(0, &readRange, (void**)&mInstances));
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    // Lays out this frame's text and writes every glyph quad into the frame's instance region.
+    void buildText() {
+        GlyphInstance* instances = mInstances + mFrameBufferIndex * maxGlyphsPerFrame;
+        const float em = mGlyphAtlas.emPixels();
+        const XMFLOAT4 white(1.0f, 1.0f, 1.0f, 1.0f);
+        const XMFLOAT4 label(0.6f, 0.8f, 1.0f, 1.0f);
+        const XMFLOAT4 warning(1.0f, 0.5f, 0.3f, 1.0f);
+        UINT count = 0;
+
+        // Labels come from the cache; the numbers change every frame and are laid out
+        // transiently next to them.
+        double now = secondsNow();
+        char text[128];
+        const TextLayout& frameLabel = mLayouts.layout("Frame ");
+        count += emitText(frameLabel, 12.0f, 8.0f, 28.0f, em, white,
+            (float)windowWidth, (float)windowHeight, instances + count, maxGlyphsPerFrame - count);
+        snprintf(text, sizeof(text), "%llu   %.2f ms", mFrameCount, (now - mLastFrameTime) * 1000.0);
+        mLastFrameTime = now;
+        mFrameCount++;
+        count += emitText(mLayouts.transient(text), 12.0f + frameLabel.width * 28.0f / em, 8.0f, 28.0f, em, white,
+            (float)windowWidth, (float)windowHeight, instances + count, maxGlyphsPerFrame - count);
+
+        for (UINT i = 0; i < sensorCount; i++) {
+            float x = 12.0f + (i / 18) * 390.0f;
+            float y = 48.0f + (i % 18) * 28.0f;
+            snprintf(text, sizeof(text), "Sensor %02u", i);
+            count += emitText(mLayouts.layout(text), x, y, 18.0f, em, label,
+                (float)windowWidth, (float)windowHeight, instances + count, maxGlyphsPerFrame - count);
+
+            float value = 100.0f + 40.0f * sinf((float)now * (0.3f + i * 0.07f) + i);
+            const XMFLOAT4& color = value > 135.0f ? warning : white;
+            snprintf(text, sizeof(text), "%7.2f", value);
+            const TextLayout& reading = mLayouts.transient(text);
+            const float unitX = x + 120.0f + reading.width * 18.0f / em;
+            count += emitText(reading, x + 120.0f, y, 18.0f, em, color,
+                (float)windowWidth, (float)windowHeight, instances + count, maxGlyphsPerFrame - count);
+            count += emitText(mLayouts.layout(" kPa"), unitX, y, 18.0f, em, color,
+                (float)windowWidth, (float)windowHeight, instances + count, maxGlyphsPerFrame - count);
+        }
+        mGlyphCount = count;
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        D3D12_VERTEX_BUFFER_VIEW instanceBufferView = {};
+        instanceBufferView.BufferLocation = mInstanceBuffer->GetGPUVirtualAddress() + (UINT64)mFrameBufferIndex * maxGlyphsPerFrame * sizeof(GlyphInstance);
+        instanceBufferView.StrideInBytes = sizeof(GlyphInstance);
+        instanceBufferView.SizeInBytes = maxGlyphsPerFrame * sizeof(GlyphInstance);
+        D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[] = { mVertexBufferView, instanceBufferView };
+        mCommandList->IASetVertexBuffers(0, _countof(vertexBufferViews), vertexBufferViews);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+
+        // All text of the frame in one instanced draw
+        mCommandList->DrawIndexedInstanced(6, mGlyphCount, 0, 0, 0);
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 4096;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+
+    GlyphAtlas mGlyphAtlas;
+    TextLayoutCache mLayouts{ mGlyphAtlas };
+    ComPtr<ID3D12Resource> mInstanceBuffer;
+    GlyphInstance* mInstances = nullptr;
+    UINT mGlyphCount = 0;
+    UINT64 mFrameCount = 0;
+    double mLastFrameTime = 0.0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkText();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
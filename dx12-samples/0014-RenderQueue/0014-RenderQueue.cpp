@@ -0,0 +1,1382 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0014-RenderQueue";
+const char* windowClass = "0014-RenderQueue";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+const UINT materialCount = 8;
+const UINT opaqueQuadCount = 1500;
+const UINT blendedQuadCount = 400;
+const UINT overlayQuadCount = 24;
+
+// Pipelines of the sample; all of them share one root signature.
+enum SamplePipeline {
+    PipelineOpaque,
+    PipelineBlended,
+    PipelineOverlay,
+    PipelineCount
+};
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Passes run in order. Opaque draws sort by state, then front to back; blended draws back
+// to front, then by state; overlay draws keep their submission order.
+enum RenderPass {
+    RenderPassOpaque = 0,
+    RenderPassBlended = 1,
+    RenderPassOverlay = 2,
+};
+
+// Root constants of a draw: rect, tint and depth.
+const UINT drawConstantCount = 9;
+
+// Everything one draw needs. The queue sorts 64-bit keys and keeps packets where they were
+// submitted; the low bits of each key index back into the packets.
+struct DrawPacket {
+    UINT pass = RenderPassOpaque;
+    UINT pipeline = 0;
+    UINT material = 0;  // Descriptor table of the draw's textures
+    float depth = 0.0f; // 0 near, 1 far
+    float constants[drawConstantCount] = {};
+};
+
+// Bit layout of a sort key, from the top: pass, then the pass's own order, then the packet
+// index so equal keys stay in submission order.
+const UINT sortKeyPassShift = 62;
+const UINT sortKeyPipelineBits = 8;
+const UINT sortKeyMaterialBits = 12;
+const UINT sortKeyDepthBits = 18;
+const UINT sortKeyIndexBits = 24;
+const UINT64 sortKeyIndexMask = (1ull << sortKeyIndexBits) - 1;
+
+UINT64 makeSortKey(const DrawPacket& packet, UINT index) {
+    const UINT64 depthMax = (1ull << sortKeyDepthBits) - 1;
+    float depth = std::min(std::max(packet.depth, 0.0f), 1.0f);
+    UINT64 quantized = (UINT64)(depth * depthMax + 0.5f);
+    UINT64 pipeline = packet.pipeline;
+    UINT64 material = packet.material;
+    UINT64 key = (UINT64)packet.pass << sortKeyPassShift;
+    switch (packet.pass) {
+    case RenderPassOpaque:
+        key |= pipeline << (sortKeyIndexBits + sortKeyDepthBits + sortKeyMaterialBits);
+        key |= material << (sortKeyIndexBits + sortKeyDepthBits);
+        key |= quantized << sortKeyIndexBits;
+        break;
+    case RenderPassBlended:
+        key |= (depthMax - quantized) << (sortKeyIndexBits + sortKeyMaterialBits + sortKeyPipelineBits);
+        key |= pipeline << (sortKeyIndexBits + sortKeyMaterialBits);
+        key |= material << sortKeyIndexBits;
+        break;
+    default:
+        break;
+    }
+    return key | index;
+}
+
+// Lets a fixed set of threads step through the sort passes together.
+class SpinBarrier {
+public:
+    explicit SpinBarrier(UINT count) : mCount(count) {}
+
+    void wait() {
+        UINT generation = mGeneration.load(std::memory_order_acquire);
+        if (mWaiting.fetch_add(1, std::memory_order_acq_rel) + 1 == mCount) {
+            mWaiting.store(0, std::memory_order_relaxed);
+            mGeneration.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (mGeneration.load(std::memory_order_acquire) == generation) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    const UINT mCount;
+    std::atomic<UINT> mWaiting{ 0 };
+    std::atomic<UINT> mGeneration{ 0 };
+};
+
+// Binds issued while recording a queue. A draw that rebinds everything costs three.
+struct RenderStateStats {
+    UINT64 draws = 0;
+    UINT64 rootSignatures = 0;
+    UINT64 pipelines = 0;
+    UINT64 tables = 0;
+
+    UINT64 bindings() const { return rootSignatures + pipelines + tables; }
+};
+
+// Draws are submitted in any order, sorted by key once per frame and recorded with only
+// the state changes the sorted order actually needs.
+class RenderQueue {
+public:
+    void reset() {
+        mPackets.clear();
+        mKeys.clear();
+    }
+
+    void submit(const DrawPacket& packet) {
+        if (mPackets.size() > sortKeyIndexMask) {
+            throw std::exception("Render queue is full");
+        }
+        if (packet.pipeline >= (1u << sortKeyPipelineBits) || packet.material >= (1u << sortKeyMaterialBits)) {
+            throw std::exception("Draw packet state is out of range for its sort key");
+        }
+        mKeys.push_back(makeSortKey(packet, (UINT)mPackets.size()));
+        mPackets.push_back(packet);
+    }
+
+    // LSD radix sort, eight bits per pass. The index bits are already in order, and passes
+    // whose byte is the same in every key are skipped; small queues stay on one thread.
+    void sort(UINT threadCount) {
+        const size_t count = mKeys.size();
+        if (count < 2) {
+            return;
+        }
+        mScratch.resize(count);
+
+        UINT64 anyBits = 0;
+        UINT64 allBits = ~0ull;
+        for (UINT64 key : mKeys) {
+            anyBits |= key;
+            allBits &= key;
+        }
+        const UINT64 varying = (anyBits ^ allBits) & ~sortKeyIndexMask;
+        UINT shifts[8];
+        UINT passCount = 0;
+        for (UINT shift = 0; shift < 64; shift += 8) {
+            if (((varying >> shift) & 0xff) != 0) {
+                shifts[passCount++] = shift;
+            }
+        }
+
+        if (count < parallelSortThreshold) {
+            threadCount = 1;
+        }
+        threadCount = std::max(1u, std::min(threadCount, maxSortThreads));
+        mCounts.resize(threadCount * 256);
+
+        SpinBarrier barrier(threadCount);
+        auto worker = [&](UINT thread) {
+            const size_t begin = count * thread / threadCount;
+            const size_t end = count * (thread + 1) / threadCount;
+            UINT64* src = mKeys.data();
+            UINT64* dst = mScratch.data();
+            size_t* counts = &mCounts[thread * 256];
+            for (UINT pass = 0; pass < passCount; pass++) {
+                const UINT shift = shifts[pass];
+                memset(counts, 0, 256 * sizeof(size_t));
+                for (size_t i = begin; i < end; i++) {
+                    counts[(src[i] >> shift) & 0xff]++;
+                }
+                barrier.wait();
+
+                // Offsets go digit-major, thread-minor, so every thread scatters its own
+                // chunk into a disjoint range and the sort stays stable.
+                if (thread == 0) {
+                    size_t offset = 0;
+                    for (UINT digit = 0; digit < 256; digit++) {
+                        for (UINT t = 0; t < threadCount; t++) {
+                            size_t n = mCounts[t * 256 + digit];
+                            mCounts[t * 256 + digit] = offset;
+                            offset += n;
+                        }
+                    }
+                }
+                barrier.wait();
+
+                for (size_t i = begin; i < end; i++) {
+                    dst[counts[(src[i] >> shift) & 0xff]++] = src[i];
+                }
+                barrier.wait();
+                std::swap(src, dst);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (UINT thread = 1; thread < threadCount; thread++) {
+            threads.emplace_back(worker, thread);
+        }
+        worker(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (passCount % 2 == 1) {
+            mKeys.swap(mScratch);
+        }
+    }
+
+    // Replays the queue into the recorder, which takes setRootSignature, setPipeline,
+    // setTable and draw. Changing the root signature drops every root argument, so the
+    // table is bound again after it. Without inKeyOrder the packets go in submission order,
+    // which shows what filtering alone saves.
+    template <typename Recorder>
+    RenderStateStats record(const UINT* pipelineRootSignatures, Recorder& recorder, bool inKeyOrder = true) const {
+        RenderStateStats stats;
+        UINT rootSignature = UINT_MAX;
+        UINT pipeline = UINT_MAX;
+        UINT table = UINT_MAX;
+        for (size_t i = 0; i < mKeys.size(); i++) {
+            const DrawPacket& packet = mPackets[inKeyOrder ? (size_t)(mKeys[i] & sortKeyIndexMask) : i];
+            const UINT packetRootSignature = pipelineRootSignatures[packet.pipeline];
+            if (packetRootSignature != rootSignature) {
+                rootSignature = packetRootSignature;
+                table = UINT_MAX;
+                recorder.setRootSignature(rootSignature);
+                stats.rootSignatures++;
+            }
+            if (packet.pipeline != pipeline) {
+                pipeline = packet.pipeline;
+                recorder.setPipeline(pipeline);
+                stats.pipelines++;
+            }
+            if (packet.material != table) {
+                table = packet.material;
+                recorder.setTable(table);
+                stats.tables++;
+            }
+            recorder.draw(packet);
+            stats.draws++;
+        }
+        return stats;
+    }
+
+    size_t size() const { return mKeys.size(); }
+    const std::vector<UINT64>& keys() const { return mKeys; }
+
+private:
+    static const size_t parallelSortThreshold = 16384;
+    static const UINT maxSortThreads = 16;
+
+    std::vector<DrawPacket> mPackets;
+    std::vector<UINT64> mKeys;
+    std::vector<UINT64> mScratch;
+    std::vector<size_t> mCounts;
+};
+
+// Counts binds instead of recording them.
+struct CountingRecorder {
+    void setRootSignature(UINT) {}
+    void setPipeline(UINT) {}
+    void setTable(UINT) {}
+    void draw(const DrawPacket& packet) { checksum += packet.material; }
+
+    UINT64 checksum = 0;
+};
+
+// 100k packets spread over 16 pipelines on 4 root signatures and 1024 materials, in all
+// three passes. Sorts with std::sort and the radix sort on one and all threads, then
+// counts the binds of rebinding every draw, filtering in submission order, and filtering
+// in key order.
+std::string benchmarkRenderQueue() {
+    const UINT packetCount = 100000;
+    const UINT pipelineCount = 16;
+    const UINT materialCount = 1024;
+    UINT pipelineRootSignatures[pipelineCount];
+    for (UINT i = 0; i < pipelineCount; i++) {
+        pipelineRootSignatures[i] = i / 4;
+    }
+
+    UINT seed = 12345;
+    auto random = [&seed]() -> UINT {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    std::vector<DrawPacket> packets(packetCount);
+    for (DrawPacket& packet : packets) {
+        UINT roll = random() % 100;
+        packet.pass = roll < 80 ? RenderPassOpaque : (roll < 95 ? RenderPassBlended : RenderPassOverlay);
+        packet.pipeline = random() % pipelineCount;
+        packet.material = random() % materialCount;
+        packet.depth = (random() % 65536) / 65535.0f;
+    }
+
+    RenderQueue queue;
+    double start = secondsNow();
+    for (const DrawPacket& packet : packets) {
+        queue.submit(packet);
+    }
+    double submitSeconds = secondsNow() - start;
+
+    std::vector<UINT64> expected = queue.keys();
+    start = secondsNow();
+    std::sort(expected.begin(), expected.end());
+    double stdSortSeconds = secondsNow() - start;
+
+    CountingRecorder recorder;
+    RenderStateStats unsorted = queue.record(pipelineRootSignatures, recorder, false);
+
+    const UINT threadCount = std::max(1u, std::thread::hardware_concurrency());
+    double radixSeconds[2] = {};
+    bool matches = true;
+    for (UINT run = 0; run < 2; run++) {
+        queue.reset();
+        for (const DrawPacket& packet : packets) {
+            queue.submit(packet);
+        }
+        start = secondsNow();
+        queue.sort(run == 0 ? 1 : threadCount);
+        radixSeconds[run] = secondsNow() - start;
+        matches = matches && queue.keys() == expected;
+    }
+
+    start = secondsNow();
+    RenderStateStats sorted = queue.record(pipelineRootSignatures, recorder);
+    double recordSeconds = secondsNow() - start;
+
+    const UINT64 naive = sorted.draws * 3;
+    char report[1024];
+    snprintf(report, sizeof(report),
+        "Render queue: %u packets, %u pipelines on 4 root signatures, %u materials\n"
+        "Submit: %.2f ms\n"
+        "Sort: std::sort %.2f ms, radix %.2f ms on 1 thread, %.2f ms on %u threads (%s)\n"
+        "Binds: %llu rebinding every draw, %llu filtered in submission order, %llu filtered in key order\n"
+        "  root signatures %llu, pipelines %llu, tables %llu; %.1f%% of binds saved\n"
+        "Record: %.2f ms\n",
+        packetCount, pipelineCount, materialCount,
+        submitSeconds * 1000.0,
+        stdSortSeconds * 1000.0, radixSeconds[0] * 1000.0, radixSeconds[1] * 1000.0, threadCount,
+        matches ? "order matches std::sort" : "ORDER MISMATCH",
+        naive, unsorted.bindings(), sorted.bindings(),
+        sorted.rootSignatures, sorted.pipelines, sorted.tables, 100.0 * (naive - sorted.bindings()) / naive,
+        recordSeconds * 1000.0);
+    return report;
+}
+
+// Records a sorted queue into a D3D12 command list. Tables are indexed by material from the
+// start of the shader visible heap; the draw's root constants go to parameter 1.
+struct CommandListRecorder {
+    void setRootSignature(UINT index) { commandList->SetGraphicsRootSignature(rootSignatures[index]); }
+    void setPipeline(UINT index) { commandList->SetPipelineState(pipelines[index]); }
+
+    void setTable(UINT index) {
+        D3D12_GPU_DESCRIPTOR_HANDLE table = tableStart;
+        table.ptr += (UINT64)index * tableStride;
+        commandList->SetGraphicsRootDescriptorTable(0, table);
+    }
+
+    void draw(const DrawPacket& packet) {
+        commandList->SetGraphicsRoot32BitConstants(1, drawConstantCount, packet.constants, 0);
+        commandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+    }
+
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12RootSignature* const* rootSignatures = nullptr;
+    ID3D12PipelineState* const* pipelines = nullptr;
+    D3D12_GPU_DESCRIPTOR_HANDLE tableStart = {};
+    UINT tableStride = 0;
+};
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = materialCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+        // Create Depth Buffer, so opaque draws sorted front to back can reject hidden pixels early
+        {
+            D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
+            dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+            dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+            dsvHeapDesc.NumDescriptors = 1;
+            _ThrowIfFailed(mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&mDSVHeap)));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+            D3D12_RESOURCE_DESC depthDesc = {};
+            depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            depthDesc.Width = windowWidth;
+            depthDesc.Height = windowHeight;
+            depthDesc.DepthOrArraySize = 1;
+            depthDesc.MipLevels = 1;
+            depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+            depthDesc.SampleDesc.Count = 1;
+            depthDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+            D3D12_CLEAR_VALUE clearValue = {};
+            clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+            clearValue.DepthStencil.Depth = 1.0f;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &depthDesc,
+                D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                &clearValue,
+                IID_PPV_ARGS(&mDepthBuffer)));
+            mDevice->CreateDepthStencilView(mDepthBuffer.Get(), nullptr, mDSVHeap->GetCPUDescriptorHandleForHeapStart());
+        }
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.0f;
+            mViewport.MaxDepth = 1.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->buildQueue();
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = drawConstantCount;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = drawConstantCount;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/012-render-queue.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/012-render-queue.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline States
+        for (UINT pipeline = 0; pipeline < PipelineCount; pipeline++) {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            if (pipeline != PipelineOpaque) {
+                psoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+                psoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+                psoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+                psoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+                psoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+                psoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+                psoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+            }
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            // Blended draws test against the opaque depth but do not write it; the overlay ignores it.
+            psoDesc.DepthStencilState.DepthEnable = pipeline != PipelineOverlay;
+            psoDesc.DepthStencilState.DepthWriteMask = pipeline == PipelineOpaque ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
+            psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+            psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineStates[pipeline])));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineStates[PipelineOpaque].Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            // A unit quad; every draw places it with its root constants.
+            Vertex triangleVertices[] = {
+                { { 0.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 0.0f} },
+                { { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 1.0f} },
+                { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 1.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Textures, one descriptor table per material
+        for (UINT material = 0; material < materialCount; material++) {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight, UINT cells, const UINT8* color)->void
+            {
+                image.resize(textureWidth * textureHeight * 4);
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT y = 0; y < textureHeight; y++) {
+                    for (UINT x = 0; x < textureWidth; x++) {
+                        bool dark = (x * cells / textureWidth) % 2 == (y * cells / textureHeight) % 2;
+                        UINT8* texel = pData + (y * textureWidth + x) * 4;
+                        texel[0] = dark ? color[0] / 3 : color[0];
+                        texel[1] = dark ? color[1] / 3 : color[1];
+                        texel[2] = dark ? color[2] / 3 : color[2];
+                        texel[3] = 0xff;
+                    }
+                }
+            };
+
+            const UINT8 colors[materialCount][3] = {
+                { 0xff, 0xff, 0xff }, { 0xff, 0x60, 0x60 }, { 0x60, 0xff, 0x60 }, { 0x60, 0x60, 0xff },
+                { 0xff, 0xff, 0x60 }, { 0x60, 0xff, 0xff }, { 0xff, 0x60, 0xff }, { 0xff, 0xa0, 0x40 },
+            };
+
+            UINT width = 64;
+            UINT height = 64;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height, 2 + material, colors[material]);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(),
+                image, width, height, format,
+                mTextureResources[material], mTextureBuffers[material], material);
+        }
+
+        // Scene: quads at random depths, a few translucent ones and an overlay bar along the bottom
+        {
+            UINT seed = 2024;
+            auto random = [&seed]() -> float {
+                seed = seed * 1664525u + 1013904223u;
+                return (seed >> 8) / 16777216.0f;
+            };
+            for (UINT i = 0; i < opaqueQuadCount + blendedQuadCount; i++) {
+                SceneQuad quad;
+                quad.pass = i < opaqueQuadCount ? RenderPassOpaque : RenderPassBlended;
+                quad.pipeline = i < opaqueQuadCount ? PipelineOpaque : PipelineBlended;
+                quad.material = (UINT)(random() * materialCount) % materialCount;
+                quad.size = 0.04f + random() * 0.12f;
+                quad.x = random() * 2.0f - 1.0f - quad.size * 0.5f;
+                quad.y = random() * 2.0f - 1.0f - quad.size * 0.5f;
+                quad.depth = 0.05f + random() * 0.9f;
+                quad.phase = random() * 6.2831853f;
+                quad.alpha = i < opaqueQuadCount ? 1.0f : 0.5f;
+                mScene.push_back(quad);
+            }
+            for (UINT i = 0; i < overlayQuadCount; i++) {
+                SceneQuad quad;
+                quad.pass = RenderPassOverlay;
+                quad.pipeline = PipelineOverlay;
+                quad.material = i % materialCount;
+                quad.size = 1.8f / overlayQuadCount;
+                quad.x = -0.9f + i * quad.size;
+                quad.y = -0.98f;
+                quad.depth = 0.0f;
+                quad.phase = 0.0f;
+                quad.alpha = 0.8f;
+                mScene.push_back(quad);
+            }
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    // Submits every quad of the frame in scene order and lets the queue sort them.
+    void buildQueue() {
+        const float time = (float)secondsNow();
+        const float aspect = windowWidth / (windowHeight + 0.0f);
+        mQueue.reset();
+        for (const SceneQuad& quad : mScene) {
+            DrawPacket packet;
+            packet.pass = quad.pass;
+            packet.pipeline = quad.pipeline;
+            packet.material = quad.material;
+            packet.depth = quad.depth;
+            float sway = quad.pass == RenderPassOverlay ? 0.0f : 0.05f * sinf(time + quad.phase);
+            packet.constants[0] = quad.x + sway;
+            packet.constants[1] = quad.y;
+            packet.constants[2] = quad.size;
+            packet.constants[3] = quad.size * (quad.pass == RenderPassOverlay ? 0.5f : aspect);
+            packet.constants[4] = 1.0f;
+            packet.constants[5] = 1.0f;
+            packet.constants[6] = 1.0f;
+            packet.constants[7] = quad.alpha;
+            packet.constants[8] = quad.depth;
+            mQueue.submit(packet);
+        }
+        mQueue.sort(std::thread::hardware_concurrency());
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), nullptr));
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle{ mDSVHeap->GetCPUDescriptorHandleForHeapStart() };
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+
+        ID3D12RootSignature* rootSignatures[] = { mRootSignature.Get() };
+        ID3D12PipelineState* pipelines[PipelineCount];
+        UINT pipelineRootSignatures[PipelineCount];
+        for (UINT i = 0; i < PipelineCount; i++) {
+            pipelines[i] = mPipelineStates[i].Get();
+            pipelineRootSignatures[i] = 0;
+        }
+        CommandListRecorder recorder;
+        recorder.commandList = mCommandList.Get();
+        recorder.rootSignatures = rootSignatures;
+        recorder.pipelines = pipelines;
+        recorder.tableStart = mSRVHeap->GetGPUDescriptorHandleForHeapStart();
+        recorder.tableStride = mSRVHeapStride;
+        RenderStateStats stats = mQueue.record(pipelineRootSignatures, recorder);
+        if (mFrameCount++ % 600 == 0) {
+            debugLog("Render queue: %llu draws, %llu binds instead of %llu (root signatures %llu, pipelines %llu, tables %llu)\n",
+                stats.draws, stats.bindings(), stats.draws * 3, stats.rootSignatures, stats.pipelines, stats.tables);
+        }
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer,
+        UINT descriptorIndex)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = mSRVHeap->GetCPUDescriptorHandleForHeapStart();
+        srvHandle.ptr += descriptorIndex * mSRVHeapStride;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, srvHandle);
+    }
+
+private:
+    // One quad of the scene; its packet is rebuilt every frame.
+    struct SceneQuad {
+        UINT pass;
+        UINT pipeline;
+        UINT material;
+        float x;
+        float y;
+        float size;
+        float depth;
+        float phase;
+        float alpha;
+    };
+
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+    ComPtr<ID3D12DescriptorHeap> mDSVHeap;
+    ComPtr<ID3D12Resource> mDepthBuffer;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineStates[PipelineCount];
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResources[materialCount];
+    ComPtr<ID3D12Resource> mTextureBuffers[materialCount];
+
+    std::vector<SceneQuad> mScene;
+    RenderQueue mQueue;
+    UINT64 mFrameCount = 0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkRenderQueue();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
@@ -0,0 +1,1631 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <memory>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0015-FrameCapture";
+const char* windowClass = "0015-FrameCapture";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Frames before the measurement starts, and frames measured without capture before it is
+// switched on for the rest of the run.
+const UINT64 warmupFrames = 60;
+const UINT64 uncapturedFrames = 300;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// One captured frame as the encoder sees it: RGBA8 rows, rowPitch bytes apart.
+struct CaptureFrame {
+    const UINT8* pixels = nullptr;
+    UINT width = 0;
+    UINT height = 0;
+    UINT rowPitch = 0;
+    UINT64 frameIndex = 0;
+};
+
+enum CaptureFormat {
+    CaptureFormatRaw,  // One file per frame, tightly packed RGBA8
+    CaptureFormatPng,  // One file per frame
+    CaptureFormatY4m,  // One YUV4MPEG2 stream, readable while it grows
+};
+
+// Writes frames on the encoder thread. Returns the bytes written, 0 on failure.
+class CaptureWriter {
+public:
+    virtual ~CaptureWriter() {}
+    virtual size_t write(const CaptureFrame& frame) = 0;
+};
+
+class RawCaptureWriter : public CaptureWriter {
+public:
+    explicit RawCaptureWriter(const std::string& directory) : mDirectory(directory) {}
+
+    size_t write(const CaptureFrame& frame) override {
+        char path[MAX_PATH];
+        snprintf(path, sizeof(path), "%s/frame_%05llu.raw", mDirectory.c_str(), frame.frameIndex);
+        FILE* fd = NULL;
+        fopen_s(&fd, path, "wb");
+        if (fd == NULL) {
+            return 0;
+        }
+        const size_t rowSize = frame.width * 4;
+        size_t written = 0;
+        for (UINT y = 0; y < frame.height; y++) {
+            written += fwrite(frame.pixels + (size_t)y * frame.rowPitch, 1, rowSize, fd);
+        }
+        fclose(fd);
+        return written;
+    }
+
+private:
+    std::string mDirectory;
+};
+
+// PNG with a small built-in deflate: one-probe LZ77 over a 32 KB window and the fixed
+// Huffman codes, after the Up filter. Rendered frames are mostly flat, so this gets most
+// of zlib's ratio at a fraction of its cost and needs no library.
+class PngCaptureWriter : public CaptureWriter {
+public:
+    explicit PngCaptureWriter(const std::string& directory) : mDirectory(directory) {
+        for (UINT n = 0; n < 256; n++) {
+            UINT c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            mCrcTable[n] = c;
+        }
+    }
+
+    size_t write(const CaptureFrame& frame) override {
+        // Filtered scanlines: a filter byte, then the row minus the row above.
+        const size_t rowSize = frame.width * 4;
+        mFiltered.resize((rowSize + 1) * frame.height);
+        for (UINT y = 0; y < frame.height; y++) {
+            const UINT8* row = frame.pixels + (size_t)y * frame.rowPitch;
+            UINT8* out = &mFiltered[(rowSize + 1) * y];
+            if (y == 0) {
+                out[0] = 0;
+                memcpy(out + 1, row, rowSize);
+            } else {
+                const UINT8* above = row - frame.rowPitch;
+                out[0] = 2;
+                for (size_t i = 0; i < rowSize; i++) {
+                    out[i + 1] = (UINT8)(row[i] - above[i]);
+                }
+            }
+        }
+
+        mChunk.clear();
+        mChunk.push_back(0x78);
+        mChunk.push_back(0x01);
+        deflate(mFiltered.data(), mFiltered.size(), mChunk);
+        UINT adler = adler32(mFiltered.data(), mFiltered.size());
+        putBigEndian(mChunk, adler);
+
+        char path[MAX_PATH];
+        snprintf(path, sizeof(path), "%s/frame_%05llu.png", mDirectory.c_str(), frame.frameIndex);
+        FILE* fd = NULL;
+        fopen_s(&fd, path, "wb");
+        if (fd == NULL) {
+            return 0;
+        }
+        static const UINT8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        size_t written = fwrite(signature, 1, sizeof(signature), fd);
+
+        std::vector<UINT8> header;
+        putBigEndian(header, frame.width);
+        putBigEndian(header, frame.height);
+        header.push_back(8); // Bit depth
+        header.push_back(6); // RGBA
+        header.push_back(0);
+        header.push_back(0);
+        header.push_back(0);
+        written += writeChunk(fd, "IHDR", header.data(), header.size());
+        written += writeChunk(fd, "IDAT", mChunk.data(), mChunk.size());
+        written += writeChunk(fd, "IEND", nullptr, 0);
+        fclose(fd);
+        return written;
+    }
+
+private:
+    struct BitWriter {
+        std::vector<UINT8>& out;
+        UINT64 bits = 0;
+        UINT count = 0;
+
+        explicit BitWriter(std::vector<UINT8>& target) : out(target) {}
+
+        void put(UINT value, UINT length) {
+            bits |= (UINT64)value << count;
+            count += length;
+            while (count >= 8) {
+                out.push_back((UINT8)bits);
+                bits >>= 8;
+                count -= 8;
+            }
+        }
+
+        // Huffman codes go most significant bit first.
+        void putCode(UINT code, UINT length) {
+            UINT reversed = 0;
+            for (UINT i = 0; i < length; i++) {
+                reversed |= ((code >> i) & 1) << (length - 1 - i);
+            }
+            put(reversed, length);
+        }
+
+        void finish() {
+            if (count > 0) {
+                out.push_back((UINT8)bits);
+            }
+            bits = 0;
+            count = 0;
+        }
+    };
+
+    static void putLiteral(BitWriter& writer, UINT symbol) {
+        if (symbol < 144) {
+            writer.putCode(0x30 + symbol, 8);
+        } else if (symbol < 256) {
+            writer.putCode(0x190 + symbol - 144, 9);
+        } else if (symbol < 280) {
+            writer.putCode(symbol - 256, 7);
+        } else {
+            writer.putCode(0xc0 + symbol - 280, 8);
+        }
+    }
+
+    static void putMatch(BitWriter& writer, UINT length, UINT distance) {
+        static const UINT16 lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static const UINT8 lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        static const UINT16 distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        static const UINT8 distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        UINT code = 28;
+        while (lengthBase[code] > length) {
+            code--;
+        }
+        putLiteral(writer, 257 + code);
+        writer.put(length - lengthBase[code], lengthExtra[code]);
+
+        code = 29;
+        while (distanceBase[code] > distance) {
+            code--;
+        }
+        writer.putCode(code, 5);
+        writer.put(distance - distanceBase[code], distanceExtra[code]);
+    }
+
+    void deflate(const UINT8* data, size_t size, std::vector<UINT8>& out) {
+        const UINT hashBits = 15;
+        const size_t window = 32768;
+        const size_t maxMatch = 258;
+        mHeads.assign((size_t)1 << hashBits, SIZE_MAX);
+
+        BitWriter writer(out);
+        writer.put(1, 1); // Final block
+        writer.put(1, 2); // Fixed Huffman codes
+        size_t i = 0;
+        while (i < size) {
+            size_t length = 0;
+            size_t distance = 0;
+            if (i + 4 <= size) {
+                UINT word;
+                memcpy(&word, data + i, 4);
+                UINT hash = (word * 2654435761u) >> (32 - hashBits);
+                size_t candidate = mHeads[hash];
+                mHeads[hash] = i;
+                if (candidate != SIZE_MAX && i - candidate <= window && memcmp(data + candidate, data + i, 4) == 0) {
+                    size_t limit = std::min(maxMatch, size - i);
+                    length = 4;
+                    while (length < limit && data[candidate + length] == data[i + length]) {
+                        length++;
+                    }
+                    distance = i - candidate;
+                }
+            }
+            if (length > 0) {
+                putMatch(writer, (UINT)length, (UINT)distance);
+                i += length;
+            } else {
+                putLiteral(writer, data[i]);
+                i++;
+            }
+        }
+        putLiteral(writer, 256);
+        writer.finish();
+    }
+
+    static UINT adler32(const UINT8* data, size_t size) {
+        UINT a = 1;
+        UINT b = 0;
+        while (size > 0) {
+            size_t block = std::min(size, (size_t)5552);
+            size -= block;
+            while (block-- > 0) {
+                a += *data++;
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    static void putBigEndian(std::vector<UINT8>& out, UINT value) {
+        out.push_back((UINT8)(value >> 24));
+        out.push_back((UINT8)(value >> 16));
+        out.push_back((UINT8)(value >> 8));
+        out.push_back((UINT8)value);
+    }
+
+    size_t writeChunk(FILE* fd, const char* type, const UINT8* data, size_t size) {
+        std::vector<UINT8> header;
+        putBigEndian(header, (UINT)size);
+        header.insert(header.end(), type, type + 4);
+        UINT crc = 0xffffffffu;
+        for (size_t i = 4; i < 8; i++) {
+            crc = mCrcTable[(crc ^ header[i]) & 0xff] ^ (crc >> 8);
+        }
+        for (size_t i = 0; i < size; i++) {
+            crc = mCrcTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        }
+        std::vector<UINT8> footer;
+        putBigEndian(footer, crc ^ 0xffffffffu);
+
+        size_t written = fwrite(header.data(), 1, header.size(), fd);
+        if (size > 0) {
+            written += fwrite(data, 1, size, fd);
+        }
+        return written + fwrite(footer.data(), 1, footer.size(), fd);
+    }
+
+    std::string mDirectory;
+    UINT mCrcTable[256];
+    std::vector<UINT8> mFiltered;
+    std::vector<UINT8> mChunk;
+    std::vector<size_t> mHeads;
+};
+
+// YUV4MPEG2 with full range BT.601 4:2:0, which most players and encoders read directly.
+// The header is written with the first frame and every frame is flushed, so the file can
+// be tailed or piped while the sample runs.
+class Y4mCaptureWriter : public CaptureWriter {
+public:
+    explicit Y4mCaptureWriter(const std::string& directory) : mPath(directory + "/capture.y4m") {}
+
+    ~Y4mCaptureWriter() {
+        if (mFile != NULL) {
+            fclose(mFile);
+        }
+    }
+
+    size_t write(const CaptureFrame& frame) override {
+        size_t written = 0;
+        if (mFile == NULL) {
+            fopen_s(&mFile, mPath.c_str(), "wb");
+            if (mFile == NULL) {
+                return 0;
+            }
+            char header[128];
+            int length = snprintf(header, sizeof(header), "YUV4MPEG2 W%u H%u F60:1 Ip A1:1 C420jpeg\n", frame.width, frame.height);
+            written += fwrite(header, 1, length, mFile);
+        }
+
+        const UINT chromaWidth = (frame.width + 1) / 2;
+        const UINT chromaHeight = (frame.height + 1) / 2;
+        mPlanes.resize((size_t)frame.width * frame.height + (size_t)chromaWidth * chromaHeight * 2);
+        UINT8* luma = mPlanes.data();
+        UINT8* cb = luma + (size_t)frame.width * frame.height;
+        UINT8* cr = cb + (size_t)chromaWidth * chromaHeight;
+
+        // Fixed point, 16 fractional bits.
+        for (UINT y = 0; y < frame.height; y++) {
+            const UINT8* row = frame.pixels + (size_t)y * frame.rowPitch;
+            for (UINT x = 0; x < frame.width; x++) {
+                const UINT8* p = row + x * 4;
+                luma[(size_t)y * frame.width + x] = (UINT8)((19595 * p[0] + 38470 * p[1] + 7471 * p[2] + 32768) >> 16);
+            }
+        }
+        for (UINT y = 0; y < chromaHeight; y++) {
+            const UINT8* row0 = frame.pixels + (size_t)(y * 2) * frame.rowPitch;
+            const UINT8* row1 = frame.pixels + (size_t)std::min(y * 2 + 1, frame.height - 1) * frame.rowPitch;
+            for (UINT x = 0; x < chromaWidth; x++) {
+                UINT x0 = x * 2 * 4;
+                UINT x1 = std::min(x * 2 + 1, frame.width - 1) * 4;
+                int r = (row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2;
+                int g = (row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1] + 2) >> 2;
+                int b = (row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2] + 2) >> 2;
+                int u = (-11059 * r - 21709 * g + 32768 * b + (128 << 16) + 32768) >> 16;
+                int v = (32768 * r - 27439 * g - 5329 * b + (128 << 16) + 32768) >> 16;
+                cb[(size_t)y * chromaWidth + x] = (UINT8)std::min(std::max(u, 0), 255);
+                cr[(size_t)y * chromaWidth + x] = (UINT8)std::min(std::max(v, 0), 255);
+            }
+        }
+
+        written += fwrite("FRAME\n", 1, 6, mFile);
+        written += fwrite(mPlanes.data(), 1, mPlanes.size(), mFile);
+        fflush(mFile);
+        return written;
+    }
+
+private:
+    std::string mPath;
+    FILE* mFile = NULL;
+    std::vector<UINT8> mPlanes;
+};
+
+std::unique_ptr<CaptureWriter> createCaptureWriter(CaptureFormat format, const std::string& directory) {
+    CreateDirectoryA(directory.c_str(), nullptr);
+    switch (format) {
+    case CaptureFormatPng:
+        return std::unique_ptr<CaptureWriter>(new PngCaptureWriter(directory));
+    case CaptureFormatY4m:
+        return std::unique_ptr<CaptureWriter>(new Y4mCaptureWriter(directory));
+    default:
+        return std::unique_ptr<CaptureWriter>(new RawCaptureWriter(directory));
+    }
+}
+
+struct CaptureEncoderStats {
+    UINT64 frames = 0;
+    UINT64 failures = 0;
+    UINT64 bytes = 0;
+    double encodeSeconds = 0.0;
+};
+
+// Writes frames on its own thread, in the order they were pushed. The finished callback
+// runs on that thread once a frame's pixels are no longer needed, so the caller can hand
+// the memory back without copying it first.
+class CaptureEncoder {
+public:
+    CaptureEncoder(std::unique_ptr<CaptureWriter> writer, std::function<void(UINT)> finished)
+        : mWriter(std::move(writer)), mFinished(finished)
+    {
+        mThread = std::thread([this]() { this->run(); });
+    }
+
+    ~CaptureEncoder() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mWake.notify_all();
+        mThread.join();
+    }
+
+    void push(const CaptureFrame& frame, UINT slot) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mJobs.push_back(Job{ frame, slot });
+        }
+        mWake.notify_all();
+    }
+
+    // Blocks until every pushed frame is written. Only for shutdown and the benchmark.
+    void flush() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdle.wait(lock, [this]() { return mJobs.empty() && !mBusy; });
+    }
+
+    CaptureEncoderStats stats() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+private:
+    struct Job {
+        CaptureFrame frame;
+        UINT slot;
+    };
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        for (;;) {
+            mWake.wait(lock, [this]() { return mStopping || !mJobs.empty(); });
+            if (mJobs.empty()) {
+                return;
+            }
+            Job job = mJobs.front();
+            mJobs.pop_front();
+            mBusy = true;
+            lock.unlock();
+
+            double start = secondsNow();
+            size_t bytes = mWriter->write(job.frame);
+            double seconds = secondsNow() - start;
+            mFinished(job.slot);
+
+            lock.lock();
+            mBusy = false;
+            mStats.frames++;
+            mStats.failures += bytes == 0 ? 1 : 0;
+            mStats.bytes += bytes;
+            mStats.encodeSeconds += seconds;
+            if (mJobs.empty()) {
+                mIdle.notify_all();
+            }
+        }
+    }
+
+    std::unique_ptr<CaptureWriter> mWriter;
+    std::function<void(UINT)> mFinished;
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mIdle;
+    std::deque<Job> mJobs;
+    bool mBusy = false;
+    bool mStopping = false;
+    CaptureEncoderStats mStats;
+};
+
+// Encodes 120 synthetic 800x600 frames in each format through the encoder thread.
+std::string benchmarkCaptureEncoding() {
+    const UINT width = 800;
+    const UINT height = 600;
+    const UINT frameCount = 120;
+    const UINT rowPitch = (width * 4 + 255) & ~255u;
+    std::vector<UINT8> pixels((size_t)rowPitch * height);
+
+    const char* names[] = { "raw", "png", "y4m" };
+    std::string report = "Capture encoding, 120 frames of 800x600:\n";
+    for (UINT format = CaptureFormatRaw; format <= CaptureFormatY4m; format++) {
+        CaptureEncoder encoder(createCaptureWriter((CaptureFormat)format, std::string("captures-benchmark-") + names[format]),
+            [](UINT) {});
+
+        double start = secondsNow();
+        for (UINT frame = 0; frame < frameCount; frame++) {
+            // A flat background with a moving checkered square, like the sample's frames.
+            for (UINT y = 0; y < height; y++) {
+                UINT8* row = pixels.data() + (size_t)y * rowPitch;
+                for (UINT x = 0; x < width; x++) {
+                    bool inside = x - (frame * 4) % width < 200 && y - 200 < 200;
+                    bool dark = ((x / 25) + (y / 25)) % 2 == 0;
+                    row[x * 4 + 0] = inside ? (dark ? 0 : 255) : 0;
+                    row[x * 4 + 1] = inside ? (dark ? 0 : 255) : 51;
+                    row[x * 4 + 2] = inside ? (dark ? 0 : 255) : 102;
+                    row[x * 4 + 3] = 255;
+                }
+            }
+            CaptureFrame captureFrame;
+            captureFrame.pixels = pixels.data();
+            captureFrame.width = width;
+            captureFrame.height = height;
+            captureFrame.rowPitch = rowPitch;
+            captureFrame.frameIndex = frame;
+            encoder.push(captureFrame, frame);
+            encoder.flush();
+        }
+        double seconds = secondsNow() - start;
+        CaptureEncoderStats stats = encoder.stats();
+
+        char line[256];
+        snprintf(line, sizeof(line), "  %s: %.2f ms/frame encoding, %.0f KB/frame, %llu failed (%.2f s total)\n",
+            names[format], stats.encodeSeconds * 1000.0 / stats.frames, stats.bytes / 1024.0 / stats.frames,
+            stats.failures, seconds);
+        report += line;
+    }
+    return report;
+}
+
+// Copies back buffers into a ring of READBACK buffers and hands each one to the encoder
+// once the GPU is past it. Nothing here waits: a frame is dropped when every slot is
+// still being copied or encoded, and poll only looks at fences that already completed.
+class FrameCapture {
+public:
+    void init(ID3D12Device* device, UINT width, UINT height, DXGI_FORMAT format, CaptureFormat captureFormat, const std::string& directory) {
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+
+        UINT64 bufferSize = 0;
+        device->GetCopyableFootprints(&textureDesc, 0, 1, 0, &mFootprint, nullptr, nullptr, &bufferSize);
+        mWidth = width;
+        mHeight = height;
+        mBufferSize = (SIZE_T)bufferSize;
+
+        D3D12_HEAP_PROPERTIES heapProperties = {};
+        heapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Width = bufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+        for (UINT i = 0; i < captureSlotCount; i++) {
+            _ThrowIfFailed(device->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_COPY_DEST,
+                nullptr,
+                IID_PPV_ARGS(&mSlots[i].buffer)));
+            mSlots[i].state = SlotFree;
+        }
+
+        mEncoder.reset(new CaptureEncoder(createCaptureWriter(captureFormat, directory), [this](UINT slot) {
+            D3D12_RANGE writtenRange = { 0, 0 };
+            mSlots[slot].buffer->Unmap(0, &writtenRange);
+            mSlots[slot].state.store(SlotFree, std::memory_order_release);
+        }));
+    }
+
+    // Copies the back buffer, which is in stateBefore, and leaves it in stateAfter. The copy
+    // is ready once fenceValue completes. Returns false when the frame was dropped, in
+    // which case the back buffer is left alone.
+    bool record(ID3D12GraphicsCommandList* commandList, ID3D12Resource* backBuffer,
+        D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter, UINT64 fenceValue)
+    {
+        const UINT64 frameIndex = mFrameIndex++;
+        Slot& slot = mSlots[mNextSlot];
+        if (slot.state.load(std::memory_order_acquire) != SlotFree) {
+            mDropped++;
+            return false;
+        }
+
+        D3D12_RESOURCE_BARRIER toCopy = {};
+        toCopy.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        toCopy.Transition.pResource = backBuffer;
+        toCopy.Transition.Subresource = 0;
+        toCopy.Transition.StateBefore = stateBefore;
+        toCopy.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        commandList->ResourceBarrier(1, &toCopy);
+
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = backBuffer;
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        srcLocation.SubresourceIndex = 0;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = slot.buffer.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        dstLocation.PlacedFootprint = mFootprint;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER toAfter = toCopy;
+        toAfter.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        toAfter.Transition.StateAfter = stateAfter;
+        commandList->ResourceBarrier(1, &toAfter);
+
+        slot.fenceValue = fenceValue;
+        slot.frameIndex = frameIndex;
+        slot.state.store(SlotCopying, std::memory_order_relaxed);
+        mNextSlot = (mNextSlot + 1) % captureSlotCount;
+        mCaptured++;
+        return true;
+    }
+
+    // Hands every copy the GPU has finished to the encoder, oldest first.
+    void poll(UINT64 completedFenceValue) {
+        for (;;) {
+            Slot& slot = mSlots[mPollSlot];
+            if (slot.state.load(std::memory_order_relaxed) != SlotCopying || slot.fenceValue > completedFenceValue) {
+                return;
+            }
+
+            void* data = nullptr;
+            D3D12_RANGE readRange = { 0, mBufferSize };
+            _ThrowIfFailed(slot.buffer->Map(0, &readRange, &data));
+            slot.state.store(SlotEncoding, std::memory_order_relaxed);
+
+            CaptureFrame frame;
+            frame.pixels = (const UINT8*)data + mFootprint.Offset;
+            frame.width = mWidth;
+            frame.height = mHeight;
+            frame.rowPitch = mFootprint.Footprint.RowPitch;
+            frame.frameIndex = slot.frameIndex;
+            mEncoder->push(frame, mPollSlot);
+            mPollSlot = (mPollSlot + 1) % captureSlotCount;
+        }
+    }
+
+    // Call with the GPU idle; writes out whatever is still in flight.
+    void flush(UINT64 completedFenceValue) {
+        this->poll(completedFenceValue);
+        mEncoder->flush();
+    }
+
+    UINT64 captured() const { return mCaptured; }
+    UINT64 dropped() const { return mDropped; }
+    CaptureEncoderStats encoderStats() { return mEncoder->stats(); }
+
+private:
+    static const UINT captureSlotCount = 4;
+
+    enum SlotState {
+        SlotFree,
+        SlotCopying,
+        SlotEncoding,
+    };
+
+    struct Slot {
+        ComPtr<ID3D12Resource> buffer;
+        UINT64 fenceValue = 0;
+        UINT64 frameIndex = 0;
+        std::atomic<UINT> state{ SlotFree };
+    };
+
+    Slot mSlots[captureSlotCount];
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT mFootprint = {};
+    UINT mWidth = 0;
+    UINT mHeight = 0;
+    SIZE_T mBufferSize = 0;
+    UINT mNextSlot = 0;
+    UINT mPollSlot = 0;
+    UINT64 mFrameIndex = 0;
+    UINT64 mCaptured = 0;
+    UINT64 mDropped = 0;
+    std::unique_ptr<CaptureEncoder> mEncoder;
+};
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    // Captures every frame after the uncaptured measurement window.
+    void enableCapture(CaptureFormat format, const std::string& directory) {
+        mCapture.init(mDevice.Get(), windowWidth, windowHeight, DXGI_FORMAT_R8G8B8A8_UNORM, format, directory);
+        mCaptureEnabled = true;
+    }
+
+    void quit() {
+        this->waitForGPU();
+        if (mCaptureEnabled) {
+            mCapture.flush(mFence->GetCompletedValue());
+        }
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        // Frame time is measured present to present, split by whether capture was on.
+        double now = secondsNow();
+        if (mFrameNumber > warmupFrames) {
+            int window = mCapturing ? 1 : 0;
+            mFrameSeconds[window] += now - mLastTickTime;
+            mMeasuredFrames[window]++;
+        }
+        mLastTickTime = now;
+        mFrameNumber++;
+        mCapturing = mCaptureEnabled && mFrameNumber > warmupFrames + uncapturedFrames;
+        if (mCapturing) {
+            mCapture.poll(mFence->GetCompletedValue());
+        }
+
+        float angle = (float)(mFrameNumber % 360) * XM_2PI / 360.0f;
+        mOffset = XMFLOAT2(0.5f * cosf(angle), 0.5f * sinf(angle));
+
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 2;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 2;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/009-frame-clock.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/009-frame-clock.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            float aspect = windowWidth / (windowHeight + 0.0f);
+            Vertex triangleVertices[] = {
+                { { -0.25f, 0.25f * aspect, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f }, {0.0f, 1.0f} },
+                { { 0.25f, 0.25f * aspect, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f }, {1.0f, 1.0f} },
+                { { 0.25f, -0.25f * aspect, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { -0.25f, -0.25f * aspect, 0.0f }, { 1.0f, 1.0f, 0.0f, 1.0f }, {0.0f, 0.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0x00;    // R
+                        pData[n + 1] = 0x00;    // G
+                        pData[n + 2] = 0x00;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+        mCommandList->SetGraphicsRoot32BitConstants(1, 2, &mOffset, 0);
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+
+        // The capture copy also moves the back buffer to PRESENT; a dropped frame does not.
+        double captureStart = secondsNow();
+        bool captured = mCapturing && mCapture.record(mCommandList.Get(), mRenderTargets[mFrameBufferIndex].Get(),
+            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT, mFenceValues[mFrameBufferIndex]);
+        mCaptureSeconds += secondsNow() - captureStart;
+        if (!captured) {
+            D3D12_RESOURCE_BARRIER onEnd = {};
+            onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+            onEnd.Transition.Subresource = 0;
+            onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+            onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+            mCommandList->ResourceBarrier(1, &onEnd);
+        }
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    std::string captureReport() {
+        double off = mMeasuredFrames[0] > 0 ? mFrameSeconds[0] * 1000.0 / mMeasuredFrames[0] : 0.0;
+        double on = mMeasuredFrames[1] > 0 ? mFrameSeconds[1] * 1000.0 / mMeasuredFrames[1] : 0.0;
+        CaptureEncoderStats stats = mCapture.encoderStats();
+        char report[768];
+        snprintf(report, sizeof(report),
+            "Frame time: %.3f ms without capture (%llu frames), %.3f ms with capture (%llu frames), %+.1f%%\n"
+            "Capture on the render thread: %.3f ms/frame\n"
+            "Captured %llu frames, dropped %llu; encoder wrote %llu (%llu failed), %.2f ms/frame, %.1f MB\n",
+            off, mMeasuredFrames[0], on, mMeasuredFrames[1], off > 0.0 ? (on - off) * 100.0 / off : 0.0,
+            mMeasuredFrames[1] > 0 ? mCaptureSeconds * 1000.0 / mMeasuredFrames[1] : 0.0,
+            mCapture.captured(), mCapture.dropped(), stats.frames, stats.failures,
+            stats.frames > 0 ? stats.encodeSeconds * 1000.0 / stats.frames : 0.0, stats.bytes / (1024.0 * 1024.0));
+        return report;
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+
+    XMFLOAT2 mOffset = XMFLOAT2(0.0f, 0.0f);
+    FrameCapture mCapture;
+    bool mCaptureEnabled = false;
+    bool mCapturing = false;
+    UINT64 mFrameNumber = 0;
+    double mLastTickTime = 0.0;
+    double mFrameSeconds[2] = {};
+    UINT64 mMeasuredFrames[2] = {};
+    double mCaptureSeconds = 0.0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkCaptureEncoding();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        // -capture=raw, -capture=png or -capture=y4m
+        const char* captureOption = strstr(lpCmdLine, "-capture=");
+        bool capture = captureOption != nullptr;
+        CaptureFormat captureFormat = CaptureFormatRaw;
+        if (capture) {
+            captureOption += strlen("-capture=");
+            if (strncmp(captureOption, "png", 3) == 0) {
+                captureFormat = CaptureFormatPng;
+            } else if (strncmp(captureOption, "y4m", 3) == 0) {
+                captureFormat = CaptureFormatY4m;
+            }
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+        if (capture) {
+            graphics.enableCapture(captureFormat, "captures");
+        }
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        if (capture) {
+            std::string report = graphics.captureReport();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+        }
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
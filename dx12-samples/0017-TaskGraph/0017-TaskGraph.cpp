@@ -0,0 +1,1059 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0017-TaskGraph";
+const char* windowClass = "0017-TaskGraph";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Startup assets: a grid of procedural textures, one quad each.
+const UINT textureColumns = 4;
+const UINT textureRows = 2;
+const UINT textureCount = textureColumns * textureRows;
+const UINT textureSize = 512;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Work items with dependencies, run on a set of worker threads. A task starts as soon as
+// everything it depends on has finished; tasks may only depend on tasks added before them,
+// so the graph cannot have cycles. Start and end times are kept for the timeline report.
+class TaskGraph {
+public:
+    UINT add(const std::string& name, std::function<void()> work, std::initializer_list<UINT> dependencies = {}) {
+        return this->add(name, work, std::vector<UINT>(dependencies));
+    }
+
+    UINT add(const std::string& name, std::function<void()> work, const std::vector<UINT>& dependencies) {
+        const UINT id = (UINT)mTasks.size();
+        Task task;
+        task.name = name;
+        task.work = work;
+        task.dependencies = dependencies;
+        for (UINT dependency : dependencies) {
+            if (dependency >= id) {
+                throw std::exception("A task can only depend on tasks added before it");
+            }
+            mTasks[dependency].dependents.push_back(id);
+        }
+        mTasks.push_back(task);
+        return id;
+    }
+
+    // Runs every task and returns once all are done. If a task throws, the tasks that
+    // have not started yet are skipped and the first exception is rethrown here.
+    void run(UINT threadCount) {
+        mThreadCount = std::max(1u, threadCount);
+        std::vector<UINT> remaining(mTasks.size());
+        std::deque<UINT> ready;
+        for (UINT i = 0; i < (UINT)mTasks.size(); i++) {
+            remaining[i] = (UINT)mTasks[i].dependencies.size();
+            if (remaining[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        size_t finished = 0;
+        std::exception_ptr failure;
+        mRunStart = secondsNow();
+
+        auto worker = [&](UINT thread) {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                wake.wait(lock, [&]() { return !ready.empty() || finished == mTasks.size(); });
+                if (ready.empty()) {
+                    return;
+                }
+                const UINT id = ready.front();
+                ready.pop_front();
+                const bool skip = failure != nullptr;
+                lock.unlock();
+
+                Task& task = mTasks[id];
+                task.thread = thread;
+                task.start = secondsNow();
+                std::exception_ptr error;
+                if (!skip) {
+                    try {
+                        task.work();
+                    }
+                    catch (...) {
+                        error = std::current_exception();
+                    }
+                }
+                task.end = secondsNow();
+
+                lock.lock();
+                if (error != nullptr && failure == nullptr) {
+                    failure = error;
+                }
+                for (UINT dependent : task.dependents) {
+                    if (--remaining[dependent] == 0) {
+                        ready.push_back(dependent);
+                    }
+                }
+                finished++;
+                wake.notify_all();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (UINT thread = 1; thread < mThreadCount; thread++) {
+            threads.emplace_back(worker, thread);
+        }
+        worker(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        mRunEnd = secondsNow();
+
+        if (failure != nullptr) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    // The chain of dependent tasks with the largest total duration, as measured. No number
+    // of threads can finish the graph sooner.
+    double criticalPath(std::vector<UINT>* path = nullptr) const {
+        std::vector<double> finish(mTasks.size(), 0.0);
+        std::vector<UINT> previous(mTasks.size(), UINT_MAX);
+        UINT last = UINT_MAX;
+        for (UINT i = 0; i < (UINT)mTasks.size(); i++) {
+            double start = 0.0;
+            for (UINT dependency : mTasks[i].dependencies) {
+                if (finish[dependency] > start) {
+                    start = finish[dependency];
+                    previous[i] = dependency;
+                }
+            }
+            finish[i] = start + (mTasks[i].end - mTasks[i].start);
+            if (last == UINT_MAX || finish[i] > finish[last]) {
+                last = i;
+            }
+        }
+        if (path != nullptr) {
+            path->clear();
+            for (UINT i = last; i != UINT_MAX; i = previous[i]) {
+                path->insert(path->begin(), i);
+            }
+        }
+        return last == UINT_MAX ? 0.0 : finish[last];
+    }
+
+    // One line per task in start order, with a bar on a shared time axis; tasks on the
+    // critical path are marked with '*'.
+    std::string report() const {
+        const int barWidth = 48;
+        const double wall = std::max(mRunEnd - mRunStart, 1e-9);
+        double serial = 0.0;
+        for (const Task& task : mTasks) {
+            serial += task.end - task.start;
+        }
+        std::vector<UINT> path;
+        const double critical = this->criticalPath(&path);
+
+        char line[256];
+        std::string report;
+        snprintf(line, sizeof(line), "Startup: %u tasks on %u threads, %.2f ms wall, %.2f ms of work, critical path %.2f ms\n",
+            (UINT)mTasks.size(), mThreadCount, wall * 1000.0, serial * 1000.0, critical * 1000.0);
+        report += line;
+
+        std::vector<UINT> order(mTasks.size());
+        for (UINT i = 0; i < (UINT)order.size(); i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this](UINT a, UINT b) { return mTasks[a].start < mTasks[b].start; });
+        for (UINT id : order) {
+            const Task& task = mTasks[id];
+            int begin = (int)((task.start - mRunStart) / wall * barWidth);
+            int end = std::max(begin + 1, (int)((task.end - mRunStart) / wall * barWidth + 0.5));
+            std::string bar(barWidth, ' ');
+            for (int i = begin; i < std::min(end, barWidth); i++) {
+                bar[i] = '#';
+            }
+            bool onPath = std::find(path.begin(), path.end(), id) != path.end();
+            snprintf(line, sizeof(line), "%c %-28s T%-2u %8.2f +%7.2f ms |%s|\n",
+                onPath ? '*' : ' ', task.name.c_str(), task.thread,
+                (task.start - mRunStart) * 1000.0, (task.end - task.start) * 1000.0, bar.c_str());
+            report += line;
+        }
+
+        report += "Critical path:";
+        for (size_t i = 0; i < path.size(); i++) {
+            report += i == 0 ? " " : " -> ";
+            report += mTasks[path[i]].name;
+        }
+        report += "\n";
+        return report;
+    }
+
+private:
+    struct Task {
+        std::string name;
+        std::function<void()> work;
+        std::vector<UINT> dependencies;
+        std::vector<UINT> dependents;
+        UINT thread = 0;
+        double start = 0.0;
+        double end = 0.0;
+    };
+
+    std::vector<Task> mTasks;
+    UINT mThreadCount = 1;
+    double mRunStart = 0.0;
+    double mRunEnd = 0.0;
+};
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle, UINT startupThreads) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = textureCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets(startupThreads);
+
+        double uploadStart = secondsNow();
+        this->waitForGPU();
+        char line[128];
+        snprintf(line, sizeof(line), "GPU upload wait: %.2f ms\n", (secondsNow() - uploadStart) * 1000.0);
+        mStartupReport += line;
+        debugLog("%s", mStartupReport.c_str());
+    }
+
+    const std::string& startupReport() const { return mStartupReport; }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    // Startup as a task graph: root signature serialization, shader compiles, buffer fills
+    // and texture generation run side by side, the PSO waits only for its inputs, and one
+    // task records every upload once all staging buffers are filled.
+    void createAssets(UINT threadCount) {
+        TaskGraph graph;
+
+        ComPtr<ID3DBlob> rootSignatureBlob;
+        UINT serializeRootSignature = graph.add("serialize root signature", [&]() {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            // The description is always 1.1; the serializer converts it when only 1.0 is supported.
+            D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+            descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+            descriptorRanges[0].NumDescriptors = 1;
+            descriptorRanges[0].BaseShaderRegister = 0;
+            descriptorRanges[0].RegisterSpace = 0;
+            descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+            D3D12_ROOT_PARAMETER1 parameters[2] = {};
+            parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+            parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+            parameters[0].DescriptorTable.pDescriptorRanges = descriptorRanges;
+            parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+            parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+            parameters[1].Constants.ShaderRegister = 0;
+            parameters[1].Constants.Num32BitValues = 2;
+            parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+            rootSignatureDesc.Desc_1_1.NumParameters = _countof(parameters);
+            rootSignatureDesc.Desc_1_1.pParameters = parameters;
+            rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+            rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+            rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+        });
+
+        UINT createRootSignature = graph.add("create root signature", [&]() {
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }, { serializeRootSignature });
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        UINT compileVertexShader = graph.add("compile vertex shader", [&]() {
+            this->compileShader("../shaders/009-frame-clock.hlsl", "vs_5_0", "VSMain", &vsCode);
+        });
+        UINT compilePixelShader = graph.add("compile pixel shader", [&]() {
+            this->compileShader("../shaders/009-frame-clock.hlsl", "ps_5_0", "PSMain", &psCode);
+        });
+
+        graph.add("create pipeline state", [&]() {
+            D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+            {
+                { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+                { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+                { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+            };
+
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }, { createRootSignature, compileVertexShader, compilePixelShader });
+
+        graph.add("vertex buffer", [&]() {
+            const float width = 2.0f / textureColumns - 0.05f;
+            const float height = 2.0f / textureRows - 0.05f;
+            Vertex triangleVertices[] = {
+                { { -0.5f * width, 0.5f * height, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 0.0f} },
+                { { 0.5f * width, 0.5f * height, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { 0.5f * width, -0.5f * height, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 1.0f} },
+                { { -0.5f * width, -0.5f * height, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 1.0f} }
+            };
+            this->createUploadBuffer(triangleVertices, sizeof(triangleVertices), mVertexBuffer);
+
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = sizeof(triangleVertices);
+        });
+
+        graph.add("index buffer", [&]() {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+            this->createUploadBuffer(indices, sizeof(indices), mIndexBuffer);
+
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = sizeof(indices);
+        });
+
+        // Each texture is generated, then staged: resource, staging buffer and SRV.
+        std::vector<UINT8> images[textureCount];
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprints[textureCount];
+        std::vector<UINT> stagedTextures;
+        for (UINT i = 0; i < textureCount; i++) {
+            UINT generate = graph.add("generate texture " + std::to_string(i), [&, i]() {
+                makeTextureData(images[i], textureSize, textureSize, i);
+            });
+            stagedTextures.push_back(graph.add("stage texture " + std::to_string(i), [&, i]() {
+                this->stageTexture(images[i], textureSize, textureSize, DXGI_FORMAT_R8G8B8A8_UNORM,
+                    mTextureResources[i], mTextureBuffers[i], footprints[i], i);
+            }, { generate }));
+        }
+
+        graph.add("record uploads", [&]() {
+            _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                mCommandAllocators[mFrameBufferIndex].Get(),
+                nullptr,
+                IID_PPV_ARGS(&mCommandList)));
+            for (UINT i = 0; i < textureCount; i++) {
+                this->recordTextureUpload(mCommandList.Get(), mTextureResources[i].Get(), mTextureBuffers[i].Get(), footprints[i]);
+            }
+            _ThrowIfFailed(mCommandList->Close());
+            ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+            mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+        }, stagedTextures);
+
+        graph.run(threadCount);
+        mStartupReport = graph.report();
+    }
+
+    // Procedural pattern, different for every index; costly enough to be worth spreading.
+    static void makeTextureData(std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight, UINT index)
+    {
+        image.resize(textureWidth * textureHeight * 4);
+        const float frequency = 6.0f + 3.0f * index;
+        const float phase = 0.7f * index;
+        UINT8* pData = image.data();
+        for (UINT y = 0; y < textureHeight; y++) {
+            for (UINT x = 0; x < textureWidth; x++) {
+                float u = x / (float)textureWidth - 0.5f;
+                float v = y / (float)textureHeight - 0.5f;
+                float radius = sqrtf(u * u + v * v);
+                float angle = atan2f(v, u);
+                float rings = 0.5f + 0.5f * sinf(radius * frequency * 6.2831853f + phase);
+                float spokes = 0.5f + 0.5f * cosf(angle * (3.0f + index) + radius * 8.0f);
+                UINT8* texel = pData + (y * textureWidth + x) * 4;
+                texel[0] = (UINT8)(255.0f * rings);
+                texel[1] = (UINT8)(255.0f * spokes);
+                texel[2] = (UINT8)(255.0f * (rings * spokes));
+                texel[3] = 0xff;
+            }
+        }
+    }
+
+    void createUploadBuffer(const void* data, UINT64 size, ComPtr<ID3D12Resource>& buffer) {
+        D3D12_HEAP_PROPERTIES heapProperties = {};
+        heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = size;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&buffer)));
+
+        void* dataPtr = NULL;
+        D3D12_RANGE readRange = { 0, 0 };
+        _ThrowIfFailed(buffer->Map(0, &readRange, &dataPtr));
+        memcpy(dataPtr, data, (size_t)size);
+        buffer->Unmap(0, nullptr);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        for (UINT i = 0; i < textureCount; i++) {
+            D3D12_GPU_DESCRIPTOR_HANDLE table = mSRVHeap->GetGPUDescriptorHandleForHeapStart();
+            table.ptr += (UINT64)i * mSRVHeapStride;
+            XMFLOAT2 offset(
+                -1.0f + (i % textureColumns + 0.5f) * 2.0f / textureColumns,
+                1.0f - (i / textureColumns + 0.5f) * 2.0f / textureRows);
+            mCommandList->SetGraphicsRootDescriptorTable(0, table);
+            mCommandList->SetGraphicsRoot32BitConstants(1, 2, &offset, 0);
+            mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+        }
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    // Creates the texture, its filled staging buffer and its SRV. Touches no command list,
+    // so any number of textures can be staged at once; the copy is recorded later.
+    void stageTexture(
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer,
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT& uploadFootprint,
+        UINT descriptorIndex)
+    {
+        ID3D12Device* device = mDevice.Get();
+
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = mSRVHeap->GetCPUDescriptorHandleForHeapStart();
+        srvHandle.ptr += descriptorIndex * mSRVHeapStride;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, srvHandle);
+    }
+
+    void recordTextureUpload(
+        ID3D12GraphicsCommandList* commandList,
+        ID3D12Resource* textureResource,
+        ID3D12Resource* uploadBuffer,
+        const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& uploadFootprint)
+    {
+        // 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer;
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource;
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource;
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        commandList->ResourceBarrier(1, &onFinish);
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResources[textureCount];
+    ComPtr<ID3D12Resource> mTextureBuffers[textureCount];
+
+    std::string mStartupReport;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        // -serial-startup runs the same graph on one thread, for comparison.
+        UINT startupThreads = std::max(1u, std::thread::hardware_concurrency());
+        if (strstr(lpCmdLine, "-serial-startup") != nullptr) {
+            startupThreads = 1;
+        }
+
+        Graphics graphics;
+        graphics.init(hWnd, startupThreads);
+        if (strstr(lpCmdLine, "-startup-report") != nullptr) {
+            MessageBoxA(NULL, graphics.startupReport().c_str(), windowTitle, 0);
+        }
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
@@ -0,0 +1,1452 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+#include <emmintrin.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0019-Particles";
+const char* windowClass = "0019-Particles";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Particle budget for the sample; the fountain keeps about 90% of it alive.
+const UINT particleCapacity = 262144;
+// Particles per chunk, the unit of parallel simulation work.
+const UINT particleChunkSize = 8192;
+// Side of the round sprite texture
+const UINT spriteSize = 64;
+// How often the particle timings go to the debug output
+const UINT64 particleReportFrames = 120;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Small fork-join pool. run() splits [0, count) into chunks that the workers and the calling
+// thread pull from an atomic counter, and returns once every chunk is done. The job is passed
+// as a function pointer plus context, so dispatching allocates nothing.
+class ParallelFor {
+public:
+    void start(UINT workerCount) {
+        for (UINT i = 0; i < workerCount; i++) {
+            mWorkers.push_back(std::thread([this]() { this->worker(); }));
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+        for (std::thread& worker : mWorkers) {
+            worker.join();
+        }
+        mWorkers.clear();
+    }
+
+    UINT workerCount() const { return (UINT)mWorkers.size(); }
+
+    template<typename F>
+    void run(UINT count, UINT chunkSize, const F& fn) {
+        if (mWorkers.empty() || count <= chunkSize) {
+            fn(0, count);
+            return;
+        }
+        this->dispatch(count, chunkSize, [](const void* context, UINT begin, UINT end) { (*(const F*)context)(begin, end); }, &fn);
+    }
+
+private:
+    typedef void (*JobFunction)(const void* context, UINT begin, UINT end);
+
+    void dispatch(UINT count, UINT chunkSize, JobFunction function, const void* context) {
+        {
+            // Wait for stragglers of the previous job before the job fields are replaced.
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait(lock, [this]() { return mActive == 0; });
+            mFunction = function;
+            mContext = context;
+            mCount = count;
+            mChunkSize = chunkSize;
+            mNextChunk = 0;
+            mGeneration++;
+        }
+        mWake.notify_all();
+
+        this->work();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mActive == 0; });
+    }
+
+    void work() {
+        UINT chunkCount = (mCount + mChunkSize - 1) / mChunkSize;
+        for (;;) {
+            UINT chunk = mNextChunk++;
+            if (chunk >= chunkCount) {
+                return;
+            }
+            UINT begin = chunk * mChunkSize;
+            mFunction(mContext, begin, std::min(begin + mChunkSize, mCount));
+        }
+    }
+
+    void worker() {
+        UINT64 seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [&]() { return mStop || mGeneration != seen; });
+                if (mStop) {
+                    return;
+                }
+                seen = mGeneration;
+                mActive++;
+            }
+
+            this->work();
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mActive == 0) {
+                mDone.notify_all();
+            }
+        }
+    }
+
+private:
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    JobFunction mFunction = nullptr;
+    const void* mContext = nullptr;
+    UINT mCount = 0;
+    UINT mChunkSize = 1;
+    std::atomic<UINT> mNextChunk;
+    UINT64 mGeneration = 0;
+    UINT mActive = 0;
+    bool mStop = false;
+};
+
+// A float array on a 16 byte boundary, so four lanes load and store as one SSE register.
+class AlignedFloats {
+public:
+    AlignedFloats() = default;
+    AlignedFloats(const AlignedFloats&) = delete;
+    AlignedFloats& operator=(const AlignedFloats&) = delete;
+    ~AlignedFloats() { _aligned_free(mData); }
+
+    void resize(UINT count) {
+        _aligned_free(mData);
+        mData = (float*)_aligned_malloc(count * sizeof(float), 16);
+        if (mData == nullptr) {
+            throw std::bad_alloc();
+        }
+        memset(mData, 0, count * sizeof(float));
+    }
+
+    float* data() { return mData; }
+    const float* data() const { return mData; }
+
+private:
+    float* mData = nullptr;
+};
+
+struct ParticleEmitter {
+    float x = 0.0f;
+    float y = 0.0f;
+    float radius = 0.0f;
+    // Unit vector the particles leave along; spread is the tangent of the cone's half angle.
+    float directionX = 0.0f;
+    float directionY = 1.0f;
+    float spread = 0.3f;
+    float speedMin = 0.5f;
+    float speedMax = 1.0f;
+    float lifeMin = 1.0f;
+    float lifeMax = 2.0f;
+    float sizeMin = 0.01f;
+    float sizeMax = 0.02f;
+    // Particles per second
+    float rate = 1000.0f;
+};
+
+struct ParticleForces {
+    float gravityX = 0.0f;
+    float gravityY = -1.0f;
+    // Fraction of the velocity lost per second
+    float drag = 0.1f;
+};
+
+// What the vertex shader reads per particle: 16 bytes, four to a cache line.
+struct ParticleInstance {
+    float x;
+    float y;
+    float size;
+    UINT color;
+};
+
+// Particles in structure-of-arrays form, split into fixed-size chunks that are simulated
+// independently: each chunk emits into its own free tail, integrates four particles per SSE
+// instruction, and compacts its dead particles away with an unconditional copy whose write
+// index only advances for survivors. write() prefix-sums the chunk counts and each chunk
+// streams its instances into its own range of the output, so chunks never share memory.
+class ParticleSystem {
+public:
+    void init(UINT capacity, UINT chunkSize, UINT seed) {
+        mChunkSize = (std::max(chunkSize, 4u) + 3) & ~3u;
+        mChunkStride = mChunkSize + 4;
+        mChunkCount = (capacity + mChunkSize - 1) / mChunkSize;
+        UINT total = mChunkCount * mChunkStride;
+        for (AlignedFloats* stream : { &mPositionX, &mPositionY, &mVelocityX, &mVelocityY, &mAge, &mLife, &mSize }) {
+            stream->resize(total);
+        }
+        mCounts.assign(mChunkCount, 0);
+        mOffsets.assign(mChunkCount, 0);
+        mEmitted.assign(mChunkCount, 0);
+        mRandom.resize(mChunkCount * 4);
+        for (UINT i = 0; i < mChunkCount * 4; i++) {
+            // Any non-zero start works for xorshift; mix the seed so lanes and chunks differ.
+            UINT state = (seed + i) * 2654435761u;
+            mRandom[i] = state != 0 ? state : 1;
+        }
+        mEmitCarry = 0.0f;
+    }
+
+    UINT capacity() const { return mChunkCount * mChunkSize; }
+
+    UINT aliveCount() const {
+        UINT count = 0;
+        for (UINT chunkCount : mCounts) {
+            count += chunkCount;
+        }
+        return count;
+    }
+
+    // Ages, moves and retires the live particles, then emits this step's share of new ones
+    // into the space that freed up. Returns how many were emitted.
+    UINT update(float dt, const ParticleEmitter& emitter, const ParticleForces& forces, ParallelFor& pool) {
+        float wanted = mEmitCarry + emitter.rate * dt;
+        UINT emit = (UINT)wanted;
+        mEmitCarry = wanted - emit;
+
+        pool.run(mChunkCount, 1, [&](UINT begin, UINT end) {
+            for (UINT chunk = begin; chunk < end; chunk++) {
+                UINT quota = emit / mChunkCount + (chunk < emit % mChunkCount ? 1 : 0);
+                this->simulateChunk(chunk, dt, forces);
+                mEmitted[chunk] = this->emitChunk(chunk, quota, emitter);
+            }
+        });
+
+        UINT emitted = 0;
+        for (UINT count : mEmitted) {
+            emitted += count;
+        }
+        return emitted;
+    }
+
+    // Writes one instance per live particle; the colour runs from startColor to endColor over
+    // the particle's life and fades out. out must be 16 byte aligned and hold capacity()
+    // instances. Returns the instance count.
+    UINT write(ParticleInstance* out, const XMFLOAT4& startColor, const XMFLOAT4& endColor, ParallelFor& pool) {
+        UINT total = 0;
+        for (UINT chunk = 0; chunk < mChunkCount; chunk++) {
+            mOffsets[chunk] = total;
+            total += mCounts[chunk];
+        }
+
+        pool.run(mChunkCount, 1, [&](UINT begin, UINT end) {
+            for (UINT chunk = begin; chunk < end; chunk++) {
+                this->writeChunk(chunk, out + mOffsets[chunk], startColor, endColor);
+            }
+        });
+        return total;
+    }
+
+private:
+    void simulateChunk(UINT chunk, float dt, const ParticleForces& forces) {
+        const UINT base = chunk * mChunkStride;
+        const UINT count = mCounts[chunk];
+        float* px = mPositionX.data() + base;
+        float* py = mPositionY.data() + base;
+        float* vx = mVelocityX.data() + base;
+        float* vy = mVelocityY.data() + base;
+        float* age = mAge.data() + base;
+        float* life = mLife.data() + base;
+        float* size = mSize.data() + base;
+
+        // Integrate in whole groups of four; lanes past count hold stale data that nothing reads.
+        const __m128 step = _mm_set1_ps(dt);
+        const __m128 keep = _mm_set1_ps(std::max(0.0f, 1.0f - forces.drag * dt));
+        const __m128 pullX = _mm_set1_ps(forces.gravityX * dt);
+        const __m128 pullY = _mm_set1_ps(forces.gravityY * dt);
+        for (UINT i = 0; i < count; i += 4) {
+            __m128 velocityX = _mm_add_ps(_mm_mul_ps(_mm_load_ps(vx + i), keep), pullX);
+            __m128 velocityY = _mm_add_ps(_mm_mul_ps(_mm_load_ps(vy + i), keep), pullY);
+            _mm_store_ps(vx + i, velocityX);
+            _mm_store_ps(vy + i, velocityY);
+            _mm_store_ps(px + i, _mm_add_ps(_mm_load_ps(px + i), _mm_mul_ps(velocityX, step)));
+            _mm_store_ps(py + i, _mm_add_ps(_mm_load_ps(py + i), _mm_mul_ps(velocityY, step)));
+            _mm_store_ps(age + i, _mm_add_ps(_mm_load_ps(age + i), step));
+        }
+
+        // Survivors slide down over the dead; the copy happens either way and only the write
+        // index depends on the comparison, so there is nothing to mispredict.
+        UINT alive = 0;
+        for (UINT i = 0; i < count; i++) {
+            px[alive] = px[i];
+            py[alive] = py[i];
+            vx[alive] = vx[i];
+            vy[alive] = vy[i];
+            age[alive] = age[i];
+            life[alive] = life[i];
+            size[alive] = size[i];
+            alive += (UINT)(age[i] < life[i]);
+        }
+        mCounts[chunk] = alive;
+    }
+
+    // Four xorshift32 generators, one per lane, returning floats in [0, 1).
+    static __m128 nextRandom(__m128i& state) {
+        state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+        state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+        state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+        __m128i mantissa = _mm_or_si128(_mm_srli_epi32(state, 9), _mm_set1_epi32(0x3f800000));
+        return _mm_sub_ps(_mm_castsi128_ps(mantissa), _mm_set1_ps(1.0f));
+    }
+
+    static __m128 lerp(__m128 low, __m128 high, __m128 t) {
+        return _mm_add_ps(low, _mm_mul_ps(_mm_sub_ps(high, low), t));
+    }
+
+    UINT emitChunk(UINT chunk, UINT quota, const ParticleEmitter& emitter) {
+        const UINT base = chunk * mChunkStride;
+        const UINT first = mCounts[chunk];
+        const UINT count = std::min(quota, mChunkSize - first);
+        if (count == 0) {
+            return 0;
+        }
+
+        // New particles start inside the emitter's radius and leave along its direction,
+        // turned sideways by up to spread; no trigonometry per particle.
+        __m128i random = _mm_loadu_si128((const __m128i*)&mRandom[chunk * 4]);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 directionX = _mm_set1_ps(emitter.directionX);
+        const __m128 directionY = _mm_set1_ps(emitter.directionY);
+        for (UINT i = 0; i < count; i += 4) {
+            __m128 offsetX = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nextRandom(random), two), one), _mm_set1_ps(emitter.radius));
+            __m128 offsetY = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nextRandom(random), two), one), _mm_set1_ps(emitter.radius));
+            __m128 side = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nextRandom(random), two), one), _mm_set1_ps(emitter.spread));
+            __m128 speed = lerp(_mm_set1_ps(emitter.speedMin), _mm_set1_ps(emitter.speedMax), nextRandom(random));
+            __m128 velocityX = _mm_mul_ps(_mm_sub_ps(directionX, _mm_mul_ps(directionY, side)), speed);
+            __m128 velocityY = _mm_mul_ps(_mm_add_ps(directionY, _mm_mul_ps(directionX, side)), speed);
+            __m128 life = lerp(_mm_set1_ps(emitter.lifeMin), _mm_set1_ps(emitter.lifeMax), nextRandom(random));
+            __m128 size = lerp(_mm_set1_ps(emitter.sizeMin), _mm_set1_ps(emitter.sizeMax), nextRandom(random));
+
+            // The count is not a multiple of four and the start is not aligned, so these stores
+            // are unaligned and may run up to three lanes past the end, into the chunk's padding
+            // at worst; anything past the count is ignored.
+            UINT at = base + first + i;
+            _mm_storeu_ps(mPositionX.data() + at, _mm_add_ps(_mm_set1_ps(emitter.x), offsetX));
+            _mm_storeu_ps(mPositionY.data() + at, _mm_add_ps(_mm_set1_ps(emitter.y), offsetY));
+            _mm_storeu_ps(mVelocityX.data() + at, velocityX);
+            _mm_storeu_ps(mVelocityY.data() + at, velocityY);
+            _mm_storeu_ps(mAge.data() + at, _mm_setzero_ps());
+            _mm_storeu_ps(mLife.data() + at, life);
+            _mm_storeu_ps(mSize.data() + at, size);
+        }
+        _mm_storeu_si128((__m128i*)&mRandom[chunk * 4], random);
+
+        mCounts[chunk] = first + count;
+        return count;
+    }
+
+    void writeChunk(UINT chunk, ParticleInstance* out, const XMFLOAT4& startColor, const XMFLOAT4& endColor) {
+        const UINT base = chunk * mChunkStride;
+        const UINT count = mCounts[chunk];
+        const float* px = mPositionX.data() + base;
+        const float* py = mPositionY.data() + base;
+        const float* age = mAge.data() + base;
+        const float* life = mLife.data() + base;
+        const float* size = mSize.data() + base;
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        const __m128 startR = _mm_set1_ps(startColor.x), endR = _mm_set1_ps(endColor.x);
+        const __m128 startG = _mm_set1_ps(startColor.y), endG = _mm_set1_ps(endColor.y);
+        const __m128 startB = _mm_set1_ps(startColor.z), endB = _mm_set1_ps(endColor.z);
+        const __m128 startA = _mm_set1_ps(startColor.w), endA = _mm_set1_ps(endColor.w);
+        UINT i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 t = _mm_min_ps(_mm_div_ps(_mm_load_ps(age + i), _mm_load_ps(life + i)), one);
+            __m128 fade = _mm_sub_ps(one, t);
+            __m128i r = _mm_cvtps_epi32(_mm_mul_ps(lerp(startR, endR, t), scale));
+            __m128i g = _mm_cvtps_epi32(_mm_mul_ps(lerp(startG, endG, t), scale));
+            __m128i b = _mm_cvtps_epi32(_mm_mul_ps(lerp(startB, endB, t), scale));
+            __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_mul_ps(lerp(startA, endA, t), fade), scale));
+            __m128i rgba = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(a, 24)));
+
+            // Particles grow as they age.
+            __m128 x = _mm_load_ps(px + i);
+            __m128 y = _mm_load_ps(py + i);
+            __m128 s = _mm_mul_ps(_mm_load_ps(size + i), _mm_add_ps(one, t));
+            __m128 c = _mm_castsi128_ps(rgba);
+            _MM_TRANSPOSE4_PS(x, y, s, c);
+
+            // Upload heaps are write-combined; streaming whole 16 byte instances in order
+            // keeps the writes out of the cache.
+            float* target = (float*)(out + i);
+            _mm_stream_ps(target, x);
+            _mm_stream_ps(target + 4, y);
+            _mm_stream_ps(target + 8, s);
+            _mm_stream_ps(target + 12, c);
+        }
+        for (; i < count; i++) {
+            float t = std::min(age[i] / life[i], 1.0f);
+            UINT r = (UINT)((startColor.x + (endColor.x - startColor.x) * t) * 255.0f + 0.5f);
+            UINT g = (UINT)((startColor.y + (endColor.y - startColor.y) * t) * 255.0f + 0.5f);
+            UINT b = (UINT)((startColor.z + (endColor.z - startColor.z) * t) * 255.0f + 0.5f);
+            UINT a = (UINT)((startColor.w + (endColor.w - startColor.w) * t) * (1.0f - t) * 255.0f + 0.5f);
+            out[i].x = px[i];
+            out[i].y = py[i];
+            out[i].size = size[i] * (1.0f + t);
+            out[i].color = r | (g << 8) | (b << 16) | (a << 24);
+        }
+        _mm_sfence();
+    }
+
+    UINT mChunkSize = 0;
+    // Each chunk is followed by four floats of padding that absorb emission's overhanging lanes.
+    UINT mChunkStride = 0;
+    UINT mChunkCount = 0;
+    AlignedFloats mPositionX;
+    AlignedFloats mPositionY;
+    AlignedFloats mVelocityX;
+    AlignedFloats mVelocityY;
+    AlignedFloats mAge;
+    AlignedFloats mLife;
+    AlignedFloats mSize;
+    std::vector<UINT> mCounts;
+    std::vector<UINT> mOffsets;
+    std::vector<UINT> mEmitted;
+    std::vector<UINT> mRandom;
+    float mEmitCarry = 0.0f;
+};
+
+// Tuned so that emission and retirement balance at about 90% of capacity.
+ParticleEmitter fountainEmitter(UINT capacity) {
+    ParticleEmitter emitter;
+    emitter.x = 0.0f;
+    emitter.y = -0.9f;
+    emitter.radius = 0.02f;
+    emitter.directionX = 0.0f;
+    emitter.directionY = 1.0f;
+    emitter.spread = 0.35f;
+    emitter.speedMin = 1.2f;
+    emitter.speedMax = 1.9f;
+    emitter.lifeMin = 1.5f;
+    emitter.lifeMax = 2.5f;
+    emitter.sizeMin = 0.004f;
+    emitter.sizeMax = 0.010f;
+    emitter.rate = capacity * 0.9f / ((emitter.lifeMin + emitter.lifeMax) * 0.5f);
+    return emitter;
+}
+
+// Headless: steady-state particles simulated and instances written per millisecond, on one
+// thread and on every hardware thread.
+std::string benchmarkParticles() {
+    const UINT capacity = 1u << 20;
+    const float dt = 1.0f / 60.0f;
+    const UINT warmupSteps = 180;
+    const UINT timedSteps = 120;
+    const ParticleEmitter emitter = fountainEmitter(capacity);
+    const ParticleForces forces;
+    const XMFLOAT4 startColor(1.0f, 0.85f, 0.4f, 1.0f);
+    const XMFLOAT4 endColor(0.9f, 0.2f, 0.05f, 1.0f);
+
+    ParticleInstance* instances = (ParticleInstance*)_aligned_malloc(capacity * sizeof(ParticleInstance), 16);
+    if (instances == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    std::string report = "Particles, steady state at 90% of 1M:\n";
+    const UINT threadCounts[2] = { 1, std::max(1u, std::thread::hardware_concurrency()) };
+    for (UINT threads : threadCounts) {
+        ParallelFor pool;
+        pool.start(threads - 1);
+
+        ParticleSystem particles;
+        particles.init(capacity, particleChunkSize, 1);
+        for (UINT i = 0; i < warmupSteps; i++) {
+            particles.update(dt, emitter, forces, pool);
+        }
+
+        double simulateSeconds = 0.0;
+        double writeSeconds = 0.0;
+        UINT64 simulated = 0;
+        UINT64 written = 0;
+        for (UINT i = 0; i < timedSteps; i++) {
+            simulated += particles.aliveCount();
+            double start = secondsNow();
+            particles.update(dt, emitter, forces, pool);
+            double updated = secondsNow();
+            written += particles.write(instances, startColor, endColor, pool);
+            writeSeconds += secondsNow() - updated;
+            simulateSeconds += updated - start;
+        }
+        pool.stop();
+
+        char line[192];
+        snprintf(line, sizeof(line), "  %2u threads: %8.0f simulated/ms  %8.0f written/ms  (%.2f + %.2f ms per step, %u alive)\n",
+            threads, simulated / (simulateSeconds * 1000.0), written / (writeSeconds * 1000.0),
+            simulateSeconds * 1000.0 / timedSteps, writeSeconds * 1000.0 / timedSteps, particles.aliveCount());
+        report += line;
+    }
+    _aligned_free(instances);
+    return report;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        mPool.start(std::max(std::thread::hardware_concurrency(), 2U) - 1);
+        mParticles.init(particleCapacity, particleChunkSize, 1);
+        mEmitter = fountainEmitter(particleCapacity);
+        mLastFrameTime = secondsNow();
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+        mPool.stop();
+    }
+
+    void tick(float delta) {
+        this->simulateParticles();
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 2;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 2;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "CENTER", 0, DXGI_FORMAT_R32G32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "SIZE", 0, DXGI_FORMAT_R32_FLOAT, 1, 8, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "TINT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, 12, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/013-particles.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/013-particles.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            // Additive, so overlapping particles glow and draw order does not matter.
+            psoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+            psoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+            psoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_ONE;
+            psoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+            psoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ZERO;
+            psoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ONE;
+            psoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            // A unit quad around the origin; every particle scales it by its size.
+            Vertex triangleVertices[] = {
+                { { -1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 0.0f} },
+                { { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { 1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 1.0f} },
+                { { -1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 1.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Texture
+        {
+            // White with a soft round alpha falloff; the instance tint supplies the colour.
+            std::vector<UINT8> image(spriteSize * spriteSize * 4);
+            for (UINT y = 0; y < spriteSize; y++) {
+                for (UINT x = 0; x < spriteSize; x++) {
+                    float dx = (x + 0.5f) / spriteSize * 2.0f - 1.0f;
+                    float dy = (y + 0.5f) / spriteSize * 2.0f - 1.0f;
+                    float falloff = std::max(0.0f, 1.0f - sqrtf(dx * dx + dy * dy));
+                    UINT8* pixel = &image[(y * spriteSize + x) * 4];
+                    pixel[0] = 0xff;
+                    pixel[1] = 0xff;
+                    pixel[2] = 0xff;
+                    pixel[3] = (UINT8)(falloff * falloff * 255.0f + 0.5f);
+                }
+            }
+            UINT width = spriteSize;
+            UINT height = spriteSize;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+        // Create Particle Instance Buffer, one region per frame in flight, mapped for good
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC bufferDesc = {};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = (UINT64)frameBufferCount * mParticles.capacity() * sizeof(ParticleInstance);
+            bufferDesc.Height = 1;
+            bufferDesc.DepthOrArraySize = 1;
+            bufferDesc.MipLevels = 1;
+            bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mInstanceBuffer)));
+
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mInstanceBuffer->Map(0, &readRange, (void**)&mInstances));
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    // Steps the particles by the real frame time and streams them into this frame's instance
+    // region, which the GPU finished reading when waitForNextFrame returned.
+    void simulateParticles() {
+        double now = secondsNow();
+        float dt = std::min((float)(now - mLastFrameTime), 0.1f);
+        mLastFrameTime = now;
+
+        // The emitter sways from side to side.
+        float angle = 0.4f * sinf((float)now * 0.7f);
+        mEmitter.directionX = sinf(angle);
+        mEmitter.directionY = cosf(angle);
+
+        double start = secondsNow();
+        mParticles.update(dt, mEmitter, mForces, mPool);
+        double updated = secondsNow();
+        ParticleInstance* instances = mInstances + (UINT64)mFrameBufferIndex * mParticles.capacity();
+        mParticleCount = mParticles.write(instances, XMFLOAT4(1.0f, 0.85f, 0.4f, 1.0f), XMFLOAT4(0.9f, 0.2f, 0.05f, 1.0f), mPool);
+        mSimulateSeconds += updated - start;
+        mWriteSeconds += secondsNow() - updated;
+
+        if (++mFrameCount % particleReportFrames == 0) {
+            debugLog("Particles: %u alive on %u threads, %.2f ms simulate, %.2f ms write per frame\n",
+                mParticleCount, mPool.workerCount() + 1,
+                mSimulateSeconds * 1000.0 / particleReportFrames, mWriteSeconds * 1000.0 / particleReportFrames);
+            mSimulateSeconds = 0.0;
+            mWriteSeconds = 0.0;
+        }
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+        const float spriteScale[2] = { windowHeight / (float)windowWidth, 1.0f };
+        mCommandList->SetGraphicsRoot32BitConstants(1, 2, spriteScale, 0);
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        D3D12_VERTEX_BUFFER_VIEW instanceBufferView = {};
+        instanceBufferView.BufferLocation = mInstanceBuffer->GetGPUVirtualAddress() + (UINT64)mFrameBufferIndex * mParticles.capacity() * sizeof(ParticleInstance);
+        instanceBufferView.StrideInBytes = sizeof(ParticleInstance);
+        instanceBufferView.SizeInBytes = mParticles.capacity() * sizeof(ParticleInstance);
+        D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[] = { mVertexBufferView, instanceBufferView };
+        mCommandList->IASetVertexBuffers(0, _countof(vertexBufferViews), vertexBufferViews);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+
+        // Every particle in one instanced draw
+        if (mParticleCount > 0) {
+            mCommandList->DrawIndexedInstanced(6, mParticleCount, 0, 0, 0);
+        }
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+    ComPtr<ID3D12Resource> mInstanceBuffer;
+    ParticleInstance* mInstances = nullptr;
+
+    ParallelFor mPool;
+    ParticleSystem mParticles;
+    ParticleEmitter mEmitter;
+    ParticleForces mForces;
+    UINT mParticleCount = 0;
+    double mLastFrameTime = 0.0;
+    UINT64 mFrameCount = 0;
+    double mSimulateSeconds = 0.0;
+    double mWriteSeconds = 0.0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkParticles();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
@@ -0,0 +1,1670 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <queue>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0020-MeshLOD";
+const char* windowClass = "0020-MeshLOD";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Target fractions of the full triangle count for the levels after the first
+const float lodRatios[] = { 0.5f, 0.25f, 0.125f, 0.0625f, 0.03125f };
+// Largest screen-space error a level may show, in pixels, and the switching band around it
+const float lodErrorPixels = 1.0f;
+const float lodHysteresis = 0.25f;
+// Objects on the field, in rows receding from the camera
+const UINT objectColumns = 8;
+const UINT objectRows = 24;
+const float objectSpacing = 2.5f;
+const float cameraFovY = 0.8f;
+// How often the LOD statistics go to the debug output
+const UINT64 lodReportFrames = 120;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+struct MeshData {
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<UINT> indices;
+};
+
+struct MeshLod {
+    // Range in MeshLodChain::indices
+    UINT indexOffset;
+    UINT indexCount;
+    // Object-space distance the level may be off from the full mesh, at most.
+    float error;
+};
+
+// Every level of one mesh, finest first. All levels index the mesh's own vertex buffer.
+struct MeshLodChain {
+    std::vector<UINT> indices;
+    std::vector<MeshLod> lods;
+    double seconds = 0.0;
+};
+
+// Sum of squared distances to a set of planes, as a symmetric 4x4 matrix.
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+
+    // The plane a*x + b*y + c*z + d = 0, with (a, b, c) of unit length.
+    static Quadric plane(double a, double b, double c, double d) {
+        Quadric q;
+        q.a00 = a * a; q.a01 = a * b; q.a02 = a * c; q.a03 = a * d;
+        q.a11 = b * b; q.a12 = b * c; q.a13 = b * d;
+        q.a22 = c * c; q.a23 = c * d;
+        q.a33 = d * d;
+        return q;
+    }
+
+    void add(const Quadric& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+        a11 += q.a11; a12 += q.a12; a13 += q.a13;
+        a22 += q.a22; a23 += q.a23;
+        a33 += q.a33;
+    }
+
+    double evaluate(const XMFLOAT3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double result = a00 * x * x + a11 * y * y + a22 * z * z + a33
+            + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z + a03 * x + a13 * y + a23 * z);
+        return std::max(result, 0.0);
+    }
+};
+
+// Garland-Heckbert simplification with half-edge collapses: a vertex is folded into one of
+// its neighbours, so no vertex moves and no attribute is interpolated, and every level keeps
+// indexing the original vertex buffer. Vertices that share a position with another vertex
+// (UV and colour seams) and vertices on open borders never move, which keeps seams and
+// outlines exactly where they were. Collapses that would flip a triangle or pinch the
+// surface into a non-manifold edge are skipped.
+class QuadricSimplifier {
+public:
+    // ratios are target fractions of the full triangle count, decreasing, e.g. 0.5, 0.25.
+    // Stops early when no legal collapse is left.
+    void build(const MeshData& mesh, const float* ratios, UINT ratioCount, MeshLodChain& chain) {
+        double start = secondsNow();
+        this->setup(mesh);
+
+        chain.indices = mesh.indices;
+        chain.lods.clear();
+        chain.lods.push_back(MeshLod{ 0, (UINT)mesh.indices.size(), 0.0f });
+
+        for (UINT level = 0; level < ratioCount; level++) {
+            UINT target = (UINT)(mTriangleCount0 * ratios[level]);
+            bool reached = this->collapseTo(target);
+
+            // A level that is barely smaller than the previous one is not worth keeping.
+            UINT previous = chain.lods.back().indexCount / 3;
+            if (mTriangleCount > previous * 0.9f || sqrt(mMaxCost) > mErrorLimit) {
+                break;
+            }
+            MeshLod lod = { (UINT)chain.indices.size(), mTriangleCount * 3, (float)sqrt(mMaxCost) };
+            for (UINT t = 0; t < mTriangles.size() / 3; t++) {
+                if (mTriangleAlive[t]) {
+                    chain.indices.insert(chain.indices.end(), &mTriangles[t * 3], &mTriangles[t * 3] + 3);
+                }
+            }
+            chain.lods.push_back(lod);
+            if (!reached) {
+                break;
+            }
+        }
+        chain.seconds = secondsNow() - start;
+    }
+
+private:
+    struct Candidate {
+        double cost;
+        UINT vertex;
+        UINT target;
+        UINT version;
+        bool operator<(const Candidate& other) const { return cost > other.cost; }
+    };
+
+    void setup(const MeshData& mesh) {
+        const UINT vertexCount = (UINT)mesh.vertices.size();
+        mPositions.resize(vertexCount);
+        for (UINT v = 0; v < vertexCount; v++) {
+            mPositions[v] = mesh.vertices[v].pos;
+        }
+
+        // Weld by exact position: sort the vertices by position, and every run of equal
+        // positions gets the index of its first vertex.
+        mCanonical.resize(vertexCount);
+        std::vector<UINT> order(vertexCount);
+        for (UINT v = 0; v < vertexCount; v++) {
+            order[v] = v;
+        }
+        auto less = [&](UINT a, UINT b) {
+            const XMFLOAT3& p = mPositions[a];
+            const XMFLOAT3& q = mPositions[b];
+            return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z != q.z ? p.z < q.z : a < b;
+        };
+        std::sort(order.begin(), order.end(), less);
+        for (UINT i = 0; i < vertexCount; i++) {
+            const XMFLOAT3& p = mPositions[order[i]];
+            bool same = i > 0 && memcmp(&p, &mPositions[order[i - 1]], sizeof(XMFLOAT3)) == 0;
+            mCanonical[order[i]] = same ? mCanonical[order[i - 1]] : order[i];
+        }
+        mLocked.assign(vertexCount, false);
+        std::vector<UINT> groupSize(vertexCount, 0);
+        for (UINT v = 0; v < vertexCount; v++) {
+            groupSize[mCanonical[v]]++;
+        }
+        for (UINT v = 0; v < vertexCount; v++) {
+            mLocked[v] = groupSize[mCanonical[v]] > 1;
+        }
+
+        // Edges used by a single triangle, counted on welded positions so that seams are not
+        // mistaken for borders.
+        mTriangles = mesh.indices;
+        const UINT triangleCount = (UINT)mTriangles.size() / 3;
+        std::unordered_map<UINT64, UINT> edgeUse;
+        edgeUse.reserve(triangleCount * 3);
+        for (UINT t = 0; t < triangleCount; t++) {
+            for (UINT e = 0; e < 3; e++) {
+                edgeUse[this->edgeKey(mTriangles[t * 3 + e], mTriangles[t * 3 + (e + 1) % 3])]++;
+            }
+        }
+        std::vector<bool> borderPosition(vertexCount, false);
+        for (const auto& edge : edgeUse) {
+            if (edge.second == 1) {
+                borderPosition[(UINT)(edge.first >> 32)] = true;
+                borderPosition[(UINT)(edge.first & 0xffffffffu)] = true;
+            }
+        }
+        for (UINT v = 0; v < vertexCount; v++) {
+            mLocked[v] = mLocked[v] || borderPosition[mCanonical[v]];
+        }
+
+        // Quadrics live on welded positions, so a locked seam vertex carries the planes of
+        // both sides.
+        mQuadrics.assign(vertexCount, Quadric());
+        mVertexTriangles.assign(vertexCount, std::vector<UINT>());
+        mWedges.assign(vertexCount, std::vector<UINT>());
+        for (UINT v = 0; v < vertexCount; v++) {
+            mWedges[mCanonical[v]].push_back(v);
+        }
+        mTriangleAlive.assign(triangleCount, true);
+        for (UINT t = 0; t < triangleCount; t++) {
+            XMFLOAT3 normal;
+            if (this->triangleNormal(mPositions[mTriangles[t * 3]], mPositions[mTriangles[t * 3 + 1]], mPositions[mTriangles[t * 3 + 2]], normal)) {
+                const XMFLOAT3& p = mPositions[mTriangles[t * 3]];
+                Quadric q = Quadric::plane(normal.x, normal.y, normal.z, -(normal.x * p.x + normal.y * p.y + normal.z * p.z));
+                for (UINT corner = 0; corner < 3; corner++) {
+                    mQuadrics[mCanonical[mTriangles[t * 3 + corner]]].add(q);
+                }
+            }
+            for (UINT corner = 0; corner < 3; corner++) {
+                mVertexTriangles[mTriangles[t * 3 + corner]].push_back(t);
+            }
+        }
+
+        // Levels coarser than half the mesh's size are never worth drawing.
+        XMFLOAT3 low = mPositions.empty() ? XMFLOAT3(0, 0, 0) : mPositions[0];
+        XMFLOAT3 high = low;
+        for (const XMFLOAT3& p : mPositions) {
+            low = XMFLOAT3(std::min(low.x, p.x), std::min(low.y, p.y), std::min(low.z, p.z));
+            high = XMFLOAT3(std::max(high.x, p.x), std::max(high.y, p.y), std::max(high.z, p.z));
+        }
+        float dx = high.x - low.x, dy = high.y - low.y, dz = high.z - low.z;
+        mErrorLimit = 0.25f * sqrtf(dx * dx + dy * dy + dz * dz);
+
+        mTriangleCount0 = triangleCount;
+        mTriangleCount = triangleCount;
+        mMaxCost = 0.0;
+        mVersions.assign(vertexCount, 0);
+        mQueuedCost.assign(vertexCount, DBL_MAX);
+        mQueuedTarget.assign(vertexCount, UINT_MAX);
+        mHeap = std::priority_queue<Candidate>();
+        for (UINT v = 0; v < vertexCount; v++) {
+            this->updateCandidate(v);
+        }
+    }
+
+    UINT64 edgeKey(UINT a, UINT b) const {
+        UINT ca = mCanonical[a];
+        UINT cb = mCanonical[b];
+        return ca < cb ? ((UINT64)ca << 32) | cb : ((UINT64)cb << 32) | ca;
+    }
+
+    static bool triangleNormal(const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c, XMFLOAT3& normal) {
+        float ex = b.x - a.x, ey = b.y - a.y, ez = b.z - a.z;
+        float fx = c.x - a.x, fy = c.y - a.y, fz = c.z - a.z;
+        normal = XMFLOAT3(ey * fz - ez * fy, ez * fx - ex * fz, ex * fy - ey * fx);
+        float length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        if (length < 1e-12f) {
+            return false;
+        }
+        normal = XMFLOAT3(normal.x / length, normal.y / length, normal.z / length);
+        return true;
+    }
+
+    // Welded neighbours over every wedge of a position.
+    void neighbours(UINT vertex, std::vector<UINT>& result) const {
+        result.clear();
+        for (UINT wedge : mWedges[mCanonical[vertex]]) {
+            for (UINT t : mVertexTriangles[wedge]) {
+                if (!mTriangleAlive[t]) {
+                    continue;
+                }
+                for (UINT corner = 0; corner < 3; corner++) {
+                    UINT other = mCanonical[mTriangles[t * 3 + corner]];
+                    if (other != mCanonical[vertex]) {
+                        result.push_back(other);
+                    }
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+
+    bool canCollapse(UINT vertex, UINT target) {
+        // The two ends may share only the vertices opposite the edge, or the collapse would
+        // glue two sheets of the surface together.
+        this->neighbours(vertex, mScratchA);
+        this->neighbours(target, mScratchB);
+        UINT shared = 0;
+        for (UINT a = 0, b = 0; a < mScratchA.size() && b < mScratchB.size();) {
+            if (mScratchA[a] == mScratchB[b]) {
+                shared++;
+                a++;
+                b++;
+            } else if (mScratchA[a] < mScratchB[b]) {
+                a++;
+            } else {
+                b++;
+            }
+        }
+        UINT edgeTriangles = 0;
+        for (UINT t : mVertexTriangles[vertex]) {
+            if (mTriangleAlive[t] && this->triangleHas(t, target)) {
+                edgeTriangles++;
+            }
+        }
+        if (edgeTriangles == 0 || shared > edgeTriangles) {
+            return false;
+        }
+
+        // No remaining triangle may turn over or collapse to a sliver.
+        for (UINT t : mVertexTriangles[vertex]) {
+            if (!mTriangleAlive[t] || this->triangleHas(t, target)) {
+                continue;
+            }
+            XMFLOAT3 corners[3];
+            XMFLOAT3 moved[3];
+            for (UINT corner = 0; corner < 3; corner++) {
+                UINT index = mTriangles[t * 3 + corner];
+                corners[corner] = mPositions[index];
+                moved[corner] = index == vertex ? mPositions[target] : mPositions[index];
+            }
+            XMFLOAT3 before;
+            XMFLOAT3 after;
+            if (!triangleNormal(moved[0], moved[1], moved[2], after)) {
+                return false;
+            }
+            if (triangleNormal(corners[0], corners[1], corners[2], before) &&
+                before.x * after.x + before.y * after.y + before.z * after.z < 0.2f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool triangleHas(UINT t, UINT vertex) const {
+        UINT position = mCanonical[vertex];
+        return mCanonical[mTriangles[t * 3]] == position || mCanonical[mTriangles[t * 3 + 1]] == position || mCanonical[mTriangles[t * 3 + 2]] == position;
+    }
+
+    // Queues the cheapest neighbour to fold the vertex into. Legality is checked when the
+    // candidate comes off the heap, since most candidates are replaced before that; validate
+    // checks it here instead and queues the cheapest legal neighbour.
+    void updateCandidate(UINT vertex, bool validate = false) {
+        if (mLocked[vertex]) {
+            mVersions[vertex]++;
+            return;
+        }
+        // An unlocked vertex has a single wedge, and its triangles name the neighbours' wedges
+        // on this side of any seam, which are the right targets. Quadrics add linearly, so
+        // the merged cost is the sum of both vertices' costs at the target.
+        const Quadric& base = mQuadrics[vertex];
+        std::vector<std::pair<double, UINT>>& costs = mScratchCosts;
+        costs.clear();
+        double bestCost = DBL_MAX;
+        UINT bestTarget = UINT_MAX;
+        for (UINT t : mVertexTriangles[vertex]) {
+            if (!mTriangleAlive[t]) {
+                continue;
+            }
+            for (UINT corner = 0; corner < 3; corner++) {
+                UINT neighbour = mTriangles[t * 3 + corner];
+                if (neighbour == vertex) {
+                    continue;
+                }
+                const XMFLOAT3& p = mPositions[neighbour];
+                double cost = base.evaluate(p) + mQuadrics[mCanonical[neighbour]].evaluate(p);
+                if (validate) {
+                    costs.push_back(std::make_pair(cost, neighbour));
+                } else if (cost < bestCost) {
+                    bestCost = cost;
+                    bestTarget = neighbour;
+                }
+            }
+        }
+
+        if (!validate) {
+            // Still queued with the same cost and target: the heap entry stands.
+            if (bestTarget == mQueuedTarget[vertex] && bestCost == mQueuedCost[vertex]) {
+                return;
+            }
+            this->queue(vertex, bestCost, bestTarget);
+            return;
+        }
+        std::sort(costs.begin(), costs.end());
+        for (UINT i = 0; i < costs.size(); i++) {
+            if ((i == 0 || costs[i].second != costs[i - 1].second) && this->canCollapse(vertex, costs[i].second)) {
+                this->queue(vertex, costs[i].first, costs[i].second);
+                return;
+            }
+        }
+        this->queue(vertex, DBL_MAX, UINT_MAX);
+    }
+
+    // Replaces the vertex's heap entry; older entries are skipped by their version.
+    void queue(UINT vertex, double cost, UINT target) {
+        mVersions[vertex]++;
+        mQueuedCost[vertex] = cost;
+        mQueuedTarget[vertex] = target;
+        if (target != UINT_MAX) {
+            mHeap.push(Candidate{ cost, vertex, target, mVersions[vertex] });
+        }
+    }
+
+    // Collapses until the triangle count is at most target; false when it ran out of collapses.
+    bool collapseTo(UINT target) {
+        while (mTriangleCount > target) {
+            if (mHeap.empty()) {
+                return false;
+            }
+            Candidate candidate = mHeap.top();
+            mHeap.pop();
+            if (candidate.version != mVersions[candidate.vertex]) {
+                continue;
+            }
+            if (!this->canCollapse(candidate.vertex, candidate.target)) {
+                this->updateCandidate(candidate.vertex, true);
+                continue;
+            }
+            this->collapse(candidate.vertex, candidate.target);
+            mMaxCost = std::max(mMaxCost, candidate.cost);
+        }
+        return true;
+    }
+
+    void collapse(UINT vertex, UINT target) {
+        for (UINT t : mVertexTriangles[vertex]) {
+            if (!mTriangleAlive[t]) {
+                continue;
+            }
+            if (this->triangleHas(t, target)) {
+                mTriangleAlive[t] = false;
+                mTriangleCount--;
+                continue;
+            }
+            for (UINT corner = 0; corner < 3; corner++) {
+                if (mTriangles[t * 3 + corner] == vertex) {
+                    mTriangles[t * 3 + corner] = target;
+                }
+            }
+            mVertexTriangles[target].push_back(t);
+        }
+        mVertexTriangles[vertex].clear();
+        std::vector<UINT>& merged = mVertexTriangles[target];
+        merged.erase(std::remove_if(merged.begin(), merged.end(), [&](UINT t) { return !mTriangleAlive[t]; }), merged.end());
+        mQuadrics[mCanonical[target]].add(mQuadrics[vertex]);
+        mLocked[vertex] = true;
+        this->queue(vertex, DBL_MAX, UINT_MAX);
+
+        // Everything around the merged vertex has new costs.
+        std::vector<UINT> around;
+        this->neighbours(target, around);
+        for (UINT position : around) {
+            for (UINT wedge : mWedges[position]) {
+                this->updateCandidate(wedge);
+            }
+        }
+        for (UINT wedge : mWedges[mCanonical[target]]) {
+            this->updateCandidate(wedge);
+        }
+    }
+
+    std::vector<XMFLOAT3> mPositions;
+    std::vector<UINT> mCanonical;
+    std::vector<std::vector<UINT>> mWedges;
+    std::vector<bool> mLocked;
+    std::vector<Quadric> mQuadrics;
+    std::vector<UINT> mTriangles;
+    std::vector<bool> mTriangleAlive;
+    std::vector<std::vector<UINT>> mVertexTriangles;
+    std::vector<UINT> mVersions;
+    std::vector<double> mQueuedCost;
+    std::vector<UINT> mQueuedTarget;
+    std::priority_queue<Candidate> mHeap;
+    UINT mTriangleCount0 = 0;
+    UINT mTriangleCount = 0;
+    double mMaxCost = 0.0;
+    float mErrorLimit = 0.0f;
+    std::vector<UINT> mScratchA;
+    std::vector<UINT> mScratchB;
+    std::vector<std::pair<double, UINT>> mScratchCosts;
+};
+
+// Builds every mesh's chain, one mesh per task on up to threadCount threads.
+void buildLodChains(const std::vector<MeshData>& meshes, UINT threadCount, std::vector<MeshLodChain>& chains) {
+    chains.resize(meshes.size());
+    std::atomic<UINT> next(0);
+    auto work = [&]() {
+        QuadricSimplifier simplifier;
+        for (UINT mesh = next++; mesh < meshes.size(); mesh = next++) {
+            simplifier.build(meshes[mesh], lodRatios, _countof(lodRatios), chains[mesh]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (UINT i = 1; i < std::min<UINT>(threadCount, (UINT)meshes.size()); i++) {
+        workers.push_back(std::thread(work));
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Pixels one object-space unit covers at a distance, for a perspective projection.
+float pixelsPerUnit(float distance, float fovY, float viewportHeight) {
+    return viewportHeight / (2.0f * tanf(fovY * 0.5f) * std::max(distance, 1e-3f));
+}
+
+// The coarsest level whose projected error stays under thresholdPixels. The current level
+// is kept while its error is within threshold * (1 + hysteresis), and a coarser level is
+// only taken once it fits under threshold * (1 - hysteresis), so an object sitting at a
+// switch distance does not flicker between levels.
+UINT selectLod(const MeshLodChain& chain, float pixelsPerUnit, UINT current, float thresholdPixels, float hysteresis) {
+    auto coarsestWithin = [&](float limit) {
+        UINT level = 0;
+        for (UINT i = 1; i < chain.lods.size(); i++) {
+            if (chain.lods[i].error * pixelsPerUnit <= limit) {
+                level = i;
+            }
+        }
+        return level;
+    };
+
+    current = std::min(current, (UINT)chain.lods.size() - 1);
+    if (chain.lods[current].error * pixelsPerUnit > thresholdPixels * (1.0f + hysteresis)) {
+        return coarsestWithin(thresholdPixels);
+    }
+    return std::max(current, coarsestWithin(thresholdPixels * (1.0f - hysteresis)));
+}
+
+// Colour shaded once by a fixed light, so the meshes read as solid without normals.
+Vertex litVertex(const XMFLOAT3& position, const XMFLOAT3& normal, const XMFLOAT3& base, const XMFLOAT2& uv) {
+    const float lx = 0.4f, ly = 0.8f, lz = -0.45f;
+    float light = 0.35f + 0.65f * std::max(0.0f, normal.x * lx + normal.y * ly + normal.z * lz);
+    return Vertex{ position, XMFLOAT4(base.x * light, base.y * light, base.z * light, 1.0f), uv };
+}
+
+void appendGrid(MeshData& mesh, UINT columns, UINT rows) {
+    const UINT first = (UINT)mesh.vertices.size() - (columns + 1) * (rows + 1);
+    for (UINT y = 0; y < rows; y++) {
+        for (UINT x = 0; x < columns; x++) {
+            UINT a = first + y * (columns + 1) + x;
+            UINT b = a + columns + 1;
+            UINT quad[6] = { a, a + 1, b + 1, a, b + 1, b };
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+// The standard mesh set: closed surfaces with UV seams, an open heightfield, and a
+// cylinder whose caps differ in colour from its side.
+std::vector<MeshData> makeStandardMeshes() {
+    const float pi = 3.14159265f;
+    std::vector<MeshData> meshes(4);
+
+    MeshData& sphere = meshes[0];
+    sphere.name = "sphere";
+    const UINT sphereSlices = 192, sphereStacks = 96;
+    for (UINT y = 0; y <= sphereStacks; y++) {
+        for (UINT x = 0; x <= sphereSlices; x++) {
+            float u = (float)x / sphereSlices, v = (float)y / sphereStacks;
+            float theta = u * 2.0f * pi, phi = v * pi;
+            XMFLOAT3 n(sinf(phi) * cosf(theta), cosf(phi), sinf(phi) * sinf(theta));
+            // The seam column repeats the first one exactly, so it welds.
+            if (x == sphereSlices) {
+                n = sphere.vertices[y * (sphereSlices + 1)].pos;
+            }
+            sphere.vertices.push_back(litVertex(n, n, XMFLOAT3(0.9f, 0.9f, 0.95f), XMFLOAT2(u * 4.0f, v * 2.0f)));
+        }
+    }
+    appendGrid(sphere, sphereSlices, sphereStacks);
+
+    MeshData& torus = meshes[1];
+    torus.name = "torus";
+    const UINT torusRings = 192, torusSides = 64;
+    for (UINT y = 0; y <= torusSides; y++) {
+        for (UINT x = 0; x <= torusRings; x++) {
+            float u = (float)(x % torusRings) / torusRings, v = (float)(y % torusSides) / torusSides;
+            float theta = u * 2.0f * pi, phi = v * 2.0f * pi;
+            XMFLOAT3 n(cosf(phi) * cosf(theta), sinf(phi), cosf(phi) * sinf(theta));
+            XMFLOAT3 p((0.7f + 0.3f * cosf(phi)) * cosf(theta), 0.3f * sinf(phi), (0.7f + 0.3f * cosf(phi)) * sinf(theta));
+            torus.vertices.push_back(litVertex(p, n, XMFLOAT3(1.0f, 0.75f, 0.4f), XMFLOAT2((float)x / torusRings * 8.0f, (float)y / torusSides * 2.0f)));
+        }
+    }
+    appendGrid(torus, torusRings, torusSides);
+
+    MeshData& terrain = meshes[2];
+    terrain.name = "terrain";
+    const UINT terrainSize = 160;
+    auto height = [](float x, float z) {
+        return 0.12f * sinf(x * 5.0f) * cosf(z * 4.0f) + 0.05f * sinf(x * 13.0f + z * 7.0f);
+    };
+    for (UINT y = 0; y <= terrainSize; y++) {
+        for (UINT x = 0; x <= terrainSize; x++) {
+            float px = (float)x / terrainSize * 2.0f - 1.0f, pz = (float)y / terrainSize * 2.0f - 1.0f;
+            float e = 0.01f;
+            XMFLOAT3 n(height(px - e, pz) - height(px + e, pz), 2.0f * e, height(px, pz - e) - height(px, pz + e));
+            float length = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+            n = XMFLOAT3(n.x / length, n.y / length, n.z / length);
+            terrain.vertices.push_back(litVertex(XMFLOAT3(px, height(px, pz), pz), n, XMFLOAT3(0.45f, 0.8f, 0.4f), XMFLOAT2(px * 4.0f, pz * 4.0f)));
+        }
+    }
+    appendGrid(terrain, terrainSize, terrainSize);
+
+    MeshData& cylinder = meshes[3];
+    cylinder.name = "cylinder";
+    const UINT cylinderSegments = 128, cylinderRings = 48;
+    for (UINT y = 0; y <= cylinderRings; y++) {
+        for (UINT x = 0; x <= cylinderSegments; x++) {
+            float theta = (float)(x % cylinderSegments) / cylinderSegments * 2.0f * pi;
+            float h = (float)y / cylinderRings;
+            // A gentle bulge, so the side is not trivially flat along its length.
+            float radius = 0.5f + 0.08f * sinf(h * pi);
+            XMFLOAT3 n(cosf(theta), 0.0f, sinf(theta));
+            cylinder.vertices.push_back(litVertex(XMFLOAT3(radius * n.x, h * 1.6f - 0.8f, radius * n.z), n, XMFLOAT3(0.5f, 0.6f, 1.0f),
+                XMFLOAT2((float)x / cylinderSegments * 6.0f, h * 2.0f)));
+        }
+    }
+    appendGrid(cylinder, cylinderSegments, cylinderRings);
+    for (UINT cap = 0; cap < 2; cap++) {
+        // The rim repeats the side's rim positions in another colour: a colour seam.
+        float y = cap == 0 ? -0.8f : 0.8f;
+        XMFLOAT3 n(0.0f, cap == 0 ? -1.0f : 1.0f, 0.0f);
+        UINT center = (UINT)cylinder.vertices.size();
+        cylinder.vertices.push_back(litVertex(XMFLOAT3(0.0f, y, 0.0f), n, XMFLOAT3(1.0f, 0.4f, 0.4f), XMFLOAT2(0.5f, 0.5f)));
+        for (UINT x = 0; x < cylinderSegments; x++) {
+            const XMFLOAT3& rim = cylinder.vertices[(cap == 0 ? 0 : cylinderRings * (cylinderSegments + 1)) + x].pos;
+            cylinder.vertices.push_back(litVertex(rim, n, XMFLOAT3(1.0f, 0.4f, 0.4f), XMFLOAT2(0.5f + rim.x, 0.5f + rim.z)));
+        }
+        for (UINT x = 0; x < cylinderSegments; x++) {
+            UINT a = center + 1 + x, b = center + 1 + (x + 1) % cylinderSegments;
+            UINT triangle[3] = { center, cap == 0 ? a : b, cap == 0 ? b : a };
+            cylinder.indices.insert(cylinder.indices.end(), triangle, triangle + 3);
+        }
+    }
+    return meshes;
+}
+
+// Headless: level sizes and errors for the standard mesh set, and simplification throughput
+// on one thread and across meshes on every hardware thread.
+std::string benchmarkLods() {
+    std::vector<MeshData> meshes = makeStandardMeshes();
+    std::string report = "Quadric LOD chains:\n";
+    char line[256];
+
+    std::vector<MeshLodChain> chains;
+    UINT64 inputTriangles = 0;
+    for (const MeshData& mesh : meshes) {
+        inputTriangles += mesh.indices.size() / 3;
+    }
+    const UINT threadCounts[2] = { 1, std::max(1u, std::thread::hardware_concurrency()) };
+    for (UINT threads : threadCounts) {
+        double start = secondsNow();
+        buildLodChains(meshes, threads, chains);
+        double seconds = secondsNow() - start;
+        snprintf(line, sizeof(line), "  %2u threads: %.1f ms, %.0f input triangles/ms\n", threads, seconds * 1000.0, inputTriangles / (seconds * 1000.0));
+        report += line;
+    }
+
+    for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+        const MeshLodChain& chain = chains[mesh];
+        snprintf(line, sizeof(line), "  %-8s %.1f ms:", meshes[mesh].name.c_str(), chain.seconds * 1000.0);
+        report += line;
+        for (const MeshLod& lod : chain.lods) {
+            snprintf(line, sizeof(line), " %u (%.4f)", lod.indexCount / 3, lod.error);
+            report += line;
+        }
+        snprintf(line, sizeof(line), "  -> %.1f%% at the last level\n",
+            100.0 * chain.lods.back().indexCount / chain.lods.front().indexCount);
+        report += line;
+    }
+    return report;
+}
+
+// Where a mesh's vertices and levels start in the shared buffers.
+struct MeshRange {
+    UINT baseVertex;
+    UINT baseIndex;
+};
+
+struct LodObject {
+    UINT mesh;
+    XMFLOAT3 position;
+    float scale;
+    // Level drawn last frame, the starting point for hysteresis
+    UINT lod;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+        // Create Depth Buffer
+        {
+            D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
+            dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+            dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+            dsvHeapDesc.NumDescriptors = 1;
+            _ThrowIfFailed(mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&mDSVHeap)));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+            D3D12_RESOURCE_DESC depthDesc = {};
+            depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            depthDesc.Width = windowWidth;
+            depthDesc.Height = windowHeight;
+            depthDesc.DepthOrArraySize = 1;
+            depthDesc.MipLevels = 1;
+            depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+            depthDesc.SampleDesc.Count = 1;
+            depthDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+            D3D12_CLEAR_VALUE clearValue = {};
+            clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+            clearValue.DepthStencil.Depth = 1.0f;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &depthDesc,
+                D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                &clearValue,
+                IID_PPV_ARGS(&mDepthBuffer)));
+            mDevice->CreateDepthStencilView(mDepthBuffer.Get(), nullptr, mDSVHeap->GetCPUDescriptorHandleForHeapStart());
+        }
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.0f;
+            mViewport.MaxDepth = 1.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        mStartTime = secondsNow();
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/014-mesh-lod.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/014-mesh-lod.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            // The terrain is seen from both sides.
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = TRUE;
+            psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+            psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+            psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Build LOD Chains, one mesh per thread
+        std::vector<MeshData> meshes = makeStandardMeshes();
+        {
+            double start = secondsNow();
+            buildLodChains(meshes, std::max(1u, std::thread::hardware_concurrency()), mChains);
+            debugLog("LOD chains built in %.1f ms\n", (secondsNow() - start) * 1000.0);
+            for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+                for (UINT level = 0; level < mChains[mesh].lods.size(); level++) {
+                    debugLog("  %s LOD%u: %u triangles, error %.4f\n", meshes[mesh].name.c_str(), level,
+                        mChains[mesh].lods[level].indexCount / 3, mChains[mesh].lods[level].error);
+                }
+            }
+        }
+
+        // All meshes share one vertex buffer and one index buffer; every level of a mesh is
+        // a range of its indices.
+        std::vector<Vertex> vertices;
+        std::vector<UINT> indices;
+        mMeshRanges.resize(meshes.size());
+        for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+            mMeshRanges[mesh].baseVertex = (UINT)vertices.size();
+            mMeshRanges[mesh].baseIndex = (UINT)indices.size();
+            vertices.insert(vertices.end(), meshes[mesh].vertices.begin(), meshes[mesh].vertices.end());
+            indices.insert(indices.end(), mChains[mesh].indices.begin(), mChains[mesh].indices.end());
+        }
+
+        // Objects in rows along +z, the mesh kinds cycling across each row.
+        for (UINT row = 0; row < objectRows; row++) {
+            for (UINT column = 0; column < objectColumns; column++) {
+                LodObject object = {};
+                object.mesh = (row + column) % meshes.size();
+                object.position = XMFLOAT3((column - (objectColumns - 1) * 0.5f) * objectSpacing, 0.0f, row * objectSpacing * 2.0f);
+                object.scale = 0.9f;
+                mObjects.push_back(object);
+            }
+        }
+
+        // Create Vertex Buffer
+        {
+            const UINT vertexBufferSize = (UINT)(vertices.size() * sizeof(Vertex));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = vertexBufferSize;
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, vertices.data(), vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = indices.size() * sizeof(UINT);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices.data(), ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = (UINT)ibDesc.Width;
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0xc0;    // R
+                        pData[n + 1] = 0xc0;    // G
+                        pData[n + 2] = 0xc0;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    // Picks each object's level from its projected error and draws it. The camera dollies
+    // along the rows, so objects keep crossing switch distances in both directions.
+    void drawObjects() {
+        float time = (float)(secondsNow() - mStartTime);
+        XMFLOAT3 eye(0.0f, 2.5f, -6.0f + 30.0f * (1.0f - cosf(time * 0.25f)));
+        XMMATRIX view = XMMatrixLookToLH(XMLoadFloat3(&eye), XMVectorSet(0.0f, -0.15f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        XMMATRIX projection = XMMatrixPerspectiveFovLH(cameraFovY, windowWidth / (float)windowHeight, 0.1f, 500.0f);
+        XMMATRIX viewProjection = XMMatrixMultiply(view, projection);
+
+        for (LodObject& object : mObjects) {
+            const MeshLodChain& chain = mChains[object.mesh];
+            float dx = object.position.x - eye.x, dy = object.position.y - eye.y, dz = object.position.z - eye.z;
+            float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+            // The chain's errors are in mesh units; the object's scale carries them to world units.
+            float pixels = pixelsPerUnit(distance, cameraFovY, (float)windowHeight) * object.scale;
+            UINT level = selectLod(chain, pixels, object.lod, lodErrorPixels, lodHysteresis);
+            mLodSwitches += level != object.lod ? 1 : 0;
+            object.lod = level;
+
+            XMMATRIX world = XMMatrixMultiply(
+                XMMatrixMultiply(XMMatrixScaling(object.scale, object.scale, object.scale), XMMatrixRotationY(time * 0.3f + object.position.x)),
+                XMMatrixTranslation(object.position.x, object.position.y, object.position.z));
+            XMFLOAT4X4 constants;
+            XMStoreFloat4x4(&constants, XMMatrixTranspose(XMMatrixMultiply(world, viewProjection)));
+            mCommandList->SetGraphicsRoot32BitConstants(1, 16, &constants, 0);
+
+            const MeshLod& lod = chain.lods[level];
+            const MeshRange& range = mMeshRanges[object.mesh];
+            mCommandList->DrawIndexedInstanced(lod.indexCount, 1, range.baseIndex + lod.indexOffset, range.baseVertex, 0);
+            mDrawnTriangles += lod.indexCount / 3;
+            mFullTriangles += chain.lods[0].indexCount / 3;
+        }
+
+        if (++mFrameCount % lodReportFrames == 0) {
+            debugLog("LOD: %.1f%% of full detail triangles drawn, %.1f level switches per frame\n",
+                100.0 * mDrawnTriangles / std::max<UINT64>(mFullTriangles, 1), mLodSwitches / (double)lodReportFrames);
+            mDrawnTriangles = 0;
+            mFullTriangles = 0;
+            mLodSwitches = 0;
+        }
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle{ mDSVHeap->GetCPUDescriptorHandleForHeapStart() };
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        this->drawObjects();
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+    ComPtr<ID3D12DescriptorHeap> mDSVHeap;
+    ComPtr<ID3D12Resource> mDepthBuffer;
+
+    std::vector<MeshLodChain> mChains;
+    std::vector<MeshRange> mMeshRanges;
+    std::vector<LodObject> mObjects;
+    double mStartTime = 0.0;
+    UINT64 mFrameCount = 0;
+    UINT64 mDrawnTriangles = 0;
+    UINT64 mFullTriangles = 0;
+    UINT64 mLodSwitches = 0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkLods();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
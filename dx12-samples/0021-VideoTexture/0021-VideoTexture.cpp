@@ -0,0 +1,1195 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <memory>
+#include <algorithm>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0021-VideoTexture";
+const char* windowClass = "0021-VideoTexture";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Frame size and rate of the stream unless the command line says otherwise
+const UINT videoWidth = 1280;
+const UINT videoHeight = 720;
+const double videoFrameRate = 30.0;
+// Upload slots; one more than the frames the GPU can be behind, so a slot is free by the time it comes around
+const UINT videoSlotCount = frameBufferCount + 1;
+// How often the streaming statistics go to the debug output
+const UINT64 videoReportFrames = 120;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Where the two planes of one NV12 frame go in an upload slot: full resolution luma, then
+// half resolution interleaved chroma, each with rows padded to the copy pitch.
+struct Nv12Layout {
+    UINT width = 0;
+    UINT height = 0;
+    UINT64 lumaOffset = 0;
+    UINT lumaPitch = 0;
+    UINT64 chromaOffset = 0;
+    UINT chromaPitch = 0;
+    UINT64 bytes = 0;
+
+    // Bytes of one tightly packed frame, as it is stored in a file or sent down a pipe.
+    UINT64 packedBytes() const { return (UINT64)width * height * 3 / 2; }
+};
+
+// The layout GetCopyableFootprints reports for an NV12 texture, for use without a device.
+Nv12Layout nv12Layout(UINT width, UINT height) {
+    auto align = [](UINT64 value, UINT64 alignment) { return (value + alignment - 1) & ~(alignment - 1); };
+    Nv12Layout layout;
+    layout.width = width;
+    layout.height = height;
+    layout.lumaOffset = 0;
+    layout.lumaPitch = (UINT)align(width, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+    layout.chromaOffset = align(layout.lumaOffset + (UINT64)layout.lumaPitch * height, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+    layout.chromaPitch = (UINT)align(width, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+    layout.bytes = layout.chromaOffset + (UINT64)layout.chromaPitch * (height / 2);
+    return layout;
+}
+
+// Copies a tightly packed NV12 frame into an upload slot, one row at a time.
+void copyNv12Frame(const UINT8* packed, const Nv12Layout& layout, UINT8* slot) {
+    const UINT8* luma = packed;
+    for (UINT row = 0; row < layout.height; row++) {
+        memcpy(slot + layout.lumaOffset + (UINT64)row * layout.lumaPitch, luma + (UINT64)row * layout.width, layout.width);
+    }
+    const UINT8* chroma = packed + (UINT64)layout.width * layout.height;
+    for (UINT row = 0; row < layout.height / 2; row++) {
+        memcpy(slot + layout.chromaOffset + (UINT64)row * layout.chromaPitch, chroma + (UINT64)row * layout.width, layout.width);
+    }
+}
+
+// Produces frames straight into upload memory; no source keeps a frame buffer of its own.
+class VideoSource {
+public:
+    virtual ~VideoSource() {}
+    // Writes the next frame into slot; false when there is none (end of stream).
+    virtual bool read(const Nv12Layout& layout, UINT8* slot) = 0;
+    virtual const char* name() const = 0;
+};
+
+// Moving colour bars over a scrolling luma ramp, generated in place.
+class TestPatternVideoSource : public VideoSource {
+public:
+    bool read(const Nv12Layout& layout, UINT8* slot) override {
+        const UINT shift = mFrame * 4;
+        for (UINT row = 0; row < layout.height; row++) {
+            UINT8* luma = slot + layout.lumaOffset + (UINT64)row * layout.lumaPitch;
+            for (UINT x = 0; x < layout.width; x++) {
+                // Limited range luma, 16 to 235
+                luma[x] = (UINT8)(16 + ((x + row / 2 + shift) * 219 / layout.width) % 220);
+            }
+        }
+        static const UINT8 bars[8][2] = {
+            { 128, 128 }, { 16, 146 }, { 166, 16 }, { 54, 34 }, { 202, 222 }, { 90, 240 }, { 240, 110 }, { 128, 128 }
+        };
+        for (UINT row = 0; row < layout.height / 2; row++) {
+            UINT8* chroma = slot + layout.chromaOffset + (UINT64)row * layout.chromaPitch;
+            for (UINT x = 0; x < layout.width / 2; x++) {
+                UINT bar = ((x + shift / 2) * 8 / (layout.width / 2)) % 8;
+                chroma[x * 2 + 0] = bars[bar][0];
+                chroma[x * 2 + 1] = bars[bar][1];
+            }
+        }
+        mFrame++;
+        return true;
+    }
+
+    const char* name() const override { return "test pattern"; }
+
+private:
+    UINT mFrame = 0;
+};
+
+// A raw NV12 file mapped into memory; frames are copied from the mapping into the slot
+// and the file loops.
+class MappedFileVideoSource : public VideoSource {
+public:
+    MappedFileVideoSource(const std::string& path, const Nv12Layout& layout) {
+        mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+        LARGE_INTEGER size;
+        GetFileSizeEx(mFile, &size);
+        mFrameCount = (UINT)(size.QuadPart / layout.packedBytes());
+        if (mFrameCount == 0) {
+            CloseHandle(mFile);
+            throw std::exception("video file holds less than one frame at the given size");
+        }
+        mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mMapping == nullptr) {
+            CloseHandle(mFile);
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+        mView = (const UINT8*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+        if (mView == nullptr) {
+            CloseHandle(mMapping);
+            CloseHandle(mFile);
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+    }
+
+    ~MappedFileVideoSource() {
+        UnmapViewOfFile(mView);
+        CloseHandle(mMapping);
+        CloseHandle(mFile);
+    }
+
+    bool read(const Nv12Layout& layout, UINT8* slot) override {
+        copyNv12Frame(mView + (UINT64)mFrame * layout.packedBytes(), layout, slot);
+        mFrame = (mFrame + 1) % mFrameCount;
+        return true;
+    }
+
+    const char* name() const override { return "mapped file"; }
+
+private:
+    HANDLE mFile = INVALID_HANDLE_VALUE;
+    HANDLE mMapping = nullptr;
+    const UINT8* mView = nullptr;
+    UINT mFrame = 0;
+    UINT mFrameCount = 0;
+};
+
+// Raw NV12 frames from a pipe: "-" for stdin, e.g. a decoder piped into the sample, or the
+// name of a named pipe. Rows are read straight into the slot at its pitch.
+class PipeVideoSource : public VideoSource {
+public:
+    explicit PipeVideoSource(const std::string& path) {
+        if (path == "-") {
+            mPipe = GetStdHandle(STD_INPUT_HANDLE);
+        }
+        else {
+            mPipe = CreateFileA(path.c_str(), GENERIC_READ, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+            mOwned = true;
+        }
+        if (mPipe == INVALID_HANDLE_VALUE || mPipe == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+    }
+
+    ~PipeVideoSource() {
+        if (mOwned) {
+            CloseHandle(mPipe);
+        }
+    }
+
+    bool read(const Nv12Layout& layout, UINT8* slot) override {
+        for (UINT row = 0; row < layout.height; row++) {
+            if (!this->readFully(slot + layout.lumaOffset + (UINT64)row * layout.lumaPitch, layout.width)) {
+                return false;
+            }
+        }
+        for (UINT row = 0; row < layout.height / 2; row++) {
+            if (!this->readFully(slot + layout.chromaOffset + (UINT64)row * layout.chromaPitch, layout.width)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const char* name() const override { return "pipe"; }
+
+private:
+    bool readFully(UINT8* destination, DWORD bytes) {
+        while (bytes > 0) {
+            DWORD read = 0;
+            if (!ReadFile(mPipe, destination, bytes, &read, nullptr) || read == 0) {
+                return false;
+            }
+            destination += read;
+            bytes -= read;
+        }
+        return true;
+    }
+
+    HANDLE mPipe = INVALID_HANDLE_VALUE;
+    bool mOwned = false;
+};
+
+// BT.709 limited range to RGBA8 on the CPU, what the RGBA path would need per frame.
+void convertNv12ToRgba(const Nv12Layout& layout, const UINT8* slot, UINT8* rgba, UINT rgbaPitch) {
+    for (UINT row = 0; row < layout.height; row++) {
+        const UINT8* luma = slot + layout.lumaOffset + (UINT64)row * layout.lumaPitch;
+        const UINT8* chroma = slot + layout.chromaOffset + (UINT64)(row / 2) * layout.chromaPitch;
+        UINT8* out = rgba + (UINT64)row * rgbaPitch;
+        for (UINT x = 0; x < layout.width; x++) {
+            int y = (luma[x] - 16) * 298;
+            int u = chroma[(x / 2) * 2] - 128;
+            int v = chroma[(x / 2) * 2 + 1] - 128;
+            int r = (y + 459 * v + 128) >> 8;
+            int g = (y - 55 * u - 136 * v + 128) >> 8;
+            int b = (y + 541 * u + 128) >> 8;
+            out[x * 4 + 0] = (UINT8)std::min(std::max(r, 0), 255);
+            out[x * 4 + 1] = (UINT8)std::min(std::max(g, 0), 255);
+            out[x * 4 + 2] = (UINT8)std::min(std::max(b, 0), 255);
+            out[x * 4 + 3] = 255;
+        }
+    }
+}
+
+// Headless: CPU cost per frame of filling an upload slot at 1080p and 4K, for NV12 against
+// RGBA8 already converted and RGBA8 converted on the CPU first.
+std::string benchmarkVideoUpload() {
+    std::string report = "Video upload, CPU side per frame:\n";
+    const UINT sizes[2][2] = { { 1920, 1080 }, { 3840, 2160 } };
+    const UINT sourceFrames = 2;
+    const UINT iterations = 30;
+    char line[256];
+    for (const auto& size : sizes) {
+        Nv12Layout layout = nv12Layout(size[0], size[1]);
+        const UINT rgbaPitch = (size[0] * 4 + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
+        const UINT64 packedRgba = (UINT64)size[0] * size[1] * 4;
+
+        // Packed source frames, as they would sit in a mapped file.
+        std::vector<UINT8> slot((size_t)layout.bytes);
+        std::vector<UINT8> packedNv12((size_t)(layout.packedBytes() * sourceFrames));
+        std::vector<UINT8> packedRgbaFrames((size_t)(packedRgba * sourceFrames));
+        std::vector<UINT8> rgbaSlot((size_t)rgbaPitch * size[1]);
+        TestPatternVideoSource pattern;
+        for (UINT frame = 0; frame < sourceFrames; frame++) {
+            pattern.read(layout, slot.data());
+            UINT8* packed = packedNv12.data() + frame * layout.packedBytes();
+            for (UINT row = 0; row < size[1]; row++) {
+                memcpy(packed + (UINT64)row * size[0], slot.data() + (UINT64)row * layout.lumaPitch, size[0]);
+            }
+            for (UINT row = 0; row < size[1] / 2; row++) {
+                memcpy(packed + (UINT64)size[0] * size[1] + (UINT64)row * size[0], slot.data() + layout.chromaOffset + (UINT64)row * layout.chromaPitch, size[0]);
+            }
+            convertNv12ToRgba(layout, slot.data(), rgbaSlot.data(), rgbaPitch);
+            for (UINT row = 0; row < size[1]; row++) {
+                memcpy(packedRgbaFrames.data() + frame * packedRgba + (UINT64)row * size[0] * 4, rgbaSlot.data() + (UINT64)row * rgbaPitch, size[0] * 4);
+            }
+        }
+
+        double start = secondsNow();
+        for (UINT i = 0; i < iterations; i++) {
+            copyNv12Frame(packedNv12.data() + (i % sourceFrames) * layout.packedBytes(), layout, slot.data());
+        }
+        double nv12Seconds = (secondsNow() - start) / iterations;
+
+        start = secondsNow();
+        for (UINT i = 0; i < iterations; i++) {
+            const UINT8* packed = packedRgbaFrames.data() + (i % sourceFrames) * packedRgba;
+            for (UINT row = 0; row < size[1]; row++) {
+                memcpy(rgbaSlot.data() + (UINT64)row * rgbaPitch, packed + (UINT64)row * size[0] * 4, size[0] * 4);
+            }
+        }
+        double rgbaSeconds = (secondsNow() - start) / iterations;
+
+        start = secondsNow();
+        for (UINT i = 0; i < iterations; i++) {
+            convertNv12ToRgba(layout, slot.data(), rgbaSlot.data(), rgbaPitch);
+        }
+        double convertSeconds = (secondsNow() - start) / iterations;
+
+        snprintf(line, sizeof(line),
+            "  %ux%u: NV12 %.2f MB %.2f ms (%.0f fps), RGBA %.2f MB %.2f ms (%.0f fps), RGBA converted on CPU %.2f ms (%.0f fps)\n",
+            size[0], size[1],
+            layout.packedBytes() / 1048576.0, nv12Seconds * 1000.0, 1.0 / nv12Seconds,
+            packedRgba / 1048576.0, rgbaSeconds * 1000.0, 1.0 / rgbaSeconds,
+            (convertSeconds + rgbaSeconds) * 1000.0, 1.0 / (convertSeconds + rgbaSeconds));
+        report += line;
+    }
+    return report;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle, std::unique_ptr<VideoSource> source, UINT width, UINT height) {
+        mVideoSource = std::move(source);
+        mVideoLayout.width = width;
+        mVideoLayout.height = height;
+
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 2;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        mFrameCount++;
+        if (mFrameCount % videoReportFrames == 0 && mStreamedFrames > 0) {
+            debugLog("Video (%s) %ux%u: %llu frames, NV12 %.2f MB per frame against %.2f MB as RGBA8, read %.3f ms per frame, %llu waits for a slot\n",
+                mVideoSource->name(), mVideoLayout.width, mVideoLayout.height, mStreamedFrames,
+                mVideoLayout.packedBytes() / 1048576.0, mVideoLayout.width * mVideoLayout.height * 4 / 1048576.0,
+                mReadSeconds * 1000.0 / mStreamedFrames, mSlotWaits);
+        }
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 2;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 1;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 2;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 1;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/015-video-nv12.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/015-video-nv12.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            // A quad with the video's aspect ratio, 90% of the window wide
+            float aspect = windowWidth / (windowHeight + 0.0f);
+            float halfWidth = 0.9f;
+            float halfHeight = halfWidth * aspect * mVideoLayout.height / mVideoLayout.width;
+            Vertex triangleVertices[] = {
+                { { -halfWidth, halfHeight, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 0.0f} },
+                { { halfWidth, halfHeight, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { halfWidth, -halfHeight, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 1.0f} },
+                { { -halfWidth, -halfHeight, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 1.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Video Texture, with the first frame already in it
+        this->createVideoTexture();
+        this->streamVideoFrame();
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        this->streamVideoFrame();
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    // One NV12 texture, sampled through an R8 view of the luma plane and an R8G8 view of the
+    // chroma plane, and a persistently mapped upload buffer split into videoSlotCount slots.
+    void createVideoTexture() {
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        textureDesc.Width = mVideoLayout.width;
+        textureDesc.Height = mVideoLayout.height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = DXGI_FORMAT_NV12;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+            nullptr,
+            IID_PPV_ARGS(&mVideoTexture)));
+
+        // Subresource 0 is the luma plane, subresource 1 the chroma plane.
+        UINT numRows[2];
+        UINT64 rowSizeInBytes[2];
+        UINT64 slotBytes;
+        mDevice->GetCopyableFootprints(&textureDesc, 0, 2, 0, mVideoFootprints, numRows, rowSizeInBytes, &slotBytes);
+        mVideoLayout.lumaOffset = mVideoFootprints[0].Offset;
+        mVideoLayout.lumaPitch = mVideoFootprints[0].Footprint.RowPitch;
+        mVideoLayout.chromaOffset = mVideoFootprints[1].Offset;
+        mVideoLayout.chromaPitch = mVideoFootprints[1].Footprint.RowPitch;
+        mVideoLayout.bytes = slotBytes;
+        mVideoSlotStride = (slotBytes + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = mVideoSlotStride * videoSlotCount;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&mVideoUpload)));
+
+        // Stays mapped; the CPU only writes it.
+        D3D12_RANGE readRange = { 0, 0 };
+        _ThrowIfFailed(mVideoUpload->Map(0, &readRange, (void**)&mVideoUploadData));
+
+        const DXGI_FORMAT planeFormats[2] = { DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8G8_UNORM };
+        D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = mSRVHeap->GetCPUDescriptorHandleForHeapStart();
+        for (UINT plane = 0; plane < 2; plane++) {
+            D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+            srvDesc.Format = planeFormats[plane];
+            srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            srvDesc.Texture2D.MipLevels = 1;
+            srvDesc.Texture2D.PlaneSlice = plane;
+            mDevice->CreateShaderResourceView(mVideoTexture.Get(), &srvDesc, srvHandle);
+            srvHandle.ptr += mSRVHeapStride;
+        }
+    }
+
+    // Reads the next frame into a free slot when one is due and records one copy per plane.
+    // Nothing is allocated; a slot is reused once the fence of the frame that copied from it passed.
+    void streamVideoFrame() {
+        double now = secondsNow();
+        if (mVideoEnded || now < mNextVideoTime) {
+            return;
+        }
+        if (mVideoSlotFences[mVideoSlot] > mFence->GetCompletedValue()) {
+            mSlotWaits++;
+            return;
+        }
+
+        UINT8* slot = mVideoUploadData + mVideoSlot * mVideoSlotStride;
+        if (!mVideoSource->read(mVideoLayout, slot)) {
+            // End of stream, the last frame stays up.
+            mVideoEnded = true;
+            return;
+        }
+        mReadSeconds += secondsNow() - now;
+        // Keep the stream's cadence but do not try to catch up after a stall.
+        mNextVideoTime = std::max(mNextVideoTime + 1.0 / videoFrameRate, now);
+
+        D3D12_RESOURCE_BARRIER toCopy = {};
+        toCopy.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        toCopy.Transition.pResource = mVideoTexture.Get();
+        toCopy.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        toCopy.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        toCopy.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+        mCommandList->ResourceBarrier(1, &toCopy);
+
+        for (UINT plane = 0; plane < 2; plane++) {
+            D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+            srcLocation.pResource = mVideoUpload.Get();
+            srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            srcLocation.PlacedFootprint = mVideoFootprints[plane];
+            srcLocation.PlacedFootprint.Offset += mVideoSlot * mVideoSlotStride;
+
+            D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+            dstLocation.pResource = mVideoTexture.Get();
+            dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            dstLocation.SubresourceIndex = plane;
+
+            mCommandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+        }
+
+        D3D12_RESOURCE_BARRIER toShader = toCopy;
+        toShader.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        toShader.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &toShader);
+
+        // Signalled once the commands recorded this frame have run.
+        mVideoSlotFences[mVideoSlot] = mFenceValues[mFrameBufferIndex];
+        mVideoSlot = (mVideoSlot + 1) % videoSlotCount;
+        mStreamedFrames++;
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+
+    std::unique_ptr<VideoSource> mVideoSource;
+    Nv12Layout mVideoLayout;
+    ComPtr<ID3D12Resource> mVideoTexture;
+    ComPtr<ID3D12Resource> mVideoUpload;
+    UINT8* mVideoUploadData = nullptr;
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT mVideoFootprints[2];
+    UINT64 mVideoSlotStride = 0;
+    UINT64 mVideoSlotFences[videoSlotCount] = {};
+    UINT mVideoSlot = 0;
+    double mNextVideoTime = 0.0;
+    bool mVideoEnded = false;
+
+    UINT64 mFrameCount = 0;
+    UINT64 mStreamedFrames = 0;
+    UINT64 mSlotWaits = 0;
+    double mReadSeconds = 0.0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkVideoUpload();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        // -size=WxH gives the frame size of raw input; -video=<file> maps a raw NV12 file,
+        // -video=- reads stdin and -video=\\.\pipe\<name> a named pipe.
+        UINT width = videoWidth;
+        UINT height = videoHeight;
+        const char* size = strstr(lpCmdLine, "-size=");
+        if (size != nullptr && sscanf_s(size, "-size=%ux%u", &width, &height) != 2) {
+            throw std::exception("-size expects WIDTHxHEIGHT");
+        }
+        if (width == 0 || height == 0 || width % 2 != 0 || height % 2 != 0) {
+            throw std::exception("NV12 frames need an even, non-zero width and height");
+        }
+
+        std::unique_ptr<VideoSource> source;
+        const char* video = strstr(lpCmdLine, "-video=");
+        if (video != nullptr) {
+            video += strlen("-video=");
+            std::string path(video, strcspn(video, " "));
+            if (path == "-" || path.compare(0, 9, "\\\\.\\pipe\\") == 0) {
+                source.reset(new PipeVideoSource(path));
+            }
+            else {
+                source.reset(new MappedFileVideoSource(path, nv12Layout(width, height)));
+            }
+        }
+        else {
+            source.reset(new TestPatternVideoSource());
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd, std::move(source), width, height);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
@@ -0,0 +1,1435 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0022-DirtyRects";
+const char* windowClass = "0022-DirtyRects";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Rects kept per upload before the cheapest pairs get merged, and the dirty fraction of the
+// canvas above which it is uploaded whole
+const UINT canvasMaxRects = 32;
+const float canvasFullUploadCoverage = 0.5f;
+// How often the upload statistics go to the debug output
+const UINT64 canvasReportFrames = 120;
+// Canvas layout, colours as 0xAABBGGRR
+const UINT canvasPanelColumns = 3;
+const UINT canvasPanelRows = 2;
+const UINT canvasMargin = 16;
+const UINT canvasTitleHeight = 24;
+const UINT32 canvasBackgroundColor = 0xff201810;
+const UINT32 canvasPanelColor = 0xff403830;
+const UINT32 canvasTitleColor = 0xff705848;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Half-open pixel rectangle: [left, right) x [top, bottom).
+struct DirtyRect {
+    UINT left = 0;
+    UINT top = 0;
+    UINT right = 0;
+    UINT bottom = 0;
+
+    UINT width() const { return right - left; }
+    UINT height() const { return bottom - top; }
+    UINT64 area() const { return (UINT64)this->width() * this->height(); }
+    bool empty() const { return right <= left || bottom <= top; }
+};
+
+DirtyRect makeDirtyRect(UINT left, UINT top, UINT right, UINT bottom) {
+    DirtyRect rect;
+    rect.left = left;
+    rect.top = top;
+    rect.right = right;
+    rect.bottom = bottom;
+    return rect;
+}
+
+DirtyRect unionOf(const DirtyRect& a, const DirtyRect& b) {
+    return makeDirtyRect(std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom));
+}
+
+// True when the rects share pixels or lie side by side along a common edge segment. Rects that
+// only meet at a corner stay apart, their union would mostly be clean pixels.
+bool dirtyRectsTouch(const DirtyRect& a, const DirtyRect& b) {
+    bool xOverlap = a.left < b.right && b.left < a.right;
+    bool yOverlap = a.top < b.bottom && b.top < a.bottom;
+    bool xTouch = a.left <= b.right && b.left <= a.right;
+    bool yTouch = a.top <= b.bottom && b.top <= a.bottom;
+    return (xOverlap && yTouch) || (yOverlap && xTouch);
+}
+
+// Collects the regions of a texture written since the last upload. Rects that overlap or are
+// adjacent are merged as they come in, so the set stays pairwise disjoint and its total area is
+// the dirty coverage. Past maxRects the pair whose union adds the fewest clean pixels is merged,
+// and past the coverage threshold the tracker gives up on rects and asks for a full upload.
+class DirtyRectTracker {
+public:
+    void init(UINT width, UINT height, UINT maxRects, float fullUploadCoverage) {
+        mWidth = width;
+        mHeight = height;
+        mMaxRects = std::max(maxRects, 1U);
+        mFullUploadCoverage = fullUploadCoverage;
+        mRects.reserve(mMaxRects + 1);
+        this->markAll();
+    }
+
+    void add(DirtyRect rect) {
+        rect.right = std::min(rect.right, mWidth);
+        rect.bottom = std::min(rect.bottom, mHeight);
+        if (mFull || rect.empty()) {
+            return;
+        }
+
+        this->insert(rect);
+        while (mRects.size() > mMaxRects) {
+            this->mergeCheapestPair();
+        }
+
+        mDirtyArea = 0;
+        for (const DirtyRect& r : mRects) {
+            mDirtyArea += r.area();
+        }
+        if (mDirtyArea > mFullUploadCoverage * ((UINT64)mWidth * mHeight)) {
+            this->markAll();
+        }
+    }
+
+    void markAll() {
+        mRects.clear();
+        mRects.push_back(makeDirtyRect(0, 0, mWidth, mHeight));
+        mDirtyArea = (UINT64)mWidth * mHeight;
+        mFull = true;
+    }
+
+    void clear() {
+        mRects.clear();
+        mDirtyArea = 0;
+        mFull = false;
+    }
+
+    const std::vector<DirtyRect>& rects() const { return mRects; }
+    bool fullUpload() const { return mFull; }
+    bool clean() const { return mRects.empty(); }
+    float coverage() const { return mDirtyArea / (float)((UINT64)mWidth * mHeight); }
+
+private:
+    // Absorbs every rect the new one touches, again after each growth, then stores it.
+    void insert(DirtyRect rect) {
+        for (size_t i = 0; i < mRects.size();) {
+            if (dirtyRectsTouch(mRects[i], rect)) {
+                rect = unionOf(rect, mRects[i]);
+                mRects[i] = mRects.back();
+                mRects.pop_back();
+                i = 0;
+            }
+            else {
+                i++;
+            }
+        }
+        mRects.push_back(rect);
+    }
+
+    void mergeCheapestPair() {
+        size_t bestA = 0;
+        size_t bestB = 1;
+        UINT64 bestWaste = ~0ULL;
+        for (size_t a = 0; a < mRects.size(); a++) {
+            for (size_t b = a + 1; b < mRects.size(); b++) {
+                UINT64 waste = unionOf(mRects[a], mRects[b]).area() - mRects[a].area() - mRects[b].area();
+                if (waste < bestWaste) {
+                    bestWaste = waste;
+                    bestA = a;
+                    bestB = b;
+                }
+            }
+        }
+        DirtyRect merged = unionOf(mRects[bestA], mRects[bestB]);
+        mRects.erase(mRects.begin() + bestB);
+        mRects.erase(mRects.begin() + bestA);
+        this->insert(merged);
+    }
+
+    UINT mWidth = 0;
+    UINT mHeight = 0;
+    UINT mMaxRects = 1;
+    float mFullUploadCoverage = 1.0f;
+    std::vector<DirtyRect> mRects;
+    UINT64 mDirtyArea = 0;
+    bool mFull = false;
+};
+
+// Upload bytes for a rect packed on its own, with the pitch and placement alignment a placed
+// footprint needs.
+UINT64 stagingBytes(const DirtyRect& rect, UINT bytesPerPixel) {
+    UINT64 pitch = ((UINT64)rect.width() * bytesPerPixel + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
+    return (pitch * rect.height() + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+}
+
+// Copies the rows of rect from an image into staging memory with the given pitch.
+void copyRect(const UINT8* image, UINT imagePitch, const DirtyRect& rect, UINT bytesPerPixel, UINT8* destination, UINT destinationPitch) {
+    const UINT8* src = image + (size_t)rect.top * imagePitch + (size_t)rect.left * bytesPerPixel;
+    const size_t rowBytes = (size_t)rect.width() * bytesPerPixel;
+    for (UINT row = 0; row < rect.height(); row++) {
+        memcpy(destination + (size_t)row * destinationPitch, src + (size_t)row * imagePitch, rowBytes);
+    }
+}
+
+UINT32 nextRandom(UINT32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// The merge rules checked without a device; returns true when every case passes.
+bool simulateDirtyRects(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+    auto has = [](const DirtyRectTracker& tracker, UINT left, UINT top, UINT right, UINT bottom) {
+        for (const DirtyRect& r : tracker.rects()) {
+            if (r.left == left && r.top == top && r.right == right && r.bottom == bottom) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    DirtyRectTracker tracker;
+    tracker.init(256, 256, 16, 0.5f);
+    check(tracker.fullUpload() && tracker.rects().size() == 1, "a new texture starts fully dirty");
+
+    tracker.clear();
+    tracker.add(makeDirtyRect(0, 0, 10, 10));
+    tracker.add(makeDirtyRect(20, 0, 30, 10));
+    check(tracker.rects().size() == 2 && !tracker.fullUpload(), "separate rects stay separate");
+
+    tracker.clear();
+    tracker.add(makeDirtyRect(0, 0, 10, 10));
+    tracker.add(makeDirtyRect(5, 5, 15, 15));
+    check(tracker.rects().size() == 1 && has(tracker, 0, 0, 15, 15), "overlapping rects merge into their union");
+
+    tracker.clear();
+    tracker.add(makeDirtyRect(0, 0, 10, 10));
+    tracker.add(makeDirtyRect(10, 2, 20, 8));
+    tracker.add(makeDirtyRect(40, 40, 50, 50));
+    tracker.add(makeDirtyRect(40, 50, 50, 60));
+    check(tracker.rects().size() == 2 && has(tracker, 0, 0, 20, 10) && has(tracker, 40, 40, 50, 60), "rects sharing an edge merge");
+
+    tracker.clear();
+    tracker.add(makeDirtyRect(0, 0, 10, 10));
+    tracker.add(makeDirtyRect(10, 10, 20, 20));
+    check(tracker.rects().size() == 2, "rects meeting at a corner stay separate");
+
+    tracker.clear();
+    tracker.add(makeDirtyRect(0, 0, 10, 10));
+    tracker.add(makeDirtyRect(30, 0, 40, 10));
+    tracker.add(makeDirtyRect(12, 20, 28, 30));
+    tracker.add(makeDirtyRect(5, 5, 35, 25));
+    check(tracker.rects().size() == 1 && has(tracker, 0, 0, 40, 30), "a bridging rect merges everything it reaches");
+
+    tracker.clear();
+    tracker.add(makeDirtyRect(250, 250, 300, 300));
+    tracker.add(makeDirtyRect(40, 40, 40, 80));
+    check(tracker.rects().size() == 1 && has(tracker, 250, 250, 256, 256), "rects are clamped and empty rects ignored");
+
+    tracker.clear();
+    tracker.add(makeDirtyRect(0, 0, 256, 100));
+    check(!tracker.fullUpload() && tracker.coverage() > 0.39f && tracker.coverage() < 0.40f, "coverage is the dirty area");
+    tracker.add(makeDirtyRect(0, 200, 256, 256));
+    check(tracker.fullUpload() && has(tracker, 0, 0, 256, 256), "coverage above the threshold asks for a full upload");
+    tracker.add(makeDirtyRect(0, 0, 1, 1));
+    check(tracker.rects().size() == 1 && tracker.fullUpload(), "a full upload absorbs later rects");
+
+    DirtyRectTracker capped;
+    capped.init(256, 256, 4, 1.0f);
+    capped.clear();
+    for (UINT i = 0; i < 8; i++) {
+        capped.add(makeDirtyRect(i * 30, i * 30, i * 30 + 4, i * 30 + 4));
+    }
+    check(capped.rects().size() <= 4, "the rect count is capped");
+
+    // Random rects against a per-pixel reference: every dirty pixel is covered, the set stays
+    // disjoint and non-adjacent, and within the cap.
+    const UINT width = 97;
+    const UINT height = 61;
+    UINT32 state = 0x2545F491;
+    bool covered = true;
+    bool disjoint = true;
+    bool bounded = true;
+    for (UINT trial = 0; trial < 200; trial++) {
+        DirtyRectTracker random;
+        random.init(width, height, 6, 1.0f);
+        random.clear();
+        std::vector<UINT8> reference(width * height, 0);
+        UINT count = 1 + nextRandom(state) % 12;
+        for (UINT i = 0; i < count; i++) {
+            UINT left = nextRandom(state) % width;
+            UINT top = nextRandom(state) % height;
+            DirtyRect rect = makeDirtyRect(left, top, left + 1 + nextRandom(state) % 20, top + 1 + nextRandom(state) % 20);
+            random.add(rect);
+            for (UINT y = rect.top; y < std::min(rect.bottom, height); y++) {
+                for (UINT x = rect.left; x < std::min(rect.right, width); x++) {
+                    reference[y * width + x] = 1;
+                }
+            }
+        }
+        const std::vector<DirtyRect>& rects = random.rects();
+        bounded = bounded && rects.size() <= 6;
+        for (size_t a = 0; a < rects.size(); a++) {
+            for (size_t b = a + 1; b < rects.size(); b++) {
+                disjoint = disjoint && !dirtyRectsTouch(rects[a], rects[b]);
+            }
+        }
+        for (UINT y = 0; y < height; y++) {
+            for (UINT x = 0; x < width; x++) {
+                if (reference[y * width + x] == 0) {
+                    continue;
+                }
+                bool inside = false;
+                for (const DirtyRect& r : rects) {
+                    inside = inside || (x >= r.left && x < r.right && y >= r.top && y < r.bottom);
+                }
+                covered = covered && inside;
+            }
+        }
+    }
+    check(covered, "random rects: every dirty pixel is covered");
+    check(disjoint, "random rects: merged rects neither overlap nor touch");
+    check(bounded, "random rects: the rect count stays within the cap");
+
+    UINT8 image[16 * 8 * 4];
+    for (UINT i = 0; i < sizeof(image); i++) {
+        image[i] = (UINT8)i;
+    }
+    UINT8 staging[4 * 256] = {};
+    copyRect(image, 16 * 4, makeDirtyRect(3, 2, 7, 6), 4, staging, 256);
+    check(memcmp(staging, image + 2 * 64 + 3 * 4, 16) == 0 && memcmp(staging + 3 * 256, image + 5 * 64 + 3 * 4, 16) == 0, "rect rows land at the staging pitch");
+    check(stagingBytes(makeDirtyRect(0, 0, 10, 3), 4) == 1024, "staging size follows the footprint alignment");
+    return passed;
+}
+
+// Headless: cost of tracking a UI-like frame of small, clustered updates, and what the dirty
+// rects save over full uploads of a 1920x1080 RGBA8 canvas.
+std::string benchmarkDirtyRects() {
+    const UINT width = 1920;
+    const UINT height = 1080;
+    const UINT frames = 2000;
+    const UINT rectsPerFrame = 24;
+    std::vector<DirtyRect> updates((size_t)frames * rectsPerFrame);
+    UINT32 state = 0x9E3779B9;
+    for (UINT frame = 0; frame < frames; frame++) {
+        // A handful of widgets per frame, each repainting a few neighbouring pieces.
+        for (UINT i = 0; i < rectsPerFrame; i++) {
+            UINT widget = (i / 4 + frame) % 16;
+            UINT left = (widget % 4) * 460 + 20 + nextRandom(state) % 120;
+            UINT top = (widget / 4) * 260 + 20 + nextRandom(state) % 80;
+            updates[(size_t)frame * rectsPerFrame + i] = makeDirtyRect(left, top, left + 8 + nextRandom(state) % 64, top + 8 + nextRandom(state) % 32);
+        }
+    }
+
+    DirtyRectTracker tracker;
+    tracker.init(width, height, 32, 0.5f);
+    UINT64 rectCount = 0;
+    UINT64 dirtyBytes = 0;
+    double start = secondsNow();
+    for (UINT frame = 0; frame < frames; frame++) {
+        tracker.clear();
+        for (UINT i = 0; i < rectsPerFrame; i++) {
+            tracker.add(updates[(size_t)frame * rectsPerFrame + i]);
+        }
+        rectCount += tracker.rects().size();
+        for (const DirtyRect& r : tracker.rects()) {
+            dirtyBytes += stagingBytes(r, 4);
+        }
+    }
+    double trackSeconds = secondsNow() - start;
+
+    // CPU side of the upload itself: rect rows against the whole canvas.
+    std::vector<UINT8> canvas((size_t)width * height * 4, 0x80);
+    std::vector<UINT8> staging((size_t)width * height * 4);
+    const UINT copyFrames = 50;
+    start = secondsNow();
+    for (UINT frame = 0; frame < copyFrames; frame++) {
+        tracker.clear();
+        for (UINT i = 0; i < rectsPerFrame; i++) {
+            tracker.add(updates[(size_t)frame * rectsPerFrame + i]);
+        }
+        UINT64 offset = 0;
+        for (const DirtyRect& r : tracker.rects()) {
+            UINT pitch = (r.width() * 4 + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
+            copyRect(canvas.data(), width * 4, r, 4, staging.data() + offset, pitch);
+            offset += stagingBytes(r, 4);
+        }
+    }
+    double rectCopySeconds = (secondsNow() - start) / copyFrames;
+    start = secondsNow();
+    for (UINT frame = 0; frame < copyFrames; frame++) {
+        copyRect(canvas.data(), width * 4, makeDirtyRect(0, 0, width, height), 4, staging.data(), width * 4);
+    }
+    double fullCopySeconds = (secondsNow() - start) / copyFrames;
+
+    const double fullBytes = (double)width * height * 4;
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+        "Dirty rects, %ux%u RGBA8, %u updates per frame over %u frames:\n"
+        "  tracking %.3f us per frame (%.0f ns per rect), %.1f rects uploaded per frame\n"
+        "  upload %.1f KB per frame against %.1f KB full (%.2f%%)\n"
+        "  staging copy %.3f ms per frame against %.3f ms full\n",
+        width, height, rectsPerFrame, frames,
+        trackSeconds * 1e6 / frames, trackSeconds * 1e9 / ((double)frames * rectsPerFrame), rectCount / (double)frames,
+        dirtyBytes / 1024.0 / frames, fullBytes / 1024.0, dirtyBytes * 100.0 / frames / fullBytes,
+        rectCopySeconds * 1000.0, fullCopySeconds * 1000.0);
+    return buffer;
+}
+
+// An RGBA8 texture with a CPU copy that callers write directly and mark dirty. upload() packs
+// the rects dirtied since the last call into that frame's region of a persistently mapped
+// staging ring and records one CopyTextureRegion per rect; when the coverage threshold is
+// crossed, or the packed rects would not fit, the whole texture goes instead.
+class UpdatableTexture {
+public:
+    struct Stats {
+        UINT64 uploads = 0;
+        UINT64 fullUploads = 0;
+        UINT64 rects = 0;
+        UINT64 bytes = 0;
+    };
+
+    void init(ID3D12Device* device, UINT width, UINT height, UINT maxRects, float fullUploadCoverage, D3D12_CPU_DESCRIPTOR_HANDLE srvHandle) {
+        mWidth = width;
+        mHeight = height;
+        mPixels.assign((size_t)width * height, 0);
+        mTracker.init(width, height, maxRects, fullUploadCoverage);
+
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+            nullptr,
+            IID_PPV_ARGS(&mTexture)));
+
+        // Each frame's region holds a full upload, the most a frame can need.
+        UINT64 fullBytes;
+        device->GetCopyableFootprints(&textureDesc, 0, 1, 0, &mFullFootprint, nullptr, nullptr, &fullBytes);
+        mStagingBytesPerFrame = (fullBytes + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = mStagingBytesPerFrame * frameBufferCount;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&mStaging)));
+
+        // Upload heaps may stay mapped for their whole lifetime.
+        D3D12_RANGE readRange = { 0, 0 };
+        _ThrowIfFailed(mStaging->Map(0, &readRange, (void**)&mStagingData));
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = textureDesc.Format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(mTexture.Get(), &srvDesc, srvHandle);
+    }
+
+    UINT32* pixels() { return mPixels.data(); }
+    UINT width() const { return mWidth; }
+    UINT height() const { return mHeight; }
+    void markDirty(const DirtyRect& rect) { mTracker.add(rect); }
+    void markAll() { mTracker.markAll(); }
+    const Stats& stats() const { return mStats; }
+
+    // Records the copies; frameIndex picks the staging region, which must no longer be in use
+    // by the GPU.
+    void upload(ID3D12GraphicsCommandList* commandList, UINT frameIndex) {
+        if (mTracker.clean()) {
+            return;
+        }
+
+        const UINT pixelPitch = mWidth * sizeof(UINT32);
+        const UINT8* pixels = (const UINT8*)mPixels.data();
+        const UINT64 regionOffset = frameIndex * mStagingBytesPerFrame;
+        UINT8* region = mStagingData + regionOffset;
+
+        // Narrow rects pay for the pitch alignment, so packed rects can outgrow a full upload.
+        bool full = mTracker.fullUpload();
+        if (!full) {
+            UINT64 packedBytes = 0;
+            for (const DirtyRect& rect : mTracker.rects()) {
+                packedBytes += stagingBytes(rect, sizeof(UINT32));
+            }
+            full = packedBytes > mStagingBytesPerFrame;
+        }
+
+        D3D12_RESOURCE_BARRIER toCopy = {};
+        toCopy.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        toCopy.Transition.pResource = mTexture.Get();
+        toCopy.Transition.Subresource = 0;
+        toCopy.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        toCopy.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+        commandList->ResourceBarrier(1, &toCopy);
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = mTexture.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = mStaging.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+
+        if (full) {
+            copyRect(pixels, pixelPitch, makeDirtyRect(0, 0, mWidth, mHeight), sizeof(UINT32), region + mFullFootprint.Offset, mFullFootprint.Footprint.RowPitch);
+            srcLocation.PlacedFootprint = mFullFootprint;
+            srcLocation.PlacedFootprint.Offset += regionOffset;
+            commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+            mStats.fullUploads++;
+            mStats.bytes += mFullFootprint.Footprint.RowPitch * (UINT64)mHeight;
+        }
+        else {
+            UINT64 offset = 0;
+            for (const DirtyRect& rect : mTracker.rects()) {
+                const UINT pitch = (rect.width() * sizeof(UINT32) + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
+                copyRect(pixels, pixelPitch, rect, sizeof(UINT32), region + offset, pitch);
+
+                srcLocation.PlacedFootprint.Offset = regionOffset + offset;
+                srcLocation.PlacedFootprint.Footprint.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+                srcLocation.PlacedFootprint.Footprint.Width = rect.width();
+                srcLocation.PlacedFootprint.Footprint.Height = rect.height();
+                srcLocation.PlacedFootprint.Footprint.Depth = 1;
+                srcLocation.PlacedFootprint.Footprint.RowPitch = pitch;
+
+                D3D12_BOX srcBox = { 0, 0, 0, rect.width(), rect.height(), 1 };
+                commandList->CopyTextureRegion(&dstLocation, rect.left, rect.top, 0, &srcLocation, &srcBox);
+                offset += stagingBytes(rect, sizeof(UINT32));
+            }
+            mStats.rects += mTracker.rects().size();
+            mStats.bytes += offset;
+        }
+
+        D3D12_RESOURCE_BARRIER toShader = toCopy;
+        toShader.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        toShader.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        commandList->ResourceBarrier(1, &toShader);
+
+        mStats.uploads++;
+        mTracker.clear();
+    }
+
+private:
+    UINT mWidth = 0;
+    UINT mHeight = 0;
+    std::vector<UINT32> mPixels;
+    DirtyRectTracker mTracker;
+    ComPtr<ID3D12Resource> mTexture;
+    ComPtr<ID3D12Resource> mStaging;
+    UINT8* mStagingData = nullptr;
+    UINT64 mStagingBytesPerFrame = 0;
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT mFullFootprint = {};
+};
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->paintWidgets();
+        this->fillCommandList();
+
+        mFrameCount++;
+        if (mFrameCount % canvasReportFrames == 0) {
+            const UpdatableTexture::Stats& stats = mCanvas.stats();
+            UINT64 uploads = stats.uploads - mReportedStats.uploads;
+            UINT64 rectUploads = uploads - (stats.fullUploads - mReportedStats.fullUploads);
+            debugLog("Canvas: %llu uploads, %llu full, %.1f rects and %.1f KB per upload (full canvas %.1f KB)\n",
+                uploads, stats.fullUploads - mReportedStats.fullUploads,
+                rectUploads > 0 ? (stats.rects - mReportedStats.rects) / (double)rectUploads : 0.0,
+                uploads > 0 ? (stats.bytes - mReportedStats.bytes) / 1024.0 / uploads : 0.0,
+                windowWidth * windowHeight * 4 / 1024.0);
+            mReportedStats = stats;
+        }
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 1;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 1;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/002-texture.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/002-texture.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            // The canvas covers the window, one texel per pixel
+            Vertex triangleVertices[] = {
+                { { -1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 0.0f} },
+                { { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 0.0f} },
+                { { 1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {1.0f, 1.0f} },
+                { { -1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, {0.0f, 1.0f} }
+            };
+            const UINT vertexBufferSize = sizeof(triangleVertices);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = sizeof(triangleVertices);
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, triangleVertices, vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const DWORD indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = sizeof(indices);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices, ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Canvas, uploaded whole the first time
+        {
+            mCanvas.init(mDevice.Get(), windowWidth, windowHeight, canvasMaxRects, canvasFullUploadCoverage, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+            mStartTime = secondsNow();
+            this->paintBackground();
+            mCanvas.upload(mCommandList.Get(), mFrameBufferIndex);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        // The staging region of this frame buffer is free again once waitForNextFrame returned.
+        mCanvas.upload(mCommandList.Get(), mFrameBufferIndex);
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    // Fills rect in the canvas and marks it dirty; every canvas write goes through here.
+    void paintRect(const DirtyRect& rect, UINT32 color) {
+        UINT32* pixels = mCanvas.pixels();
+        const UINT right = std::min(rect.right, mCanvas.width());
+        const UINT bottom = std::min(rect.bottom, mCanvas.height());
+        for (UINT y = rect.top; y < bottom; y++) {
+            std::fill(pixels + (size_t)y * mCanvas.width() + rect.left, pixels + (size_t)y * mCanvas.width() + right, color);
+        }
+        mCanvas.markDirty(rect);
+    }
+
+    DirtyRect panelRect(UINT index) const {
+        const UINT width = (windowWidth - (canvasPanelColumns + 1) * canvasMargin) / canvasPanelColumns;
+        const UINT height = (windowHeight - (canvasPanelRows + 1) * canvasMargin) / canvasPanelRows;
+        const UINT left = canvasMargin + (index % canvasPanelColumns) * (width + canvasMargin);
+        const UINT top = canvasMargin + (index / canvasPanelColumns) * (height + canvasMargin);
+        return makeDirtyRect(left, top, left + width, top + height);
+    }
+
+    DirtyRect meterRect(UINT index) const {
+        DirtyRect panel = this->panelRect(2);
+        const UINT width = (panel.width() - 24) / _countof(mMeterLevels);
+        const UINT left = panel.left + 12 + index * width;
+        return makeDirtyRect(left, panel.top + canvasTitleHeight + 12, left + width - 4, panel.bottom - 12);
+    }
+
+    // The static part of the canvas. Dirtying all of it crosses the coverage threshold, so a
+    // repaint goes up as one full upload.
+    void paintBackground() {
+        this->paintRect(makeDirtyRect(0, 0, windowWidth, windowHeight), canvasBackgroundColor);
+        for (UINT i = 0; i < canvasPanelColumns * canvasPanelRows; i++) {
+            DirtyRect panel = this->panelRect(i);
+            this->paintRect(panel, canvasPanelColor);
+            this->paintRect(makeDirtyRect(panel.left, panel.top, panel.right, panel.top + canvasTitleHeight), canvasTitleColor);
+        }
+        for (UINT i = 0; i < _countof(mMeterLevels); i++) {
+            this->paintRect(this->meterRect(i), 0xff202020);
+            mMeterLevels[i] = 0;
+        }
+        mBoxRect = DirtyRect();
+        mProgress = 0;
+        mCursorOn = false;
+        mShownSecond = ~0U;
+    }
+
+    // Widgets that change every frame, each repainting a small region of its panel.
+    void paintWidgets() {
+        const double elapsed = secondsNow() - mStartTime;
+
+        // Panel 0: a bouncing box. Erasing the old position and painting the new one dirties
+        // two overlapping rects, which the tracker merges into one.
+        {
+            DirtyRect area = this->panelRect(0);
+            area.top += canvasTitleHeight;
+            const UINT size = 40;
+            const UINT rangeX = area.width() - size;
+            const UINT rangeY = area.height() - size;
+            UINT x = (UINT)(elapsed * 150.0) % (rangeX * 2);
+            UINT y = (UINT)(elapsed * 110.0) % (rangeY * 2);
+            x = x < rangeX ? x : rangeX * 2 - x;
+            y = y < rangeY ? y : rangeY * 2 - y;
+            if (!mBoxRect.empty()) {
+                this->paintRect(mBoxRect, canvasPanelColor);
+            }
+            mBoxRect = makeDirtyRect(area.left + x, area.top + y, area.left + x + size, area.top + y + size);
+            this->paintRect(mBoxRect, 0xff30a0f0);
+        }
+
+        // Panel 1: a progress bar growing a pixel column per frame.
+        {
+            DirtyRect panel = this->panelRect(1);
+            DirtyRect bar = makeDirtyRect(panel.left + 12, panel.top + 60, panel.right - 12, panel.top + 84);
+            if (mProgress == 0) {
+                this->paintRect(bar, 0xff202020);
+            }
+            this->paintRect(makeDirtyRect(bar.left + mProgress, bar.top, bar.left + mProgress + 1, bar.bottom), 0xff40d060);
+            mProgress = (mProgress + 1) % bar.width();
+        }
+
+        // Panel 2: level meters. Only the span between the old and the new level is repainted.
+        for (UINT i = 0; i < _countof(mMeterLevels); i++) {
+            DirtyRect column = this->meterRect(i);
+            UINT level = (UINT)((0.5 + 0.5 * sin(elapsed * 3.0 + i * 0.7)) * column.height());
+            if (level > mMeterLevels[i]) {
+                this->paintRect(makeDirtyRect(column.left, column.bottom - level, column.right, column.bottom - mMeterLevels[i]), 0xff20c0f0);
+            }
+            else if (level < mMeterLevels[i]) {
+                this->paintRect(makeDirtyRect(column.left, column.bottom - mMeterLevels[i], column.right, column.bottom - level), 0xff202020);
+            }
+            mMeterLevels[i] = level;
+        }
+
+        // Panel 3: a blinking cursor.
+        {
+            DirtyRect panel = this->panelRect(3);
+            bool on = fmod(elapsed, 1.0) < 0.5;
+            if (on != mCursorOn) {
+                mCursorOn = on;
+                this->paintRect(makeDirtyRect(panel.left + 20, panel.top + 50, panel.left + 23, panel.top + 70), on ? 0xffffffff : canvasPanelColor);
+            }
+        }
+
+        // Panel 4: the seconds as binary lamps, changing once a second.
+        {
+            DirtyRect panel = this->panelRect(4);
+            UINT second = (UINT)elapsed;
+            if (second != mShownSecond) {
+                for (UINT bit = 0; bit < 8; bit++) {
+                    bool lit = (second >> bit) & 1;
+                    if (mShownSecond == ~0U || lit != (((mShownSecond >> bit) & 1) != 0)) {
+                        UINT left = panel.right - 32 - bit * 28;
+                        this->paintRect(makeDirtyRect(left, panel.top + 60, left + 20, panel.top + 80), lit ? 0xff4040f0 : 0xff303030);
+                    }
+                }
+                mShownSecond = second;
+            }
+        }
+    }
+
+    void repaint() {
+        this->paintBackground();
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+
+    UpdatableTexture mCanvas;
+    UpdatableTexture::Stats mReportedStats;
+    double mStartTime = 0.0;
+    UINT64 mFrameCount = 0;
+    DirtyRect mBoxRect;
+    UINT mProgress = 0;
+    UINT mMeterLevels[8] = {};
+    bool mCursorOn = false;
+    UINT mShownSecond = ~0U;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateDirtyRects(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkDirtyRects();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                // R repaints the whole canvas, which goes up as a full upload
+                if (msg.message == WM_KEYDOWN && msg.wParam == 'R') {
+                    graphics.repaint();
+                }
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
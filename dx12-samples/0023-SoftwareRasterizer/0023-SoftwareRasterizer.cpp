@@ -0,0 +1,1797 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+#include <emmintrin.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0023-SoftwareRasterizer";
+const char* windowClass = "0023-SoftwareRasterizer";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Small fork-join pool. run() splits [0, count) into chunks that the workers and the calling
+// thread pull from an atomic counter, and returns once every chunk is done. The job is passed
+// as a function pointer plus context, so dispatching allocates nothing.
+class ParallelFor {
+public:
+    void start(UINT workerCount) {
+        for (UINT i = 0; i < workerCount; i++) {
+            mWorkers.push_back(std::thread([this]() { this->worker(); }));
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+        for (std::thread& worker : mWorkers) {
+            worker.join();
+        }
+        mWorkers.clear();
+    }
+
+    UINT workerCount() const { return (UINT)mWorkers.size(); }
+
+    template<typename F>
+    void run(UINT count, UINT chunkSize, const F& fn) {
+        if (mWorkers.empty() || count <= chunkSize) {
+            fn(0, count);
+            return;
+        }
+        this->dispatch(count, chunkSize, [](const void* context, UINT begin, UINT end) { (*(const F*)context)(begin, end); }, &fn);
+    }
+
+private:
+    typedef void (*JobFunction)(const void* context, UINT begin, UINT end);
+
+    void dispatch(UINT count, UINT chunkSize, JobFunction function, const void* context) {
+        {
+            // Wait for stragglers of the previous job before the job fields are replaced.
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait(lock, [this]() { return mActive == 0; });
+            mFunction = function;
+            mContext = context;
+            mCount = count;
+            mChunkSize = chunkSize;
+            mNextChunk = 0;
+            mGeneration++;
+        }
+        mWake.notify_all();
+
+        this->work();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mActive == 0; });
+    }
+
+    void work() {
+        UINT chunkCount = (mCount + mChunkSize - 1) / mChunkSize;
+        for (;;) {
+            UINT chunk = mNextChunk++;
+            if (chunk >= chunkCount) {
+                return;
+            }
+            UINT begin = chunk * mChunkSize;
+            mFunction(mContext, begin, std::min(begin + mChunkSize, mCount));
+        }
+    }
+
+    void worker() {
+        UINT64 seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [&]() { return mStop || mGeneration != seen; });
+                if (mStop) {
+                    return;
+                }
+                seen = mGeneration;
+                mActive++;
+            }
+
+            this->work();
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mActive == 0) {
+                mDone.notify_all();
+            }
+        }
+    }
+
+private:
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    JobFunction mFunction = nullptr;
+    const void* mContext = nullptr;
+    UINT mCount = 0;
+    UINT mChunkSize = 1;
+    std::atomic<UINT> mNextChunk;
+    UINT64 mGeneration = 0;
+    UINT mActive = 0;
+    bool mStop = false;
+};
+
+// RGBA8 texels, in the same byte order as DXGI_FORMAT_R8G8B8A8_UNORM.
+struct SoftwareTexture {
+    UINT width = 0;
+    UINT height = 0;
+    const UINT32* texels = nullptr;
+};
+
+struct SoftwareTarget {
+    UINT width = 0;
+    UINT height = 0;
+    UINT32* pixels = nullptr;
+};
+
+// An indexed triangle list drawn with 002-texture.hlsl: positions pass through with w = 1 and
+// the pixel shader returns the point sampled texel.
+struct SoftwareDraw {
+    const Vertex* vertices = nullptr;
+    const UINT* indices = nullptr;
+    UINT indexCount = 0;
+    const SoftwareTexture* texture = nullptr;
+};
+
+// Float to UNORM8 as the output merger converts it.
+UINT32 packUnorm(const float rgba[4]) {
+    UINT32 packed = 0;
+    for (UINT i = 0; i < 4; i++) {
+        float c = std::min(std::max(rgba[i], 0.0f), 1.0f);
+        packed |= (UINT32)(c * 255.0f + 0.5f) << (i * 8);
+    }
+    return packed;
+}
+
+INT64 floorDiv256(INT64 value) {
+    return (value >= 0 ? value : value - 255) / 256;
+}
+
+// Rasterizer setup for one triangle. Positions are snapped to 24.8 fixed point like the
+// hardware does, and E(p) = dx * (p.y - y) - dy * (p.x - x) - bias is exact in 64 bits, so
+// coverage, including the top-left rule on shared edges, is decided without rounding.
+struct SoftwareTriangle {
+    INT64 edgeX[3];
+    INT64 edgeY[3];
+    INT64 edgeDx[3];
+    INT64 edgeDy[3];
+    INT64 edgeBias[3];
+    // Pixel bounds, inclusive and clamped to the target
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+    // Texture coordinate planes around the first vertex, in pixels
+    float originX;
+    float originY;
+    float u0;
+    float uX;
+    float uY;
+    float v0;
+    float vX;
+    float vY;
+    const SoftwareTexture* texture;
+};
+
+// Snapped positions must stay within this many pixels of the origin, which keeps every edge
+// value the SIMD path steps through inside 32 bits. There is no clipping; triangles reaching
+// further are dropped.
+const float softwareGuardBand = 16384.0f;
+
+// Returns false for triangles that produce no pixels: back facing (counter-clockwise on screen,
+// the pipeline's default front face is clockwise), degenerate, outside the target or the
+// guard band.
+bool setupTriangle(const Vertex& a, const Vertex& b, const Vertex& c, UINT width, UINT height, const SoftwareTexture* texture, SoftwareTriangle& t) {
+    const Vertex* vertices[3] = { &a, &b, &c };
+    const float halfWidth = width * 0.5f;
+    const float halfHeight = height * 0.5f;
+    INT64 x[3];
+    INT64 y[3];
+    for (UINT i = 0; i < 3; i++) {
+        // The viewport transform, in the same float operations
+        float sx = vertices[i]->pos.x * halfWidth + halfWidth;
+        float sy = -vertices[i]->pos.y * halfHeight + halfHeight;
+        if (!(fabsf(sx) < softwareGuardBand && fabsf(sy) < softwareGuardBand)) {
+            return false;
+        }
+        x[i] = (INT64)lrintf(sx * 256.0f);
+        y[i] = (INT64)lrintf(sy * 256.0f);
+    }
+
+    INT64 area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (area <= 0) {
+        return false;
+    }
+
+    // Pixel centers sit at +128 in fixed point.
+    INT64 left = std::min(std::min(x[0], x[1]), x[2]);
+    INT64 top = std::min(std::min(y[0], y[1]), y[2]);
+    INT64 right = std::max(std::max(x[0], x[1]), x[2]);
+    INT64 bottom = std::max(std::max(y[0], y[1]), y[2]);
+    t.minX = (int)std::max<INT64>(-floorDiv256(128 - left), 0);
+    t.minY = (int)std::max<INT64>(-floorDiv256(128 - top), 0);
+    t.maxX = (int)std::min<INT64>(floorDiv256(right - 128), (INT64)width - 1);
+    t.maxY = (int)std::min<INT64>(floorDiv256(bottom - 128), (INT64)height - 1);
+    if (t.minX > t.maxX || t.minY > t.maxY) {
+        return false;
+    }
+
+    for (UINT e = 0; e < 3; e++) {
+        UINT next = (e + 1) % 3;
+        t.edgeX[e] = x[e];
+        t.edgeY[e] = y[e];
+        t.edgeDx[e] = x[next] - x[e];
+        t.edgeDy[e] = y[next] - y[e];
+        // Top-left rule: pixel centers exactly on a top or left edge belong to the triangle.
+        bool topLeft = (t.edgeDy[e] == 0 && t.edgeDx[e] > 0) || t.edgeDy[e] < 0;
+        t.edgeBias[e] = topLeft ? 0 : 1;
+    }
+
+    const double d1x = (x[1] - x[0]) / 256.0;
+    const double d1y = (y[1] - y[0]) / 256.0;
+    const double d2x = (x[2] - x[0]) / 256.0;
+    const double d2y = (y[2] - y[0]) / 256.0;
+    const double det = d1x * d2y - d1y * d2x;
+    const double du1 = b.uv.x - a.uv.x;
+    const double du2 = c.uv.x - a.uv.x;
+    const double dv1 = b.uv.y - a.uv.y;
+    const double dv2 = c.uv.y - a.uv.y;
+    t.originX = (float)(x[0] / 256.0);
+    t.originY = (float)(y[0] / 256.0);
+    t.u0 = a.uv.x;
+    t.uX = (float)((du1 * d2y - du2 * d1y) / det);
+    t.uY = (float)((du2 * d1x - du1 * d2x) / det);
+    t.v0 = a.uv.y;
+    t.vX = (float)((dv1 * d2y - dv2 * d1y) / det);
+    t.vY = (float)((dv2 * d1x - dv1 * d2x) / det);
+    t.texture = texture;
+    return true;
+}
+
+INT64 edgeAt(const SoftwareTriangle& t, UINT e, int px, int py) {
+    return t.edgeDx[e] * ((INT64)py * 256 + 128 - t.edgeY[e]) - t.edgeDy[e] * ((INT64)px * 256 + 128 - t.edgeX[e]) - t.edgeBias[e];
+}
+
+bool coversPixel(const SoftwareTriangle& t, int px, int py) {
+    return edgeAt(t, 0, px, py) >= 0 && edgeAt(t, 1, px, py) >= 0 && edgeAt(t, 2, px, py) >= 0;
+}
+
+// Point sampling with border addressing; the border colour is transparent black.
+UINT32 sampleTexel(const SoftwareTexture& texture, float u, float v) {
+    float tu = u * (float)texture.width;
+    float tv = v * (float)texture.height;
+    if (!(tu >= 0.0f && tu < (float)texture.width && tv >= 0.0f && tv < (float)texture.height)) {
+        return 0;
+    }
+    return texture.texels[(UINT)tv * texture.width + (UINT)tu];
+}
+
+// Evaluated in exactly this order by both paths, so they agree to the bit.
+UINT32 shadePixel(const SoftwareTriangle& t, int px, int py) {
+    float dx = ((float)px + 0.5f) - t.originX;
+    float dy = ((float)py + 0.5f) - t.originY;
+    float u = (t.u0 + t.uX * dx) + t.uY * dy;
+    float v = (t.v0 + t.vX * dx) + t.vY * dy;
+    return sampleTexel(*t.texture, u, v);
+}
+
+// One pixel at a time over each bounding box: the reference the tiled renderer must match.
+void renderReference(const SoftwareTarget& target, UINT32 background, const SoftwareDraw* draws, UINT drawCount) {
+    std::fill(target.pixels, target.pixels + (size_t)target.width * target.height, background);
+    for (UINT d = 0; d < drawCount; d++) {
+        const SoftwareDraw& draw = draws[d];
+        for (UINT i = 0; i + 2 < draw.indexCount; i += 3) {
+            SoftwareTriangle t;
+            if (!setupTriangle(draw.vertices[draw.indices[i]], draw.vertices[draw.indices[i + 1]], draw.vertices[draw.indices[i + 2]],
+                target.width, target.height, draw.texture, t)) {
+                continue;
+            }
+            for (int py = t.minY; py <= t.maxY; py++) {
+                for (int px = t.minX; px <= t.maxX; px++) {
+                    if (coversPixel(t, px, py)) {
+                        target.pixels[(size_t)py * target.width + px] = shadePixel(t, px, py);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Tile size for binning, and the block size coverage is classified at
+const UINT softwareTileSize = 64;
+const UINT softwareBlockSize = 8;
+
+// Sets up triangles in parallel, bins them into screen tiles in submission order, then clears
+// and rasterizes the tiles in parallel; a tile is only ever touched by one thread. Within a
+// tile, 8x8 blocks are accepted or rejected per edge from their corners, and the pixels of
+// blocks an edge crosses are tested four at a time with SSE2.
+class SoftwareRasterizer {
+public:
+    struct Stats {
+        UINT64 triangles = 0;
+        UINT64 visible = 0;
+        UINT64 binned = 0;
+        UINT64 pixels = 0;
+    };
+
+    void init(UINT threads) {
+        mPool.start(threads > 1 ? threads - 1 : 0);
+    }
+
+    void shutdown() {
+        mPool.stop();
+    }
+
+    UINT threadCount() const { return mPool.workerCount() + 1; }
+
+    const Stats& render(const SoftwareTarget& target, UINT32 background, const SoftwareDraw* draws, UINT drawCount) {
+        mStats = Stats();
+        mTilesX = (target.width + softwareTileSize - 1) / softwareTileSize;
+        mTilesY = (target.height + softwareTileSize - 1) / softwareTileSize;
+        const UINT tileCount = mTilesX * mTilesY;
+        if (mBins.size() < tileCount) {
+            mBins.resize(tileCount);
+            mTilePixels.resize(tileCount);
+        }
+        for (UINT i = 0; i < tileCount; i++) {
+            mBins[i].clear();
+        }
+
+        mDrawStarts.clear();
+        UINT triangleCount = 0;
+        for (UINT d = 0; d < drawCount; d++) {
+            mDrawStarts.push_back(triangleCount);
+            triangleCount += draws[d].indexCount / 3;
+        }
+        if (mTriangles.size() < triangleCount) {
+            mTriangles.resize(triangleCount);
+            mVisible.resize(triangleCount);
+        }
+
+        mPool.run(triangleCount, 1024, [&](UINT begin, UINT end) {
+            UINT d = (UINT)(std::upper_bound(mDrawStarts.begin(), mDrawStarts.end(), begin) - mDrawStarts.begin()) - 1;
+            for (UINT i = begin; i < end; i++) {
+                while (d + 1 < drawCount && i >= mDrawStarts[d + 1]) {
+                    d++;
+                }
+                const SoftwareDraw& draw = draws[d];
+                const UINT* indices = draw.indices + (i - mDrawStarts[d]) * 3;
+                mVisible[i] = setupTriangle(draw.vertices[indices[0]], draw.vertices[indices[1]], draw.vertices[indices[2]],
+                    target.width, target.height, draw.texture, mTriangles[i]);
+            }
+        });
+
+        for (UINT i = 0; i < triangleCount; i++) {
+            if (!mVisible[i]) {
+                continue;
+            }
+            const SoftwareTriangle& t = mTriangles[i];
+            mStats.visible++;
+            for (UINT ty = t.minY / softwareTileSize; ty <= t.maxY / softwareTileSize; ty++) {
+                for (UINT tx = t.minX / softwareTileSize; tx <= t.maxX / softwareTileSize; tx++) {
+                    mBins[ty * mTilesX + tx].push_back(i);
+                    mStats.binned++;
+                }
+            }
+        }
+        mStats.triangles = triangleCount;
+
+        mPool.run(tileCount, 1, [&](UINT begin, UINT end) {
+            for (UINT tile = begin; tile < end; tile++) {
+                mTilePixels[tile] = this->renderTile(target, background, tile);
+            }
+        });
+        for (UINT i = 0; i < tileCount; i++) {
+            mStats.pixels += mTilePixels[i];
+        }
+        return mStats;
+    }
+
+private:
+    UINT64 renderTile(const SoftwareTarget& target, UINT32 background, UINT tile) {
+        const int tileX = (int)((tile % mTilesX) * softwareTileSize);
+        const int tileY = (int)((tile / mTilesX) * softwareTileSize);
+        const int tileRight = std::min(tileX + (int)softwareTileSize, (int)target.width) - 1;
+        const int tileBottom = std::min(tileY + (int)softwareTileSize, (int)target.height) - 1;
+
+        for (int y = tileY; y <= tileBottom; y++) {
+            std::fill(target.pixels + (size_t)y * target.width + tileX, target.pixels + (size_t)y * target.width + tileRight + 1, background);
+        }
+
+        UINT64 pixels = 0;
+        for (UINT index : mBins[tile]) {
+            const SoftwareTriangle& t = mTriangles[index];
+            // Blocks stay aligned to the tile so partial blocks only occur at the target edge.
+            const int x0 = tileX + (std::max(t.minX, tileX) - tileX) / (int)softwareBlockSize * (int)softwareBlockSize;
+            const int y0 = tileY + (std::max(t.minY, tileY) - tileY) / (int)softwareBlockSize * (int)softwareBlockSize;
+            const int x1 = std::min(t.maxX, tileRight);
+            const int y1 = std::min(t.maxY, tileBottom);
+            for (int by = y0; by <= y1; by += softwareBlockSize) {
+                for (int bx = x0; bx <= x1; bx += softwareBlockSize) {
+                    pixels += this->renderBlock(target, t, bx, by, tileRight, tileBottom);
+                }
+            }
+        }
+        return pixels;
+    }
+
+    UINT64 renderBlock(const SoftwareTarget& target, const SoftwareTriangle& t, int bx, int by, int right, int bottom) {
+        const int last = softwareBlockSize - 1;
+        bool partial[3];
+        int q[3];
+        for (UINT e = 0; e < 3; e++) {
+            // Corner values bound the block since the edge function is linear.
+            INT64 origin = edgeAt(t, e, bx, by);
+            INT64 stepX = -t.edgeDy[e] * 256 * last;
+            INT64 stepY = t.edgeDx[e] * 256 * last;
+            INT64 low = origin + std::min<INT64>(stepX, 0) + std::min<INT64>(stepY, 0);
+            INT64 high = origin + std::max<INT64>(stepX, 0) + std::max<INT64>(stepY, 0);
+            if (high < 0) {
+                return 0;
+            }
+            partial[e] = low < 0;
+            // E >= 0 exactly when floor(E / 256) >= 0, and every pixel step is a multiple of 256,
+            // so the block steps through floor(E / 256) with the edge deltas. The edge crosses the
+            // block, which keeps these values small.
+            q[e] = partial[e] ? (int)floorDiv256(origin) : 0;
+        }
+
+        const __m128i laneIndex = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128i minusOne = _mm_set1_epi32(-1);
+        // Small triangles cover a corner of the block; only their rows and halves are visited.
+        const int firstRow = std::max(t.minY - by, 0);
+        const int lastRow = std::min(std::min(t.maxY, bottom) - by, last);
+        const int firstHalf = t.minX - bx >= 4 ? 1 : 0;
+        const int lastHalf = t.maxX - bx < 4 ? 0 : 1;
+
+        __m128i rowQ[3];
+        __m128i stepQ[3];
+        __m128i halfQ[3];
+        for (UINT e = 0; e < 3; e++) {
+            int dqx = (int)-t.edgeDy[e];
+            int start = q[e] + firstRow * (int)t.edgeDx[e];
+            rowQ[e] = _mm_setr_epi32(start, start + dqx, start + dqx * 2, start + dqx * 3);
+            halfQ[e] = _mm_set1_epi32(dqx * 4);
+            stepQ[e] = _mm_set1_epi32((int)t.edgeDx[e]);
+        }
+
+        const __m128 u0 = _mm_set1_ps(t.u0);
+        const __m128 uX = _mm_set1_ps(t.uX);
+        const __m128 uY = _mm_set1_ps(t.uY);
+        const __m128 v0 = _mm_set1_ps(t.v0);
+        const __m128 vX = _mm_set1_ps(t.vX);
+        const __m128 vY = _mm_set1_ps(t.vY);
+        const __m128 originX = _mm_set1_ps(t.originX);
+        const __m128 texWidth = _mm_set1_ps((float)t.texture->width);
+        const __m128 texHeight = _mm_set1_ps((float)t.texture->height);
+        const __m128 zero = _mm_setzero_ps();
+
+        UINT64 pixels = 0;
+        for (int row = firstRow; row <= lastRow; row++) {
+            const int py = by + row;
+            const __m128 dy = _mm_set1_ps(((float)py + 0.5f) - t.originY);
+            UINT32* line = target.pixels + (size_t)py * target.width;
+            for (int half = firstHalf; half <= lastHalf; half++) {
+                const int px = bx + half * 4;
+                if (px > right) {
+                    break;
+                }
+                __m128i mask = minusOne;
+                for (UINT e = 0; e < 3; e++) {
+                    if (partial[e]) {
+                        __m128i value = half == 0 ? rowQ[e] : _mm_add_epi32(rowQ[e], halfQ[e]);
+                        mask = _mm_and_si128(mask, _mm_cmpgt_epi32(value, minusOne));
+                    }
+                }
+                const int valid = right - px + 1;
+                if (valid < 4) {
+                    mask = _mm_and_si128(mask, _mm_cmplt_epi32(laneIndex, _mm_set1_epi32(valid)));
+                }
+                const int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+                if (bits == 0) {
+                    continue;
+                }
+
+                // The same float operations as shadePixel, four lanes at a time.
+                __m128 dx = _mm_sub_ps(_mm_add_ps(_mm_set1_ps((float)px), laneOffset), originX);
+                __m128 u = _mm_add_ps(_mm_add_ps(u0, _mm_mul_ps(uX, dx)), _mm_mul_ps(uY, dy));
+                __m128 v = _mm_add_ps(_mm_add_ps(v0, _mm_mul_ps(vX, dx)), _mm_mul_ps(vY, dy));
+                __m128 tu = _mm_mul_ps(u, texWidth);
+                __m128 tv = _mm_mul_ps(v, texHeight);
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(tu, zero), _mm_cmplt_ps(tu, texWidth)),
+                    _mm_and_ps(_mm_cmpge_ps(tv, zero), _mm_cmplt_ps(tv, texHeight)));
+                // Out of range lanes are zeroed before converting, their texel is the border.
+                alignas(16) int texelX[4];
+                alignas(16) int texelY[4];
+                _mm_store_si128((__m128i*)texelX, _mm_cvttps_epi32(_mm_and_ps(tu, inside)));
+                _mm_store_si128((__m128i*)texelY, _mm_cvttps_epi32(_mm_and_ps(tv, inside)));
+                alignas(16) UINT32 texels[4];
+                for (UINT lane = 0; lane < 4; lane++) {
+                    texels[lane] = t.texture->texels[texelY[lane] * t.texture->width + texelX[lane]];
+                }
+                __m128i color = _mm_and_si128(_mm_load_si128((const __m128i*)texels), _mm_castps_si128(inside));
+
+                if (valid >= 4) {
+                    __m128i existing = _mm_loadu_si128((const __m128i*)(line + px));
+                    _mm_storeu_si128((__m128i*)(line + px), _mm_or_si128(_mm_and_si128(mask, color), _mm_andnot_si128(mask, existing)));
+                }
+                else {
+                    // A full store here would reach into the next row, which another tile owns.
+                    alignas(16) UINT32 colors[4];
+                    _mm_store_si128((__m128i*)colors, color);
+                    for (int lane = 0; lane < valid; lane++) {
+                        if (bits & (1 << lane)) {
+                            line[px + lane] = colors[lane];
+                        }
+                    }
+                }
+                pixels += popCount4(bits);
+            }
+            for (UINT e = 0; e < 3; e++) {
+                rowQ[e] = _mm_add_epi32(rowQ[e], stepQ[e]);
+            }
+        }
+        return pixels;
+    }
+
+    static UINT popCount4(int bits) {
+        return (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+    }
+
+    ParallelFor mPool;
+    Stats mStats;
+    UINT mTilesX = 0;
+    UINT mTilesY = 0;
+    std::vector<std::vector<UINT>> mBins;
+    std::vector<UINT64> mTilePixels;
+    std::vector<UINT> mDrawStarts;
+    std::vector<SoftwareTriangle> mTriangles;
+    std::vector<UINT8> mVisible;
+};
+
+// The checkerboard of the texture samples: 8x8 cells, black where the cell row and column
+// parity match.
+void makeCheckerboard(std::vector<UINT32>& texels, UINT width, UINT height) {
+    texels.resize((size_t)width * height);
+    const UINT cellWidth = width >> 3;
+    const UINT cellHeight = width >> 3;
+    for (UINT y = 0; y < height; y++) {
+        for (UINT x = 0; x < width; x++) {
+            texels[(size_t)y * width + x] = (x / cellWidth) % 2 == (y / cellHeight) % 2 ? 0xff000000 : 0xffffffff;
+        }
+    }
+}
+
+struct SoftwareScene {
+    std::vector<Vertex> vertices;
+    std::vector<UINT> indices;
+};
+
+// A quad in clip space with its corners listed clockwise on screen, indexed like the samples.
+void appendQuad(SoftwareScene& scene, float left, float top, float right, float bottom, float u0, float v0, float u1, float v1) {
+    UINT base = (UINT)scene.vertices.size();
+    Vertex corners[4] = {
+        { { left, top, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { u0, v1 } },
+        { { right, top, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { u1, v1 } },
+        { { right, bottom, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { u1, v0 } },
+        { { left, bottom, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { u0, v0 } }
+    };
+    scene.vertices.insert(scene.vertices.end(), corners, corners + 4);
+    const UINT indices[] = { 0, 1, 2, 2, 3, 0 };
+    for (UINT index : indices) {
+        scene.indices.push_back(base + index);
+    }
+}
+
+// The textured quad of the texture samples.
+SoftwareScene sampleQuadScene(float aspect) {
+    SoftwareScene scene;
+    appendQuad(scene, -0.25f, 0.25f * aspect, 0.25f, -0.25f * aspect, 0.0f, 0.0f, 1.0f, 1.0f);
+    return scene;
+}
+
+// A jittered grid of quads; with border the outer ring of vertices lies beyond the target.
+SoftwareScene gridScene(UINT columns, UINT rows, float extent, float jitter, UINT32 seed) {
+    SoftwareScene scene;
+    auto random = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return (seed & 0xffffff) / (float)0x1000000;
+    };
+    for (UINT y = 0; y <= rows; y++) {
+        for (UINT x = 0; x <= columns; x++) {
+            float px = -extent + 2.0f * extent * x / columns;
+            float py = extent - 2.0f * extent * y / rows;
+            bool edge = x == 0 || y == 0 || x == columns || y == rows;
+            if (!edge) {
+                px += (random() - 0.5f) * jitter * 2.0f * extent / columns;
+                py += (random() - 0.5f) * jitter * 2.0f * extent / rows;
+            }
+            Vertex vertex = { { px, py, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { (float)x / columns, (float)y / rows } };
+            scene.vertices.push_back(vertex);
+        }
+    }
+    for (UINT y = 0; y < rows; y++) {
+        for (UINT x = 0; x < columns; x++) {
+            UINT topLeft = y * (columns + 1) + x;
+            UINT quad[6] = { topLeft, topLeft + 1, topLeft + columns + 2, topLeft + columns + 2, topLeft + columns + 1, topLeft };
+            scene.indices.insert(scene.indices.end(), quad, quad + 6);
+        }
+    }
+    return scene;
+}
+
+// Device-less checks of the fill rules and of the tiled renderer against the reference.
+bool simulateSoftwareRasterizer(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+
+    std::vector<UINT32> checkerboard;
+    makeCheckerboard(checkerboard, 256, 256);
+    SoftwareTexture texture;
+    texture.width = 256;
+    texture.height = 256;
+    texture.texels = checkerboard.data();
+    const UINT32 background = packUnorm(clearColor);
+
+    auto coverageCounts = [&texture](const SoftwareScene& scene, UINT width, UINT height) {
+        std::vector<UINT> counts((size_t)width * height, 0);
+        for (size_t i = 0; i + 2 < scene.indices.size(); i += 3) {
+            SoftwareTriangle t;
+            if (setupTriangle(scene.vertices[scene.indices[i]], scene.vertices[scene.indices[i + 1]], scene.vertices[scene.indices[i + 2]], width, height, &texture, t)) {
+                for (int y = t.minY; y <= t.maxY; y++) {
+                    for (int x = t.minX; x <= t.maxX; x++) {
+                        counts[(size_t)y * width + x] += coversPixel(t, x, y) ? 1 : 0;
+                    }
+                }
+            }
+        }
+        return counts;
+    };
+
+    // Edges through pixel centers on a 16x16 target: x 2.5 to 6.5, y 2.5 to 5.5.
+    {
+        SoftwareScene rect;
+        appendQuad(rect, -0.6875f, 0.6875f, -0.1875f, 0.3125f, 0.0f, 0.0f, 1.0f, 1.0f);
+        std::vector<UINT> counts = coverageCounts(rect, 16, 16);
+        bool exact = true;
+        for (UINT y = 0; y < 16; y++) {
+            for (UINT x = 0; x < 16; x++) {
+                UINT expected = (x >= 2 && x <= 5 && y >= 2 && y <= 4) ? 1 : 0;
+                exact = exact && counts[y * 16 + x] == expected;
+            }
+        }
+        check(exact, "top and left edges are inside, right and bottom edges outside, the diagonal is drawn once");
+    }
+
+    {
+        SoftwareScene grid = gridScene(12, 12, 1.2f, 0.8f, 0x1234567);
+        std::vector<UINT> counts = coverageCounts(grid, 64, 64);
+        bool once = std::all_of(counts.begin(), counts.end(), [](UINT count) { return count == 1; });
+        check(once, "a jittered mesh covers every pixel exactly once");
+    }
+
+    {
+        SoftwareScene flipped = sampleQuadScene(1.0f);
+        std::swap(flipped.indices[1], flipped.indices[2]);
+        std::swap(flipped.indices[4], flipped.indices[5]);
+        std::vector<UINT> counts = coverageCounts(flipped, 64, 64);
+        check(std::all_of(counts.begin(), counts.end(), [](UINT count) { return count == 0; }), "counter-clockwise triangles are culled");
+    }
+
+    SoftwareRasterizer rasterizer;
+    rasterizer.init(4);
+    auto compare = [&](const SoftwareScene& scene, UINT width, UINT height, const char* name) {
+        std::vector<UINT32> reference((size_t)width * height);
+        std::vector<UINT32> tiled((size_t)width * height);
+        SoftwareDraw draw;
+        draw.vertices = scene.vertices.data();
+        draw.indices = scene.indices.data();
+        draw.indexCount = (UINT)scene.indices.size();
+        draw.texture = &texture;
+        SoftwareTarget target;
+        target.width = width;
+        target.height = height;
+        target.pixels = reference.data();
+        renderReference(target, background, &draw, 1);
+        target.pixels = tiled.data();
+        rasterizer.render(target, background, &draw, 1);
+        check(reference == tiled, name);
+        return reference;
+    };
+
+    SoftwareScene quad = sampleQuadScene(800.0f / 600.0f);
+    std::vector<UINT32> image = compare(quad, 800, 600, "the sample quad at 800x600 matches the reference");
+    // Analytically: (400, 300) samples texel (128, 127), cell (4, 3), white
+    check(image[300 * 800 + 400] == 0xffffffff && image[300 * 800 + 299] == background && image[300 * 800 + 300] != background,
+        "the sample quad lands where the pipeline puts it");
+    compare(quad, 333, 217, "the sample quad at 333x217 matches the reference");
+    compare(gridScene(40, 30, 1.3f, 0.9f, 0x2545F491), 257, 191, "a jittered mesh reaching past the target matches the reference");
+
+    SoftwareScene soup;
+    UINT32 seed = 0x9E3779B9;
+    auto random = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return (seed & 0xffffff) / (float)0x1000000;
+    };
+    for (UINT i = 0; i < 600; i++) {
+        float cx = random() * 2.4f - 1.2f;
+        float cy = random() * 2.4f - 1.2f;
+        float size = i % 10 == 0 ? 1.0f : 0.1f;
+        for (UINT k = 0; k < 3; k++) {
+            // Texture coordinates from -0.5 to 1.5 reach into the border.
+            Vertex vertex = { { cx + (random() - 0.5f) * size, cy + (random() - 0.5f) * size, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, { random() * 2.0f - 0.5f, random() * 2.0f - 0.5f } };
+            soup.indices.push_back((UINT)soup.vertices.size());
+            soup.vertices.push_back(vertex);
+        }
+    }
+    std::vector<UINT32> soupImage = compare(soup, 257, 191, "random triangles of both windings match the reference");
+    check(std::find(soupImage.begin(), soupImage.end(), 0u) != soupImage.end(), "border texels are transparent black");
+    rasterizer.shutdown();
+
+    rasterizer.init(1);
+    compare(soup, 257, 191, "a single thread matches the reference");
+    rasterizer.shutdown();
+    return passed;
+}
+
+// Headless throughput at 800x600 and 4K: the sample quad, a mesh of many small triangles for
+// triangle rate, and eight full screen layers for fill rate.
+std::string benchmarkSoftwareRasterizer() {
+    std::vector<UINT32> checkerboard;
+    makeCheckerboard(checkerboard, 256, 256);
+    SoftwareTexture texture;
+    texture.width = 256;
+    texture.height = 256;
+    texture.texels = checkerboard.data();
+    const UINT32 background = packUnorm(clearColor);
+
+    SoftwareScene layers;
+    for (UINT i = 0; i < 8; i++) {
+        appendQuad(layers, -1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
+    }
+    SoftwareScene mesh = gridScene(256, 192, 1.0f, 0.5f, 0x1234567);
+
+    const UINT threads = std::max(std::thread::hardware_concurrency(), 1U);
+    const UINT sizes[2][2] = { { 800, 600 }, { 3840, 2160 } };
+    std::string report = "Software rasterizer (" + std::to_string(threads) + " threads):\n";
+    char line[256];
+    for (const auto& size : sizes) {
+        std::vector<UINT32> pixels((size_t)size[0] * size[1]);
+        SoftwareTarget target;
+        target.width = size[0];
+        target.height = size[1];
+        target.pixels = pixels.data();
+        SoftwareScene quad = sampleQuadScene(size[0] / (float)size[1]);
+
+        struct Case {
+            const char* name;
+            const SoftwareScene* scene;
+        };
+        const Case cases[] = { { "sample quad", &quad }, { "small triangles", &mesh }, { "8 full screen layers", &layers } };
+        for (const Case& c : cases) {
+            SoftwareDraw draw;
+            draw.vertices = c.scene->vertices.data();
+            draw.indices = c.scene->indices.data();
+            draw.indexCount = (UINT)c.scene->indices.size();
+            draw.texture = &texture;
+
+            double seconds[2] = {};
+            SoftwareRasterizer::Stats stats;
+            for (UINT pass = 0; pass < 2; pass++) {
+                SoftwareRasterizer rasterizer;
+                rasterizer.init(pass == 0 ? threads : 1);
+                rasterizer.render(target, background, &draw, 1);
+                const UINT iterations = 10;
+                double start = secondsNow();
+                for (UINT i = 0; i < iterations; i++) {
+                    stats = rasterizer.render(target, background, &draw, 1);
+                }
+                seconds[pass] = (secondsNow() - start) / iterations;
+                rasterizer.shutdown();
+            }
+
+            // Cleared pixels count towards the fill rate.
+            const double touched = (double)stats.pixels + (double)size[0] * size[1];
+            snprintf(line, sizeof(line), "  %ux%u %s: %.3f ms, %.2f Mtri/s, %.1f Mpix/s (1 thread %.3f ms)\n",
+                size[0], size[1], c.name, seconds[0] * 1000.0,
+                stats.triangles / seconds[0] / 1e6, touched / seconds[0] / 1e6, seconds[1] * 1000.0);
+            report += line;
+        }
+    }
+    return report;
+}
+
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        mWindow = windowHandle;
+        mSoftware.init(std::max(std::thread::hardware_concurrency(), 1U));
+        mSoftwareImage.resize((size_t)windowWidth * windowHeight);
+
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.1f;
+            mViewport.MaxDepth = 100.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        mSoftware.shutdown();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        if (mCompareRecorded) {
+            mCompareRecorded = false;
+            this->waitForGPU();
+            this->compareWithSoftware();
+        }
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 1;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[1] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 1;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/002-texture.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/002-texture.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Create Vertex Buffer
+        {
+            // The CPU keeps the scene for the software renderer.
+            float aspect = windowWidth / (windowHeight + 0.0f);
+            SoftwareScene scene = sampleQuadScene(aspect);
+            mSceneVertices = scene.vertices;
+            mSceneIndices = scene.indices;
+            const UINT vertexBufferSize = (UINT)(mSceneVertices.size() * sizeof(Vertex));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = vertexBufferSize;
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, mSceneVertices.data(), vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            const UINT indexBufferSize = (UINT)(mSceneIndices.size() * sizeof(UINT));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = indexBufferSize;
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, mSceneIndices.data(), indexBufferSize);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = ibDesc.Width;
+        }
+
+        // Texture
+        {
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            makeCheckerboard(mCheckerboard, width, height);
+            mSoftwareTexture.width = width;
+            mSoftwareTexture.height = height;
+            mSoftwareTexture.texels = mCheckerboard.data();
+
+            std::vector<UINT8> image(mCheckerboard.size() * sizeof(UINT32));
+            memcpy(image.data(), mCheckerboard.data(), image.size());
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+        // Readback of the back buffer for the comparison
+        {
+            D3D12_RESOURCE_DESC targetDesc = mRenderTargets[0]->GetDesc();
+            UINT64 readbackSize = 0;
+            mDevice->GetCopyableFootprints(&targetDesc, 0, 1, 0, &mReadbackFootprint, nullptr, nullptr, &readbackSize);
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+            D3D12_RESOURCE_DESC bufferDesc = {};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = readbackSize;
+            bufferDesc.Height = 1;
+            bufferDesc.DepthOrArraySize = 1;
+            bufferDesc.MipLevels = 1;
+            bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_COPY_DEST,
+                nullptr,
+                IID_PPV_ARGS(&mReadback)));
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        mCommandList->DrawIndexedInstanced((UINT)mSceneIndices.size(), 1, 0, 0, 0);
+
+        D3D12_RESOURCE_STATES finalState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        if (mCompareRequested) {
+            D3D12_RESOURCE_BARRIER toCopy = {};
+            toCopy.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            toCopy.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+            toCopy.Transition.Subresource = 0;
+            toCopy.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+            toCopy.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+            mCommandList->ResourceBarrier(1, &toCopy);
+
+            D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+            srcLocation.pResource = mRenderTargets[mFrameBufferIndex].Get();
+            srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            srcLocation.SubresourceIndex = 0;
+
+            D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+            dstLocation.pResource = mReadback.Get();
+            dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            dstLocation.PlacedFootprint = mReadbackFootprint;
+
+            mCommandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+            finalState = D3D12_RESOURCE_STATE_COPY_SOURCE;
+            mCompareRequested = false;
+            mCompareRecorded = true;
+        }
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = finalState;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    // Renders the frame the GPU just produced on the CPU and counts the pixels that differ.
+    void compareWithSoftware() {
+        SoftwareDraw draw;
+        draw.vertices = mSceneVertices.data();
+        draw.indices = mSceneIndices.data();
+        draw.indexCount = (UINT)mSceneIndices.size();
+        draw.texture = &mSoftwareTexture;
+
+        SoftwareTarget target;
+        target.width = windowWidth;
+        target.height = windowHeight;
+        target.pixels = mSoftwareImage.data();
+        double start = secondsNow();
+        const SoftwareRasterizer::Stats& stats = mSoftware.render(target, packUnorm(clearColor), &draw, 1);
+        double seconds = secondsNow() - start;
+
+        const UINT8* data = nullptr;
+        D3D12_RANGE readRange = { 0, (SIZE_T)mReadbackFootprint.Footprint.RowPitch * windowHeight };
+        _ThrowIfFailed(mReadback->Map(0, &readRange, (void**)&data));
+        UINT mismatches = 0;
+        int firstX = -1;
+        int firstY = -1;
+        for (UINT y = 0; y < (UINT)windowHeight; y++) {
+            const UINT32* gpu = (const UINT32*)(data + mReadbackFootprint.Offset + (UINT64)y * mReadbackFootprint.Footprint.RowPitch);
+            const UINT32* cpu = mSoftwareImage.data() + (size_t)y * windowWidth;
+            for (UINT x = 0; x < (UINT)windowWidth; x++) {
+                if (gpu[x] != cpu[x]) {
+                    if (mismatches == 0) {
+                        firstX = x;
+                        firstY = y;
+                    }
+                    mismatches++;
+                }
+            }
+        }
+        D3D12_RANGE writtenRange = { 0, 0 };
+        mReadback->Unmap(0, &writtenRange);
+
+        char text[256];
+        if (mismatches == 0) {
+            snprintf(text, sizeof(text), "%s - software frame matches the GPU, %.3f ms, %llu pixels, %u threads",
+                windowTitle, seconds * 1000.0, stats.pixels, mSoftware.threadCount());
+        }
+        else {
+            snprintf(text, sizeof(text), "%s - %u pixels differ from the GPU, first at (%d, %d), %.3f ms, %u threads",
+                windowTitle, mismatches, firstX, firstY, seconds * 1000.0, mSoftware.threadCount());
+        }
+        debugLog("%s\n", text);
+        SetWindowTextA(mWindow, text);
+    }
+
+    void requestCompare() {
+        mCompareRequested = true;
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+
+    HWND mWindow = nullptr;
+    std::vector<Vertex> mSceneVertices;
+    std::vector<UINT> mSceneIndices;
+    std::vector<UINT32> mCheckerboard;
+    SoftwareTexture mSoftwareTexture;
+    SoftwareRasterizer mSoftware;
+    std::vector<UINT32> mSoftwareImage;
+    ComPtr<ID3D12Resource> mReadback;
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT mReadbackFootprint = {};
+    // The first frame is compared, and any frame after C is pressed
+    bool mCompareRequested = true;
+    bool mCompareRecorded = false;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateSoftwareRasterizer(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkSoftwareRasterizer();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_KEYDOWN && msg.wParam == 'C') {
+                    graphics.requestCompare();
+                }
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
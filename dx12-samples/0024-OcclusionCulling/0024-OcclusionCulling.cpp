@@ -0,0 +1,1949 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+#include <emmintrin.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0024-OcclusionCulling";
+const char* windowClass = "0024-OcclusionCulling";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// The occlusion buffer is about a third of the window each way, in whole 32x4 tiles.
+const UINT occlusionWidth = 256;
+const UINT occlusionHeight = 192;
+const UINT cityBlocks = 48;
+const UINT64 cullingReportFrames = 120;
+
+// One object's bounds as an instance of the unit cube.
+struct CubeInstance {
+    XMFLOAT3 center;
+    XMFLOAT3 extent;
+    UINT32 color;
+};
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Small fork-join pool. run() splits [0, count) into chunks that the workers and the calling
+// thread pull from an atomic counter, and returns once every chunk is done. The job is passed
+// as a function pointer plus context, so dispatching allocates nothing.
+class ParallelFor {
+public:
+    void start(UINT workerCount) {
+        for (UINT i = 0; i < workerCount; i++) {
+            mWorkers.push_back(std::thread([this]() { this->worker(); }));
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+        for (std::thread& worker : mWorkers) {
+            worker.join();
+        }
+        mWorkers.clear();
+    }
+
+    UINT workerCount() const { return (UINT)mWorkers.size(); }
+
+    template<typename F>
+    void run(UINT count, UINT chunkSize, const F& fn) {
+        if (mWorkers.empty() || count <= chunkSize) {
+            fn(0, count);
+            return;
+        }
+        this->dispatch(count, chunkSize, [](const void* context, UINT begin, UINT end) { (*(const F*)context)(begin, end); }, &fn);
+    }
+
+private:
+    typedef void (*JobFunction)(const void* context, UINT begin, UINT end);
+
+    void dispatch(UINT count, UINT chunkSize, JobFunction function, const void* context) {
+        {
+            // Wait for stragglers of the previous job before the job fields are replaced.
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait(lock, [this]() { return mActive == 0; });
+            mFunction = function;
+            mContext = context;
+            mCount = count;
+            mChunkSize = chunkSize;
+            mNextChunk = 0;
+            mGeneration++;
+        }
+        mWake.notify_all();
+
+        this->work();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mActive == 0; });
+    }
+
+    void work() {
+        UINT chunkCount = (mCount + mChunkSize - 1) / mChunkSize;
+        for (;;) {
+            UINT chunk = mNextChunk++;
+            if (chunk >= chunkCount) {
+                return;
+            }
+            UINT begin = chunk * mChunkSize;
+            mFunction(mContext, begin, std::min(begin + mChunkSize, mCount));
+        }
+    }
+
+    void worker() {
+        UINT64 seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [&]() { return mStop || mGeneration != seen; });
+                if (mStop) {
+                    return;
+                }
+                seen = mGeneration;
+                mActive++;
+            }
+
+            this->work();
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mActive == 0) {
+                mDone.notify_all();
+            }
+        }
+    }
+
+private:
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    JobFunction mFunction = nullptr;
+    const void* mContext = nullptr;
+    UINT mCount = 0;
+    UINT mChunkSize = 1;
+    std::atomic<UINT> mNextChunk;
+    UINT64 mGeneration = 0;
+    UINT mActive = 0;
+    bool mStop = false;
+};
+
+// Row vector convention like DirectXMath: clip = (x, y, z, 1) * m. Left handed, so the
+// camera looks down +z of view space and clip w is the view depth.
+void makeViewProjection(const XMFLOAT3& eye, const XMFLOAT3& target, float fovY, float aspect, float nearZ, float farZ, float m[16]) {
+    auto normalize = [](XMFLOAT3 v) {
+        float length = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+        return XMFLOAT3(v.x / length, v.y / length, v.z / length);
+    };
+    auto cross = [](const XMFLOAT3& a, const XMFLOAT3& b) {
+        return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    };
+    auto dot = [](const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; };
+
+    XMFLOAT3 zAxis = normalize(XMFLOAT3(target.x - eye.x, target.y - eye.y, target.z - eye.z));
+    XMFLOAT3 xAxis = normalize(cross(XMFLOAT3(0.0f, 1.0f, 0.0f), zAxis));
+    XMFLOAT3 yAxis = cross(zAxis, xAxis);
+    const float view[16] = {
+        xAxis.x, yAxis.x, zAxis.x, 0.0f,
+        xAxis.y, yAxis.y, zAxis.y, 0.0f,
+        xAxis.z, yAxis.z, zAxis.z, 0.0f,
+        -dot(xAxis, eye), -dot(yAxis, eye), -dot(zAxis, eye), 1.0f
+    };
+    const float h = 1.0f / tanf(fovY * 0.5f);
+    const float w = h / aspect;
+    const float range = farZ / (farZ - nearZ);
+    const float projection[16] = {
+        w, 0.0f, 0.0f, 0.0f,
+        0.0f, h, 0.0f, 0.0f,
+        0.0f, 0.0f, range, 1.0f,
+        0.0f, 0.0f, -range * nearZ, 0.0f
+    };
+    for (UINT row = 0; row < 4; row++) {
+        for (UINT column = 0; column < 4; column++) {
+            float sum = 0.0f;
+            for (UINT k = 0; k < 4; k++) {
+                sum += view[row * 4 + k] * projection[k * 4 + column];
+            }
+            m[row * 4 + column] = sum;
+        }
+    }
+}
+
+// Static occluder geometry in world space; front faces are clockwise on screen.
+struct OccluderMesh {
+    std::vector<XMFLOAT3> vertices;
+    std::vector<UINT> indices;
+};
+
+// An object to cull, by its world space bounds.
+struct OcclusionObject {
+    XMFLOAT3 boundsMin;
+    XMFLOAT3 boundsMax;
+    UINT32 color;
+};
+
+// Appends an axis aligned box as 6 quads wound clockwise seen from outside.
+void appendBox(OccluderMesh& mesh, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) {
+    const XMFLOAT3 center((boundsMin.x + boundsMax.x) * 0.5f, (boundsMin.y + boundsMax.y) * 0.5f, (boundsMin.z + boundsMax.z) * 0.5f);
+    const XMFLOAT3 extent((boundsMax.x - boundsMin.x) * 0.5f, (boundsMax.y - boundsMin.y) * 0.5f, (boundsMax.z - boundsMin.z) * 0.5f);
+    // Outward normal and the up direction of each face as seen from outside; right is up x -normal.
+    const int faces[6][6] = {
+        { 0, 0, -1, 0, 1, 0 }, { 0, 0, 1, 0, 1, 0 }, { -1, 0, 0, 0, 1, 0 },
+        { 1, 0, 0, 0, 1, 0 }, { 0, 1, 0, 0, 0, 1 }, { 0, -1, 0, 0, 0, 1 }
+    };
+    for (const auto& face : faces) {
+        const int n[3] = { face[0], face[1], face[2] };
+        const int u[3] = { face[3], face[4], face[5] };
+        const int r[3] = { -(u[1] * n[2] - u[2] * n[1]), -(u[2] * n[0] - u[0] * n[2]), -(u[0] * n[1] - u[1] * n[0]) };
+        const int corners[4][2] = { { -1, 1 }, { 1, 1 }, { 1, -1 }, { -1, -1 } };
+        UINT base = (UINT)mesh.vertices.size();
+        for (const auto& corner : corners) {
+            float p[3];
+            for (UINT i = 0; i < 3; i++) {
+                p[i] = (float)(n[i] + r[i] * corner[0] + u[i] * corner[1]);
+            }
+            mesh.vertices.push_back(XMFLOAT3(center.x + p[0] * extent.x, center.y + p[1] * extent.y, center.z + p[2] * extent.z));
+        }
+        const UINT quad[6] = { 0, 1, 2, 2, 3, 0 };
+        for (UINT index : quad) {
+            mesh.indices.push_back(base + index);
+        }
+    }
+}
+
+// Masked occlusion: the screen is split into 32x4 pixel tiles, one 32 bit coverage mask per
+// row, so a tile is one SSE register. Depth is 1/w, larger is nearer. Each tile keeps a
+// reference layer, zMin[0], that every pixel is at least as near as, and a working layer:
+// the pixels in mask are at least as near as zMin[1]. Occluder triangles merge into the
+// working layer, which replaces the reference once it covers the whole tile.
+struct OcclusionTile {
+    __m128i mask;
+    float zMin[2];
+};
+
+// Screen space setup of one occluder triangle, in buffer pixels.
+struct OcclusionTriangle {
+    float x[3];
+    float y[3];
+    // 1/w plane: d = dX * x + dY * y + d0, and the smallest vertex value to clamp it by
+    float dX;
+    float dY;
+    float d0;
+    float dMin;
+    int minY;
+    int maxY;
+    int minX;
+    int maxX;
+};
+
+class MaskedOcclusionBuffer {
+public:
+    struct Stats {
+        UINT64 occluderTriangles = 0;
+        UINT64 rasterizedTriangles = 0;
+        UINT64 objects = 0;
+        UINT64 frustumCulled = 0;
+        UINT64 occlusionCulled = 0;
+    };
+
+    // Width must be a multiple of 32 and height of 4.
+    void init(UINT width, UINT height, float nearZ) {
+        mWidth = width;
+        mHeight = height;
+        mNearZ = nearZ;
+        mTilesX = width / 32;
+        mTilesY = height / 4;
+        mTiles.resize((size_t)mTilesX * mTilesY);
+        this->clear();
+    }
+
+    void clear() {
+        for (OcclusionTile& tile : mTiles) {
+            tile.mask = _mm_setzero_si128();
+            tile.zMin[0] = 0.0f;
+            tile.zMin[1] = FLT_MAX;
+        }
+    }
+
+    // Projects and clips the occluders, then rasterizes them into the tiles one row of tiles
+    // per job, so no two threads touch the same tile.
+    void renderOccluders(const float viewProjection[16], const OccluderMesh* meshes, UINT meshCount, ParallelFor& pool) {
+        mTriangles.clear();
+        for (UINT m = 0; m < meshCount; m++) {
+            const OccluderMesh& mesh = meshes[m];
+            mProjected.resize(mesh.vertices.size());
+            for (size_t i = 0; i < mesh.vertices.size(); i++) {
+                mProjected[i] = transform(viewProjection, mesh.vertices[i]);
+            }
+            for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+                mStats.occluderTriangles++;
+                this->clipAndSetup(mProjected[mesh.indices[i]], mProjected[mesh.indices[i + 1]], mProjected[mesh.indices[i + 2]]);
+            }
+        }
+        mStats.rasterizedTriangles += mTriangles.size();
+
+        pool.run(mTilesY, 1, [&](UINT begin, UINT end) {
+            for (UINT row = begin; row < end; row++) {
+                for (const OcclusionTriangle& t : mTriangles) {
+                    if (t.maxY >= (int)row * 4 && t.minY < (int)row * 4 + 4) {
+                        this->rasterizeRow(t, row);
+                    }
+                }
+            }
+        });
+    }
+
+    // False when the bounds are outside the frustum or behind the occluders everywhere they
+    // cover. Only reads the buffer, so any number of threads may test at once.
+    bool testBounds(const float viewProjection[16], const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax, bool& frustumCulled) const {
+        frustumCulled = false;
+        float left = FLT_MAX;
+        float top = FLT_MAX;
+        float right = -FLT_MAX;
+        float bottom = -FLT_MAX;
+        float nearest = 0.0f;
+        UINT outside[5] = {};
+        for (UINT corner = 0; corner < 8; corner++) {
+            XMFLOAT3 p((corner & 1) ? boundsMax.x : boundsMin.x, (corner & 2) ? boundsMax.y : boundsMin.y, (corner & 4) ? boundsMax.z : boundsMin.z);
+            XMFLOAT4 clip = transform(viewProjection, p);
+            outside[0] += clip.x < -clip.w;
+            outside[1] += clip.x > clip.w;
+            outside[2] += clip.y < -clip.w;
+            outside[3] += clip.y > clip.w;
+            outside[4] += clip.w < mNearZ;
+            if (clip.w >= mNearZ) {
+                XMFLOAT3 screen = this->toScreen(clip);
+                left = std::min(left, screen.x);
+                right = std::max(right, screen.x);
+                top = std::min(top, screen.y);
+                bottom = std::max(bottom, screen.y);
+                nearest = std::max(nearest, screen.z);
+            }
+        }
+        if (outside[0] == 8 || outside[1] == 8 || outside[2] == 8 || outside[3] == 8 || outside[4] == 8) {
+            frustumCulled = true;
+            return false;
+        }
+        if (outside[4] != 0) {
+            // Crossing the near plane: no usable screen rect.
+            return true;
+        }
+
+        // Every pixel the rect touches, not only those whose centers it covers, so objects
+        // smaller than a buffer pixel are still tested.
+        const int x0 = clampToPixel(floorf(left), mWidth);
+        const int y0 = clampToPixel(floorf(top), mHeight);
+        const int x1 = clampToPixel(ceilf(right), mWidth) - 1;
+        const int y1 = clampToPixel(ceilf(bottom), mHeight) - 1;
+        const __m128i zero = _mm_setzero_si128();
+        for (int ty = y0 / 4; ty <= y1 / 4; ty++) {
+            alignas(16) UINT32 rowMask[4];
+            for (int tx = x0 / 32; tx <= x1 / 32; tx++) {
+                const UINT32 columns = spanMask(x0 - tx * 32, x1 + 1 - tx * 32);
+                for (int r = 0; r < 4; r++) {
+                    int y = ty * 4 + r;
+                    rowMask[r] = (y >= y0 && y <= y1) ? columns : 0;
+                }
+                const OcclusionTile& tile = mTiles[(size_t)ty * mTilesX + tx];
+                const __m128i rect = _mm_load_si128((const __m128i*)rowMask);
+                // Pixels outside the working layer are bounded by the reference layer only.
+                const bool outsideLayer = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_andnot_si128(tile.mask, rect), zero)) != 0xffff;
+                const bool insideLayer = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(tile.mask, rect), zero)) != 0xffff;
+                if ((outsideLayer && nearest >= tile.zMin[0]) || (insideLayer && nearest >= std::max(tile.zMin[0], tile.zMin[1]))) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Tests every object in parallel; visible[i] is 1 for objects to draw.
+    void cullObjects(const float viewProjection[16], const OcclusionObject* objects, UINT count, UINT8* visible, ParallelFor& pool) {
+        std::atomic<UINT> frustumCulled(0);
+        std::atomic<UINT> occlusionCulled(0);
+        pool.run(count, 256, [&](UINT begin, UINT end) {
+            UINT frustum = 0;
+            UINT occluded = 0;
+            for (UINT i = begin; i < end; i++) {
+                bool outside = false;
+                visible[i] = this->testBounds(viewProjection, objects[i].boundsMin, objects[i].boundsMax, outside) ? 1 : 0;
+                frustum += outside ? 1 : 0;
+                occluded += (!visible[i] && !outside) ? 1 : 0;
+            }
+            frustumCulled += frustum;
+            occlusionCulled += occluded;
+        });
+        mStats.objects += count;
+        mStats.frustumCulled += frustumCulled;
+        mStats.occlusionCulled += occlusionCulled;
+    }
+
+    const Stats& stats() const { return mStats; }
+    void resetStats() { mStats = Stats(); }
+    UINT width() const { return mWidth; }
+    UINT height() const { return mHeight; }
+
+    // The depth bound a pixel is known to be at least as near as; for checks and debugging.
+    float pixelDepth(UINT x, UINT y) const {
+        const OcclusionTile& tile = mTiles[(size_t)(y / 4) * mTilesX + x / 32];
+        alignas(16) UINT32 rows[4];
+        _mm_store_si128((__m128i*)rows, tile.mask);
+        bool inLayer = (rows[y % 4] >> (x % 32)) & 1;
+        return inLayer ? std::max(tile.zMin[0], tile.zMin[1]) : tile.zMin[0];
+    }
+
+private:
+    // Clip space x, y and w; z is not needed.
+    static XMFLOAT4 transform(const float m[16], const XMFLOAT3& p) {
+        return XMFLOAT4(
+            p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12],
+            p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13],
+            0.0f,
+            p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15]);
+    }
+
+    // Buffer pixel x and y, and 1/w in z.
+    XMFLOAT3 toScreen(const XMFLOAT4& clip) const {
+        const float inverseW = 1.0f / clip.w;
+        return XMFLOAT3((clip.x * inverseW * 0.5f + 0.5f) * mWidth, (0.5f - clip.y * inverseW * 0.5f) * mHeight, inverseW);
+    }
+
+    // Clips against the near plane, which leaves a triangle or a quad, and sets up the pieces.
+    // Occluders that cross it are usually the walls beside the camera, the best ones to keep.
+    void clipAndSetup(const XMFLOAT4& a, const XMFLOAT4& b, const XMFLOAT4& c) {
+        const XMFLOAT4* v[3] = { &a, &b, &c };
+        if (a.w >= mNearZ && b.w >= mNearZ && c.w >= mNearZ) {
+            OcclusionTriangle t;
+            if (this->setup(this->toScreen(a), this->toScreen(b), this->toScreen(c), t)) {
+                mTriangles.push_back(t);
+            }
+            return;
+        }
+        XMFLOAT3 polygon[4];
+        UINT count = 0;
+        for (UINT i = 0; i < 3; i++) {
+            const XMFLOAT4& p = *v[i];
+            const XMFLOAT4& q = *v[(i + 1) % 3];
+            if (p.w >= mNearZ) {
+                polygon[count++] = this->toScreen(p);
+            }
+            if ((p.w >= mNearZ) != (q.w >= mNearZ)) {
+                const float s = (mNearZ - p.w) / (q.w - p.w);
+                polygon[count++] = this->toScreen(XMFLOAT4(p.x + (q.x - p.x) * s, p.y + (q.y - p.y) * s, 0.0f, mNearZ));
+            }
+        }
+        for (UINT i = 2; i < count; i++) {
+            OcclusionTriangle t;
+            if (this->setup(polygon[0], polygon[i - 1], polygon[i], t)) {
+                mTriangles.push_back(t);
+            }
+        }
+    }
+
+    bool setup(const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c, OcclusionTriangle& t) const {
+        const XMFLOAT3* v[3] = { &a, &b, &c };
+        for (UINT i = 0; i < 3; i++) {
+            t.x[i] = v[i]->x;
+            t.y[i] = v[i]->y;
+        }
+        // Clockwise on screen is front facing; back faces and slivers are skipped.
+        const float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.y[1] - t.y[0]) * (t.x[2] - t.x[0]);
+        if (!(area > 0.0f)) {
+            return false;
+        }
+        t.minX = clampToPixel(floorf(std::min(std::min(t.x[0], t.x[1]), t.x[2])), mWidth);
+        t.maxX = clampToPixel(ceilf(std::max(std::max(t.x[0], t.x[1]), t.x[2])), mWidth) - 1;
+        t.minY = clampToPixel(floorf(std::min(std::min(t.y[0], t.y[1]), t.y[2])), mHeight);
+        t.maxY = clampToPixel(ceilf(std::max(std::max(t.y[0], t.y[1]), t.y[2])), mHeight) - 1;
+        if (t.minX > t.maxX || t.minY > t.maxY) {
+            return false;
+        }
+
+        const float d1x = t.x[1] - t.x[0];
+        const float d1y = t.y[1] - t.y[0];
+        const float d2x = t.x[2] - t.x[0];
+        const float d2y = t.y[2] - t.y[0];
+        const float dd1 = b.z - a.z;
+        const float dd2 = c.z - a.z;
+        t.dX = (dd1 * d2y - dd2 * d1y) / area;
+        t.dY = (dd2 * d1x - dd1 * d2x) / area;
+        t.d0 = a.z - t.dX * t.x[0] - t.dY * t.y[0];
+        t.dMin = std::min(std::min(a.z, b.z), c.z);
+        return true;
+    }
+
+    // Converts after clamping to [0, size]; clipped geometry can land far off screen.
+    static int clampToPixel(float value, UINT size) {
+        return (int)std::min(std::max(value, 0.0f), (float)size);
+    }
+
+    // Bits [begin, end) of a 32 pixel tile row, clamped to the tile.
+    static UINT32 spanMask(int begin, int end) {
+        begin = std::max(begin, 0);
+        end = std::min(end, 32);
+        if (begin >= end) {
+            return 0;
+        }
+        UINT32 fromBegin = ~0U << begin;
+        UINT32 belowEnd = end >= 32 ? ~0U : ~(~0U << end);
+        return fromBegin & belowEnd;
+    }
+
+    // Coverage of the four scanlines of a tile row, from the x range each edge allows at the
+    // pixel centers, then one mask update per tile the triangle spans.
+    void rasterizeRow(const OcclusionTriangle& t, UINT tileRow) {
+        const float rowY = tileRow * 4.0f;
+        const __m128 y = _mm_add_ps(_mm_set1_ps(rowY), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+        __m128 low = _mm_set1_ps(-FLT_MAX);
+        __m128 high = _mm_set1_ps(FLT_MAX);
+        for (UINT e = 0; e < 3; e++) {
+            const UINT next = (e + 1) % 3;
+            const float dx = t.x[next] - t.x[e];
+            const float dy = t.y[next] - t.y[e];
+            if (dy == 0.0f) {
+                // Horizontal edge: inside on one side of its scanline only.
+                __m128 side = _mm_mul_ps(_mm_set1_ps(dx), _mm_sub_ps(y, _mm_set1_ps(t.y[e])));
+                __m128 outside = _mm_cmplt_ps(side, _mm_setzero_ps());
+                low = _mm_or_ps(_mm_andnot_ps(outside, low), _mm_and_ps(outside, _mm_set1_ps(FLT_MAX)));
+                continue;
+            }
+            // x where the edge crosses each scanline; inside is x <= crossing for downward edges.
+            __m128 crossing = _mm_add_ps(_mm_set1_ps(t.x[e]), _mm_mul_ps(_mm_set1_ps(dx / dy), _mm_sub_ps(y, _mm_set1_ps(t.y[e]))));
+            if (dy > 0.0f) {
+                high = _mm_min_ps(high, crossing);
+            }
+            else {
+                low = _mm_max_ps(low, crossing);
+            }
+        }
+
+        // First and one past the last pixel whose center is inside, per scanline.
+        alignas(16) float lows[4];
+        alignas(16) float highs[4];
+        _mm_store_ps(lows, low);
+        _mm_store_ps(highs, high);
+        int first[4];
+        int last[4];
+        for (UINT r = 0; r < 4; r++) {
+            first[r] = clampToPixel(ceilf(lows[r] - 0.5f), mWidth);
+            last[r] = clampToPixel(floorf(highs[r] - 0.5f) + 1.0f, mWidth);
+        }
+
+        const int tileX0 = t.minX / 32;
+        const int tileX1 = t.maxX / 32;
+        const __m128i zero = _mm_setzero_si128();
+        for (int tx = tileX0; tx <= tileX1; tx++) {
+            alignas(16) UINT32 rows[4];
+            for (UINT r = 0; r < 4; r++) {
+                rows[r] = spanMask(first[r] - tx * 32, last[r] - tx * 32);
+            }
+            const __m128i coverage = _mm_load_si128((const __m128i*)rows);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(coverage, zero)) == 0xffff) {
+                continue;
+            }
+
+            // The farthest the triangle gets within the tile: its plane at the far corner,
+            // clamped by its farthest vertex since the plane extrapolates past the edges.
+            const float cornerX = t.dX < 0.0f ? (tx + 1) * 32.0f : tx * 32.0f;
+            const float cornerY = t.dY < 0.0f ? rowY + 4.0f : rowY;
+            const float depth = std::max(t.dX * cornerX + t.dY * cornerY + t.d0, t.dMin);
+            this->updateTile(mTiles[(size_t)tileRow * mTilesX + tx], coverage, depth);
+        }
+    }
+
+    static void updateTile(OcclusionTile& tile, __m128i coverage, float depth) {
+        if (depth <= tile.zMin[0]) {
+            return;
+        }
+        // When the triangle is nearer the reference than the working layer, merging would
+        // drag the working layer back; starting it over loses less.
+        const __m128i zero = _mm_setzero_si128();
+        const bool layerEmpty = _mm_movemask_epi8(_mm_cmpeq_epi32(tile.mask, zero)) == 0xffff;
+        if (!layerEmpty && tile.zMin[1] - depth > depth - tile.zMin[0]) {
+            tile.mask = zero;
+            tile.zMin[1] = FLT_MAX;
+        }
+        tile.mask = _mm_or_si128(tile.mask, coverage);
+        tile.zMin[1] = std::min(tile.zMin[1], depth);
+        const __m128i full = _mm_cmpeq_epi32(zero, zero);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(tile.mask, full)) == 0xffff) {
+            tile.zMin[0] = std::max(tile.zMin[0], tile.zMin[1]);
+            tile.mask = zero;
+            tile.zMin[1] = FLT_MAX;
+        }
+    }
+
+    UINT mWidth = 0;
+    UINT mHeight = 0;
+    float mNearZ = 0.1f;
+    UINT mTilesX = 0;
+    UINT mTilesY = 0;
+    std::vector<OcclusionTile> mTiles;
+    std::vector<XMFLOAT4> mProjected;
+    std::vector<OcclusionTriangle> mTriangles;
+    Stats mStats;
+};
+
+UINT32 cityRandom(UINT32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+float cityRandom(UINT32& state, float low, float high) {
+    return low + (high - low) * (cityRandom(state) & 0xffffff) / (float)0xffffff;
+}
+
+// A grid of blocks, each a building with props along its sidewalks. Buildings are objects
+// and occluders, the props objects only. Streets run between blocks at multiples of the pitch.
+const float cityBlockPitch = 24.0f;
+
+void makeCity(UINT blocks, UINT32 seed, std::vector<OcclusionObject>& objects, OccluderMesh& occluders) {
+    objects.clear();
+    occluders = OccluderMesh();
+    UINT32 state = seed | 1;
+    for (UINT bz = 0; bz < blocks; bz++) {
+        for (UINT bx = 0; bx < blocks; bx++) {
+            const float centerX = (bx + 0.5f) * cityBlockPitch;
+            const float centerZ = (bz + 0.5f) * cityBlockPitch;
+            const float halfX = cityRandom(state, 6.0f, 9.0f);
+            const float halfZ = cityRandom(state, 6.0f, 9.0f);
+            const float height = cityRandom(state, 6.0f, 70.0f);
+            OcclusionObject building;
+            building.boundsMin = XMFLOAT3(centerX - halfX, 0.0f, centerZ - halfZ);
+            building.boundsMax = XMFLOAT3(centerX + halfX, height, centerZ + halfZ);
+            UINT32 shade = 0x80 + (cityRandom(state) & 0x3f);
+            building.color = 0xff000000 | (shade << 16) | (shade << 8) | shade;
+            objects.push_back(building);
+            appendBox(occluders, building.boundsMin, building.boundsMax);
+
+            // Props on the sidewalk ring between the building and the street.
+            for (UINT i = 0; i < 8; i++) {
+                const float size = cityRandom(state, 0.5f, 2.0f);
+                const float along = cityRandom(state, -10.0f, 10.0f);
+                const float side = (i & 1) ? 10.5f : -10.5f;
+                const float x = (i & 2) ? centerX + along : centerX + side;
+                const float z = (i & 2) ? centerZ + side : centerZ + along;
+                OcclusionObject prop;
+                prop.boundsMin = XMFLOAT3(x - size * 0.5f, 0.0f, z - size * 0.5f);
+                prop.boundsMax = XMFLOAT3(x + size * 0.5f, size * 1.5f, z + size * 0.5f);
+                prop.color = 0xff000000 | (cityRandom(state) & 0x00ffffff);
+                objects.push_back(prop);
+            }
+        }
+    }
+}
+
+// Street level walk along the middle avenue, panning left and right; t in [0, 1).
+void cityCamera(UINT blocks, float t, XMFLOAT3& eye, XMFLOAT3& target) {
+    const float street = (blocks / 2) * cityBlockPitch;
+    const float length = blocks * cityBlockPitch;
+    eye = XMFLOAT3(street, 2.0f, length * (0.1f + 0.8f * t));
+    const float yaw = sinf(t * 6.2831853f * 3.0f) * 1.2f;
+    target = XMFLOAT3(eye.x + sinf(yaw), eye.y + 0.05f, eye.z + cosf(yaw));
+}
+
+const float cullingFovY = 0.9f;
+const float cullingNearZ = 0.1f;
+const float cullingFarZ = 2000.0f;
+
+bool simulateOcclusionCulling(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+
+    const UINT width = 320;
+    const UINT height = 240;
+    ParallelFor pool;
+    pool.start(3);
+    MaskedOcclusionBuffer buffer;
+    buffer.init(width, height, cullingNearZ);
+    float viewProjection[16];
+    makeViewProjection(XMFLOAT3(0.0f, 2.0f, 0.0f), XMFLOAT3(0.0f, 2.0f, 1.0f), cullingFovY, width / (float)height, cullingNearZ, cullingFarZ, viewProjection);
+    auto box = [](float x0, float y0, float z0, float x1, float y1, float z1) {
+        OcclusionObject object;
+        object.boundsMin = XMFLOAT3(x0, y0, z0);
+        object.boundsMax = XMFLOAT3(x1, y1, z1);
+        object.color = 0;
+        return object;
+    };
+    auto visibleCount = [&](const std::vector<OcclusionObject>& objects) {
+        std::vector<UINT8> visible(objects.size());
+        buffer.cullObjects(viewProjection, objects.data(), (UINT)objects.size(), visible.data(), pool);
+        UINT count = 0;
+        for (UINT8 v : visible) {
+            count += v;
+        }
+        return count;
+    };
+
+    UINT32 state = 0x2545f491;
+    std::vector<OcclusionObject> ahead;
+    for (UINT i = 0; i < 200; i++) {
+        float x = cityRandom(state, -5.0f, 5.0f);
+        float y = cityRandom(state, 0.0f, 4.0f);
+        float z = cityRandom(state, 5.0f, 100.0f);
+        ahead.push_back(box(x, y, z, x + 0.5f, y + 0.5f, z + 0.5f));
+    }
+    buffer.clear();
+    buffer.resetStats();
+    const UINT emptyVisible = visibleCount(ahead);
+    check(emptyVisible + buffer.stats().frustumCulled == ahead.size(), "an empty buffer culls nothing in the frustum");
+
+    // A wall 20 units ahead, 16 wide and 6 high.
+    OccluderMesh wall;
+    appendBox(wall, XMFLOAT3(-8.0f, 0.0f, 20.0f), XMFLOAT3(8.0f, 6.0f, 21.0f));
+    buffer.clear();
+    buffer.renderOccluders(viewProjection, &wall, 1, pool);
+    bool frustum = false;
+    check(!buffer.testBounds(viewProjection, XMFLOAT3(-1.0f, 0.0f, 40.0f), XMFLOAT3(1.0f, 2.0f, 42.0f), frustum) && !frustum, "a box behind the wall is culled");
+    check(buffer.testBounds(viewProjection, XMFLOAT3(-1.0f, 0.0f, 10.0f), XMFLOAT3(1.0f, 2.0f, 12.0f), frustum), "a box in front of the wall is visible");
+    check(buffer.testBounds(viewProjection, XMFLOAT3(-1.0f, 0.0f, 40.0f), XMFLOAT3(1.0f, 40.0f, 42.0f), frustum), "a tower behind the wall peeking over it is visible");
+    check(buffer.testBounds(viewProjection, XMFLOAT3(23.0f, 0.0f, 40.0f), XMFLOAT3(25.0f, 2.0f, 42.0f), frustum), "a box beside the wall is visible");
+    check(buffer.testBounds(viewProjection, XMFLOAT3(-1.0f, 0.0f, 19.0f), XMFLOAT3(1.0f, 2.0f, 30.0f), frustum), "a box through the wall is visible");
+    check(!buffer.testBounds(viewProjection, XMFLOAT3(-1.0f, 0.0f, -10.0f), XMFLOAT3(1.0f, 2.0f, -8.0f), frustum) && frustum, "a box behind the camera is frustum culled");
+    check(buffer.testBounds(viewProjection, XMFLOAT3(-1.0f, 0.0f, -1.0f), XMFLOAT3(1.0f, 3.0f, 1.0f), frustum), "a box around the camera is visible");
+
+    // Random occluders against a per pixel reference: the nearest occluder 1/w at every pixel
+    // center. An object may only be culled if every pixel its rect touches is nearer.
+    UINT falseCulls = 0;
+    UINT hidden = 0;
+    UINT culled = 0;
+    for (UINT scene = 0; scene < 8; scene++) {
+        OccluderMesh occluders;
+        for (UINT i = 0; i < 12; i++) {
+            float x = cityRandom(state, -30.0f, 30.0f);
+            float z = cityRandom(state, 8.0f, 60.0f);
+            appendBox(occluders, XMFLOAT3(x, 0.0f, z), XMFLOAT3(x + cityRandom(state, 1.0f, 12.0f), cityRandom(state, 1.0f, 20.0f), z + cityRandom(state, 1.0f, 12.0f)));
+        }
+        buffer.clear();
+        buffer.renderOccluders(viewProjection, &occluders, 1, pool);
+
+        std::vector<float> reference((size_t)width * height, 0.0f);
+        for (size_t i = 0; i + 2 < occluders.indices.size(); i += 3) {
+            float sx[3];
+            float sy[3];
+            float d[3];
+            for (UINT k = 0; k < 3; k++) {
+                const XMFLOAT3& p = occluders.vertices[occluders.indices[i + k]];
+                const float* m = viewProjection;
+                float x = p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12];
+                float y = p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13];
+                float w = p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15];
+                sx[k] = (x / w * 0.5f + 0.5f) * width;
+                sy[k] = (0.5f - y / w * 0.5f) * height;
+                d[k] = 1.0f / w;
+            }
+            const float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+            if (!(area > 0.0f)) {
+                continue;
+            }
+            for (UINT py = 0; py < height; py++) {
+                for (UINT px = 0; px < width; px++) {
+                    const float cx = px + 0.5f;
+                    const float cy = py + 0.5f;
+                    float b[3];
+                    for (UINT k = 0; k < 3; k++) {
+                        const UINT i0 = (k + 1) % 3;
+                        const UINT i1 = (k + 2) % 3;
+                        b[k] = ((sx[i1] - sx[i0]) * (cy - sy[i0]) - (sy[i1] - sy[i0]) * (cx - sx[i0])) / area;
+                    }
+                    if (b[0] >= 0.0f && b[1] >= 0.0f && b[2] >= 0.0f) {
+                        float& nearest = reference[(size_t)py * width + px];
+                        nearest = std::max(nearest, b[0] * d[0] + b[1] * d[1] + b[2] * d[2]);
+                    }
+                }
+            }
+        }
+
+        for (UINT i = 0; i < 250; i++) {
+            float x = cityRandom(state, -40.0f, 40.0f);
+            float y = cityRandom(state, 0.0f, 10.0f);
+            float z = cityRandom(state, 10.0f, 90.0f);
+            float size = cityRandom(state, 0.2f, 4.0f);
+            OcclusionObject object = box(x, y, z, x + size, y + size, z + size);
+            if (!buffer.testBounds(viewProjection, object.boundsMin, object.boundsMax, frustum) && frustum) {
+                continue;
+            }
+            float left = FLT_MAX;
+            float top = FLT_MAX;
+            float right = -FLT_MAX;
+            float bottom = -FLT_MAX;
+            float nearest = 0.0f;
+            for (UINT corner = 0; corner < 8; corner++) {
+                const float* m = viewProjection;
+                float px = (corner & 1) ? object.boundsMax.x : object.boundsMin.x;
+                float py = (corner & 2) ? object.boundsMax.y : object.boundsMin.y;
+                float pz = (corner & 4) ? object.boundsMax.z : object.boundsMin.z;
+                float cx = px * m[0] + py * m[4] + pz * m[8] + m[12];
+                float cy = px * m[1] + py * m[5] + pz * m[9] + m[13];
+                float w = px * m[3] + py * m[7] + pz * m[11] + m[15];
+                left = std::min(left, (cx / w * 0.5f + 0.5f) * width);
+                right = std::max(right, (cx / w * 0.5f + 0.5f) * width);
+                top = std::min(top, (0.5f - cy / w * 0.5f) * height);
+                bottom = std::max(bottom, (0.5f - cy / w * 0.5f) * height);
+                nearest = std::max(nearest, 1.0f / w);
+            }
+            bool occluded = true;
+            for (int py = std::max((int)floorf(top), 0); py < std::min((int)ceilf(bottom), (int)height); py++) {
+                for (int px = std::max((int)floorf(left), 0); px < std::min((int)ceilf(right), (int)width); px++) {
+                    occluded = occluded && reference[(size_t)py * width + px] > nearest;
+                }
+            }
+            const bool visible = buffer.testBounds(viewProjection, object.boundsMin, object.boundsMax, frustum);
+            falseCulls += (!visible && !occluded) ? 1 : 0;
+            hidden += occluded ? 1 : 0;
+            culled += visible ? 0 : 1;
+        }
+    }
+    check(falseCulls == 0, "random scenes never cull an object the reference sees");
+    check(culled * 2 >= hidden, "random scenes cull at least half of the hidden objects");
+
+    // The city from the street: most of it hides behind the first buildings, and the result
+    // does not depend on how the work was split.
+    std::vector<OcclusionObject> objects;
+    OccluderMesh occluders;
+    makeCity(24, 0x9e3779b9, objects, occluders);
+    XMFLOAT3 eye;
+    XMFLOAT3 target;
+    cityCamera(24, 0.3f, eye, target);
+    makeViewProjection(eye, target, cullingFovY, width / (float)height, cullingNearZ, cullingFarZ, viewProjection);
+    std::vector<UINT8> visibleThreaded(objects.size());
+    std::vector<UINT8> visibleSingle(objects.size());
+    buffer.clear();
+    buffer.resetStats();
+    buffer.renderOccluders(viewProjection, &occluders, 1, pool);
+    buffer.cullObjects(viewProjection, objects.data(), (UINT)objects.size(), visibleThreaded.data(), pool);
+    const MaskedOcclusionBuffer::Stats stats = buffer.stats();
+    pool.stop();
+    buffer.clear();
+    buffer.renderOccluders(viewProjection, &occluders, 1, pool);
+    buffer.cullObjects(viewProjection, objects.data(), (UINT)objects.size(), visibleSingle.data(), pool);
+    check(visibleThreaded == visibleSingle, "threaded culling matches a single thread");
+    check(stats.occlusionCulled * 2 > stats.objects - stats.frustumCulled, "the street view occludes most of the city in the frustum");
+    return passed;
+}
+
+// Culling cost per frame and the share culled along the street walk of a 48x48 block city.
+std::string benchmarkOcclusionCulling() {
+    std::vector<OcclusionObject> objects;
+    OccluderMesh occluders;
+    makeCity(48, 0x9e3779b9, objects, occluders);
+    std::vector<UINT8> visible(objects.size());
+
+    const UINT threads = std::max(std::thread::hardware_concurrency(), 1U);
+    const UINT sizes[2][2] = { { 256, 192 }, { 512, 384 } };
+    char line[256];
+    snprintf(line, sizeof(line), "Occlusion culling, %u objects, %u occluder triangles (%u threads):\n",
+        (UINT)objects.size(), (UINT)(occluders.indices.size() / 3), threads);
+    std::string report = line;
+    for (const auto& size : sizes) {
+        for (UINT pass = 0; pass < 2; pass++) {
+            ParallelFor pool;
+            pool.start(pass == 0 ? threads - 1 : 0);
+            MaskedOcclusionBuffer buffer;
+            buffer.init(size[0], size[1], cullingNearZ);
+            const UINT frames = 32;
+            double rasterSeconds = 0.0;
+            double testSeconds = 0.0;
+            for (UINT frame = 0; frame < frames; frame++) {
+                XMFLOAT3 eye;
+                XMFLOAT3 target;
+                cityCamera(48, frame / (float)frames, eye, target);
+                float viewProjection[16];
+                makeViewProjection(eye, target, cullingFovY, windowWidth / (float)windowHeight, cullingNearZ, cullingFarZ, viewProjection);
+                double start = secondsNow();
+                buffer.clear();
+                buffer.renderOccluders(viewProjection, &occluders, 1, pool);
+                double rastered = secondsNow();
+                buffer.cullObjects(viewProjection, objects.data(), (UINT)objects.size(), visible.data(), pool);
+                testSeconds += secondsNow() - rastered;
+                rasterSeconds += rastered - start;
+            }
+            pool.stop();
+
+            const MaskedOcclusionBuffer::Stats& stats = buffer.stats();
+            snprintf(line, sizeof(line), "  %ux%u, %u thread%s: raster %.3f ms, test %.3f ms per frame; frustum culled %.1f%%, occluded %.1f%% (%.1f%% of the frustum), %.1f%% of occluder triangles rasterized\n",
+                size[0], size[1], pass == 0 ? threads : 1, pass == 0 && threads > 1 ? "s" : "",
+                rasterSeconds * 1000.0 / frames, testSeconds * 1000.0 / frames,
+                100.0 * stats.frustumCulled / stats.objects, 100.0 * stats.occlusionCulled / stats.objects,
+                100.0 * stats.occlusionCulled / (stats.objects - stats.frustumCulled),
+                100.0 * stats.rasterizedTriangles / stats.occluderTriangles);
+            report += line;
+        }
+    }
+    return report;
+}
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        mPool.start(std::max(std::thread::hardware_concurrency(), 1U) - 1);
+        mOcclusion.init(occlusionWidth, occlusionHeight, cullingNearZ);
+
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+        // Create Depth Buffer
+        {
+            D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
+            dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+            dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+            dsvHeapDesc.NumDescriptors = 1;
+            _ThrowIfFailed(mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&mDSVHeap)));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+            D3D12_RESOURCE_DESC depthDesc = {};
+            depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            depthDesc.Width = windowWidth;
+            depthDesc.Height = windowHeight;
+            depthDesc.DepthOrArraySize = 1;
+            depthDesc.MipLevels = 1;
+            depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+            depthDesc.SampleDesc.Count = 1;
+            depthDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+            D3D12_CLEAR_VALUE clearValue = {};
+            clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+            clearValue.DepthStencil.Depth = 1.0f;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &depthDesc,
+                D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                &clearValue,
+                IID_PPV_ARGS(&mDepthBuffer)));
+            mDevice->CreateDepthStencilView(mDepthBuffer.Get(), nullptr, mDSVHeap->GetCPUDescriptorHandleForHeapStart());
+        }
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.0f;
+            mViewport.MaxDepth = 1.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        mStartTime = secondsNow();
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+        mPool.stop();
+    }
+
+    void toggleCulling() {
+        mCulling = !mCulling;
+        debugLog("Occlusion culling %s\n", mCulling ? "on" : "off");
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "CENTER", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "EXTENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 12, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "TINT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, 24, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/016-occlusion.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/016-occlusion.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+            psoDesc.RasterizerState.FrontCounterClockwise = FALSE;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = TRUE;
+            psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+            psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+            psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // The city is static: its buildings double as the occluders.
+        makeCity(cityBlocks, 0x9e3779b9, mObjects, mOccluders);
+        mVisible.resize(mObjects.size());
+        debugLog("City: %u objects, %u occluder triangles\n", (UINT)mObjects.size(), (UINT)(mOccluders.indices.size() / 3));
+
+        // One unit cube, instanced over every object's bounds. Faces are shaded by direction.
+        std::vector<Vertex> vertices;
+        std::vector<UINT> indices;
+        {
+            OccluderMesh cube;
+            appendBox(cube, XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+            const float shades[6] = { 0.8f, 0.6f, 0.7f, 0.9f, 1.0f, 0.4f };
+            const XMFLOAT2 uvs[4] = { XMFLOAT2(0.0f, 0.0f), XMFLOAT2(1.0f, 0.0f), XMFLOAT2(1.0f, 1.0f), XMFLOAT2(0.0f, 1.0f) };
+            for (UINT i = 0; i < cube.vertices.size(); i++) {
+                const float shade = shades[i / 4];
+                vertices.push_back({ cube.vertices[i], XMFLOAT4(shade, shade, shade, 1.0f), uvs[i % 4] });
+            }
+            indices = cube.indices;
+            mCubeIndexCount = (UINT)indices.size();
+        }
+
+        // Create Vertex Buffer
+        {
+            const UINT vertexBufferSize = (UINT)(vertices.size() * sizeof(Vertex));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = vertexBufferSize;
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, vertices.data(), vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = indices.size() * sizeof(UINT);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices.data(), ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = (UINT)ibDesc.Width;
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0xc0;    // R
+                        pData[n + 1] = 0xc0;    // G
+                        pData[n + 2] = 0xc0;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        // Create Instance Buffer, one region per frame in flight, mapped for good
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC bufferDesc = {};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = (UINT64)frameBufferCount * mObjects.size() * sizeof(CubeInstance);
+            bufferDesc.Height = 1;
+            bufferDesc.DepthOrArraySize = 1;
+            bufferDesc.MipLevels = 1;
+            bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mInstanceBuffer)));
+
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mInstanceBuffer->Map(0, &readRange, (void**)&mInstances));
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    // Rasterizes the occluders, tests every object against them and writes the survivors into
+    // this frame's instance region, which the GPU finished reading when waitForNextFrame
+    // returned. With culling off every object is written, as before.
+    void cullCity() {
+        float t = (float)fmod((secondsNow() - mStartTime) * 0.01, 1.0);
+        XMFLOAT3 eye;
+        XMFLOAT3 target;
+        cityCamera(cityBlocks, t, eye, target);
+        makeViewProjection(eye, target, cullingFovY, windowWidth / (float)windowHeight, cullingNearZ, cullingFarZ, mViewProjection);
+
+        double start = secondsNow();
+        double rastered = start;
+        if (mCulling) {
+            mOcclusion.clear();
+            mOcclusion.renderOccluders(mViewProjection, &mOccluders, 1, mPool);
+            rastered = secondsNow();
+            mOcclusion.cullObjects(mViewProjection, mObjects.data(), (UINT)mObjects.size(), mVisible.data(), mPool);
+        }
+        else {
+            std::fill(mVisible.begin(), mVisible.end(), (UINT8)1);
+        }
+        double tested = secondsNow();
+
+        CubeInstance* instances = mInstances + (UINT64)mFrameBufferIndex * mObjects.size();
+        mInstanceCount = 0;
+        for (UINT i = 0; i < mObjects.size(); i++) {
+            if (mVisible[i]) {
+                const OcclusionObject& object = mObjects[i];
+                CubeInstance& instance = instances[mInstanceCount++];
+                instance.center = XMFLOAT3((object.boundsMin.x + object.boundsMax.x) * 0.5f, (object.boundsMin.y + object.boundsMax.y) * 0.5f, (object.boundsMin.z + object.boundsMax.z) * 0.5f);
+                instance.extent = XMFLOAT3((object.boundsMax.x - object.boundsMin.x) * 0.5f, (object.boundsMax.y - object.boundsMin.y) * 0.5f, (object.boundsMax.z - object.boundsMin.z) * 0.5f);
+                instance.color = object.color;
+            }
+        }
+        mRasterSeconds += rastered - start;
+        mTestSeconds += tested - rastered;
+        mDrawnObjects += mInstanceCount;
+
+        if (++mFrameCount % cullingReportFrames == 0) {
+            const MaskedOcclusionBuffer::Stats& stats = mOcclusion.stats();
+            debugLog("Culling %s: %.1f%% of %u objects drawn (frustum culled %.1f%%, occluded %.1f%%), raster %.3f ms, test %.3f ms per frame\n",
+                mCulling ? "on" : "off", 100.0 * mDrawnObjects / ((double)mObjects.size() * cullingReportFrames), (UINT)mObjects.size(),
+                100.0 * stats.frustumCulled / std::max<UINT64>(stats.objects, 1), 100.0 * stats.occlusionCulled / std::max<UINT64>(stats.objects, 1),
+                mRasterSeconds * 1000.0 / cullingReportFrames, mTestSeconds * 1000.0 / cullingReportFrames);
+            mOcclusion.resetStats();
+            mRasterSeconds = 0.0;
+            mTestSeconds = 0.0;
+            mDrawnObjects = 0;
+        }
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        this->cullCity();
+        XMFLOAT4X4 viewProjection(mViewProjection);
+        XMFLOAT4X4 constants;
+        XMStoreFloat4x4(&constants, XMMatrixTranspose(XMLoadFloat4x4(&viewProjection)));
+        mCommandList->SetGraphicsRoot32BitConstants(1, 16, &constants, 0);
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle{ mDSVHeap->GetCPUDescriptorHandleForHeapStart() };
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        D3D12_VERTEX_BUFFER_VIEW instanceBufferView = {};
+        instanceBufferView.BufferLocation = mInstanceBuffer->GetGPUVirtualAddress() + (UINT64)mFrameBufferIndex * mObjects.size() * sizeof(CubeInstance);
+        instanceBufferView.StrideInBytes = sizeof(CubeInstance);
+        instanceBufferView.SizeInBytes = (UINT)(mObjects.size() * sizeof(CubeInstance));
+        D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[] = { mVertexBufferView, instanceBufferView };
+        mCommandList->IASetVertexBuffers(0, _countof(vertexBufferViews), vertexBufferViews);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+
+        // Every object that survived culling in one instanced draw
+        if (mInstanceCount > 0) {
+            mCommandList->DrawIndexedInstanced(mCubeIndexCount, mInstanceCount, 0, 0, 0);
+        }
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+    ComPtr<ID3D12DescriptorHeap> mDSVHeap;
+    ComPtr<ID3D12Resource> mDepthBuffer;
+
+    ComPtr<ID3D12Resource> mInstanceBuffer;
+    CubeInstance* mInstances = nullptr;
+    UINT mInstanceCount = 0;
+    UINT mCubeIndexCount = 0;
+
+    ParallelFor mPool;
+    MaskedOcclusionBuffer mOcclusion;
+    std::vector<OcclusionObject> mObjects;
+    OccluderMesh mOccluders;
+    std::vector<UINT8> mVisible;
+    float mViewProjection[16] = {};
+    bool mCulling = true;
+    double mStartTime = 0.0;
+    UINT64 mFrameCount = 0;
+    UINT64 mDrawnObjects = 0;
+    double mRasterSeconds = 0.0;
+    double mTestSeconds = 0.0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateOcclusionCulling(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkOcclusionCulling();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_KEYDOWN && msg.wParam == 'O') {
+                    graphics.toggleCulling();
+                }
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
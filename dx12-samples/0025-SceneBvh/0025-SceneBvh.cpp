@@ -0,0 +1,2640 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+#include <emmintrin.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0025-SceneBvh";
+const char* windowClass = "0025-SceneBvh";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// 50k boxes; the BVH is refit every frame and checked for degraded subtrees every
+// rebuildFrames frames. Picking marks boxes within pickRadius of the one under the cursor.
+const UINT sceneBoxCount = 50000;
+const UINT sceneMovingStride = 20;
+const float sceneFovY = 0.9f;
+const float sceneNearZ = 0.1f;
+const UINT64 rebuildFrames = 30;
+const float rebuildThreshold = 1.2f;
+const UINT rebuildBudget = 2;
+const float pickRadius = 4.0f;
+const UINT8 highlightPicked = 1;
+const UINT8 highlightNeighbour = 2;
+const UINT64 sceneReportFrames = 120;
+
+// One box as an instance of the unit cube.
+struct CubeInstance {
+    XMFLOAT3 center;
+    XMFLOAT3 extent;
+    UINT32 color;
+};
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Small fork-join pool. run() splits [0, count) into chunks that the workers and the calling
+// thread pull from an atomic counter, and returns once every chunk is done. The job is passed
+// as a function pointer plus context, so dispatching allocates nothing.
+class ParallelFor {
+public:
+    void start(UINT workerCount) {
+        for (UINT i = 0; i < workerCount; i++) {
+            mWorkers.push_back(std::thread([this]() { this->worker(); }));
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+        for (std::thread& worker : mWorkers) {
+            worker.join();
+        }
+        mWorkers.clear();
+    }
+
+    UINT workerCount() const { return (UINT)mWorkers.size(); }
+
+    template<typename F>
+    void run(UINT count, UINT chunkSize, const F& fn) {
+        if (mWorkers.empty() || count <= chunkSize) {
+            fn(0, count);
+            return;
+        }
+        this->dispatch(count, chunkSize, [](const void* context, UINT begin, UINT end) { (*(const F*)context)(begin, end); }, &fn);
+    }
+
+private:
+    typedef void (*JobFunction)(const void* context, UINT begin, UINT end);
+
+    void dispatch(UINT count, UINT chunkSize, JobFunction function, const void* context) {
+        {
+            // Wait for stragglers of the previous job before the job fields are replaced.
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait(lock, [this]() { return mActive == 0; });
+            mFunction = function;
+            mContext = context;
+            mCount = count;
+            mChunkSize = chunkSize;
+            mNextChunk = 0;
+            mGeneration++;
+        }
+        mWake.notify_all();
+
+        this->work();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mActive == 0; });
+    }
+
+    void work() {
+        UINT chunkCount = (mCount + mChunkSize - 1) / mChunkSize;
+        for (;;) {
+            UINT chunk = mNextChunk++;
+            if (chunk >= chunkCount) {
+                return;
+            }
+            UINT begin = chunk * mChunkSize;
+            mFunction(mContext, begin, std::min(begin + mChunkSize, mCount));
+        }
+    }
+
+    void worker() {
+        UINT64 seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [&]() { return mStop || mGeneration != seen; });
+                if (mStop) {
+                    return;
+                }
+                seen = mGeneration;
+                mActive++;
+            }
+
+            this->work();
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mActive == 0) {
+                mDone.notify_all();
+            }
+        }
+    }
+
+private:
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    JobFunction mFunction = nullptr;
+    const void* mContext = nullptr;
+    UINT mCount = 0;
+    UINT mChunkSize = 1;
+    std::atomic<UINT> mNextChunk;
+    UINT64 mGeneration = 0;
+    UINT mActive = 0;
+    bool mStop = false;
+};
+
+struct Aabb {
+    XMFLOAT3 boundsMin;
+    XMFLOAT3 boundsMax;
+};
+
+Aabb emptyAabb() {
+    return { XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX), XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX) };
+}
+
+void growAabb(Aabb& a, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) {
+    a.boundsMin = XMFLOAT3(std::min(a.boundsMin.x, boundsMin.x), std::min(a.boundsMin.y, boundsMin.y), std::min(a.boundsMin.z, boundsMin.z));
+    a.boundsMax = XMFLOAT3(std::max(a.boundsMax.x, boundsMax.x), std::max(a.boundsMax.y, boundsMax.y), std::max(a.boundsMax.z, boundsMax.z));
+}
+
+void growAabb(Aabb& a, const Aabb& b) {
+    growAabb(a, b.boundsMin, b.boundsMax);
+}
+
+float aabbArea(const Aabb& a) {
+    float x = std::max(a.boundsMax.x - a.boundsMin.x, 0.0f);
+    float y = std::max(a.boundsMax.y - a.boundsMin.y, 0.0f);
+    float z = std::max(a.boundsMax.z - a.boundsMin.z, 0.0f);
+    return 2.0f * (x * y + y * z + z * x);
+}
+
+bool aabbOverlaps(const Aabb& a, const Aabb& b) {
+    return a.boundsMin.x <= b.boundsMax.x && a.boundsMax.x >= b.boundsMin.x
+        && a.boundsMin.y <= b.boundsMax.y && a.boundsMax.y >= b.boundsMin.y
+        && a.boundsMin.z <= b.boundsMax.z && a.boundsMax.z >= b.boundsMin.z;
+}
+
+// Distance along the ray to where it enters the box, or false when it misses within
+// maxDistance. inverse holds 1 / direction per axis.
+bool rayHitsAabb(const XMFLOAT3& origin, const XMFLOAT3& inverse, float maxDistance, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax, float& distance) {
+    float x0 = (boundsMin.x - origin.x) * inverse.x;
+    float x1 = (boundsMax.x - origin.x) * inverse.x;
+    float y0 = (boundsMin.y - origin.y) * inverse.y;
+    float y1 = (boundsMax.y - origin.y) * inverse.y;
+    float z0 = (boundsMin.z - origin.z) * inverse.z;
+    float z1 = (boundsMax.z - origin.z) * inverse.z;
+    float enter = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::max(std::min(z0, z1), 0.0f));
+    float exit = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::min(std::max(z0, z1), maxDistance));
+    distance = enter;
+    return enter <= exit;
+}
+
+// Six inward facing planes, a * x + b * y + c * z + d >= 0 inside.
+struct Frustum {
+    XMFLOAT4 planes[6];
+};
+
+// From a row vector view-projection matrix, where clip = (x, y, z, 1) * m.
+Frustum makeFrustum(const float m[16]) {
+    auto column = [m](UINT c) { return XMFLOAT4(m[c], m[4 + c], m[8 + c], m[12 + c]); };
+    auto add = [](const XMFLOAT4& a, const XMFLOAT4& b, float sign) { return XMFLOAT4(a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z, a.w + sign * b.w); };
+    const XMFLOAT4 x = column(0);
+    const XMFLOAT4 y = column(1);
+    const XMFLOAT4 z = column(2);
+    const XMFLOAT4 w = column(3);
+    Frustum frustum;
+    frustum.planes[0] = add(w, x, 1.0f);
+    frustum.planes[1] = add(w, x, -1.0f);
+    frustum.planes[2] = add(w, y, 1.0f);
+    frustum.planes[3] = add(w, y, -1.0f);
+    frustum.planes[4] = z;
+    frustum.planes[5] = add(w, z, -1.0f);
+    return frustum;
+}
+
+enum FrustumTest {
+    FrustumOutside,
+    FrustumIntersects,
+    FrustumInside
+};
+
+FrustumTest testFrustum(const Frustum& frustum, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) {
+    FrustumTest result = FrustumInside;
+    for (const XMFLOAT4& p : frustum.planes) {
+        // The corners furthest along and against the plane normal.
+        float farthest = p.x * (p.x > 0.0f ? boundsMax.x : boundsMin.x) + p.y * (p.y > 0.0f ? boundsMax.y : boundsMin.y) + p.z * (p.z > 0.0f ? boundsMax.z : boundsMin.z) + p.w;
+        if (farthest < 0.0f) {
+            return FrustumOutside;
+        }
+        float nearest = p.x * (p.x > 0.0f ? boundsMin.x : boundsMax.x) + p.y * (p.y > 0.0f ? boundsMin.y : boundsMax.y) + p.z * (p.z > 0.0f ? boundsMin.z : boundsMax.z) + p.w;
+        if (nearest < 0.0f) {
+            result = FrustumIntersects;
+        }
+    }
+    return result;
+}
+
+// 32 bytes. Interior nodes have count 0 and their children at leftFirst and leftFirst + 1;
+// leaves hold count primitives from leftFirst in the index array. Sibling pairs start at
+// even indices of a 64 byte aligned array, so both boxes a traversal step tests share a
+// cache line. Slot 1 is padding for that.
+struct BvhNode {
+    XMFLOAT3 boundsMin;
+    UINT leftFirst;
+    XMFLOAT3 boundsMax;
+    UINT count;
+};
+
+// Growable node storage on a 64 byte boundary.
+class BvhNodeArray {
+public:
+    BvhNodeArray() = default;
+    BvhNodeArray(const BvhNodeArray&) = delete;
+    BvhNodeArray& operator=(const BvhNodeArray&) = delete;
+    ~BvhNodeArray() { _aligned_free(mData); }
+
+    void resize(UINT count) {
+        if (count > mCapacity) {
+            UINT capacity = std::max(count, mCapacity + mCapacity / 2);
+            BvhNode* data = (BvhNode*)_aligned_malloc((size_t)capacity * sizeof(BvhNode), 64);
+            if (data == nullptr) {
+                throw std::bad_alloc();
+            }
+            if (mData != nullptr) {
+                memcpy(data, mData, (size_t)mCount * sizeof(BvhNode));
+                _aligned_free(mData);
+            }
+            mData = data;
+            mCapacity = capacity;
+        }
+        mCount = count;
+    }
+
+    UINT size() const { return mCount; }
+    BvhNode& operator[](UINT i) { return mData[i]; }
+    const BvhNode& operator[](UINT i) const { return mData[i]; }
+
+private:
+    BvhNode* mData = nullptr;
+    UINT mCount = 0;
+    UINT mCapacity = 0;
+};
+
+const UINT bvhBinCount = 16;
+const UINT bvhMaxLeafSize = 8;
+// Past this depth nodes split at the median, so traversal stacks of bvhMaxDepth suffice.
+const UINT bvhMedianDepth = 40;
+const UINT bvhMaxDepth = 64;
+// Partial rebuilds replace whole subtrees of about this many primitives, checking at most
+// bvhTreeletChecks of those that refits touched per call.
+const UINT bvhTreeletSize = 4096;
+const UINT bvhTreeletChecks = 8;
+
+// Bounding volume hierarchy over primitive bounds the caller owns. Built top down with
+// binned SAH; the upper levels bin in parallel and the subtrees below them build as
+// parallel tasks. Moving primitives are handled by refitting, and the subtrees that refits
+// degraded most can be rebuilt in place without touching the rest of the tree.
+class SceneBvh {
+public:
+    struct Stats {
+        UINT nodes = 0;
+        UINT leaves = 0;
+        UINT maxDepth = 0;
+        UINT garbageNodes = 0;
+        float sahCost = 0.0f;
+    };
+
+    // bounds must stay valid, and be updated in place before refits, for the BVH's lifetime.
+    void build(const Aabb* bounds, UINT count, ParallelFor& pool) {
+        mBounds = bounds;
+        mPrimitiveCount = count;
+        mIndices.resize(count);
+        mCentroids.resize(count);
+        mLeafOf.resize(count);
+        pool.run(count, 4096, [&](UINT begin, UINT end) {
+            for (UINT i = begin; i < end; i++) {
+                mIndices[i] = i;
+                mCentroids[i] = XMFLOAT3(
+                    (bounds[i].boundsMin.x + bounds[i].boundsMax.x) * 0.5f,
+                    (bounds[i].boundsMin.y + bounds[i].boundsMax.y) * 0.5f,
+                    (bounds[i].boundsMin.z + bounds[i].boundsMax.z) * 0.5f);
+            }
+        });
+
+        BuildTask root;
+        root.node = 0;
+        root.begin = 0;
+        root.end = count;
+        root.depth = 0;
+        root.bounds = emptyAabb();
+        root.centroids = emptyAabb();
+        {
+            std::vector<Aabb> chunkBounds((count + 4095) / 4096 * 2 + 2, emptyAabb());
+            pool.run(count, 4096, [&](UINT begin, UINT end) {
+                Aabb& b = chunkBounds[begin / 4096 * 2];
+                Aabb& c = chunkBounds[begin / 4096 * 2 + 1];
+                for (UINT i = begin; i < end; i++) {
+                    growAabb(b, bounds[i]);
+                    growAabb(c, mCentroids[i], mCentroids[i]);
+                }
+            });
+            for (size_t i = 0; i < chunkBounds.size(); i += 2) {
+                growAabb(root.bounds, chunkBounds[i]);
+                growAabb(root.centroids, chunkBounds[i + 1]);
+            }
+        }
+        mNodes.resize(2);
+        mNodes[1] = BvhNode();
+        if (count == 0) {
+            mNodes[0] = BvhNode();
+            mParents.clear();
+            mTreelets.clear();
+            mTreeletDirty.clear();
+            return;
+        }
+
+        // Split the top of the tree here, binning the big nodes in parallel, until there are
+        // enough subtrees to keep every thread busy.
+        const UINT threads = pool.workerCount() + 1;
+        const UINT taskSize = std::max(count / (threads * 8), 4096U);
+        std::vector<BuildTask> tasks;
+        std::vector<BuildTask> pending;
+        pending.push_back(root);
+        while (!pending.empty()) {
+            BuildTask task = pending.back();
+            pending.pop_back();
+            if (task.end - task.begin <= taskSize || threads == 1) {
+                tasks.push_back(task);
+                continue;
+            }
+            BuildTask children[2];
+            if (this->split(task, &pool, children)) {
+                UINT left = mNodes.size();
+                mNodes.resize(left + 2);
+                this->setInterior(mNodes[task.node], task.bounds, left);
+                children[0].node = left;
+                children[1].node = left + 1;
+                pending.push_back(children[1]);
+                pending.push_back(children[0]);
+            }
+            else {
+                this->setLeaf(mNodes[task.node], task);
+            }
+        }
+
+        // Each subtree builds into its own array, spliced in after all of them finish.
+        std::vector<std::vector<BvhNode>> subtrees(tasks.size());
+        pool.run((UINT)tasks.size(), 1, [&](UINT begin, UINT end) {
+            for (UINT i = begin; i < end; i++) {
+                this->buildSubtree(tasks[i], subtrees[i]);
+            }
+        });
+        for (UINT i = 0; i < tasks.size(); i++) {
+            this->splice(tasks[i].node, subtrees[i]);
+        }
+        mGarbageNodes = 0;
+        this->linkParents(0);
+        this->findTreelets();
+    }
+
+    // Recomputes every node from the current primitive bounds; children always sit after
+    // their parent, so one reverse pass does it.
+    void refit() {
+        if (mPrimitiveCount == 0) {
+            return;
+        }
+        for (UINT i = mNodes.size(); i-- > 0;) {
+            if (i != 1) {
+                this->refitNode(i);
+            }
+        }
+        std::fill(mTreeletDirty.begin(), mTreeletDirty.end(), (UINT8)1);
+    }
+
+    // Refits only the leaves holding the moved primitives and the paths above them, stopping
+    // where a node's bounds come out unchanged.
+    void refit(const UINT* moved, UINT movedCount) {
+        if (mPrimitiveCount == 0) {
+            return;
+        }
+        for (UINT m = 0; m < movedCount; m++) {
+            if (mTreeletOf[moved[m]] != UINT_MAX) {
+                mTreeletDirty[mTreeletOf[moved[m]]] = 1;
+            }
+            UINT node = mLeafOf[moved[m]];
+            while (true) {
+                BvhNode before = mNodes[node];
+                this->refitNode(node);
+                const BvhNode& after = mNodes[node];
+                if (node == 0 || memcmp(&before, &after, sizeof(BvhNode)) == 0) {
+                    break;
+                }
+                node = mParents[node];
+            }
+        }
+    }
+
+    // Rebuilds up to maxCount of the subtrees whose SAH cost refits have pushed past threshold
+    // times what they had when built, worst first. Each call checks the next few subtrees that
+    // refits touched, round robin, so the cost per call stays flat as the tree grows. The
+    // replaced nodes are left unused until the next full build. Returns how many were rebuilt.
+    UINT rebuildDegraded(float threshold, UINT maxCount) {
+        std::vector<std::pair<float, UINT>> degraded;
+        UINT checked = 0;
+        for (UINT n = 0; n < mTreelets.size() && checked < bvhTreeletChecks; n++) {
+            const UINT i = mTreeletCursor;
+            mTreeletCursor = (mTreeletCursor + 1) % (UINT)mTreelets.size();
+            if (!mTreeletDirty[i]) {
+                continue;
+            }
+            checked++;
+            mTreeletDirty[i] = 0;
+            float ratio = this->subtreeCost(mTreelets[i].node) / mTreelets[i].builtCost;
+            if (ratio > threshold) {
+                degraded.push_back(std::make_pair(ratio, i));
+            }
+        }
+        std::sort(degraded.begin(), degraded.end(), [](const std::pair<float, UINT>& a, const std::pair<float, UINT>& b) { return a.first > b.first; });
+        UINT rebuilt = 0;
+        for (const auto& entry : degraded) {
+            if (rebuilt == maxCount) {
+                // Still degraded; check it again next time.
+                mTreeletDirty[entry.second] = 1;
+                continue;
+            }
+            Treelet& treelet = mTreelets[entry.second];
+            const UINT oldNodes = this->subtreeNodes(treelet.node);
+
+            BuildTask task;
+            task.node = treelet.node;
+            task.begin = treelet.begin;
+            task.end = treelet.end;
+            task.depth = mTreeletDepth;
+            task.bounds = emptyAabb();
+            task.centroids = emptyAabb();
+            for (UINT k = task.begin; k < task.end; k++) {
+                const UINT p = mIndices[k];
+                const Aabb& b = mBounds[p];
+                mCentroids[p] = XMFLOAT3((b.boundsMin.x + b.boundsMax.x) * 0.5f, (b.boundsMin.y + b.boundsMax.y) * 0.5f, (b.boundsMin.z + b.boundsMax.z) * 0.5f);
+                growAabb(task.bounds, b);
+                growAabb(task.centroids, mCentroids[p], mCentroids[p]);
+            }
+            std::vector<BvhNode> subtree;
+            this->buildSubtree(task, subtree);
+            this->splice(task.node, subtree);
+            this->linkParents(task.node);
+            mGarbageNodes += oldNodes - 1;
+            treelet.builtCost = std::max(this->subtreeCost(treelet.node), FLT_MIN);
+            rebuilt++;
+        }
+        return rebuilt;
+    }
+
+    // Every primitive whose bounds touch the frustum. Subtrees entirely inside are taken
+    // whole without further tests.
+    void queryFrustum(const Frustum& frustum, std::vector<UINT>& out) const {
+        if (mPrimitiveCount == 0) {
+            return;
+        }
+        UINT stack[bvhMaxDepth * 2];
+        bool insideStack[bvhMaxDepth * 2];
+        UINT top = 0;
+        stack[top] = 0;
+        insideStack[top++] = false;
+        while (top > 0) {
+            top--;
+            const BvhNode& node = mNodes[stack[top]];
+            bool inside = insideStack[top];
+            if (!inside) {
+                FrustumTest test = testFrustum(frustum, node.boundsMin, node.boundsMax);
+                if (test == FrustumOutside) {
+                    continue;
+                }
+                inside = test == FrustumInside;
+            }
+            if (node.count > 0) {
+                for (UINT i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    const Aabb& b = mBounds[mIndices[i]];
+                    if (inside || testFrustum(frustum, b.boundsMin, b.boundsMax) != FrustumOutside) {
+                        out.push_back(mIndices[i]);
+                    }
+                }
+                continue;
+            }
+            stack[top] = node.leftFirst + 1;
+            insideStack[top++] = inside;
+            stack[top] = node.leftFirst;
+            insideStack[top++] = inside;
+        }
+    }
+
+    // The nearest primitive box the ray enters within maxDistance. Children are visited near
+    // first, and subtrees beyond the closest hit so far are skipped.
+    bool raycast(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, UINT& hit, float& distance) const {
+        if (mPrimitiveCount == 0) {
+            return false;
+        }
+        const XMFLOAT3 inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+        float closest = maxDistance;
+        bool found = false;
+        UINT stack[bvhMaxDepth * 2];
+        UINT top = 0;
+        float entry;
+        if (!rayHitsAabb(origin, inverse, closest, mNodes[0].boundsMin, mNodes[0].boundsMax, entry)) {
+            return false;
+        }
+        stack[top++] = 0;
+        while (top > 0) {
+            const BvhNode& node = mNodes[stack[--top]];
+            if (node.count > 0) {
+                for (UINT i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    const Aabb& b = mBounds[mIndices[i]];
+                    if (rayHitsAabb(origin, inverse, closest, b.boundsMin, b.boundsMax, entry)) {
+                        // Ties go to the lower index, so the answer does not depend on the tree.
+                        if (!found || entry < closest || (entry == closest && mIndices[i] < hit)) {
+                            closest = entry;
+                            hit = mIndices[i];
+                            found = true;
+                        }
+                    }
+                }
+                continue;
+            }
+            const BvhNode& left = mNodes[node.leftFirst];
+            const BvhNode& right = mNodes[node.leftFirst + 1];
+            float leftEntry;
+            float rightEntry;
+            bool hitLeft = rayHitsAabb(origin, inverse, closest, left.boundsMin, left.boundsMax, leftEntry);
+            bool hitRight = rayHitsAabb(origin, inverse, closest, right.boundsMin, right.boundsMax, rightEntry);
+            if (hitLeft && hitRight) {
+                // The farther child goes on the stack first, so the nearer one is popped next.
+                bool leftFirst = leftEntry <= rightEntry;
+                stack[top++] = leftFirst ? node.leftFirst + 1 : node.leftFirst;
+                stack[top++] = leftFirst ? node.leftFirst : node.leftFirst + 1;
+            }
+            else if (hitLeft || hitRight) {
+                stack[top++] = hitLeft ? node.leftFirst : node.leftFirst + 1;
+            }
+        }
+        distance = closest;
+        return found;
+    }
+
+    // Every primitive whose bounds overlap box.
+    void queryOverlap(const Aabb& box, std::vector<UINT>& out) const {
+        if (mPrimitiveCount == 0) {
+            return;
+        }
+        UINT stack[bvhMaxDepth * 2];
+        UINT top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const BvhNode& node = mNodes[stack[--top]];
+            if (!aabbOverlaps(box, { node.boundsMin, node.boundsMax })) {
+                continue;
+            }
+            if (node.count > 0) {
+                for (UINT i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    if (aabbOverlaps(box, mBounds[mIndices[i]])) {
+                        out.push_back(mIndices[i]);
+                    }
+                }
+                continue;
+            }
+            stack[top++] = node.leftFirst + 1;
+            stack[top++] = node.leftFirst;
+        }
+    }
+
+    // SAH cost of the live tree relative to its root: one per interior node and one per
+    // primitive in a leaf, each weighted by the chance a ray through the root hits it.
+    Stats stats() const {
+        Stats s;
+        if (mPrimitiveCount == 0) {
+            return s;
+        }
+        s.garbageNodes = mGarbageNodes;
+        UINT stack[bvhMaxDepth * 2];
+        UINT depths[bvhMaxDepth * 2];
+        UINT top = 0;
+        stack[top] = 0;
+        depths[top++] = 1;
+        float cost = 0.0f;
+        while (top > 0) {
+            top--;
+            const BvhNode& node = mNodes[stack[top]];
+            const UINT depth = depths[top];
+            s.nodes++;
+            s.maxDepth = std::max(s.maxDepth, depth);
+            cost += aabbArea({ node.boundsMin, node.boundsMax }) * (node.count > 0 ? (float)node.count : 1.0f);
+            if (node.count > 0) {
+                s.leaves++;
+                continue;
+            }
+            stack[top] = node.leftFirst + 1;
+            depths[top++] = depth + 1;
+            stack[top] = node.leftFirst;
+            depths[top++] = depth + 1;
+        }
+        s.sahCost = cost / std::max(aabbArea({ mNodes[0].boundsMin, mNodes[0].boundsMax }), FLT_MIN);
+        return s;
+    }
+
+    // Checks that every node contains its children and primitives, and every primitive sits
+    // in exactly one leaf.
+    bool validate() const {
+        if (mPrimitiveCount == 0) {
+            return true;
+        }
+        std::vector<UINT> seen(mPrimitiveCount, 0);
+        std::vector<UINT> stack(1, 0);
+        auto contains = [](const BvhNode& outer, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) {
+            return outer.boundsMin.x <= boundsMin.x && outer.boundsMin.y <= boundsMin.y && outer.boundsMin.z <= boundsMin.z
+                && outer.boundsMax.x >= boundsMax.x && outer.boundsMax.y >= boundsMax.y && outer.boundsMax.z >= boundsMax.z;
+        };
+        while (!stack.empty()) {
+            const UINT index = stack.back();
+            stack.pop_back();
+            const BvhNode& node = mNodes[index];
+            if (node.count > 0) {
+                for (UINT i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    const Aabb& b = mBounds[mIndices[i]];
+                    if (!contains(node, b.boundsMin, b.boundsMax) || mLeafOf[mIndices[i]] != index) {
+                        return false;
+                    }
+                    seen[mIndices[i]]++;
+                }
+                continue;
+            }
+            for (UINT c = 0; c < 2; c++) {
+                const BvhNode& child = mNodes[node.leftFirst + c];
+                if (node.leftFirst % 2 != 0 || !contains(node, child.boundsMin, child.boundsMax) || mParents[node.leftFirst + c] != index) {
+                    return false;
+                }
+                stack.push_back(node.leftFirst + c);
+            }
+        }
+        for (UINT count : seen) {
+            if (count != 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    UINT nodeCount() const { return mNodes.size(); }
+    UINT garbageNodes() const { return mGarbageNodes; }
+
+private:
+    struct BuildTask {
+        UINT node;
+        UINT begin;
+        UINT end;
+        UINT depth;
+        Aabb bounds;
+        Aabb centroids;
+    };
+
+    struct Bin {
+        Aabb bounds;
+        UINT count;
+    };
+
+    struct Bins {
+        Bin bins[3][bvhBinCount];
+        UINT used;
+
+        void clear(UINT binCount) {
+            used = binCount;
+            for (auto& axis : bins) {
+                for (UINT i = 0; i < used; i++) {
+                    axis[i].bounds = emptyAabb();
+                    axis[i].count = 0;
+                }
+            }
+        }
+
+        void merge(const Bins& other) {
+            for (UINT axis = 0; axis < 3; axis++) {
+                for (UINT i = 0; i < used; i++) {
+                    growAabb(bins[axis][i].bounds, other.bins[axis][i].bounds);
+                    bins[axis][i].count += other.bins[axis][i].count;
+                }
+            }
+        }
+    };
+
+    struct Treelet {
+        UINT node;
+        UINT begin;
+        UINT end;
+        float builtCost;
+    };
+
+    static float axisOf(const XMFLOAT3& v, UINT axis) {
+        return (&v.x)[axis];
+    }
+
+    // Maps centroids to bins along each axis; the binning and the partition share it, so
+    // they always agree on which side a primitive falls. Small nodes use fewer bins, which
+    // is most nodes, as they sit near the leaves.
+    struct BinMapping {
+        float low[3];
+        float scale[3];
+        UINT count;
+
+        BinMapping(const Aabb& centroids, UINT primitives) {
+            count = std::min(std::max(primitives, 4U), bvhBinCount);
+            for (UINT axis = 0; axis < 3; axis++) {
+                low[axis] = axisOf(centroids.boundsMin, axis);
+                float extent = axisOf(centroids.boundsMax, axis) - low[axis];
+                scale[axis] = extent > 0.0f ? count / extent : 0.0f;
+            }
+        }
+
+        UINT bin(const XMFLOAT3& centroid, UINT axis) const {
+            const int bin = (int)((axisOf(centroid, axis) - low[axis]) * scale[axis]);
+            return (UINT)std::min(std::max(bin, 0), (int)count - 1);
+        }
+    };
+
+    void binRange(UINT begin, UINT end, const BinMapping& mapping, Bins& bins) const {
+        for (UINT i = begin; i < end; i++) {
+            const UINT p = mIndices[i];
+            const XMFLOAT3& c = mCentroids[p];
+            const Aabb& b = mBounds[p];
+            for (UINT axis = 0; axis < 3; axis++) {
+                Bin& bin = bins.bins[axis][mapping.bin(c, axis)];
+                growAabb(bin.bounds, b);
+                bin.count++;
+            }
+        }
+    }
+
+    // Splits a node at the cheapest bin boundary by SAH, or at the median past
+    // bvhMedianDepth or when every centroid coincides. False when a leaf is cheaper and
+    // small enough. Bins the range in parallel chunks when the pool has workers.
+    bool split(const BuildTask& task, ParallelFor* pool, BuildTask children[2]) {
+        const UINT count = task.end - task.begin;
+        if (count <= 1) {
+            return false;
+        }
+        const bool degenerate = !(task.centroids.boundsMax.x > task.centroids.boundsMin.x)
+            && !(task.centroids.boundsMax.y > task.centroids.boundsMin.y)
+            && !(task.centroids.boundsMax.z > task.centroids.boundsMin.z);
+        if (degenerate || task.depth >= bvhMedianDepth) {
+            if (count <= bvhMaxLeafSize) {
+                return false;
+            }
+            this->splitMedian(task, children);
+            return true;
+        }
+
+        const BinMapping mapping(task.centroids, count);
+        Bins bins;
+        bins.clear(mapping.count);
+        const UINT chunk = 16384;
+        if (pool != nullptr && pool->workerCount() > 0 && count > chunk) {
+            std::vector<Bins> partial((count + chunk - 1) / chunk);
+            pool->run(count, chunk, [&](UINT begin, UINT end) {
+                Bins& local = partial[begin / chunk];
+                local.clear(mapping.count);
+                this->binRange(task.begin + begin, task.begin + end, mapping, local);
+            });
+            for (const Bins& local : partial) {
+                bins.merge(local);
+            }
+        }
+        else {
+            this->binRange(task.begin, task.end, mapping, bins);
+        }
+
+        // Sweep each axis from both ends for the area and count on either side of every plane.
+        float bestCost = FLT_MAX;
+        UINT bestAxis = 0;
+        UINT bestBin = 0;
+        for (UINT axis = 0; axis < 3; axis++) {
+            if (!(axisOf(task.centroids.boundsMax, axis) > axisOf(task.centroids.boundsMin, axis))) {
+                continue;
+            }
+            const Bin* row = bins.bins[axis];
+            float rightCost[bvhBinCount];
+            Aabb right = emptyAabb();
+            UINT rightCount = 0;
+            for (UINT i = mapping.count - 1; i > 0; i--) {
+                growAabb(right, row[i].bounds);
+                rightCount += row[i].count;
+                rightCost[i] = rightCount > 0 ? aabbArea(right) * rightCount : 0.0f;
+            }
+            Aabb left = emptyAabb();
+            UINT leftCount = 0;
+            for (UINT i = 1; i < mapping.count; i++) {
+                growAabb(left, row[i - 1].bounds);
+                leftCount += row[i - 1].count;
+                if (leftCount == 0 || leftCount == count) {
+                    continue;
+                }
+                float cost = aabbArea(left) * leftCount + rightCost[i];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = i;
+                }
+            }
+        }
+        // Traversal costs one, a primitive test one; both relative to the parent's area.
+        const float parentArea = std::max(aabbArea(task.bounds), FLT_MIN);
+        const float splitCost = 1.0f + bestCost / parentArea;
+        if (bestCost == FLT_MAX) {
+            if (count <= bvhMaxLeafSize) {
+                return false;
+            }
+            this->splitMedian(task, children);
+            return true;
+        }
+        if (count <= bvhMaxLeafSize && (float)count <= splitCost) {
+            return false;
+        }
+
+        UINT* first = mIndices.data() + task.begin;
+        UINT* middle = std::partition(first, mIndices.data() + task.end, [&](UINT p) {
+            return mapping.bin(mCentroids[p], bestAxis) < bestBin;
+        });
+        const UINT mid = task.begin + (UINT)(middle - first);
+        for (UINT c = 0; c < 2; c++) {
+            children[c].bounds = emptyAabb();
+            children[c].centroids = emptyAabb();
+            children[c].depth = task.depth + 1;
+        }
+        for (UINT i = 0; i < mapping.count; i++) {
+            growAabb(children[i < bestBin ? 0 : 1].bounds, bins.bins[bestAxis][i].bounds);
+        }
+        children[0].begin = task.begin;
+        children[0].end = mid;
+        children[1].begin = mid;
+        children[1].end = task.end;
+        for (UINT c = 0; c < 2; c++) {
+            for (UINT i = children[c].begin; i < children[c].end; i++) {
+                const XMFLOAT3& centroid = mCentroids[mIndices[i]];
+                growAabb(children[c].centroids, centroid, centroid);
+            }
+        }
+        return true;
+    }
+
+    void splitMedian(const BuildTask& task, BuildTask children[2]) {
+        const Aabb& c = task.centroids;
+        const float extents[3] = { c.boundsMax.x - c.boundsMin.x, c.boundsMax.y - c.boundsMin.y, c.boundsMax.z - c.boundsMin.z };
+        const UINT axis = extents[0] >= extents[1] && extents[0] >= extents[2] ? 0 : (extents[1] >= extents[2] ? 1 : 2);
+        const UINT mid = task.begin + (task.end - task.begin) / 2;
+        std::nth_element(mIndices.data() + task.begin, mIndices.data() + mid, mIndices.data() + task.end, [&](UINT a, UINT b) {
+            return axisOf(mCentroids[a], axis) < axisOf(mCentroids[b], axis);
+        });
+        const UINT ranges[2][2] = { { task.begin, mid }, { mid, task.end } };
+        for (UINT i = 0; i < 2; i++) {
+            children[i].begin = ranges[i][0];
+            children[i].end = ranges[i][1];
+            children[i].depth = task.depth + 1;
+            children[i].bounds = emptyAabb();
+            children[i].centroids = emptyAabb();
+            for (UINT k = ranges[i][0]; k < ranges[i][1]; k++) {
+                const UINT p = mIndices[k];
+                growAabb(children[i].bounds, mBounds[p]);
+                growAabb(children[i].centroids, mCentroids[p], mCentroids[p]);
+            }
+        }
+    }
+
+    static void setInterior(BvhNode& node, const Aabb& bounds, UINT left) {
+        node.boundsMin = bounds.boundsMin;
+        node.boundsMax = bounds.boundsMax;
+        node.leftFirst = left;
+        node.count = 0;
+    }
+
+    void setLeaf(BvhNode& node, const BuildTask& task) {
+        node.boundsMin = task.bounds.boundsMin;
+        node.boundsMax = task.bounds.boundsMax;
+        node.leftFirst = task.begin;
+        node.count = task.end - task.begin;
+    }
+
+    // Builds one subtree on this thread into nodes: its root at 0, padding at 1 and sibling
+    // pairs from 2, as in the main array.
+    void buildSubtree(const BuildTask& root, std::vector<BvhNode>& nodes) {
+        nodes.resize(2);
+        nodes[1] = BvhNode();
+        std::vector<BuildTask> stack;
+        stack.push_back(root);
+        stack.back().node = 0;
+        while (!stack.empty()) {
+            BuildTask task = stack.back();
+            stack.pop_back();
+            BuildTask children[2];
+            if (this->split(task, nullptr, children)) {
+                UINT left = (UINT)nodes.size();
+                nodes.resize(left + 2);
+                this->setInterior(nodes[task.node], task.bounds, left);
+                children[0].node = left;
+                children[1].node = left + 1;
+                stack.push_back(children[1]);
+                stack.push_back(children[0]);
+            }
+            else {
+                this->setLeaf(nodes[task.node], task);
+            }
+        }
+    }
+
+    // Copies a subtree built by buildSubtree into the main array: its root into slot node,
+    // the rest appended. Leaves keep their primitive ranges; child links are rebased.
+    void splice(UINT node, const std::vector<BvhNode>& subtree) {
+        const UINT base = mNodes.size();
+        mNodes.resize(base + (UINT)subtree.size() - 2);
+        auto rebase = [base](BvhNode n) {
+            if (n.count == 0) {
+                n.leftFirst = n.leftFirst - 2 + base;
+            }
+            return n;
+        };
+        mNodes[node] = rebase(subtree[0]);
+        for (UINT i = 2; i < subtree.size(); i++) {
+            mNodes[base + i - 2] = rebase(subtree[i]);
+        }
+    }
+
+    // Parent links and the leaf of every primitive below root.
+    void linkParents(UINT root) {
+        mParents.resize(mNodes.size());
+        std::vector<UINT> stack(1, root);
+        while (!stack.empty()) {
+            const UINT index = stack.back();
+            stack.pop_back();
+            const BvhNode& node = mNodes[index];
+            if (node.count > 0) {
+                for (UINT i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    mLeafOf[mIndices[i]] = index;
+                }
+                continue;
+            }
+            for (UINT c = 0; c < 2; c++) {
+                mParents[node.leftFirst + c] = index;
+                stack.push_back(node.leftFirst + c);
+            }
+        }
+    }
+
+    void refitNode(UINT index) {
+        BvhNode& node = mNodes[index];
+        Aabb bounds = emptyAabb();
+        if (node.count > 0) {
+            for (UINT i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                growAabb(bounds, mBounds[mIndices[i]]);
+            }
+        }
+        else {
+            const BvhNode& left = mNodes[node.leftFirst];
+            const BvhNode& right = mNodes[node.leftFirst + 1];
+            growAabb(bounds, left.boundsMin, left.boundsMax);
+            growAabb(bounds, right.boundsMin, right.boundsMax);
+        }
+        node.boundsMin = bounds.boundsMin;
+        node.boundsMax = bounds.boundsMax;
+    }
+
+    // The roots of the subtrees at the depth where they hold about bvhTreeletSize primitives,
+    // with the primitive ranges they cover and their cost as built. Primitives in shallower
+    // leaves belong to none.
+    void findTreelets() {
+        mTreelets.clear();
+        mTreeletDepth = 0;
+        while ((mPrimitiveCount >> mTreeletDepth) > bvhTreeletSize * 2 && mTreeletDepth < bvhMedianDepth) {
+            mTreeletDepth++;
+        }
+        mTreeletOf.assign(mPrimitiveCount, UINT_MAX);
+        struct Entry {
+            UINT node;
+            UINT depth;
+        };
+        std::vector<Entry> stack(1, Entry{ 0, 0 });
+        while (!stack.empty()) {
+            Entry entry = stack.back();
+            stack.pop_back();
+            const BvhNode& node = mNodes[entry.node];
+            if (node.count > 0) {
+                continue;
+            }
+            if (entry.depth == mTreeletDepth) {
+                Treelet treelet;
+                treelet.node = entry.node;
+                this->subtreeRange(entry.node, treelet.begin, treelet.end);
+                treelet.builtCost = std::max(this->subtreeCost(entry.node), FLT_MIN);
+                for (UINT i = treelet.begin; i < treelet.end; i++) {
+                    mTreeletOf[mIndices[i]] = (UINT)mTreelets.size();
+                }
+                mTreelets.push_back(treelet);
+                continue;
+            }
+            stack.push_back(Entry{ node.leftFirst, entry.depth + 1 });
+            stack.push_back(Entry{ node.leftFirst + 1, entry.depth + 1 });
+        }
+        mTreeletDirty.assign(mTreelets.size(), 0);
+        mTreeletCursor = 0;
+    }
+
+    // A subtree's leaves cover one contiguous run of the index array.
+    void subtreeRange(UINT root, UINT& begin, UINT& end) const {
+        begin = UINT_MAX;
+        end = 0;
+        std::vector<UINT> stack(1, root);
+        while (!stack.empty()) {
+            const BvhNode& node = mNodes[stack.back()];
+            stack.pop_back();
+            if (node.count > 0) {
+                begin = std::min(begin, node.leftFirst);
+                end = std::max(end, node.leftFirst + node.count);
+                continue;
+            }
+            stack.push_back(node.leftFirst);
+            stack.push_back(node.leftFirst + 1);
+        }
+    }
+
+    float subtreeCost(UINT root) const {
+        float cost = 0.0f;
+        UINT stack[bvhMaxDepth * 2];
+        UINT top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            const BvhNode& node = mNodes[stack[--top]];
+            cost += aabbArea({ node.boundsMin, node.boundsMax }) * (node.count > 0 ? (float)node.count : 1.0f);
+            if (node.count == 0) {
+                stack[top++] = node.leftFirst;
+                stack[top++] = node.leftFirst + 1;
+            }
+        }
+        return cost / std::max(aabbArea({ mNodes[root].boundsMin, mNodes[root].boundsMax }), FLT_MIN);
+    }
+
+    UINT subtreeNodes(UINT root) const {
+        UINT count = 0;
+        UINT stack[bvhMaxDepth * 2];
+        UINT top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            const BvhNode& node = mNodes[stack[--top]];
+            count++;
+            if (node.count == 0) {
+                stack[top++] = node.leftFirst;
+                stack[top++] = node.leftFirst + 1;
+            }
+        }
+        return count;
+    }
+
+    const Aabb* mBounds = nullptr;
+    UINT mPrimitiveCount = 0;
+    BvhNodeArray mNodes;
+    std::vector<UINT> mIndices;
+    std::vector<XMFLOAT3> mCentroids;
+    std::vector<UINT> mParents;
+    std::vector<UINT> mLeafOf;
+    std::vector<Treelet> mTreelets;
+    std::vector<UINT> mTreeletOf;
+    std::vector<UINT8> mTreeletDirty;
+    UINT mTreeletDepth = 0;
+    UINT mTreeletCursor = 0;
+    UINT mGarbageNodes = 0;
+};
+
+// Row vector convention like DirectXMath: clip = (x, y, z, 1) * m. Left handed, so the
+// camera looks down +z of view space and clip w is the view depth.
+void makeViewProjection(const XMFLOAT3& eye, const XMFLOAT3& target, float fovY, float aspect, float nearZ, float farZ, float m[16]) {
+    auto normalize = [](XMFLOAT3 v) {
+        float length = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+        return XMFLOAT3(v.x / length, v.y / length, v.z / length);
+    };
+    auto cross = [](const XMFLOAT3& a, const XMFLOAT3& b) {
+        return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    };
+    auto dot = [](const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; };
+
+    XMFLOAT3 zAxis = normalize(XMFLOAT3(target.x - eye.x, target.y - eye.y, target.z - eye.z));
+    XMFLOAT3 xAxis = normalize(cross(XMFLOAT3(0.0f, 1.0f, 0.0f), zAxis));
+    XMFLOAT3 yAxis = cross(zAxis, xAxis);
+    const float view[16] = {
+        xAxis.x, yAxis.x, zAxis.x, 0.0f,
+        xAxis.y, yAxis.y, zAxis.y, 0.0f,
+        xAxis.z, yAxis.z, zAxis.z, 0.0f,
+        -dot(xAxis, eye), -dot(yAxis, eye), -dot(zAxis, eye), 1.0f
+    };
+    const float h = 1.0f / tanf(fovY * 0.5f);
+    const float w = h / aspect;
+    const float range = farZ / (farZ - nearZ);
+    const float projection[16] = {
+        w, 0.0f, 0.0f, 0.0f,
+        0.0f, h, 0.0f, 0.0f,
+        0.0f, 0.0f, range, 1.0f,
+        0.0f, 0.0f, -range * nearZ, 0.0f
+    };
+    for (UINT row = 0; row < 4; row++) {
+        for (UINT column = 0; column < 4; column++) {
+            float sum = 0.0f;
+            for (UINT k = 0; k < 4; k++) {
+                sum += view[row * 4 + k] * projection[k * 4 + column];
+            }
+            m[row * 4 + column] = sum;
+        }
+    }
+}
+
+UINT32 sceneRandom(UINT32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+float sceneRandom(UINT32& state, float low, float high) {
+    return low + (high - low) * (sceneRandom(state) & 0xffffff) / (float)0xffffff;
+}
+
+// count boxes of 0.5 to 2.5 units scattered through a cube sized for about one box per 64
+// cubic units, with a quarter of them packed into a few dense clusters.
+float makeBoxField(UINT count, UINT32 seed, std::vector<Aabb>& boxes) {
+    const float size = 4.0f * cbrtf((float)count);
+    UINT32 state = seed | 1;
+    XMFLOAT3 clusters[8];
+    for (XMFLOAT3& cluster : clusters) {
+        cluster = XMFLOAT3(sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size));
+    }
+    boxes.resize(count);
+    for (UINT i = 0; i < count; i++) {
+        XMFLOAT3 center;
+        if (i % 4 == 0) {
+            const XMFLOAT3& cluster = clusters[sceneRandom(state) % 8];
+            const float spread = size * 0.03f;
+            center = XMFLOAT3(cluster.x + sceneRandom(state, -spread, spread), cluster.y + sceneRandom(state, -spread, spread), cluster.z + sceneRandom(state, -spread, spread));
+        }
+        else {
+            center = XMFLOAT3(sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size));
+        }
+        const XMFLOAT3 extent(sceneRandom(state, 0.25f, 1.25f), sceneRandom(state, 0.25f, 1.25f), sceneRandom(state, 0.25f, 1.25f));
+        boxes[i].boundsMin = XMFLOAT3(center.x - extent.x, center.y - extent.y, center.z - extent.z);
+        boxes[i].boundsMax = XMFLOAT3(center.x + extent.x, center.y + extent.y, center.z + extent.z);
+    }
+    return size;
+}
+
+void moveBox(Aabb& box, const XMFLOAT3& offset) {
+    box.boundsMin = XMFLOAT3(box.boundsMin.x + offset.x, box.boundsMin.y + offset.y, box.boundsMin.z + offset.z);
+    box.boundsMax = XMFLOAT3(box.boundsMax.x + offset.x, box.boundsMax.y + offset.y, box.boundsMax.z + offset.z);
+}
+
+// A camera somewhere inside the field looking at another random point.
+Frustum randomFrustum(UINT32& state, float size) {
+    XMFLOAT3 eye(sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size));
+    XMFLOAT3 target(sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size));
+    float m[16];
+    makeViewProjection(eye, target, 0.9f, 4.0f / 3.0f, 0.1f, size * 0.5f, m);
+    return makeFrustum(m);
+}
+
+void randomRay(UINT32& state, float size, XMFLOAT3& origin, XMFLOAT3& direction) {
+    origin = XMFLOAT3(sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size));
+    XMFLOAT3 target(sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size));
+    direction = XMFLOAT3(target.x - origin.x, target.y - origin.y, target.z - origin.z);
+    float length = sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+    direction = XMFLOAT3(direction.x / length, direction.y / length, direction.z / length);
+}
+
+Aabb randomQueryBox(UINT32& state, float size, float extent) {
+    XMFLOAT3 center(sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size), sceneRandom(state, 0.0f, size));
+    return { XMFLOAT3(center.x - extent, center.y - extent, center.z - extent), XMFLOAT3(center.x + extent, center.y + extent, center.z + extent) };
+}
+
+// The linear scans the BVH replaces; the simulation checks against them.
+void scanFrustum(const std::vector<Aabb>& boxes, const Frustum& frustum, std::vector<UINT>& out) {
+    for (UINT i = 0; i < boxes.size(); i++) {
+        if (testFrustum(frustum, boxes[i].boundsMin, boxes[i].boundsMax) != FrustumOutside) {
+            out.push_back(i);
+        }
+    }
+}
+
+bool scanRay(const std::vector<Aabb>& boxes, const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, UINT& hit, float& distance) {
+    const XMFLOAT3 inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    bool found = false;
+    distance = maxDistance;
+    for (UINT i = 0; i < boxes.size(); i++) {
+        float entry;
+        if (rayHitsAabb(origin, inverse, distance, boxes[i].boundsMin, boxes[i].boundsMax, entry) && (!found || entry < distance)) {
+            distance = entry;
+            hit = i;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void scanOverlap(const std::vector<Aabb>& boxes, const Aabb& box, std::vector<UINT>& out) {
+    for (UINT i = 0; i < boxes.size(); i++) {
+        if (aabbOverlaps(box, boxes[i])) {
+            out.push_back(i);
+        }
+    }
+}
+
+bool simulateSceneBvh(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+
+    ParallelFor pool;
+    pool.start(3);
+    ParallelFor serial;
+    std::vector<Aabb> boxes;
+    const float size = makeBoxField(20000, 0x51ed270b, boxes);
+    UINT32 state = 0x2545f491;
+
+    // Every query against its linear scan; ray hits by distance, since equally near boxes
+    // may be reported either way.
+    auto matchesScans = [&](const SceneBvh& bvh) {
+        bool same = true;
+        std::vector<UINT> expected;
+        std::vector<UINT> found;
+        for (UINT i = 0; i < 16; i++) {
+            Frustum frustum = randomFrustum(state, size);
+            expected.clear();
+            found.clear();
+            scanFrustum(boxes, frustum, expected);
+            bvh.queryFrustum(frustum, found);
+            std::sort(found.begin(), found.end());
+            same = same && found == expected;
+        }
+        for (UINT i = 0; i < 500; i++) {
+            XMFLOAT3 origin;
+            XMFLOAT3 direction;
+            randomRay(state, size, origin, direction);
+            UINT expectedHit = 0;
+            UINT hit = 0;
+            float expectedDistance = 0.0f;
+            float distance = 0.0f;
+            bool expectedFound = scanRay(boxes, origin, direction, size, expectedHit, expectedDistance);
+            bool hitFound = bvh.raycast(origin, direction, size, hit, distance);
+            same = same && expectedFound == hitFound && (!hitFound || distance == expectedDistance);
+        }
+        for (UINT i = 0; i < 200; i++) {
+            Aabb box = randomQueryBox(state, size, sceneRandom(state, 0.5f, 8.0f));
+            expected.clear();
+            found.clear();
+            scanOverlap(boxes, box, expected);
+            bvh.queryOverlap(box, found);
+            std::sort(found.begin(), found.end());
+            same = same && found == expected;
+        }
+        return same;
+    };
+
+    SceneBvh bvh;
+    bvh.build(boxes.data(), (UINT)boxes.size(), pool);
+    check(bvh.validate(), "the built tree is valid");
+    check(matchesScans(bvh), "frustum, ray and overlap queries match linear scans");
+
+    SceneBvh single;
+    single.build(boxes.data(), (UINT)boxes.size(), serial);
+    const SceneBvh::Stats threadedStats = bvh.stats();
+    const SceneBvh::Stats singleStats = single.stats();
+    check(threadedStats.sahCost == singleStats.sahCost && threadedStats.nodes == singleStats.nodes, "a threaded build makes the same tree as one thread");
+
+    // Scatter a tenth of the boxes; refit only those, and the result matches a full refit.
+    std::vector<UINT> moved;
+    for (UINT i = 0; i < boxes.size(); i += 10) {
+        moveBox(boxes[i], XMFLOAT3(sceneRandom(state, -20.0f, 20.0f), sceneRandom(state, -20.0f, 20.0f), sceneRandom(state, -20.0f, 20.0f)));
+        moved.push_back(i);
+    }
+    bvh.refit(moved.data(), (UINT)moved.size());
+    single.refit();
+    check(bvh.validate(), "the tree is valid after an incremental refit");
+    check(bvh.stats().sahCost == single.stats().sahCost, "an incremental refit matches a full refit");
+    check(matchesScans(bvh), "queries match linear scans after a refit");
+
+    const float refitCost = bvh.stats().sahCost;
+    const UINT rebuilt = bvh.rebuildDegraded(1.1f, 16);
+    const float rebuiltCost = bvh.stats().sahCost;
+    check(rebuilt > 0 && rebuiltCost < refitCost, "rebuilding degraded subtrees lowers the SAH cost");
+    check(bvh.validate(), "the tree is valid after partial rebuilds");
+    check(matchesScans(bvh), "queries match linear scans after partial rebuilds");
+    bvh.build(boxes.data(), (UINT)boxes.size(), pool);
+    check(bvh.stats().sahCost <= rebuiltCost && bvh.garbageNodes() == 0, "a full rebuild is no worse and reclaims the replaced nodes");
+
+    std::vector<Aabb> same(1000, Aabb{ XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f) });
+    SceneBvh stacked;
+    stacked.build(same.data(), (UINT)same.size(), pool);
+    std::vector<UINT> found;
+    stacked.queryOverlap(same[0], found);
+    check(stacked.validate() && found.size() == same.size() && stacked.stats().maxDepth < bvhMaxDepth, "coincident boxes split by count");
+
+    SceneBvh empty;
+    empty.build(nullptr, 0, pool);
+    found.clear();
+    empty.queryOverlap(same[0], found);
+    UINT hit;
+    float distance;
+    check(found.empty() && !empty.raycast(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f), 10.0f, hit, distance) && empty.validate(), "an empty tree answers nothing");
+    pool.stop();
+    return passed;
+}
+
+// Build, refit and query costs at 100k and 1M boxes, against the linear scans.
+std::string benchmarkSceneBvh() {
+    const UINT threads = std::max(std::thread::hardware_concurrency(), 1U);
+    char line[256];
+    snprintf(line, sizeof(line), "Scene BVH (%u threads):\n", threads);
+    std::string report = line;
+    const UINT counts[2] = { 100000, 1000000 };
+    for (UINT count : counts) {
+        std::vector<Aabb> boxes;
+        const float size = makeBoxField(count, 0x51ed270b, boxes);
+        ParallelFor pool;
+        pool.start(threads - 1);
+        ParallelFor serial;
+
+        SceneBvh bvh;
+        double start = secondsNow();
+        bvh.build(boxes.data(), count, serial);
+        const double serialBuild = secondsNow() - start;
+        start = secondsNow();
+        bvh.build(boxes.data(), count, pool);
+        const double build = secondsNow() - start;
+        const SceneBvh::Stats stats = bvh.stats();
+        snprintf(line, sizeof(line), "  %u boxes: build %.1f ms (1 thread %.1f ms), %u nodes, %u leaves, depth %u, SAH cost %.1f\n",
+            count, build * 1000.0, serialBuild * 1000.0, stats.nodes, stats.leaves, stats.maxDepth, stats.sahCost);
+        report += line;
+
+        // A percent of the boxes drift each frame, for several frames.
+        UINT32 state = 0x2545f491;
+        std::vector<UINT> moved;
+        for (UINT i = 0; i < count; i += 100) {
+            moved.push_back(i);
+        }
+        double incremental = 0.0;
+        double full = 0.0;
+        double partial = 0.0;
+        UINT rebuilt = 0;
+        const UINT frames = 8;
+        for (UINT frame = 0; frame < frames; frame++) {
+            for (UINT i : moved) {
+                moveBox(boxes[i], XMFLOAT3(sceneRandom(state, -2.0f, 2.0f), sceneRandom(state, -2.0f, 2.0f), sceneRandom(state, -2.0f, 2.0f)));
+            }
+            start = secondsNow();
+            bvh.refit(moved.data(), (UINT)moved.size());
+            double refitted = secondsNow();
+            rebuilt += bvh.rebuildDegraded(1.2f, 2);
+            partial += secondsNow() - refitted;
+            incremental += refitted - start;
+        }
+        start = secondsNow();
+        bvh.refit();
+        full = secondsNow() - start;
+        snprintf(line, sizeof(line), "    refit 1%% moved %.3f ms, full refit %.2f ms, partial rebuilds %.2f ms per frame (%u subtrees), SAH cost now %.1f\n",
+            incremental * 1000.0 / frames, full * 1000.0, partial * 1000.0 / frames, rebuilt, bvh.stats().sahCost);
+        report += line;
+
+        std::vector<UINT> found;
+        const UINT frustumQueries = 32;
+        size_t frustumHits = 0;
+        start = secondsNow();
+        for (UINT i = 0; i < frustumQueries; i++) {
+            found.clear();
+            bvh.queryFrustum(randomFrustum(state, size), found);
+            frustumHits += found.size();
+        }
+        const double frustum = (secondsNow() - start) / frustumQueries;
+        start = secondsNow();
+        for (UINT i = 0; i < 4; i++) {
+            found.clear();
+            scanFrustum(boxes, randomFrustum(state, size), found);
+        }
+        const double frustumScan = (secondsNow() - start) / 4;
+
+        const UINT rays = 100000;
+        UINT hits = 0;
+        start = secondsNow();
+        for (UINT i = 0; i < rays; i++) {
+            XMFLOAT3 origin;
+            XMFLOAT3 direction;
+            randomRay(state, size, origin, direction);
+            UINT hit;
+            float distance;
+            hits += bvh.raycast(origin, direction, size, hit, distance) ? 1 : 0;
+        }
+        const double ray = (secondsNow() - start) / rays;
+        start = secondsNow();
+        for (UINT i = 0; i < 16; i++) {
+            XMFLOAT3 origin;
+            XMFLOAT3 direction;
+            randomRay(state, size, origin, direction);
+            UINT hit;
+            float distance;
+            hits += scanRay(boxes, origin, direction, size, hit, distance) ? 1 : 0;
+        }
+        const double rayScan = (secondsNow() - start) / 16;
+
+        const UINT overlaps = 100000;
+        size_t overlapHits = 0;
+        start = secondsNow();
+        for (UINT i = 0; i < overlaps; i++) {
+            found.clear();
+            bvh.queryOverlap(randomQueryBox(state, size, 4.0f), found);
+            overlapHits += found.size();
+        }
+        const double overlap = (secondsNow() - start) / overlaps;
+        start = secondsNow();
+        for (UINT i = 0; i < 16; i++) {
+            found.clear();
+            scanOverlap(boxes, randomQueryBox(state, size, 4.0f), found);
+        }
+        const double overlapScan = (secondsNow() - start) / 16;
+
+        snprintf(line, sizeof(line), "    frustum %.3f ms, %.0f results (scan %.2f ms)\n",
+            frustum * 1000.0, frustumHits / (double)frustumQueries, frustumScan * 1000.0);
+        report += line;
+        snprintf(line, sizeof(line), "    ray %.2f us, %.2f Mrays/s on one thread, %.0f%% hit (scan %.1f us)\n",
+            ray * 1e6, 1e-6 / ray, 100.0 * hits / (rays + 16), rayScan * 1e6);
+        report += line;
+        snprintf(line, sizeof(line), "    overlap %.2f us, %.1f results (scan %.1f us)\n",
+            overlap * 1e6, overlapHits / (double)overlaps, overlapScan * 1e6);
+        report += line;
+        pool.stop();
+    }
+    return report;
+}
+
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        mPool.start(std::max(std::thread::hardware_concurrency(), 1U) - 1);
+
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+        // Create Depth Buffer
+        {
+            D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
+            dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+            dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+            dsvHeapDesc.NumDescriptors = 1;
+            _ThrowIfFailed(mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&mDSVHeap)));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+            D3D12_RESOURCE_DESC depthDesc = {};
+            depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            depthDesc.Width = windowWidth;
+            depthDesc.Height = windowHeight;
+            depthDesc.DepthOrArraySize = 1;
+            depthDesc.MipLevels = 1;
+            depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+            depthDesc.SampleDesc.Count = 1;
+            depthDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+            D3D12_CLEAR_VALUE clearValue = {};
+            clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+            clearValue.DepthStencil.Depth = 1.0f;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &depthDesc,
+                D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                &clearValue,
+                IID_PPV_ARGS(&mDepthBuffer)));
+            mDevice->CreateDepthStencilView(mDepthBuffer.Get(), nullptr, mDSVHeap->GetCPUDescriptorHandleForHeapStart());
+        }
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.0f;
+            mViewport.MaxDepth = 1.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        mStartTime = secondsNow();
+        mLastTime = mStartTime;
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+        mPool.stop();
+    }
+
+    void toggleQueries() {
+        mUseBvh = !mUseBvh;
+        debugLog("Frustum culling with %s\n", mUseBvh ? "the BVH" : "a linear scan");
+    }
+
+    // Casts a ray through the cursor, x and y in [0, 1] across the client area, and marks the
+    // nearest box it hits and the boxes around it until the next pick.
+    void pick(float x, float y) {
+        XMFLOAT4X4 viewProjection(mViewProjection);
+        XMMATRIX inverse = XMMatrixInverse(nullptr, XMLoadFloat4x4(&viewProjection));
+        XMVECTOR nearPoint = XMVector3TransformCoord(XMVectorSet(x * 2.0f - 1.0f, 1.0f - y * 2.0f, 0.0f, 1.0f), inverse);
+        XMVECTOR farPoint = XMVector3TransformCoord(XMVectorSet(x * 2.0f - 1.0f, 1.0f - y * 2.0f, 1.0f, 1.0f), inverse);
+        XMFLOAT3 origin;
+        XMFLOAT3 direction;
+        XMStoreFloat3(&origin, nearPoint);
+        XMStoreFloat3(&direction, XMVector3Normalize(farPoint - nearPoint));
+
+        std::fill(mHighlights.begin(), mHighlights.end(), (UINT8)0);
+        UINT hit = 0;
+        float distance = 0.0f;
+        double start = secondsNow();
+        if (!mBvh.raycast(origin, direction, XMVectorGetX(XMVector3Length(farPoint - nearPoint)), hit, distance)) {
+            debugLog("Pick: nothing hit\n");
+            return;
+        }
+        const Aabb& box = mBoxes[hit];
+        mNeighbours.clear();
+        mBvh.queryOverlap({ XMFLOAT3(box.boundsMin.x - pickRadius, box.boundsMin.y - pickRadius, box.boundsMin.z - pickRadius),
+            XMFLOAT3(box.boundsMax.x + pickRadius, box.boundsMax.y + pickRadius, box.boundsMax.z + pickRadius) }, mNeighbours);
+        double queried = secondsNow();
+        for (UINT i : mNeighbours) {
+            mHighlights[i] = highlightNeighbour;
+        }
+        mHighlights[hit] = highlightPicked;
+        debugLog("Pick: box %u at distance %.2f, %u boxes within %.1f units, %.3f ms\n", hit, distance, (UINT)mNeighbours.size() - 1, pickRadius, (queried - start) * 1000.0);
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "CENTER", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "EXTENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 12, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+            { "TINT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, 24, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/016-occlusion.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/016-occlusion.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+            psoDesc.RasterizerState.FrontCounterClockwise = FALSE;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = TRUE;
+            psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+            psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+            psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // One box in sceneMovingStride circles the middle of the field; the rest stay put.
+        mSceneSize = makeBoxField(sceneBoxCount, 0x9e3779b9, mBoxes);
+        mColors.resize(mBoxes.size());
+        mHighlights.assign(mBoxes.size(), 0);
+        UINT32 state = 0x2545f491;
+        for (UINT i = 0; i < mBoxes.size(); i++) {
+            const UINT32 shade = 0x80 + sceneRandom(state) % 0x60;
+            if (i % sceneMovingStride == 0) {
+                mMoving.push_back(i);
+                mColors[i] = 0xff000000 | 0xff << 16 | shade << 8 | shade / 2;
+            }
+            else {
+                mColors[i] = 0xff000000 | shade << 16 | shade << 8 | shade;
+            }
+        }
+        double start = secondsNow();
+        mBvh.build(mBoxes.data(), (UINT)mBoxes.size(), mPool);
+        const SceneBvh::Stats stats = mBvh.stats();
+        debugLog("Scene: %u boxes, %u moving, BVH built in %.1f ms, %u nodes, depth %u, SAH cost %.1f\n",
+            (UINT)mBoxes.size(), (UINT)mMoving.size(), (secondsNow() - start) * 1000.0, stats.nodes, stats.maxDepth, stats.sahCost);
+
+        // One unit cube, instanced over every box. Faces are shaded by direction.
+        std::vector<Vertex> vertices;
+        std::vector<UINT> indices;
+        {
+            // Outward normal and the up direction of each face as seen from outside; right is up x -normal.
+            const int faces[6][6] = {
+                { 0, 0, -1, 0, 1, 0 }, { 0, 0, 1, 0, 1, 0 }, { -1, 0, 0, 0, 1, 0 },
+                { 1, 0, 0, 0, 1, 0 }, { 0, 1, 0, 0, 0, 1 }, { 0, -1, 0, 0, 0, 1 }
+            };
+            const float shades[6] = { 0.8f, 0.6f, 0.7f, 0.9f, 1.0f, 0.4f };
+            const int corners[4][2] = { { -1, 1 }, { 1, 1 }, { 1, -1 }, { -1, -1 } };
+            const XMFLOAT2 uvs[4] = { XMFLOAT2(0.0f, 0.0f), XMFLOAT2(1.0f, 0.0f), XMFLOAT2(1.0f, 1.0f), XMFLOAT2(0.0f, 1.0f) };
+            for (UINT f = 0; f < 6; f++) {
+                const int* n = faces[f];
+                const int* u = faces[f] + 3;
+                const int r[3] = { -(u[1] * n[2] - u[2] * n[1]), -(u[2] * n[0] - u[0] * n[2]), -(u[0] * n[1] - u[1] * n[0]) };
+                const UINT base = (UINT)vertices.size();
+                for (UINT c = 0; c < 4; c++) {
+                    const XMFLOAT3 p(
+                        (float)(n[0] + r[0] * corners[c][0] + u[0] * corners[c][1]),
+                        (float)(n[1] + r[1] * corners[c][0] + u[1] * corners[c][1]),
+                        (float)(n[2] + r[2] * corners[c][0] + u[2] * corners[c][1]));
+                    vertices.push_back({ p, XMFLOAT4(shades[f], shades[f], shades[f], 1.0f), uvs[c] });
+                }
+                const UINT quad[6] = { 0, 1, 2, 2, 3, 0 };
+                for (UINT index : quad) {
+                    indices.push_back(base + index);
+                }
+            }
+            mCubeIndexCount = (UINT)indices.size();
+        }
+
+        // Create Vertex Buffer
+        {
+            const UINT vertexBufferSize = (UINT)(vertices.size() * sizeof(Vertex));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = vertexBufferSize;
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, vertices.data(), vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = indices.size() * sizeof(UINT);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices.data(), ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = (UINT)ibDesc.Width;
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0xc0;    // R
+                        pData[n + 1] = 0xc0;    // G
+                        pData[n + 2] = 0xc0;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        // Create Instance Buffer, one region per frame in flight, mapped for good
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC bufferDesc = {};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = (UINT64)frameBufferCount * mBoxes.size() * sizeof(CubeInstance);
+            bufferDesc.Height = 1;
+            bufferDesc.DepthOrArraySize = 1;
+            bufferDesc.MipLevels = 1;
+            bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mInstanceBuffer)));
+
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mInstanceBuffer->Map(0, &readRange, (void**)&mInstances));
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    // Moves the circling boxes and refits the BVH over them, rebuilds the subtrees that the
+    // refits degraded every few frames, and rebuilds everything once the replaced nodes
+    // outnumber the live ones. Then queries the frustum and writes the visible boxes into this
+    // frame's instance region, which the GPU finished reading when waitForNextFrame returned.
+    void updateScene() {
+        const double now = secondsNow();
+        const float angle = (float)(now - mLastTime) * 0.2f;
+        mLastTime = now;
+        const float center = mSceneSize * 0.5f;
+        const float cosine = cosf(angle);
+        const float sine = sinf(angle);
+        for (UINT i : mMoving) {
+            Aabb& box = mBoxes[i];
+            const float x = (box.boundsMin.x + box.boundsMax.x) * 0.5f - center;
+            const float z = (box.boundsMin.z + box.boundsMax.z) * 0.5f - center;
+            moveBox(box, XMFLOAT3(x * cosine - z * sine - x, 0.0f, x * sine + z * cosine - z));
+        }
+
+        double start = secondsNow();
+        mBvh.refit(mMoving.data(), (UINT)mMoving.size());
+        double refitted = secondsNow();
+        if (mFrameCount % rebuildFrames == 0) {
+            mRebuiltSubtrees += mBvh.rebuildDegraded(rebuildThreshold, rebuildBudget);
+        }
+        if (mBvh.garbageNodes() > mBvh.nodeCount() - mBvh.garbageNodes()) {
+            mBvh.build(mBoxes.data(), (UINT)mBoxes.size(), mPool);
+            mFullRebuilds++;
+        }
+        double rebuilt = secondsNow();
+
+        // The camera flies a slow loop through the field, looking ahead.
+        const float t = (float)((now - mStartTime) * 0.05);
+        const float radius = mSceneSize * 0.3f;
+        XMFLOAT3 eye(center + radius * cosf(t), center + radius * 0.3f * sinf(t * 0.7f), center + radius * sinf(t));
+        XMFLOAT3 target(eye.x - sinf(t), eye.y, eye.z + cosf(t));
+        makeViewProjection(eye, target, sceneFovY, windowWidth / (float)windowHeight, sceneNearZ, mSceneSize, mViewProjection);
+
+        const Frustum frustum = makeFrustum(mViewProjection);
+        mVisible.clear();
+        if (mUseBvh) {
+            mBvh.queryFrustum(frustum, mVisible);
+        }
+        else {
+            scanFrustum(mBoxes, frustum, mVisible);
+        }
+        double queried = secondsNow();
+
+        const UINT32 highlightColors[3] = { 0, 0xff2020ff, 0xff20ffff };
+        CubeInstance* instances = mInstances + (UINT64)mFrameBufferIndex * mBoxes.size();
+        mInstanceCount = (UINT)mVisible.size();
+        for (UINT i = 0; i < mInstanceCount; i++) {
+            const UINT index = mVisible[i];
+            const Aabb& box = mBoxes[index];
+            CubeInstance& instance = instances[i];
+            instance.center = XMFLOAT3((box.boundsMin.x + box.boundsMax.x) * 0.5f, (box.boundsMin.y + box.boundsMax.y) * 0.5f, (box.boundsMin.z + box.boundsMax.z) * 0.5f);
+            instance.extent = XMFLOAT3((box.boundsMax.x - box.boundsMin.x) * 0.5f, (box.boundsMax.y - box.boundsMin.y) * 0.5f, (box.boundsMax.z - box.boundsMin.z) * 0.5f);
+            instance.color = mHighlights[index] != 0 ? highlightColors[mHighlights[index]] : mColors[index];
+        }
+        mRefitSeconds += refitted - start;
+        mRebuildSeconds += rebuilt - refitted;
+        mQuerySeconds += queried - rebuilt;
+        mDrawnBoxes += mInstanceCount;
+
+        if (++mFrameCount % sceneReportFrames == 0) {
+            const SceneBvh::Stats stats = mBvh.stats();
+            debugLog("Scene: %.1f%% of %u boxes drawn, %s %.3f ms, refit %.3f ms, rebuilds %.3f ms per frame; %u subtrees and %u full rebuilds so far, SAH cost %.1f, %u garbage nodes\n",
+                100.0 * mDrawnBoxes / ((double)mBoxes.size() * sceneReportFrames), (UINT)mBoxes.size(), mUseBvh ? "BVH query" : "linear scan",
+                mQuerySeconds * 1000.0 / sceneReportFrames, mRefitSeconds * 1000.0 / sceneReportFrames, mRebuildSeconds * 1000.0 / sceneReportFrames,
+                mRebuiltSubtrees, mFullRebuilds, stats.sahCost, stats.garbageNodes);
+            mRefitSeconds = 0.0;
+            mRebuildSeconds = 0.0;
+            mQuerySeconds = 0.0;
+            mDrawnBoxes = 0;
+        }
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        this->updateScene();
+        XMFLOAT4X4 viewProjection(mViewProjection);
+        XMFLOAT4X4 constants;
+        XMStoreFloat4x4(&constants, XMMatrixTranspose(XMLoadFloat4x4(&viewProjection)));
+        mCommandList->SetGraphicsRoot32BitConstants(1, 16, &constants, 0);
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle{ mDSVHeap->GetCPUDescriptorHandleForHeapStart() };
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        D3D12_VERTEX_BUFFER_VIEW instanceBufferView = {};
+        instanceBufferView.BufferLocation = mInstanceBuffer->GetGPUVirtualAddress() + (UINT64)mFrameBufferIndex * mBoxes.size() * sizeof(CubeInstance);
+        instanceBufferView.StrideInBytes = sizeof(CubeInstance);
+        instanceBufferView.SizeInBytes = (UINT)(mBoxes.size() * sizeof(CubeInstance));
+        D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[] = { mVertexBufferView, instanceBufferView };
+        mCommandList->IASetVertexBuffers(0, _countof(vertexBufferViews), vertexBufferViews);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+
+        // Every box in the frustum in one instanced draw
+        if (mInstanceCount > 0) {
+            mCommandList->DrawIndexedInstanced(mCubeIndexCount, mInstanceCount, 0, 0, 0);
+        }
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+    ComPtr<ID3D12DescriptorHeap> mDSVHeap;
+    ComPtr<ID3D12Resource> mDepthBuffer;
+
+    ComPtr<ID3D12Resource> mInstanceBuffer;
+    CubeInstance* mInstances = nullptr;
+    UINT mInstanceCount = 0;
+    UINT mCubeIndexCount = 0;
+
+    ParallelFor mPool;
+    SceneBvh mBvh;
+    std::vector<Aabb> mBoxes;
+    std::vector<UINT32> mColors;
+    std::vector<UINT8> mHighlights;
+    std::vector<UINT> mMoving;
+    std::vector<UINT> mVisible;
+    std::vector<UINT> mNeighbours;
+    float mSceneSize = 0.0f;
+    float mViewProjection[16] = {};
+    bool mUseBvh = true;
+    double mStartTime = 0.0;
+    double mLastTime = 0.0;
+    UINT64 mFrameCount = 0;
+    UINT64 mDrawnBoxes = 0;
+    UINT mRebuiltSubtrees = 0;
+    UINT mFullRebuilds = 0;
+    double mRefitSeconds = 0.0;
+    double mRebuildSeconds = 0.0;
+    double mQuerySeconds = 0.0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateSceneBvh(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkSceneBvh();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_KEYDOWN && msg.wParam == 'B') {
+                    graphics.toggleQueries();
+                }
+                if (msg.message == WM_LBUTTONDOWN) {
+                    RECT client;
+                    GetClientRect(msg.hwnd, &client);
+                    graphics.pick((short)LOWORD(msg.lParam) / (float)std::max(client.right, 1L), (short)HIWORD(msg.lParam) / (float)std::max(client.bottom, 1L));
+                }
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
@@ -0,0 +1,2743 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+#include <emmintrin.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0026-CommandReplay";
+const char* windowClass = "0026-CommandReplay";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// A 32x32 field of cubes drawn two rows at a time, its instance data uploaded every frame.
+// Key C, or -capture, captures the next captureFrameCount frames into captureLogFile.
+const UINT fieldSide = 32;
+const UINT fieldRowsPerDraw = 2;
+const UINT captureFrameCount = 120;
+const char* captureLogFile = "capture.cmdlog";
+
+// One cube of the field as an instance of the unit cube.
+struct CubeInstance {
+    XMFLOAT3 center;
+    XMFLOAT3 extent;
+    UINT32 color;
+};
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// Row vector convention like DirectXMath: clip = (x, y, z, 1) * m. Left handed, so the
+// camera looks down +z of view space and clip w is the view depth.
+void makeViewProjection(const XMFLOAT3& eye, const XMFLOAT3& target, float fovY, float aspect, float nearZ, float farZ, float m[16]) {
+    auto normalize = [](XMFLOAT3 v) {
+        float length = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+        return XMFLOAT3(v.x / length, v.y / length, v.z / length);
+    };
+    auto cross = [](const XMFLOAT3& a, const XMFLOAT3& b) {
+        return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    };
+    auto dot = [](const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; };
+
+    XMFLOAT3 zAxis = normalize(XMFLOAT3(target.x - eye.x, target.y - eye.y, target.z - eye.z));
+    XMFLOAT3 xAxis = normalize(cross(XMFLOAT3(0.0f, 1.0f, 0.0f), zAxis));
+    XMFLOAT3 yAxis = cross(zAxis, xAxis);
+    const float view[16] = {
+        xAxis.x, yAxis.x, zAxis.x, 0.0f,
+        xAxis.y, yAxis.y, zAxis.y, 0.0f,
+        xAxis.z, yAxis.z, zAxis.z, 0.0f,
+        -dot(xAxis, eye), -dot(yAxis, eye), -dot(zAxis, eye), 1.0f
+    };
+    const float h = 1.0f / tanf(fovY * 0.5f);
+    const float w = h / aspect;
+    const float range = farZ / (farZ - nearZ);
+    const float projection[16] = {
+        w, 0.0f, 0.0f, 0.0f,
+        0.0f, h, 0.0f, 0.0f,
+        0.0f, 0.0f, range, 1.0f,
+        0.0f, 0.0f, -range * nearZ, 0.0f
+    };
+    for (UINT row = 0; row < 4; row++) {
+        for (UINT column = 0; column < 4; column++) {
+            float sum = 0.0f;
+            for (UINT k = 0; k < 4; k++) {
+                sum += view[row * 4 + k] * projection[k * 4 + column];
+            }
+            m[row * 4 + column] = sum;
+        }
+    }
+}
+
+// Bytes of a command log. Integers are LEB128 varints, so the ids, counts and enums that make
+// up most commands take a byte each; floats and plain D3D12 structs are stored as they are.
+class LogWriter {
+public:
+    void byte(UINT8 value) { mBytes.push_back(value); }
+
+    void varint(UINT64 value) {
+        while (value >= 0x80) {
+            mBytes.push_back((UINT8)(value | 0x80));
+            value >>= 7;
+        }
+        mBytes.push_back((UINT8)value);
+    }
+
+    void signedVarint(INT64 value) { this->varint(((UINT64)value << 1) ^ (UINT64)(value >> 63)); }
+    void real(float value) { this->raw(&value, sizeof(value)); }
+
+    void raw(const void* data, size_t size) {
+        const UINT8* bytes = (const UINT8*)data;
+        mBytes.insert(mBytes.end(), bytes, bytes + size);
+    }
+
+    template<typename T>
+    void pod(const T& value) { this->raw(&value, sizeof(T)); }
+
+    void blob(const void* data, size_t size) {
+        this->varint(size);
+        this->raw(data, size);
+    }
+
+    void string(const char* text) { this->blob(text, strlen(text)); }
+
+    const std::vector<UINT8>& bytes() const { return mBytes; }
+    size_t size() const { return mBytes.size(); }
+    void clear() { mBytes.clear(); }
+
+private:
+    std::vector<UINT8> mBytes;
+};
+
+// Reads a command log back. Every read is bounds checked, so a truncated or corrupt log
+// throws instead of replaying garbage.
+class LogReader {
+public:
+    LogReader(const UINT8* data, size_t size) : mData(data), mEnd(data + size) {}
+
+    bool atEnd() const { return mData == mEnd; }
+
+    UINT8 byte() { return *this->raw(1); }
+
+    UINT64 varint() {
+        UINT64 value = 0;
+        for (UINT shift = 0; shift < 64; shift += 7) {
+            UINT8 b = this->byte();
+            value |= (UINT64)(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::exception("Command log is corrupt.");
+    }
+
+    INT64 signedVarint() {
+        UINT64 value = this->varint();
+        return (INT64)(value >> 1) ^ -(INT64)(value & 1);
+    }
+
+    UINT small() {
+        UINT64 value = this->varint();
+        if (value > UINT_MAX) {
+            throw std::exception("Command log is corrupt.");
+        }
+        return (UINT)value;
+    }
+
+    float real() { return this->pod<float>(); }
+
+    const UINT8* raw(size_t size) {
+        if ((size_t)(mEnd - mData) < size) {
+            throw std::exception("Command log is truncated.");
+        }
+        const UINT8* data = mData;
+        mData += size;
+        return data;
+    }
+
+    template<typename T>
+    T pod() {
+        T value;
+        memcpy(&value, this->raw(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    const UINT8* blob(size_t& size) {
+        UINT64 length = this->varint();
+        if (length > (UINT64)(mEnd - mData)) {
+            throw std::exception("Command log is truncated.");
+        }
+        size = (size_t)length;
+        return this->raw(size);
+    }
+
+    std::string string() {
+        size_t size = 0;
+        const UINT8* data = this->blob(size);
+        return std::string((const char*)data, size);
+    }
+
+private:
+    const UINT8* mData;
+    const UINT8* mEnd;
+};
+
+// Setup records create the objects that frames refer to; the rest are commands. Objects are
+// numbered per kind in the order they were created.
+enum CommandOp : UINT8 {
+    CommandOpDescriptorHeap,
+    CommandOpResource,
+    CommandOpRootSignature,
+    CommandOpPipelineState,
+    CommandOpShaderResourceView,
+    CommandOpRenderTargetView,
+    CommandOpDepthStencilView,
+    CommandOpBeginFrame,
+    CommandOpEndFrame,
+    CommandOpSetPipelineState,
+    CommandOpSetRootSignature,
+    CommandOpSetDescriptorHeaps,
+    CommandOpSetRootTable,
+    CommandOpSetRootConstants,
+    CommandOpSetViewport,
+    CommandOpSetScissorRect,
+    CommandOpTransition,
+    CommandOpSetRenderTarget,
+    CommandOpClearRenderTarget,
+    CommandOpClearDepth,
+    CommandOpSetTopology,
+    CommandOpSetVertexBuffer,
+    CommandOpSetIndexBuffer,
+    CommandOpDrawInstanced,
+    CommandOpDrawIndexedInstanced,
+    CommandOpUpload,
+};
+
+// An upload is stored whole the first time a range is written during a capture and as a
+// delta against the previous write of the same range after that.
+enum UploadEncoding : UINT8 {
+    UploadEncodingRaw,
+    UploadEncodingDelta,
+};
+
+struct CommandLogHeader {
+    UINT magic;
+    UINT version;
+    UINT frameCount;
+    UINT reserved;
+    UINT64 setupBytes;
+    UINT64 frameBytes;
+};
+const UINT commandLogMagic = 0x4c444d43; // "CMDL"
+const UINT commandLogVersion = 1;
+
+// Writes the bytes of data that differ from previous as (unchanged run, changed run, changed
+// bytes). A changed run absorbs gaps of fewer than four unchanged bytes, which would cost
+// more to skip than to copy.
+void writeUploadDelta(LogWriter& writer, const UINT8* previous, const UINT8* data, size_t size) {
+    size_t position = 0;
+    while (position < size) {
+        size_t changed = position;
+        while (changed < size && data[changed] == previous[changed]) {
+            changed++;
+        }
+        size_t end = changed;
+        for (size_t look = changed; look < size && look - end < 4; look++) {
+            if (data[look] != previous[look]) {
+                end = look + 1;
+            }
+        }
+        writer.varint(changed - position);
+        writer.varint(end - changed);
+        writer.raw(data + changed, end - changed);
+        position = end;
+    }
+}
+
+void readUploadDelta(LogReader& reader, UINT8* data, size_t size) {
+    size_t position = 0;
+    while (position < size) {
+        UINT64 skip = reader.varint();
+        UINT64 count = reader.varint();
+        if ((skip == 0 && count == 0) || skip > size - position || count > size - position - skip) {
+            throw std::exception("Command log is corrupt.");
+        }
+        position += (size_t)skip;
+        memcpy(data + position, reader.raw((size_t)count), (size_t)count);
+        position += (size_t)count;
+    }
+}
+
+// Everything the captured commands refer to, by id, and the capture itself. Objects are
+// added along with their D3D12 object, or with nullptr for the null backend, which records
+// and replays with no device at all. Each addition is also written to the setup records,
+// so a capture started at any frame can recreate every object it uses.
+class CommandCapture {
+public:
+    struct ResourceInfo {
+        D3D12_HEAP_TYPE heapType;
+        D3D12_RESOURCE_DESC desc;
+        D3D12_RESOURCE_STATES state;
+        bool hasClearValue;
+        D3D12_CLEAR_VALUE clearValue;
+    };
+
+    UINT addDescriptorHeap(ID3D12DescriptorHeap* heap, const D3D12_DESCRIPTOR_HEAP_DESC& desc, UINT stride) {
+        mSetup.byte(CommandOpDescriptorHeap);
+        mSetup.pod(desc);
+
+        Heap entry = {};
+        entry.heap = heap;
+        entry.desc = desc;
+        entry.stride = stride;
+        if (heap != nullptr) {
+            entry.cpuStart = heap->GetCPUDescriptorHandleForHeapStart();
+            if (desc.Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) {
+                entry.gpuStart = heap->GetGPUDescriptorHandleForHeapStart();
+            }
+        }
+        mHeaps.push_back(entry);
+        return (UINT)mHeaps.size() - 1;
+    }
+
+    // data is the resource's contents when added, for the first subresource only; upload
+    // heap resources get a CPU copy under the null backend so uploads still land somewhere.
+    UINT addResource(ID3D12Resource* resource, const ResourceInfo& info, const void* data, UINT64 size) {
+        mSetup.byte(CommandOpResource);
+        mSetup.pod(info.heapType);
+        mSetup.pod(info.desc);
+        mSetup.pod(info.state);
+        mSetup.byte(info.hasClearValue ? 1 : 0);
+        if (info.hasClearValue) {
+            mSetup.pod(info.clearValue);
+        }
+        mSetup.blob(data, (size_t)size);
+
+        mResources.push_back(Resource());
+        Resource& entry = mResources.back();
+        entry.resource = resource;
+        entry.info = info;
+        if (info.heapType == D3D12_HEAP_TYPE_UPLOAD) {
+            if (resource != nullptr) {
+                D3D12_RANGE readRange = { 0, 0 };
+                _ThrowIfFailed(resource->Map(0, &readRange, (void**)&entry.memory));
+            }
+            else {
+                entry.shadow.resize((size_t)info.desc.Width);
+                if (data != nullptr) {
+                    memcpy(entry.shadow.data(), data, (size_t)std::min<UINT64>(size, info.desc.Width));
+                }
+                entry.memory = entry.shadow.data();
+            }
+        }
+        return (UINT)mResources.size() - 1;
+    }
+
+    UINT addRootSignature(ID3D12RootSignature* rootSignature, const void* blob, size_t size) {
+        mSetup.byte(CommandOpRootSignature);
+        mSetup.blob(blob, size);
+        mRootSignatures.push_back(rootSignature);
+        return (UINT)mRootSignatures.size() - 1;
+    }
+
+    // Only the stages and state a graphics pipeline of these samples sets are kept; the
+    // root signature is given by id rather than by desc.pRootSignature.
+    UINT addPipelineState(ID3D12PipelineState* pipelineState, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT rootSignature) {
+        this->checkId(rootSignature, (UINT)mRootSignatures.size());
+        if (desc.DS.BytecodeLength != 0 || desc.HS.BytecodeLength != 0 || desc.GS.BytecodeLength != 0 || desc.StreamOutput.NumEntries != 0) {
+            throw std::exception("Only vertex and pixel shader pipelines can be captured.");
+        }
+        mSetup.byte(CommandOpPipelineState);
+        mSetup.varint(rootSignature);
+        mSetup.blob(desc.VS.pShaderBytecode, desc.VS.BytecodeLength);
+        mSetup.blob(desc.PS.pShaderBytecode, desc.PS.BytecodeLength);
+        mSetup.pod(desc.BlendState);
+        mSetup.varint(desc.SampleMask);
+        mSetup.pod(desc.RasterizerState);
+        mSetup.pod(desc.DepthStencilState);
+        mSetup.varint(desc.InputLayout.NumElements);
+        for (UINT i = 0; i < desc.InputLayout.NumElements; i++) {
+            const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+            mSetup.string(element.SemanticName);
+            mSetup.varint(element.SemanticIndex);
+            mSetup.varint(element.Format);
+            mSetup.varint(element.InputSlot);
+            mSetup.varint(element.AlignedByteOffset);
+            mSetup.varint(element.InputSlotClass);
+            mSetup.varint(element.InstanceDataStepRate);
+        }
+        mSetup.varint(desc.IBStripCutValue);
+        mSetup.varint(desc.PrimitiveTopologyType);
+        mSetup.varint(desc.NumRenderTargets);
+        for (UINT i = 0; i < 8; i++) {
+            mSetup.varint(desc.RTVFormats[i]);
+        }
+        mSetup.varint(desc.DSVFormat);
+        mSetup.varint(desc.SampleDesc.Count);
+        mSetup.varint(desc.SampleDesc.Quality);
+        mSetup.varint(desc.NodeMask);
+        mSetup.varint(desc.Flags);
+        mPipelineStates.push_back(pipelineState);
+        return (UINT)mPipelineStates.size() - 1;
+    }
+
+    void addShaderResourceView(UINT resource, const D3D12_SHADER_RESOURCE_VIEW_DESC* desc, UINT heap, UINT index) {
+        this->addView(CommandOpShaderResourceView, resource, desc, heap, index);
+    }
+
+    void addRenderTargetView(UINT resource, const D3D12_RENDER_TARGET_VIEW_DESC* desc, UINT heap, UINT index) {
+        this->addView(CommandOpRenderTargetView, resource, desc, heap, index);
+    }
+
+    void addDepthStencilView(UINT resource, const D3D12_DEPTH_STENCIL_VIEW_DESC* desc, UINT heap, UINT index) {
+        this->addView(CommandOpDepthStencilView, resource, desc, heap, index);
+    }
+
+    // Captures the next frameCount frames, starting at the next beginFrame.
+    void beginCapture(UINT frameCount) {
+        mFrames.clear();
+        mLastUploads.clear();
+        mFramesLeft = frameCount;
+        mCapturedFrames = 0;
+        mActive = false;
+    }
+
+    bool captureRunning() const { return mFramesLeft > 0; }
+    UINT capturedFrames() const { return mCapturedFrames; }
+
+    // The finished log: header, setup records, then the captured frames.
+    std::vector<UINT8> takeLog() {
+        CommandLogHeader header = {};
+        header.magic = commandLogMagic;
+        header.version = commandLogVersion;
+        header.frameCount = mCapturedFrames;
+        header.setupBytes = mSetup.size();
+        header.frameBytes = mFrames.size();
+
+        std::vector<UINT8> log(sizeof(header));
+        memcpy(log.data(), &header, sizeof(header));
+        log.insert(log.end(), mSetup.bytes().begin(), mSetup.bytes().end());
+        log.insert(log.end(), mFrames.bytes().begin(), mFrames.bytes().end());
+        mFrames.clear();
+        mLastUploads.clear();
+        mFramesLeft = 0;
+        mCapturedFrames = 0;
+        mActive = false;
+        return log;
+    }
+
+    // Used by CapturedCommandList.
+    LogWriter* frameLog() { return mActive ? &mFrames : nullptr; }
+
+    void frameStarted() {
+        mActive = mFramesLeft > 0;
+    }
+
+    void frameFinished() {
+        if (mActive) {
+            mCapturedFrames++;
+            mFramesLeft--;
+            mActive = false;
+        }
+    }
+
+    // The previous capture of an uploaded range; empty the first time.
+    std::vector<UINT8>& lastUpload(UINT resource, UINT64 offset) { return mLastUploads[std::make_pair(resource, offset)]; }
+
+    ID3D12Resource* resource(UINT id) const {
+        this->checkId(id, (UINT)mResources.size());
+        return mResources[id].resource;
+    }
+
+    UINT8* uploadMemory(UINT id, UINT64 offset, UINT64 size) const {
+        this->checkId(id, (UINT)mResources.size());
+        const Resource& entry = mResources[id];
+        if (entry.memory == nullptr || offset > entry.info.desc.Width || size > entry.info.desc.Width - offset) {
+            throw std::exception("Upload outside of an upload heap buffer.");
+        }
+        return entry.memory + offset;
+    }
+
+    ID3D12DescriptorHeap* descriptorHeap(UINT id) const {
+        this->checkId(id, (UINT)mHeaps.size());
+        return mHeaps[id].heap;
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuDescriptor(UINT heap, UINT index) const {
+        this->checkId(heap, (UINT)mHeaps.size());
+        this->checkId(index, mHeaps[heap].desc.NumDescriptors);
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = mHeaps[heap].cpuStart;
+        handle.ptr += (SIZE_T)index * mHeaps[heap].stride;
+        return handle;
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE gpuDescriptor(UINT heap, UINT index) const {
+        this->checkId(heap, (UINT)mHeaps.size());
+        this->checkId(index, mHeaps[heap].desc.NumDescriptors);
+        D3D12_GPU_DESCRIPTOR_HANDLE handle = mHeaps[heap].gpuStart;
+        handle.ptr += (UINT64)index * mHeaps[heap].stride;
+        return handle;
+    }
+
+    ID3D12RootSignature* rootSignature(UINT id) const {
+        this->checkId(id, (UINT)mRootSignatures.size());
+        return mRootSignatures[id];
+    }
+
+    ID3D12PipelineState* pipelineState(UINT id) const {
+        this->checkId(id, (UINT)mPipelineStates.size());
+        return mPipelineStates[id];
+    }
+
+    void checkId(UINT id, UINT count) const {
+        if (id >= count) {
+            throw std::exception("Command refers to an object that was never created.");
+        }
+    }
+
+private:
+    struct Heap {
+        ID3D12DescriptorHeap* heap;
+        D3D12_DESCRIPTOR_HEAP_DESC desc;
+        UINT stride;
+        D3D12_CPU_DESCRIPTOR_HANDLE cpuStart;
+        D3D12_GPU_DESCRIPTOR_HANDLE gpuStart;
+    };
+
+    struct Resource {
+        ID3D12Resource* resource = nullptr;
+        ResourceInfo info = {};
+        UINT8* memory = nullptr;
+        std::vector<UINT8> shadow;
+    };
+
+    template<typename ViewDesc>
+    void addView(CommandOp op, UINT resource, const ViewDesc* desc, UINT heap, UINT index) {
+        this->checkId(resource, (UINT)mResources.size());
+        this->cpuDescriptor(heap, index);
+        mSetup.byte(op);
+        mSetup.varint(resource);
+        mSetup.varint(heap);
+        mSetup.varint(index);
+        mSetup.byte(desc != nullptr ? 1 : 0);
+        if (desc != nullptr) {
+            mSetup.pod(*desc);
+        }
+    }
+
+    std::vector<Heap> mHeaps;
+    std::vector<Resource> mResources;
+    std::vector<ID3D12RootSignature*> mRootSignatures;
+    std::vector<ID3D12PipelineState*> mPipelineStates;
+    LogWriter mSetup;
+    LogWriter mFrames;
+    std::map<std::pair<UINT, UINT64>, std::vector<UINT8>> mLastUploads;
+    UINT mFramesLeft = 0;
+    UINT mCapturedFrames = 0;
+    bool mActive = false;
+};
+
+// Records into a D3D12 command list, or into nothing for the null backend, and into the
+// capture while one is running. Objects are named by their capture ids, which is what
+// lets a replay bind whatever objects it recreated.
+class CapturedCommandList {
+public:
+    explicit CapturedCommandList(CommandCapture& capture) : mCapture(capture) {}
+
+    // The list being recorded; nullptr records nothing.
+    void setCommandList(ID3D12GraphicsCommandList* commandList) { mCommandList = commandList; }
+    UINT64 commandCount() const { return mCommandCount; }
+
+    void beginFrame(UINT slot) {
+        mCapture.frameStarted();
+        if (LogWriter* log = this->record(CommandOpBeginFrame)) {
+            log->varint(slot);
+        }
+    }
+
+    void endFrame() {
+        this->record(CommandOpEndFrame);
+        mCapture.frameFinished();
+    }
+
+    void setPipelineState(UINT pipelineState) {
+        ID3D12PipelineState* native = mCapture.pipelineState(pipelineState);
+        if (LogWriter* log = this->record(CommandOpSetPipelineState)) {
+            log->varint(pipelineState);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->SetPipelineState(native);
+        }
+    }
+
+    void setGraphicsRootSignature(UINT rootSignature) {
+        ID3D12RootSignature* native = mCapture.rootSignature(rootSignature);
+        if (LogWriter* log = this->record(CommandOpSetRootSignature)) {
+            log->varint(rootSignature);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->SetGraphicsRootSignature(native);
+        }
+    }
+
+    void setDescriptorHeaps(UINT count, const UINT* heaps) {
+        ID3D12DescriptorHeap* natives[2];
+        if (count > _countof(natives)) {
+            throw std::exception("At most two descriptor heaps can be bound.");
+        }
+        for (UINT i = 0; i < count; i++) {
+            natives[i] = mCapture.descriptorHeap(heaps[i]);
+        }
+        if (LogWriter* log = this->record(CommandOpSetDescriptorHeaps)) {
+            log->varint(count);
+            for (UINT i = 0; i < count; i++) {
+                log->varint(heaps[i]);
+            }
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->SetDescriptorHeaps(count, natives);
+        }
+    }
+
+    void setGraphicsRootDescriptorTable(UINT parameter, UINT heap, UINT index) {
+        D3D12_GPU_DESCRIPTOR_HANDLE handle = mCapture.gpuDescriptor(heap, index);
+        if (LogWriter* log = this->record(CommandOpSetRootTable)) {
+            log->varint(parameter);
+            log->varint(heap);
+            log->varint(index);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->SetGraphicsRootDescriptorTable(parameter, handle);
+        }
+    }
+
+    void setGraphicsRoot32BitConstants(UINT parameter, UINT count, const void* data, UINT offset) {
+        if (LogWriter* log = this->record(CommandOpSetRootConstants)) {
+            log->varint(parameter);
+            log->varint(count);
+            log->varint(offset);
+            log->raw(data, count * sizeof(UINT));
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->SetGraphicsRoot32BitConstants(parameter, count, data, offset);
+        }
+    }
+
+    void setViewport(const D3D12_VIEWPORT& viewport) {
+        if (LogWriter* log = this->record(CommandOpSetViewport)) {
+            log->pod(viewport);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->RSSetViewports(1, &viewport);
+        }
+    }
+
+    void setScissorRect(const D3D12_RECT& rect) {
+        if (LogWriter* log = this->record(CommandOpSetScissorRect)) {
+            log->signedVarint(rect.left);
+            log->signedVarint(rect.top);
+            log->signedVarint(rect.right);
+            log->signedVarint(rect.bottom);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->RSSetScissorRects(1, &rect);
+        }
+    }
+
+    void transition(UINT resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after) {
+        ID3D12Resource* native = mCapture.resource(resource);
+        if (LogWriter* log = this->record(CommandOpTransition)) {
+            log->varint(resource);
+            log->varint(before);
+            log->varint(after);
+        }
+        if (mCommandList != nullptr) {
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            barrier.Transition.pResource = native;
+            barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            barrier.Transition.StateBefore = before;
+            barrier.Transition.StateAfter = after;
+            mCommandList->ResourceBarrier(1, &barrier);
+        }
+    }
+
+    // dsvHeap may be noDescriptor for no depth buffer.
+    void setRenderTarget(UINT rtvHeap, UINT rtvIndex, UINT dsvHeap, UINT dsvIndex) {
+        D3D12_CPU_DESCRIPTOR_HANDLE rtv = mCapture.cpuDescriptor(rtvHeap, rtvIndex);
+        D3D12_CPU_DESCRIPTOR_HANDLE dsv = {};
+        if (dsvHeap != noDescriptor) {
+            dsv = mCapture.cpuDescriptor(dsvHeap, dsvIndex);
+        }
+        if (LogWriter* log = this->record(CommandOpSetRenderTarget)) {
+            log->varint(rtvHeap);
+            log->varint(rtvIndex);
+            log->varint(dsvHeap);
+            log->varint(dsvIndex);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->OMSetRenderTargets(1, &rtv, FALSE, dsvHeap != noDescriptor ? &dsv : nullptr);
+        }
+    }
+
+    void clearRenderTarget(UINT heap, UINT index, const float color[4]) {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = mCapture.cpuDescriptor(heap, index);
+        if (LogWriter* log = this->record(CommandOpClearRenderTarget)) {
+            log->varint(heap);
+            log->varint(index);
+            log->raw(color, 4 * sizeof(float));
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->ClearRenderTargetView(handle, color, 0, nullptr);
+        }
+    }
+
+    void clearDepth(UINT heap, UINT index, float depth) {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = mCapture.cpuDescriptor(heap, index);
+        if (LogWriter* log = this->record(CommandOpClearDepth)) {
+            log->varint(heap);
+            log->varint(index);
+            log->real(depth);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->ClearDepthStencilView(handle, D3D12_CLEAR_FLAG_DEPTH, depth, 0, 0, nullptr);
+        }
+    }
+
+    void setPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology) {
+        if (LogWriter* log = this->record(CommandOpSetTopology)) {
+            log->varint(topology);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->IASetPrimitiveTopology(topology);
+        }
+    }
+
+    void setVertexBuffer(UINT slot, UINT resource, UINT64 offset, UINT size, UINT stride) {
+        ID3D12Resource* native = mCapture.resource(resource);
+        if (LogWriter* log = this->record(CommandOpSetVertexBuffer)) {
+            log->varint(slot);
+            log->varint(resource);
+            log->varint(offset);
+            log->varint(size);
+            log->varint(stride);
+        }
+        if (mCommandList != nullptr) {
+            D3D12_VERTEX_BUFFER_VIEW view = {};
+            view.BufferLocation = native->GetGPUVirtualAddress() + offset;
+            view.SizeInBytes = size;
+            view.StrideInBytes = stride;
+            mCommandList->IASetVertexBuffers(slot, 1, &view);
+        }
+    }
+
+    void setIndexBuffer(UINT resource, UINT64 offset, UINT size, DXGI_FORMAT format) {
+        ID3D12Resource* native = mCapture.resource(resource);
+        if (LogWriter* log = this->record(CommandOpSetIndexBuffer)) {
+            log->varint(resource);
+            log->varint(offset);
+            log->varint(size);
+            log->varint(format);
+        }
+        if (mCommandList != nullptr) {
+            D3D12_INDEX_BUFFER_VIEW view = {};
+            view.BufferLocation = native->GetGPUVirtualAddress() + offset;
+            view.SizeInBytes = size;
+            view.Format = format;
+            mCommandList->IASetIndexBuffer(&view);
+        }
+    }
+
+    void drawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance) {
+        if (LogWriter* log = this->record(CommandOpDrawInstanced)) {
+            log->varint(vertexCount);
+            log->varint(instanceCount);
+            log->varint(startVertex);
+            log->varint(startInstance);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+        }
+    }
+
+    void drawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) {
+        if (LogWriter* log = this->record(CommandOpDrawIndexedInstanced)) {
+            log->varint(indexCount);
+            log->varint(instanceCount);
+            log->varint(startIndex);
+            log->signedVarint(baseVertex);
+            log->varint(startInstance);
+        }
+        if (mCommandList != nullptr) {
+            mCommandList->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+        }
+    }
+
+    // Writes CPU data into an upload heap buffer the GPU is done with, as the mapped memcpys
+    // of the other samples do. The capture keeps the bytes, so a replay uploads the same data.
+    void upload(UINT resource, UINT64 offset, const void* data, UINT64 size) {
+        UINT8* memory = mCapture.uploadMemory(resource, offset, size);
+        if (LogWriter* log = this->record(CommandOpUpload)) {
+            log->varint(resource);
+            log->varint(offset);
+            log->varint(size);
+            std::vector<UINT8>& previous = mCapture.lastUpload(resource, offset);
+            if (previous.size() == size) {
+                log->byte(UploadEncodingDelta);
+                writeUploadDelta(*log, previous.data(), (const UINT8*)data, (size_t)size);
+            }
+            else {
+                log->byte(UploadEncodingRaw);
+                log->raw(data, (size_t)size);
+                previous.resize((size_t)size);
+            }
+            memcpy(previous.data(), data, (size_t)size);
+        }
+        memcpy(memory, data, (size_t)size);
+    }
+
+    static const UINT noDescriptor = UINT_MAX;
+
+private:
+    LogWriter* record(CommandOp op) {
+        mCommandCount++;
+        LogWriter* log = mCapture.frameLog();
+        if (log != nullptr) {
+            log->byte(op);
+        }
+        return log;
+    }
+
+    CommandCapture& mCapture;
+    ID3D12GraphicsCommandList* mCommandList = nullptr;
+    UINT64 mCommandCount = 0;
+};
+
+struct ReplayStats {
+    UINT frames = 0;
+    UINT64 commands = 0;
+    UINT64 logBytes = 0;
+    std::vector<double> frameSeconds;
+};
+
+// Recreates a log's objects and re-issues its frames through a CapturedCommandList. With a
+// device the objects are real, and every frame is submitted and fenced as the live sample's
+// frames are; without one this is the null backend, which decodes and validates everything
+// and measures what recording alone costs. A frame's time runs from its BeginFrame record,
+// after waiting for the frame slot, to the return of ExecuteCommandLists.
+class CommandReplayer {
+public:
+    // device is nullptr for the null backend.
+    void init(ID3D12Device* device) {
+        mDevice = device;
+        if (mDevice == nullptr) {
+            return;
+        }
+
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCommandAllocators[0].Get(), nullptr, IID_PPV_ARGS(&mCommandList)));
+        _ThrowIfFailed(mCommandList->Close());
+        _ThrowIfFailed(mDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+    }
+
+    void quit() {
+        if (mDevice == nullptr) {
+            return;
+        }
+        this->waitForFence(mFenceValue);
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    // Replays log into capture, which must be new. With recapture the frames are captured
+    // again as they replay, so the capture's log should come out identical.
+    void replay(const std::vector<UINT8>& log, CommandCapture& capture, bool recapture, ReplayStats& stats) {
+        CommandLogHeader header = {};
+        if (log.size() < sizeof(header)) {
+            throw std::exception("Command log is truncated.");
+        }
+        memcpy(&header, log.data(), sizeof(header));
+        if (header.magic != commandLogMagic || header.version != commandLogVersion) {
+            throw std::exception("Not a command log of this version.");
+        }
+        if (header.setupBytes > log.size() - sizeof(header) || header.frameBytes != log.size() - sizeof(header) - header.setupBytes) {
+            throw std::exception("Command log is truncated.");
+        }
+        const UINT8* setupStart = log.data() + sizeof(header);
+
+        this->beginSetup();
+        LogReader setup(setupStart, (size_t)header.setupBytes);
+        while (!setup.atEnd()) {
+            this->createObject((CommandOp)setup.byte(), setup, capture);
+        }
+        this->endSetup();
+
+        if (recapture) {
+            capture.beginCapture(header.frameCount);
+        }
+        CapturedCommandList list(capture);
+        std::map<std::pair<UINT, UINT64>, std::vector<UINT8>> lastUploads;
+        std::vector<UINT8> upload;
+        LogReader frames(setupStart + header.setupBytes, (size_t)header.frameBytes);
+        bool inFrame = false;
+        double frameStart = 0.0;
+        stats = ReplayStats();
+        stats.logBytes = header.frameBytes;
+        while (!frames.atEnd()) {
+            CommandOp op = (CommandOp)frames.byte();
+            if ((op == CommandOpBeginFrame) == inFrame || op < CommandOpBeginFrame) {
+                throw std::exception("Command log is corrupt.");
+            }
+            switch (op) {
+            case CommandOpBeginFrame: {
+                UINT slot = frames.small();
+                capture.checkId(slot, frameBufferCount);
+                this->beginFrame(slot);
+                list.setCommandList(mCommandList.Get());
+                frameStart = secondsNow();
+                list.beginFrame(slot);
+                inFrame = true;
+                break;
+            }
+            case CommandOpEndFrame:
+                list.endFrame();
+                this->endFrame();
+                stats.frameSeconds.push_back(secondsNow() - frameStart);
+                stats.frames++;
+                inFrame = false;
+                break;
+            case CommandOpSetPipelineState:
+                list.setPipelineState(frames.small());
+                break;
+            case CommandOpSetRootSignature:
+                list.setGraphicsRootSignature(frames.small());
+                break;
+            case CommandOpSetDescriptorHeaps: {
+                UINT heaps[2];
+                UINT count = frames.small();
+                if (count > _countof(heaps)) {
+                    throw std::exception("Command log is corrupt.");
+                }
+                for (UINT i = 0; i < count; i++) {
+                    heaps[i] = frames.small();
+                }
+                list.setDescriptorHeaps(count, heaps);
+                break;
+            }
+            case CommandOpSetRootTable: {
+                UINT parameter = frames.small();
+                UINT heap = frames.small();
+                list.setGraphicsRootDescriptorTable(parameter, heap, frames.small());
+                break;
+            }
+            case CommandOpSetRootConstants: {
+                UINT parameter = frames.small();
+                UINT count = frames.small();
+                UINT offset = frames.small();
+                if (count > 64) {
+                    throw std::exception("Command log is corrupt.");
+                }
+                list.setGraphicsRoot32BitConstants(parameter, count, frames.raw(count * sizeof(UINT)), offset);
+                break;
+            }
+            case CommandOpSetViewport:
+                list.setViewport(frames.pod<D3D12_VIEWPORT>());
+                break;
+            case CommandOpSetScissorRect: {
+                D3D12_RECT rect;
+                rect.left = (LONG)frames.signedVarint();
+                rect.top = (LONG)frames.signedVarint();
+                rect.right = (LONG)frames.signedVarint();
+                rect.bottom = (LONG)frames.signedVarint();
+                list.setScissorRect(rect);
+                break;
+            }
+            case CommandOpTransition: {
+                UINT resource = frames.small();
+                D3D12_RESOURCE_STATES before = (D3D12_RESOURCE_STATES)frames.small();
+                list.transition(resource, before, (D3D12_RESOURCE_STATES)frames.small());
+                break;
+            }
+            case CommandOpSetRenderTarget: {
+                UINT rtvHeap = frames.small();
+                UINT rtvIndex = frames.small();
+                UINT dsvHeap = frames.small();
+                list.setRenderTarget(rtvHeap, rtvIndex, dsvHeap, frames.small());
+                break;
+            }
+            case CommandOpClearRenderTarget: {
+                UINT heap = frames.small();
+                UINT index = frames.small();
+                float color[4];
+                memcpy(color, frames.raw(sizeof(color)), sizeof(color));
+                list.clearRenderTarget(heap, index, color);
+                break;
+            }
+            case CommandOpClearDepth: {
+                UINT heap = frames.small();
+                UINT index = frames.small();
+                list.clearDepth(heap, index, frames.real());
+                break;
+            }
+            case CommandOpSetTopology:
+                list.setPrimitiveTopology((D3D12_PRIMITIVE_TOPOLOGY)frames.small());
+                break;
+            case CommandOpSetVertexBuffer: {
+                UINT slot = frames.small();
+                UINT resource = frames.small();
+                UINT64 offset = frames.varint();
+                UINT size = frames.small();
+                list.setVertexBuffer(slot, resource, offset, size, frames.small());
+                break;
+            }
+            case CommandOpSetIndexBuffer: {
+                UINT resource = frames.small();
+                UINT64 offset = frames.varint();
+                UINT size = frames.small();
+                list.setIndexBuffer(resource, offset, size, (DXGI_FORMAT)frames.small());
+                break;
+            }
+            case CommandOpDrawInstanced: {
+                UINT vertexCount = frames.small();
+                UINT instanceCount = frames.small();
+                UINT startVertex = frames.small();
+                list.drawInstanced(vertexCount, instanceCount, startVertex, frames.small());
+                break;
+            }
+            case CommandOpDrawIndexedInstanced: {
+                UINT indexCount = frames.small();
+                UINT instanceCount = frames.small();
+                UINT startIndex = frames.small();
+                INT baseVertex = (INT)frames.signedVarint();
+                list.drawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, frames.small());
+                break;
+            }
+            case CommandOpUpload: {
+                UINT resource = frames.small();
+                UINT64 offset = frames.varint();
+                UINT64 size = frames.varint();
+                capture.uploadMemory(resource, offset, size);
+                std::vector<UINT8>& previous = lastUploads[std::make_pair(resource, offset)];
+                if (frames.byte() == UploadEncodingDelta) {
+                    if (previous.size() != size) {
+                        throw std::exception("Command log is corrupt.");
+                    }
+                    readUploadDelta(frames, previous.data(), (size_t)size);
+                }
+                else {
+                    previous.resize((size_t)size);
+                    memcpy(previous.data(), frames.raw((size_t)size), (size_t)size);
+                }
+                list.upload(resource, offset, previous.data(), size);
+                break;
+            }
+            default:
+                throw std::exception("Command log is corrupt.");
+            }
+        }
+        if (inFrame || stats.frames != header.frameCount) {
+            throw std::exception("Command log is truncated.");
+        }
+        stats.commands = list.commandCount();
+    }
+
+private:
+    void createObject(CommandOp op, LogReader& reader, CommandCapture& capture) {
+        switch (op) {
+        case CommandOpDescriptorHeap: {
+            D3D12_DESCRIPTOR_HEAP_DESC desc = reader.pod<D3D12_DESCRIPTOR_HEAP_DESC>();
+            ComPtr<ID3D12DescriptorHeap> heap;
+            UINT stride = 0;
+            if (mDevice != nullptr) {
+                _ThrowIfFailed(mDevice->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&heap)));
+                stride = mDevice->GetDescriptorHandleIncrementSize(desc.Type);
+                mHeaps.push_back(heap);
+            }
+            capture.addDescriptorHeap(heap.Get(), desc, stride);
+            break;
+        }
+        case CommandOpResource: {
+            CommandCapture::ResourceInfo info = {};
+            info.heapType = reader.pod<D3D12_HEAP_TYPE>();
+            info.desc = reader.pod<D3D12_RESOURCE_DESC>();
+            info.state = reader.pod<D3D12_RESOURCE_STATES>();
+            info.hasClearValue = reader.byte() != 0;
+            if (info.hasClearValue) {
+                info.clearValue = reader.pod<D3D12_CLEAR_VALUE>();
+            }
+            size_t size = 0;
+            const UINT8* data = reader.blob(size);
+            ComPtr<ID3D12Resource> resource;
+            if (mDevice != nullptr) {
+                this->createResource(info, data, size, resource);
+                mResources.push_back(resource);
+            }
+            capture.addResource(resource.Get(), info, data, size);
+            break;
+        }
+        case CommandOpRootSignature: {
+            size_t size = 0;
+            const UINT8* blob = reader.blob(size);
+            ComPtr<ID3D12RootSignature> rootSignature;
+            if (mDevice != nullptr) {
+                _ThrowIfFailed(mDevice->CreateRootSignature(0, blob, size, IID_PPV_ARGS(&rootSignature)));
+                mRootSignatures.push_back(rootSignature);
+            }
+            capture.addRootSignature(rootSignature.Get(), blob, size);
+            break;
+        }
+        case CommandOpPipelineState: {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
+            UINT rootSignature = reader.small();
+            size_t size = 0;
+            const UINT8* code = reader.blob(size);
+            desc.VS = { code, size };
+            code = reader.blob(size);
+            desc.PS = { code, size };
+            desc.BlendState = reader.pod<D3D12_BLEND_DESC>();
+            desc.SampleMask = reader.small();
+            desc.RasterizerState = reader.pod<D3D12_RASTERIZER_DESC>();
+            desc.DepthStencilState = reader.pod<D3D12_DEPTH_STENCIL_DESC>();
+            UINT elementCount = reader.small();
+            if (elementCount > D3D12_IA_VERTEX_INPUT_STRUCTURE_ELEMENT_COUNT) {
+                throw std::exception("Command log is corrupt.");
+            }
+            std::vector<std::string> names(elementCount);
+            std::vector<D3D12_INPUT_ELEMENT_DESC> elements(elementCount);
+            for (UINT i = 0; i < elementCount; i++) {
+                names[i] = reader.string();
+                elements[i].SemanticName = names[i].c_str();
+                elements[i].SemanticIndex = reader.small();
+                elements[i].Format = (DXGI_FORMAT)reader.small();
+                elements[i].InputSlot = reader.small();
+                elements[i].AlignedByteOffset = reader.small();
+                elements[i].InputSlotClass = (D3D12_INPUT_CLASSIFICATION)reader.small();
+                elements[i].InstanceDataStepRate = reader.small();
+            }
+            desc.InputLayout = { elements.data(), elementCount };
+            desc.IBStripCutValue = (D3D12_INDEX_BUFFER_STRIP_CUT_VALUE)reader.small();
+            desc.PrimitiveTopologyType = (D3D12_PRIMITIVE_TOPOLOGY_TYPE)reader.small();
+            desc.NumRenderTargets = reader.small();
+            for (UINT i = 0; i < 8; i++) {
+                desc.RTVFormats[i] = (DXGI_FORMAT)reader.small();
+            }
+            desc.DSVFormat = (DXGI_FORMAT)reader.small();
+            desc.SampleDesc.Count = reader.small();
+            desc.SampleDesc.Quality = reader.small();
+            desc.NodeMask = reader.small();
+            desc.Flags = (D3D12_PIPELINE_STATE_FLAGS)reader.small();
+            ComPtr<ID3D12PipelineState> pipelineState;
+            if (mDevice != nullptr) {
+                desc.pRootSignature = capture.rootSignature(rootSignature);
+                _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineState)));
+                mPipelineStates.push_back(pipelineState);
+            }
+            capture.addPipelineState(pipelineState.Get(), desc, rootSignature);
+            break;
+        }
+        case CommandOpShaderResourceView: {
+            D3D12_SHADER_RESOURCE_VIEW_DESC desc;
+            const D3D12_SHADER_RESOURCE_VIEW_DESC* viewDesc = this->readView(reader, desc);
+            if (mDevice != nullptr) {
+                mDevice->CreateShaderResourceView(capture.resource(mViewResource), viewDesc, capture.cpuDescriptor(mViewHeap, mViewIndex));
+            }
+            capture.addShaderResourceView(mViewResource, viewDesc, mViewHeap, mViewIndex);
+            break;
+        }
+        case CommandOpRenderTargetView: {
+            D3D12_RENDER_TARGET_VIEW_DESC desc;
+            const D3D12_RENDER_TARGET_VIEW_DESC* viewDesc = this->readView(reader, desc);
+            if (mDevice != nullptr) {
+                mDevice->CreateRenderTargetView(capture.resource(mViewResource), viewDesc, capture.cpuDescriptor(mViewHeap, mViewIndex));
+            }
+            capture.addRenderTargetView(mViewResource, viewDesc, mViewHeap, mViewIndex);
+            break;
+        }
+        case CommandOpDepthStencilView: {
+            D3D12_DEPTH_STENCIL_VIEW_DESC desc;
+            const D3D12_DEPTH_STENCIL_VIEW_DESC* viewDesc = this->readView(reader, desc);
+            if (mDevice != nullptr) {
+                mDevice->CreateDepthStencilView(capture.resource(mViewResource), viewDesc, capture.cpuDescriptor(mViewHeap, mViewIndex));
+            }
+            capture.addDepthStencilView(mViewResource, viewDesc, mViewHeap, mViewIndex);
+            break;
+        }
+        default:
+            throw std::exception("Command log is corrupt.");
+        }
+    }
+
+    template<typename ViewDesc>
+    const ViewDesc* readView(LogReader& reader, ViewDesc& desc) {
+        mViewResource = reader.small();
+        mViewHeap = reader.small();
+        mViewIndex = reader.small();
+        if (reader.byte() == 0) {
+            return nullptr;
+        }
+        desc = reader.pod<ViewDesc>();
+        return &desc;
+    }
+
+    // Upload heap contents are written through a mapping; default heap contents go through a
+    // staging buffer on the setup command list.
+    void createResource(const CommandCapture::ResourceInfo& info, const UINT8* data, size_t size, ComPtr<ID3D12Resource>& resource) {
+        const bool staged = size > 0 && info.heapType == D3D12_HEAP_TYPE_DEFAULT;
+        D3D12_HEAP_PROPERTIES heapProperties = {};
+        heapProperties.Type = info.heapType;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &info.desc,
+            staged ? D3D12_RESOURCE_STATE_COPY_DEST : info.state,
+            info.hasClearValue ? &info.clearValue : nullptr,
+            IID_PPV_ARGS(&resource)));
+        if (size == 0) {
+            return;
+        }
+        if (!staged) {
+            UINT8* memory = nullptr;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(resource->Map(0, &readRange, (void**)&memory));
+            memcpy(memory, data, (size_t)std::min<UINT64>(size, info.desc.Width));
+            resource->Unmap(0, nullptr);
+            return;
+        }
+
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+        UINT rowCount = 0;
+        UINT64 rowSize = 0;
+        UINT64 stagingSize = 0;
+        mDevice->GetCopyableFootprints(&info.desc, 0, 1, 0, &footprint, &rowCount, &rowSize, &stagingSize);
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = {};
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+        D3D12_RESOURCE_DESC stagingDesc = {};
+        stagingDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        stagingDesc.Width = stagingSize;
+        stagingDesc.Height = 1;
+        stagingDesc.DepthOrArraySize = 1;
+        stagingDesc.MipLevels = 1;
+        stagingDesc.Format = DXGI_FORMAT_UNKNOWN;
+        stagingDesc.SampleDesc.Count = 1;
+        stagingDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        ComPtr<ID3D12Resource> staging;
+        _ThrowIfFailed(mDevice->CreateCommittedResource(
+            &uploadHeapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &stagingDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&staging)));
+        mStaging.push_back(staging);
+
+        UINT8* memory = nullptr;
+        D3D12_RANGE readRange = { 0, 0 };
+        _ThrowIfFailed(staging->Map(0, &readRange, (void**)&memory));
+        if (info.desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+            memcpy(memory, data, (size_t)std::min<UINT64>(size, stagingSize));
+            mCommandList->CopyBufferRegion(resource.Get(), 0, staging.Get(), 0, std::min<UINT64>(size, info.desc.Width));
+        }
+        else {
+            const UINT depth = footprint.Footprint.Depth;
+            for (UINT row = 0; row < rowCount * depth && (row + 1) * rowSize <= size; row++) {
+                memcpy(memory + footprint.Offset + (UINT64)row * footprint.Footprint.RowPitch, data + row * rowSize, (size_t)rowSize);
+            }
+            D3D12_TEXTURE_COPY_LOCATION source = {};
+            source.pResource = staging.Get();
+            source.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            source.PlacedFootprint = footprint;
+            D3D12_TEXTURE_COPY_LOCATION destination = {};
+            destination.pResource = resource.Get();
+            destination.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            destination.SubresourceIndex = 0;
+            mCommandList->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+        }
+        staging->Unmap(0, nullptr);
+
+        D3D12_RESOURCE_BARRIER barrier = {};
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Transition.pResource = resource.Get();
+        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        barrier.Transition.StateAfter = info.state;
+        mCommandList->ResourceBarrier(1, &barrier);
+    }
+
+    void beginSetup() {
+        if (mDevice != nullptr) {
+            _ThrowIfFailed(mCommandAllocators[0]->Reset());
+            _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[0].Get(), nullptr));
+        }
+    }
+
+    void endSetup() {
+        if (mDevice != nullptr) {
+            _ThrowIfFailed(mCommandList->Close());
+            ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+            mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+            _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), ++mFenceValue));
+            this->waitForFence(mFenceValue);
+            mStaging.clear();
+        }
+    }
+
+    void beginFrame(UINT slot) {
+        if (mDevice != nullptr) {
+            this->waitForFence(mFrameFenceValues[slot]);
+            _ThrowIfFailed(mCommandAllocators[slot]->Reset());
+            _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[slot].Get(), nullptr));
+            mFrameSlot = slot;
+        }
+    }
+
+    void endFrame() {
+        if (mDevice != nullptr) {
+            _ThrowIfFailed(mCommandList->Close());
+            ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+            mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+            _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), ++mFenceValue));
+            mFrameFenceValues[mFrameSlot] = mFenceValue;
+        }
+    }
+
+    void waitForFence(UINT64 value) {
+        if (mFence->GetCompletedValue() < value) {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(value, mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+    }
+
+    ID3D12Device* mDevice = nullptr;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Fence> mFence;
+    HANDLE mFenceEvent = nullptr;
+    UINT64 mFenceValue = 0;
+    UINT64 mFrameFenceValues[frameBufferCount] = {};
+    UINT mFrameSlot = 0;
+
+    std::vector<ComPtr<ID3D12DescriptorHeap>> mHeaps;
+    std::vector<ComPtr<ID3D12Resource>> mResources;
+    std::vector<ComPtr<ID3D12RootSignature>> mRootSignatures;
+    std::vector<ComPtr<ID3D12PipelineState>> mPipelineStates;
+    std::vector<ComPtr<ID3D12Resource>> mStaging;
+    UINT mViewResource = 0;
+    UINT mViewHeap = 0;
+    UINT mViewIndex = 0;
+};
+
+std::string formatReplayStats(const char* backend, const ReplayStats& stats) {
+    std::vector<double> sorted = stats.frameSeconds;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (double seconds : sorted) {
+        total += seconds;
+    }
+    const size_t count = std::max<size_t>(sorted.size(), 1);
+    auto percentile = [&](double p) { return sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))]; };
+    char report[512];
+    snprintf(report, sizeof(report),
+        "Replay on %s: %u frames, %.1f commands and %.1f KB of log per frame\n"
+        "CPU submission per frame: average %.3f ms, median %.3f ms, 95th percentile %.3f ms, max %.3f ms\n",
+        backend, stats.frames, stats.commands / (double)count, stats.logBytes / 1024.0 / count,
+        total * 1000.0 / count, percentile(0.5) * 1000.0, percentile(0.95) * 1000.0, (sorted.empty() ? 0.0 : sorted.back()) * 1000.0);
+    return report;
+}
+
+bool saveCommandLog(const char* path, const std::vector<UINT8>& log) {
+    FILE* fd = NULL;
+    fopen_s(&fd, path, "wb");
+    if (fd == NULL) {
+        return false;
+    }
+    size_t written = fwrite(log.data(), 1, log.size(), fd);
+    fclose(fd);
+    return written == log.size();
+}
+
+bool loadCommandLog(const char* path, std::vector<UINT8>& log) {
+    FILE* fd = NULL;
+    fopen_s(&fd, path, "rb");
+    if (fd == NULL) {
+        return false;
+    }
+    fseek(fd, 0, SEEK_END);
+    long size = ftell(fd);
+    fseek(fd, 0, SEEK_SET);
+    log.resize(size > 0 ? (size_t)size : 0);
+    size_t read = fread(log.data(), 1, log.size(), fd);
+    fclose(fd);
+    return read == log.size();
+}
+
+// Capture ids of everything a frame of the cube field binds.
+struct CubeFieldIds {
+    UINT rootSignature;
+    UINT pipelineState;
+    UINT srvHeap;
+    UINT rtvHeap;
+    UINT dsvHeap;
+    UINT renderTargets[frameBufferCount];
+    UINT vertexBuffer;
+    UINT vertexBufferSize;
+    UINT indexBuffer;
+    UINT indexCount;
+    UINT instanceBuffer;
+};
+
+const D3D12_INPUT_ELEMENT_DESC cubeInputLayout[] =
+{
+    { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+    { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+    { "CENTER", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+    { "EXTENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 12, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+    { "TINT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, 24, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+};
+
+D3D12_GRAPHICS_PIPELINE_STATE_DESC makeCubePipelineDesc(ID3D12RootSignature* rootSignature, const D3D12_SHADER_BYTECODE& vs, const D3D12_SHADER_BYTECODE& ps) {
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+    psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    psoDesc.InputLayout.pInputElementDescs = cubeInputLayout;
+    psoDesc.InputLayout.NumElements = _countof(cubeInputLayout);
+
+    psoDesc.pRootSignature = rootSignature;
+    psoDesc.VS = vs;
+    psoDesc.PS = ps;
+
+    psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+    psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+    psoDesc.RasterizerState.FrontCounterClockwise = FALSE;
+
+    psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+    psoDesc.BlendState.IndependentBlendEnable = FALSE;
+    psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+    psoDesc.DepthStencilState.DepthEnable = TRUE;
+    psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+    psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+    psoDesc.DepthStencilState.StencilEnable = FALSE;
+    psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+    psoDesc.NumRenderTargets = 1;
+    psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+    psoDesc.SampleMask = UINT_MAX;
+    psoDesc.SampleDesc.Count = 1;
+    return psoDesc;
+}
+
+D3D12_RESOURCE_DESC makeBufferDesc(UINT64 width) {
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = width;
+    desc.Height = 1;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.Format = DXGI_FORMAT_UNKNOWN;
+    desc.SampleDesc.Count = 1;
+    desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    return desc;
+}
+
+D3D12_RESOURCE_DESC makeTextureDesc(UINT width, UINT height, DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags) {
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    desc.Width = width;
+    desc.Height = height;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.Format = format;
+    desc.SampleDesc.Count = 1;
+    desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    desc.Flags = flags;
+    return desc;
+}
+
+// One unit cube with its faces shaded by direction, wound clockwise seen from outside.
+void makeCubeMesh(std::vector<Vertex>& vertices, std::vector<UINT>& indices) {
+    // Outward normal and the up direction of each face as seen from outside; right is up x -normal.
+    const int faces[6][6] = {
+        { 0, 0, -1, 0, 1, 0 }, { 0, 0, 1, 0, 1, 0 }, { -1, 0, 0, 0, 1, 0 },
+        { 1, 0, 0, 0, 1, 0 }, { 0, 1, 0, 0, 0, 1 }, { 0, -1, 0, 0, 0, 1 }
+    };
+    const float shades[6] = { 0.8f, 0.6f, 0.7f, 0.9f, 1.0f, 0.4f };
+    const int corners[4][2] = { { -1, 1 }, { 1, 1 }, { 1, -1 }, { -1, -1 } };
+    const XMFLOAT2 uvs[4] = { XMFLOAT2(0.0f, 0.0f), XMFLOAT2(1.0f, 0.0f), XMFLOAT2(1.0f, 1.0f), XMFLOAT2(0.0f, 1.0f) };
+    for (UINT f = 0; f < 6; f++) {
+        const int* n = faces[f];
+        const int* u = faces[f] + 3;
+        const int r[3] = { -(u[1] * n[2] - u[2] * n[1]), -(u[2] * n[0] - u[0] * n[2]), -(u[0] * n[1] - u[1] * n[0]) };
+        const UINT base = (UINT)vertices.size();
+        for (UINT c = 0; c < 4; c++) {
+            const XMFLOAT3 p(
+                (float)(n[0] + r[0] * corners[c][0] + u[0] * corners[c][1]),
+                (float)(n[1] + r[1] * corners[c][0] + u[1] * corners[c][1]),
+                (float)(n[2] + r[2] * corners[c][0] + u[2] * corners[c][1]));
+            vertices.push_back({ p, XMFLOAT4(shades[f], shades[f], shades[f], 1.0f), uvs[c] });
+        }
+        const UINT quad[6] = { 0, 1, 2, 2, 3, 0 };
+        for (UINT index : quad) {
+            indices.push_back(base + index);
+        }
+    }
+}
+
+void makeCheckerboard(std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight) {
+    const UINT rowPitch = textureWidth * 4;
+    const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+    const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+    const UINT textureSize = rowPitch * textureHeight;
+
+    image.resize(textureSize);
+
+    UINT8* pData = (UINT8*)image.data();
+    for (UINT n = 0; n < textureSize; n += 4)
+    {
+        UINT x = n % rowPitch;
+        UINT y = n / rowPitch;
+        UINT i = x / cellPitch;
+        UINT j = y / cellHeight;
+        const UINT8 value = i % 2 == j % 2 ? 0xc0 : 0xff;
+        pData[n + 0] = value;   // R
+        pData[n + 1] = value;   // G
+        pData[n + 2] = value;   // B
+        pData[n + 3] = 0xff;    // A
+    }
+}
+
+// The cube field's objects for the null backend: the live sample's descriptions and
+// contents, with stand-ins for the compiled shaders and the serialized root signature.
+CubeFieldIds addNullCubeField(CommandCapture& capture) {
+    CubeFieldIds ids = {};
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+    heapDesc.NumDescriptors = frameBufferCount;
+    ids.rtvHeap = capture.addDescriptorHeap(nullptr, heapDesc, 0);
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+    heapDesc.NumDescriptors = 1;
+    ids.dsvHeap = capture.addDescriptorHeap(nullptr, heapDesc, 0);
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    ids.srvHeap = capture.addDescriptorHeap(nullptr, heapDesc, 0);
+
+    CommandCapture::ResourceInfo info = {};
+    info.heapType = D3D12_HEAP_TYPE_DEFAULT;
+    info.desc = makeTextureDesc(windowWidth, windowHeight, DXGI_FORMAT_R8G8B8A8_UNORM, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+    info.state = D3D12_RESOURCE_STATE_PRESENT;
+    for (UINT i = 0; i < frameBufferCount; i++) {
+        ids.renderTargets[i] = capture.addResource(nullptr, info, nullptr, 0);
+        capture.addRenderTargetView(ids.renderTargets[i], nullptr, ids.rtvHeap, i);
+    }
+
+    info.desc = makeTextureDesc(windowWidth, windowHeight, DXGI_FORMAT_D32_FLOAT, D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+    info.state = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+    info.hasClearValue = true;
+    info.clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+    info.clearValue.DepthStencil.Depth = 1.0f;
+    capture.addDepthStencilView(capture.addResource(nullptr, info, nullptr, 0), nullptr, ids.dsvHeap, 0);
+
+    std::vector<Vertex> vertices;
+    std::vector<UINT> indices;
+    makeCubeMesh(vertices, indices);
+    info = {};
+    info.heapType = D3D12_HEAP_TYPE_UPLOAD;
+    info.state = D3D12_RESOURCE_STATE_GENERIC_READ;
+    info.desc = makeBufferDesc(vertices.size() * sizeof(Vertex));
+    ids.vertexBuffer = capture.addResource(nullptr, info, vertices.data(), info.desc.Width);
+    ids.vertexBufferSize = (UINT)info.desc.Width;
+    info.desc = makeBufferDesc(indices.size() * sizeof(UINT));
+    ids.indexBuffer = capture.addResource(nullptr, info, indices.data(), info.desc.Width);
+    ids.indexCount = (UINT)indices.size();
+    info.desc = makeBufferDesc((UINT64)frameBufferCount * fieldSide * fieldSide * sizeof(CubeInstance));
+    ids.instanceBuffer = capture.addResource(nullptr, info, nullptr, 0);
+
+    std::vector<UINT8> image;
+    makeCheckerboard(image, 256, 256);
+    info.heapType = D3D12_HEAP_TYPE_DEFAULT;
+    info.desc = makeTextureDesc(256, 256, DXGI_FORMAT_R8G8B8A8_UNORM, D3D12_RESOURCE_FLAG_NONE);
+    info.state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    UINT texture = capture.addResource(nullptr, info, image.data(), image.size());
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Texture2D.MipLevels = 1;
+    capture.addShaderResourceView(texture, &srvDesc, ids.srvHeap, 0);
+
+    const char rootSignature[] = "null backend root signature";
+    const char vs[] = "null backend vertex shader";
+    const char ps[] = "null backend pixel shader";
+    ids.rootSignature = capture.addRootSignature(nullptr, rootSignature, sizeof(rootSignature));
+    ids.pipelineState = capture.addPipelineState(nullptr, makeCubePipelineDesc(nullptr, { vs, sizeof(vs) }, { ps, sizeof(ps) }), ids.rootSignature);
+    return ids;
+}
+
+// One frame of the cube field, between beginFrame and endFrame: the instance data goes into
+// this slot's region of the instance buffer, then the field is drawn in strips of rows.
+void recordCubeField(CapturedCommandList& list, const CubeFieldIds& ids, UINT slot, float time, std::vector<CubeInstance>& instances) {
+    // A wave of raised cubes sweeps across the field; the cubes outside it keep their data.
+    const float wave = fmodf(time * 8.0f, fieldSide + 16.0f) - 8.0f;
+    instances.resize(fieldSide * fieldSide);
+    for (UINT z = 0; z < fieldSide; z++) {
+        for (UINT x = 0; x < fieldSide; x++) {
+            const float lift = std::max(0.0f, 1.0f - fabsf(x - wave) * 0.25f);
+            const float height = 0.5f + 2.0f * lift;
+            CubeInstance& instance = instances[z * fieldSide + x];
+            instance.center = XMFLOAT3((x - fieldSide * 0.5f) * 2.0f, height, (z - fieldSide * 0.5f) * 2.0f);
+            instance.extent = XMFLOAT3(0.8f, height, 0.8f);
+            instance.color = 0xff000000 | (UINT32)(0x80 + 0x7f * lift) << 16 | (0x60 + z * 4) << 8 | (0x60 + x * 4);
+        }
+    }
+    const UINT64 regionSize = instances.size() * sizeof(CubeInstance);
+
+    const float angle = time * 0.1f;
+    float m[16];
+    makeViewProjection(XMFLOAT3(60.0f * cosf(angle), 30.0f, 60.0f * sinf(angle)), XMFLOAT3(0.0f, 0.0f, 0.0f),
+        0.9f, windowWidth / (float)windowHeight, 0.1f, 500.0f, m);
+    XMFLOAT4X4 viewProjection(m);
+    XMFLOAT4X4 constants;
+    XMStoreFloat4x4(&constants, XMMatrixTranspose(XMLoadFloat4x4(&viewProjection)));
+
+    D3D12_VIEWPORT viewport = { 0.0f, 0.0f, (float)windowWidth, (float)windowHeight, 0.0f, 1.0f };
+    D3D12_RECT scissorRect = { 0, 0, windowWidth, windowHeight };
+    const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+
+    list.setPipelineState(ids.pipelineState);
+    list.setGraphicsRootSignature(ids.rootSignature);
+    list.setDescriptorHeaps(1, &ids.srvHeap);
+    list.setGraphicsRootDescriptorTable(0, ids.srvHeap, 0);
+    list.setGraphicsRoot32BitConstants(1, 16, &constants, 0);
+    list.setViewport(viewport);
+    list.setScissorRect(scissorRect);
+    list.transition(ids.renderTargets[slot], D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    list.setRenderTarget(ids.rtvHeap, slot, ids.dsvHeap, 0);
+    list.clearRenderTarget(ids.rtvHeap, slot, clearColor);
+    list.clearDepth(ids.dsvHeap, 0, 1.0f);
+    list.setPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    list.upload(ids.instanceBuffer, slot * regionSize, instances.data(), regionSize);
+    list.setVertexBuffer(0, ids.vertexBuffer, 0, ids.vertexBufferSize, sizeof(Vertex));
+    list.setVertexBuffer(1, ids.instanceBuffer, slot * regionSize, (UINT)regionSize, sizeof(CubeInstance));
+    list.setIndexBuffer(ids.indexBuffer, 0, ids.indexCount * sizeof(UINT), DXGI_FORMAT_R32_UINT);
+    for (UINT row = 0; row < fieldSide; row += fieldRowsPerDraw) {
+        list.drawIndexedInstanced(ids.indexCount, fieldSide * fieldRowsPerDraw, 0, 0, row * fieldSide);
+    }
+    list.transition(ids.renderTargets[slot], D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+}
+
+// Records frames of the cube field on the null backend, 60 to the second, alternating slots.
+void recordNullFrames(CapturedCommandList& list, const CubeFieldIds& ids, UINT firstFrame, UINT frameCount) {
+    std::vector<CubeInstance> instances;
+    for (UINT frame = firstFrame; frame < firstFrame + frameCount; frame++) {
+        list.beginFrame(frame % frameBufferCount);
+        recordCubeField(list, ids, frame % frameBufferCount, frame / 60.0f, instances);
+        list.endFrame();
+    }
+}
+
+// Captures the cube field on the null backend and checks that a replay reproduces it
+// exactly, and that broken logs are refused rather than replayed.
+bool simulateCommandReplay(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+    auto rejects = [](const std::vector<UINT8>& log) {
+        try {
+            CommandCapture capture;
+            CommandReplayer replayer;
+            replayer.init(nullptr);
+            ReplayStats stats;
+            replayer.replay(log, capture, false, stats);
+        }
+        catch (std::exception&) {
+            return true;
+        }
+        return false;
+    };
+
+    // Ten frames before the capture starts, so it begins mid-session on slot 0 again.
+    CommandCapture live;
+    const CubeFieldIds ids = addNullCubeField(live);
+    CapturedCommandList list(live);
+    recordNullFrames(list, ids, 0, 10);
+    live.beginCapture(60);
+    const UINT64 commandsBefore = list.commandCount();
+    recordNullFrames(list, ids, 10, 80);
+    const UINT64 capturedCommands = (list.commandCount() - commandsBefore) * 60 / 80;
+    const std::vector<UINT8> log = live.takeLog();
+    CommandLogHeader header;
+    memcpy(&header, log.data(), sizeof(header));
+    check(header.frameCount == 60 && !live.captureRunning(), "the capture stops after the frames it was asked for");
+
+    // The replay ends on the capture's last frame, 69; the live session went on to 89.
+    CommandCapture live69;
+    const CubeFieldIds ids69 = addNullCubeField(live69);
+    CapturedCommandList list69(live69);
+    recordNullFrames(list69, ids69, 0, 70);
+
+    CommandCapture replayed;
+    CommandReplayer replayer;
+    replayer.init(nullptr);
+    ReplayStats stats;
+    replayer.replay(log, replayed, true, stats);
+    check(stats.frames == 60 && stats.commands == capturedCommands, "the replay issues every captured command");
+    check(replayed.takeLog() == log, "capturing the replay reproduces the log byte for byte");
+
+    const UINT64 ringSize = (UINT64)frameBufferCount * fieldSide * fieldSide * sizeof(CubeInstance);
+    check(memcmp(replayed.uploadMemory(ids.instanceBuffer, 0, ringSize), live69.uploadMemory(ids69.instanceBuffer, 0, ringSize), (size_t)ringSize) == 0,
+        "replayed uploads leave the instance buffer as the live frames did");
+
+    const UINT64 rawUploads = 60 * fieldSide * fieldSide * sizeof(CubeInstance);
+    check(header.frameBytes * 4 < rawUploads, "frames take under a quarter of their raw upload bytes");
+
+    std::vector<UINT8> broken(log.begin(), log.end() - 5);
+    check(rejects(broken), "a truncated log is rejected");
+
+    // The first command after the first BeginFrame names the pipeline state.
+    broken = log;
+    const size_t firstCommand = sizeof(header) + (size_t)header.setupBytes + 2;
+    check(broken[firstCommand] == CommandOpSetPipelineState, "the frames start with a pipeline state");
+    broken[firstCommand + 1] = 99;
+    check(rejects(broken), "a command naming an object the log never created is rejected");
+
+    broken = log;
+    broken[4] = commandLogVersion + 1;
+    check(rejects(broken), "a log of another version is rejected");
+
+    bool refused = false;
+    try {
+        list.setPipelineState(99);
+    }
+    catch (std::exception&) {
+        refused = true;
+    }
+    check(refused, "recording with an unknown id is refused");
+
+    CommandCapture empty;
+    addNullCubeField(empty);
+    empty.beginCapture(0);
+    CommandCapture emptyReplay;
+    replayer.replay(empty.takeLog(), emptyReplay, false, stats);
+    check(stats.frames == 0 && stats.commands == 0, "an empty capture replays nothing");
+    replayer.quit();
+    return passed;
+}
+
+// Costs of capturing 600 frames of the cube field and replaying them on the null backend.
+std::string benchmarkCommandReplay() {
+    const UINT frames = 600;
+    CommandCapture capture;
+    const CubeFieldIds ids = addNullCubeField(capture);
+    CapturedCommandList list(capture);
+
+    double start = secondsNow();
+    recordNullFrames(list, ids, 0, frames);
+    const double plain = (secondsNow() - start) / frames;
+
+    capture.beginCapture(frames);
+    start = secondsNow();
+    recordNullFrames(list, ids, 0, frames);
+    const double captured = (secondsNow() - start) / frames;
+    const std::vector<UINT8> log = capture.takeLog();
+    CommandLogHeader header;
+    memcpy(&header, log.data(), sizeof(header));
+
+    CommandCapture replayed;
+    CommandReplayer replayer;
+    replayer.init(nullptr);
+    ReplayStats stats;
+    start = secondsNow();
+    replayer.replay(log, replayed, false, stats);
+    const double replay = secondsNow() - start;
+    replayer.quit();
+
+    const double rawBytes = (double)fieldSide * fieldSide * sizeof(CubeInstance);
+    char report[1024];
+    snprintf(report, sizeof(report),
+        "Command capture: %u frames of %u cubes in %u draws\n"
+        "Record: %.1f us per frame, %.1f us while capturing\n"
+        "Log: %.1f KB of setup, %.2f KB per frame against %.1f KB of raw uploads (%.1f%%)\n"
+        "Null replay: %.1f MB/s of log\n",
+        frames, fieldSide * fieldSide, fieldSide / fieldRowsPerDraw,
+        plain * 1e6, captured * 1e6,
+        header.setupBytes / 1024.0, header.frameBytes / 1024.0 / frames, rawBytes / 1024.0, 100.0 * header.frameBytes / frames / rawBytes,
+        log.size() / replay / 1e6);
+    return report + formatReplayStats("the null backend", stats);
+}
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Everything a frame binds is registered with the capture, which names it by id.
+        mIds.rtvHeap = mCapture.addDescriptorHeap(mRTVHeap.Get(), rtvHeapDesc, mRTVHeapStride);
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            CommandCapture::ResourceInfo info = {};
+            info.heapType = D3D12_HEAP_TYPE_DEFAULT;
+            info.desc = mRenderTargets[i]->GetDesc();
+            info.state = D3D12_RESOURCE_STATE_PRESENT;
+            mIds.renderTargets[i] = mCapture.addResource(mRenderTargets[i].Get(), info, nullptr, 0);
+            mCapture.addRenderTargetView(mIds.renderTargets[i], nullptr, mIds.rtvHeap, i);
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+        mIds.srvHeap = mCapture.addDescriptorHeap(mSRVHeap.Get(), srvHeapDesc, mSRVHeapStride);
+
+        // Create Depth Buffer
+        {
+            D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
+            dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+            dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+            dsvHeapDesc.NumDescriptors = 1;
+            _ThrowIfFailed(mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&mDSVHeap)));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+            D3D12_RESOURCE_DESC depthDesc = {};
+            depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            depthDesc.Width = windowWidth;
+            depthDesc.Height = windowHeight;
+            depthDesc.DepthOrArraySize = 1;
+            depthDesc.MipLevels = 1;
+            depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+            depthDesc.SampleDesc.Count = 1;
+            depthDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+            D3D12_CLEAR_VALUE clearValue = {};
+            clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+            clearValue.DepthStencil.Depth = 1.0f;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &depthDesc,
+                D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                &clearValue,
+                IID_PPV_ARGS(&mDepthBuffer)));
+            mDevice->CreateDepthStencilView(mDepthBuffer.Get(), nullptr, mDSVHeap->GetCPUDescriptorHandleForHeapStart());
+
+            CommandCapture::ResourceInfo info = {};
+            info.heapType = D3D12_HEAP_TYPE_DEFAULT;
+            info.desc = depthDesc;
+            info.state = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+            info.hasClearValue = true;
+            info.clearValue = clearValue;
+            mIds.dsvHeap = mCapture.addDescriptorHeap(mDSVHeap.Get(), dsvHeapDesc, mDevice->GetDescriptorHandleIncrementSize(dsvHeapDesc.Type));
+            mCapture.addDepthStencilView(mCapture.addResource(mDepthBuffer.Get(), info, nullptr, 0), nullptr, mIds.dsvHeap, 0);
+        }
+
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        mStartTime = secondsNow();
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    // Captures the next captureFrameCount frames; the log is written once the last one is recorded.
+    void startCapture() {
+        if (mCapture.captureRunning()) {
+            return;
+        }
+        mCapture.beginCapture(captureFrameCount);
+        debugLog("Capturing %u frames\n", captureFrameCount);
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+            mIds.rootSignature = mCapture.addRootSignature(mRootSignature.Get(), rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize());
+        }
+
+        // Compile Shader
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/016-occlusion.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/016-occlusion.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = makeCubePipelineDesc(mRootSignature.Get(),
+                { vsCode->GetBufferPointer(), vsCode->GetBufferSize() },
+                { psCode->GetBufferPointer(), psCode->GetBufferSize() });
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+            mIds.pipelineState = mCapture.addPipelineState(mPipelineState.Get(), psoDesc, mIds.rootSignature);
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        std::vector<Vertex> vertices;
+        std::vector<UINT> indices;
+        makeCubeMesh(vertices, indices);
+
+        // Create Vertex Buffer
+        {
+            const UINT vertexBufferSize = (UINT)(vertices.size() * sizeof(Vertex));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = vertexBufferSize;
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, vertices.data(), vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            CommandCapture::ResourceInfo info = {};
+            info.heapType = D3D12_HEAP_TYPE_UPLOAD;
+            info.desc = vbDesc;
+            info.state = D3D12_RESOURCE_STATE_GENERIC_READ;
+            mIds.vertexBuffer = mCapture.addResource(mVertexBuffer.Get(), info, vertices.data(), vertexBufferSize);
+            mIds.vertexBufferSize = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = indices.size() * sizeof(UINT);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices.data(), ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            CommandCapture::ResourceInfo info = {};
+            info.heapType = D3D12_HEAP_TYPE_UPLOAD;
+            info.desc = ibDesc;
+            info.state = D3D12_RESOURCE_STATE_GENERIC_READ;
+            mIds.indexBuffer = mCapture.addResource(mIndexBuffer.Get(), info, indices.data(), ibDesc.Width);
+            mIds.indexCount = (UINT)indices.size();
+        }
+
+        // Texture
+        {
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeCheckerboard(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+
+            // A replay uploads the same contents and ends in the state the copy left it in.
+            CommandCapture::ResourceInfo info = {};
+            info.heapType = D3D12_HEAP_TYPE_DEFAULT;
+            info.desc = mTextureResource->GetDesc();
+            info.state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+            UINT texture = mCapture.addResource(mTextureResource.Get(), info, image.data(), image.size());
+
+            D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+            srvDesc.Format = format;
+            srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            srvDesc.Texture2D.MipLevels = 1;
+            mCapture.addShaderResourceView(texture, &srvDesc, mIds.srvHeap, 0);
+        }
+
+
+        // Create Instance Buffer, one region per frame in flight; the capture maps it for uploads
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC bufferDesc = {};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = (UINT64)frameBufferCount * fieldSide * fieldSide * sizeof(CubeInstance);
+            bufferDesc.Height = 1;
+            bufferDesc.DepthOrArraySize = 1;
+            bufferDesc.MipLevels = 1;
+            bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mInstanceBuffer)));
+
+            CommandCapture::ResourceInfo info = {};
+            info.heapType = D3D12_HEAP_TYPE_UPLOAD;
+            info.desc = bufferDesc;
+            info.state = D3D12_RESOURCE_STATE_GENERIC_READ;
+            mIds.instanceBuffer = mCapture.addResource(mInstanceBuffer.Get(), info, nullptr, 0);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    // The frame is recorded through the capture's command list, which names everything by
+    // capture id; the live list and the capture, while one runs, see the same commands.
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        const double start = secondsNow();
+        mCapturedList.setCommandList(mCommandList.Get());
+        mCapturedList.beginFrame(mFrameBufferIndex);
+        recordCubeField(mCapturedList, mIds, mFrameBufferIndex, (float)(secondsNow() - mStartTime), mFieldInstances);
+        mCapturedList.endFrame();
+        mRecordSeconds += secondsNow() - start;
+
+        _ThrowIfFailed(mCommandList->Close());
+
+        if (mCapture.capturedFrames() == captureFrameCount) {
+            const UINT frames = mCapture.capturedFrames();
+            const std::vector<UINT8> log = mCapture.takeLog();
+            if (!saveCommandLog(captureLogFile, log)) {
+                throw std::exception("Write command log failed.");
+            }
+            debugLog("Captured %u frames into %s, %.1f KB\n", frames, captureLogFile, log.size() / 1024.0);
+        }
+        if (++mFrameCount % captureFrameCount == 0) {
+            debugLog("Recording: %.3f ms per frame\n", mRecordSeconds * 1000.0 / captureFrameCount);
+            mRecordSeconds = 0.0;
+        }
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+    ComPtr<ID3D12DescriptorHeap> mDSVHeap;
+    ComPtr<ID3D12Resource> mDepthBuffer;
+
+    ComPtr<ID3D12Resource> mInstanceBuffer;
+
+    CommandCapture mCapture;
+    CapturedCommandList mCapturedList{ mCapture };
+    CubeFieldIds mIds = {};
+    std::vector<CubeInstance> mFieldInstances;
+    double mStartTime = 0.0;
+    UINT64 mFrameCount = 0;
+    double mRecordSeconds = 0.0;
+};
+
+
+ComPtr<ID3D12Device> createReplayDevice() {
+    ComPtr<IDXGIFactory4> factory;
+    _ThrowIfFailed(CreateDXGIFactory2(0, IID_PPV_ARGS(&factory)));
+
+    ComPtr<IDXGIAdapter1> adapter;
+    for (UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != factory->EnumAdapters1(adapterIndex, &adapter); adapterIndex++) {
+        DXGI_ADAPTER_DESC1 desc = {};
+        adapter->GetDesc1(&desc);
+        if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+            continue;
+        }
+
+        ComPtr<ID3D12Device> device;
+        _ThrowIfFailed(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(&device)));
+        return device;
+    }
+    throw std::exception("No hardware adapter to replay on.");
+}
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateCommandReplay(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkCommandReplay();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        // -replay=<file> replays a capture on the GPU, or on the null backend with -null.
+        const char* replay = strstr(lpCmdLine, "-replay=");
+        if (replay != nullptr) {
+            replay += strlen("-replay=");
+            std::string path(replay, strcspn(replay, " "));
+            std::vector<UINT8> log;
+            if (!loadCommandLog(path.c_str(), log)) {
+                throw std::exception("Open command log failed.");
+            }
+
+            const bool nullBackend = strstr(lpCmdLine, "-null") != nullptr;
+            ComPtr<ID3D12Device> device;
+            if (!nullBackend) {
+                device = createReplayDevice();
+            }
+            CommandCapture capture;
+            CommandReplayer replayer;
+            replayer.init(device.Get());
+            ReplayStats stats;
+            replayer.replay(log, capture, false, stats);
+            replayer.quit();
+
+            std::string report = formatReplayStats(nullBackend ? "the null backend" : "the GPU", stats);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+        if (strstr(lpCmdLine, "-capture") != nullptr) {
+            graphics.startCapture();
+        }
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_KEYDOWN && msg.wParam == 'C') {
+                    graphics.startCapture();
+                }
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
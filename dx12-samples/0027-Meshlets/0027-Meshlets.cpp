@@ -0,0 +1,1902 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <tuple>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0027-Meshlets";
+const char* windowClass = "0027-Meshlets";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Meshlet limits: 64 vertices and 124 triangles fit the common mesh shader output sizes
+const UINT meshletMaxVertices = 64;
+const UINT meshletMaxTriangles = 124;
+// No candidate triangle, and a vertex outside the meshlet being built
+const UINT meshletNoTriangle = UINT_MAX;
+const UINT8 meshletNoSlot = 0xff;
+// Objects on a square field the camera circles
+const UINT meshletObjectColumns = 5;
+const float meshletObjectSpacing = 3.5f;
+const float meshletFovY = 0.9f;
+// How often the culling statistics go to the debug output
+const UINT64 meshletReportFrames = 120;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+struct MeshData {
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<UINT> indices;
+};
+
+// Colour shaded once by a fixed light, so the meshes read as solid without normals.
+Vertex litVertex(const XMFLOAT3& position, const XMFLOAT3& normal, const XMFLOAT3& base, const XMFLOAT2& uv) {
+    const float lx = 0.4f, ly = 0.8f, lz = -0.45f;
+    float light = 0.35f + 0.65f * std::max(0.0f, normal.x * lx + normal.y * ly + normal.z * lz);
+    return Vertex{ position, XMFLOAT4(base.x * light, base.y * light, base.z * light, 1.0f), uv };
+}
+
+XMFLOAT3 subtract(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+XMFLOAT3 cross(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x); }
+float dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+float length(const XMFLOAT3& a) { return sqrtf(dot(a, a)); }
+
+// Row vector convention like DirectXMath: clip = (x, y, z, 1) * m. Left handed, so the
+// camera looks down +z of view space and clip w is the view depth.
+void makeViewProjection(const XMFLOAT3& eye, const XMFLOAT3& target, float fovY, float aspect, float nearZ, float farZ, float m[16]) {
+    auto normalize = [](XMFLOAT3 v) {
+        float l = length(v);
+        return XMFLOAT3(v.x / l, v.y / l, v.z / l);
+    };
+
+    XMFLOAT3 zAxis = normalize(XMFLOAT3(target.x - eye.x, target.y - eye.y, target.z - eye.z));
+    XMFLOAT3 xAxis = normalize(cross(XMFLOAT3(0.0f, 1.0f, 0.0f), zAxis));
+    XMFLOAT3 yAxis = cross(zAxis, xAxis);
+    const float view[16] = {
+        xAxis.x, yAxis.x, zAxis.x, 0.0f,
+        xAxis.y, yAxis.y, zAxis.y, 0.0f,
+        xAxis.z, yAxis.z, zAxis.z, 0.0f,
+        -dot(xAxis, eye), -dot(yAxis, eye), -dot(zAxis, eye), 1.0f
+    };
+    const float h = 1.0f / tanf(fovY * 0.5f);
+    const float w = h / aspect;
+    const float range = farZ / (farZ - nearZ);
+    const float projection[16] = {
+        w, 0.0f, 0.0f, 0.0f,
+        0.0f, h, 0.0f, 0.0f,
+        0.0f, 0.0f, range, 1.0f,
+        0.0f, 0.0f, -range * nearZ, 0.0f
+    };
+    for (UINT row = 0; row < 4; row++) {
+        for (UINT column = 0; column < 4; column++) {
+            float sum = 0.0f;
+            for (UINT k = 0; k < 4; k++) {
+                sum += view[row * 4 + k] * projection[k * 4 + column];
+            }
+            m[row * 4 + column] = sum;
+        }
+    }
+}
+
+// Triangles whose cross(b - a, c - a) points out of the surface, which the pipeline's
+// clockwise front faces draw from outside.
+XMFLOAT3 triangleNormal(const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c) {
+    return cross(subtract(b, a), subtract(c, a));
+}
+
+// A columns x rows grid over surface(u, v) for u and v in [0, 1], outward being the side
+// outside(u, v) points to. Normals are taken across neighbouring samples and each quad is
+// wound so its front faces outward.
+template<typename Surface, typename Outside>
+void appendSurface(MeshData& mesh, UINT columns, UINT rows, const XMFLOAT3& base, const Surface& surface, const Outside& outside) {
+    const UINT first = (UINT)mesh.vertices.size();
+    const float e = 1e-3f;
+    for (UINT y = 0; y <= rows; y++) {
+        for (UINT x = 0; x <= columns; x++) {
+            const float u = (float)x / columns, v = (float)y / rows;
+            XMFLOAT3 n = cross(subtract(surface(u + e, v), surface(u - e, v)), subtract(surface(u, v + e), surface(u, v - e)));
+            const float scale = (dot(n, outside(u, v)) < 0.0f ? -1.0f : 1.0f) / std::max(length(n), 1e-12f);
+            n = XMFLOAT3(n.x * scale, n.y * scale, n.z * scale);
+            mesh.vertices.push_back(litVertex(surface(u, v), n, base, XMFLOAT2(u * 8.0f, v * 4.0f)));
+        }
+    }
+    for (UINT y = 0; y < rows; y++) {
+        for (UINT x = 0; x < columns; x++) {
+            UINT a = first + y * (columns + 1) + x;
+            UINT b = a + columns + 1;
+            UINT quad[6] = { a, a + 1, b + 1, a, b + 1, b };
+            const float u = (x + 0.5f) / columns, v = (y + 0.5f) / rows;
+            if (dot(triangleNormal(mesh.vertices[a].pos, mesh.vertices[a + 1].pos, mesh.vertices[b + 1].pos), outside(u, v)) < 0.0f) {
+                std::swap(quad[1], quad[2]);
+                std::swap(quad[4], quad[5]);
+            }
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+// Closed surfaces with seams and degenerate pole triangles, a bumpy closed surface, and an
+// open heightfield.
+std::vector<MeshData> makeMeshletMeshes() {
+    const float pi = 3.14159265f;
+    std::vector<MeshData> meshes(4);
+
+    meshes[0].name = "sphere";
+    auto sphere = [pi](float u, float v) {
+        float theta = u * 2.0f * pi, phi = v * pi;
+        return XMFLOAT3(sinf(phi) * cosf(theta), cosf(phi), sinf(phi) * sinf(theta));
+    };
+    appendSurface(meshes[0], 128, 64, XMFLOAT3(0.9f, 0.9f, 0.95f), sphere, sphere);
+
+    meshes[1].name = "torus";
+    auto torus = [pi](float u, float v) {
+        float theta = u * 2.0f * pi, phi = v * 2.0f * pi;
+        return XMFLOAT3((0.7f + 0.3f * cosf(phi)) * cosf(theta), 0.3f * sinf(phi), (0.7f + 0.3f * cosf(phi)) * sinf(theta));
+    };
+    auto torusOutside = [pi](float u, float v) {
+        float theta = u * 2.0f * pi, phi = v * 2.0f * pi;
+        return XMFLOAT3(cosf(phi) * cosf(theta), sinf(phi), cosf(phi) * sinf(theta));
+    };
+    appendSurface(meshes[1], 192, 48, XMFLOAT3(1.0f, 0.75f, 0.4f), torus, torusOutside);
+
+    meshes[2].name = "rock";
+    auto rock = [pi, sphere](float u, float v) {
+        XMFLOAT3 n = sphere(u, v);
+        float r = 0.85f + 0.1f * sinf(n.x * 7.0f + n.y * 3.0f) * cosf(n.z * 5.0f) + 0.05f * sinf(n.y * 17.0f + n.z * 11.0f);
+        return XMFLOAT3(n.x * r, n.y * r, n.z * r);
+    };
+    appendSurface(meshes[2], 128, 64, XMFLOAT3(0.6f, 0.55f, 0.5f), rock, sphere);
+
+    meshes[3].name = "terrain";
+    auto terrain = [](float u, float v) {
+        float x = u * 2.0f - 1.0f, z = v * 2.0f - 1.0f;
+        return XMFLOAT3(x, 0.12f * sinf(x * 5.0f) * cosf(z * 4.0f) + 0.05f * sinf(x * 13.0f + z * 7.0f), z);
+    };
+    auto up = [](float, float) { return XMFLOAT3(0.0f, 1.0f, 0.0f); };
+    appendSurface(meshes[3], 96, 96, XMFLOAT3(0.45f, 0.8f, 0.4f), terrain, up);
+    return meshes;
+}
+
+// A meshlet's vertices are vertexCount entries of MeshletMesh::vertices from vertexOffset,
+// and its triangles triangleCount entries of MeshletMesh::triangles from triangleOffset.
+// The layout is what a mesh shader reads: 16 bytes per meshlet, a 32-bit vertex index per
+// meshlet vertex and one 32-bit word per triangle.
+struct Meshlet {
+    UINT vertexOffset;
+    UINT triangleOffset;
+    UINT vertexCount;
+    UINT triangleCount;
+};
+
+// A sphere around every vertex and a cone around every triangle normal. The meshlet faces
+// away from any eye where dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius.
+struct MeshletBounds {
+    XMFLOAT3 center;
+    float radius;
+    XMFLOAT3 coneAxis;
+    // Sine of the cone's half angle; 1 culls nothing, for normals spread over a half space.
+    float coneCutoff;
+};
+
+struct MeshletMesh {
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;
+    std::vector<UINT> vertices;
+    std::vector<UINT> triangles;
+    double seconds = 0.0;
+};
+
+// Three meshlet-local vertex indices, 10 bits each.
+UINT packMeshletTriangle(UINT a, UINT b, UINT c) { return a | b << 10 | c << 20; }
+UINT unpackMeshletIndex(UINT triangle, UINT corner) { return triangle >> (corner * 10) & 0x3ff; }
+
+// Greedy meshlet growth. A meshlet takes, among the triangles next to its vertices, the one
+// adding the fewest new vertices, then the one closest to its centroid and most in line with
+// its normals, so meshlets come out compact and with narrow cones. Used triangles are taken
+// out of the vertex adjacency as they go, which keeps the search to the meshlet's border.
+// A full meshlet hands over to a triangle on its border with the fewest live neighbours,
+// so the next one starts in a corner instead of leaving islands behind.
+class MeshletBuilder {
+public:
+    void build(const MeshData& mesh, MeshletMesh& out) {
+        double start = secondsNow();
+        out.meshlets.clear();
+        out.bounds.clear();
+        out.vertices.clear();
+        out.triangles.clear();
+        this->setup(mesh);
+
+        const UINT triangleCount = (UINT)(mesh.indices.size() / 3);
+        UINT seedCursor = 0;
+        for (UINT emitted = 0; emitted < triangleCount; ) {
+            UINT triangle = mTriangles.empty() ? this->seed(mesh, seedCursor) : this->bestNeighbour(mesh);
+            if (triangle == meshletNoTriangle) {
+                this->flush(mesh, out);
+                continue;
+            }
+            this->add(mesh, triangle);
+            emitted++;
+            if (mTriangles.size() == meshletMaxTriangles) {
+                this->flush(mesh, out);
+            }
+        }
+        if (!mTriangles.empty()) {
+            this->flush(mesh, out);
+        }
+        out.seconds = secondsNow() - start;
+    }
+
+private:
+    void setup(const MeshData& mesh) {
+        const UINT vertexCount = (UINT)mesh.vertices.size();
+        const UINT triangleCount = (UINT)(mesh.indices.size() / 3);
+        mAdjacencyOffsets.assign(vertexCount + 1, 0);
+        mLive.assign(vertexCount, 0);
+        for (UINT i = 0; i < triangleCount * 3; i++) {
+            if (mesh.indices[i] >= vertexCount) {
+                throw std::exception("Mesh index out of range.");
+            }
+            mLive[mesh.indices[i]]++;
+        }
+        for (UINT v = 0; v < vertexCount; v++) {
+            mAdjacencyOffsets[v + 1] = mAdjacencyOffsets[v] + mLive[v];
+            mLive[v] = 0;
+        }
+        mAdjacency.resize(triangleCount * 3);
+        for (UINT i = 0; i < triangleCount * 3; i++) {
+            UINT v = mesh.indices[i];
+            mAdjacency[mAdjacencyOffsets[v] + mLive[v]++] = i / 3;
+        }
+
+        mCentroids.resize(triangleCount);
+        mNormals.resize(triangleCount);
+        for (UINT t = 0; t < triangleCount; t++) {
+            const XMFLOAT3& a = mesh.vertices[mesh.indices[t * 3 + 0]].pos;
+            const XMFLOAT3& b = mesh.vertices[mesh.indices[t * 3 + 1]].pos;
+            const XMFLOAT3& c = mesh.vertices[mesh.indices[t * 3 + 2]].pos;
+            mCentroids[t] = XMFLOAT3((a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f);
+            XMFLOAT3 n = triangleNormal(a, b, c);
+            float l = length(n);
+            // Degenerate triangles have no direction and are left out of the cone.
+            mNormals[t] = l > 0.0f ? XMFLOAT3(n.x / l, n.y / l, n.z / l) : XMFLOAT3(0.0f, 0.0f, 0.0f);
+        }
+
+        mUsed.assign(triangleCount, 0);
+        mSlots.assign(vertexCount, meshletNoSlot);
+        mVertices.clear();
+        mTriangles.clear();
+        mPreviousVertices.clear();
+        mCentroidSum = XMFLOAT3(0.0f, 0.0f, 0.0f);
+        mNormalSum = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    }
+
+    UINT newVertices(const MeshData& mesh, UINT triangle) const {
+        const UINT* v = &mesh.indices[triangle * 3];
+        UINT extra = mSlots[v[0]] == meshletNoSlot ? 1 : 0;
+        extra += mSlots[v[1]] == meshletNoSlot && v[1] != v[0] ? 1 : 0;
+        extra += mSlots[v[2]] == meshletNoSlot && v[2] != v[0] && v[2] != v[1] ? 1 : 0;
+        return extra;
+    }
+
+    UINT seed(const MeshData& mesh, UINT& cursor) {
+        UINT best = meshletNoTriangle;
+        UINT bestLive = UINT_MAX;
+        for (UINT v : mPreviousVertices) {
+            for (UINT i = 0; i < mLive[v]; i++) {
+                UINT t = mAdjacency[mAdjacencyOffsets[v] + i];
+                const UINT* corners = &mesh.indices[t * 3];
+                UINT live = mLive[corners[0]] + mLive[corners[1]] + mLive[corners[2]];
+                if (live < bestLive) {
+                    best = t;
+                    bestLive = live;
+                }
+            }
+        }
+        if (best != meshletNoTriangle) {
+            return best;
+        }
+        while (mUsed[cursor]) {
+            cursor++;
+        }
+        return cursor;
+    }
+
+    UINT bestNeighbour(const MeshData& mesh) const {
+        const float count = (float)mTriangles.size();
+        const XMFLOAT3 centroid(mCentroidSum.x / count, mCentroidSum.y / count, mCentroidSum.z / count);
+        const float normalLength = length(mNormalSum);
+        const XMFLOAT3 axis = normalLength > 0.0f ? XMFLOAT3(mNormalSum.x / normalLength, mNormalSum.y / normalLength, mNormalSum.z / normalLength) : mNormalSum;
+
+        UINT best = meshletNoTriangle;
+        UINT bestPriority = UINT_MAX;
+        float bestScore = FLT_MAX;
+        for (UINT v : mVertices) {
+            for (UINT i = 0; i < mLive[v]; i++) {
+                UINT t = mAdjacency[mAdjacencyOffsets[v] + i];
+                UINT extra = this->newVertices(mesh, t);
+                if (mVertices.size() + extra > meshletMaxVertices) {
+                    continue;
+                }
+                // Triangles adding no vertex come first, then the last triangle of a vertex,
+                // which would otherwise be left to start a meshlet of its own.
+                const UINT* corners = &mesh.indices[t * 3];
+                UINT priority = extra == 0 ? 0 : mLive[corners[0]] == 1 || mLive[corners[1]] == 1 || mLive[corners[2]] == 1 ? 1 : extra + 1;
+                if (priority > bestPriority) {
+                    continue;
+                }
+                XMFLOAT3 d = subtract(mCentroids[t], centroid);
+                // Distance, stretched up to three times for triangles facing away from the cone.
+                float score = dot(d, d) * (2.0f - dot(mNormals[t], axis));
+                if (priority < bestPriority || score < bestScore) {
+                    best = t;
+                    bestPriority = priority;
+                    bestScore = score;
+                }
+            }
+        }
+        return best;
+    }
+
+    void add(const MeshData& mesh, UINT triangle) {
+        mUsed[triangle] = 1;
+        mTriangles.push_back(triangle);
+        for (UINT corner = 0; corner < 3; corner++) {
+            UINT v = mesh.indices[triangle * 3 + corner];
+            if (mSlots[v] == meshletNoSlot) {
+                mSlots[v] = (UINT8)mVertices.size();
+                mVertices.push_back(v);
+            }
+            // Take the triangle out of the vertex's live list; a degenerate triangle may be
+            // listed twice under the same vertex.
+            UINT* live = &mAdjacency[mAdjacencyOffsets[v]];
+            for (UINT i = 0; i < mLive[v]; ) {
+                if (live[i] == triangle) {
+                    live[i] = live[--mLive[v]];
+                }
+                else {
+                    i++;
+                }
+            }
+        }
+        mCentroidSum = XMFLOAT3(mCentroidSum.x + mCentroids[triangle].x, mCentroidSum.y + mCentroids[triangle].y, mCentroidSum.z + mCentroids[triangle].z);
+        mNormalSum = XMFLOAT3(mNormalSum.x + mNormals[triangle].x, mNormalSum.y + mNormals[triangle].y, mNormalSum.z + mNormals[triangle].z);
+    }
+
+    void flush(const MeshData& mesh, MeshletMesh& out) {
+        Meshlet meshlet = { (UINT)out.vertices.size(), (UINT)out.triangles.size(), (UINT)mVertices.size(), (UINT)mTriangles.size() };
+        out.meshlets.push_back(meshlet);
+        out.vertices.insert(out.vertices.end(), mVertices.begin(), mVertices.end());
+        for (UINT t : mTriangles) {
+            const UINT* v = &mesh.indices[t * 3];
+            out.triangles.push_back(packMeshletTriangle(mSlots[v[0]], mSlots[v[1]], mSlots[v[2]]));
+        }
+        out.bounds.push_back(this->bounds(mesh));
+
+        for (UINT v : mVertices) {
+            mSlots[v] = meshletNoSlot;
+        }
+        mPreviousVertices.swap(mVertices);
+        mVertices.clear();
+        mTriangles.clear();
+        mCentroidSum = XMFLOAT3(0.0f, 0.0f, 0.0f);
+        mNormalSum = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    }
+
+    // Ritter's sphere: the span between two far apart vertices, grown to take in the rest.
+    MeshletBounds bounds(const MeshData& mesh) const {
+        auto farthest = [&](const XMFLOAT3& from) {
+            UINT best = mVertices[0];
+            float bestDistance = -1.0f;
+            for (UINT v : mVertices) {
+                XMFLOAT3 d = subtract(mesh.vertices[v].pos, from);
+                if (dot(d, d) > bestDistance) {
+                    best = v;
+                    bestDistance = dot(d, d);
+                }
+            }
+            return mesh.vertices[best].pos;
+        };
+        const XMFLOAT3 a = farthest(mesh.vertices[mVertices[0]].pos);
+        const XMFLOAT3 b = farthest(a);
+        MeshletBounds bounds = {};
+        bounds.center = XMFLOAT3((a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f);
+        bounds.radius = length(subtract(b, a)) * 0.5f;
+        for (UINT v : mVertices) {
+            XMFLOAT3 d = subtract(mesh.vertices[v].pos, bounds.center);
+            float distance = length(d);
+            if (distance > bounds.radius) {
+                float radius = (bounds.radius + distance) * 0.5f;
+                float shift = (radius - bounds.radius) / distance;
+                bounds.center = XMFLOAT3(bounds.center.x + d.x * shift, bounds.center.y + d.y * shift, bounds.center.z + d.z * shift);
+                bounds.radius = radius;
+            }
+        }
+        // Rounding in the growth steps can leave a vertex a hair outside.
+        bounds.radius *= 1.0f + 1e-5f;
+
+        // The cone is only worth testing while every normal is within about 84 degrees of
+        // the axis; past that it would almost never cull.
+        bounds.coneCutoff = 1.0f;
+        const float normalLength = length(mNormalSum);
+        if (normalLength > 0.0f) {
+            bounds.coneAxis = XMFLOAT3(mNormalSum.x / normalLength, mNormalSum.y / normalLength, mNormalSum.z / normalLength);
+            float minDot = 1.0f;
+            for (UINT t : mTriangles) {
+                if (dot(mNormals[t], mNormals[t]) > 0.0f) {
+                    minDot = std::min(minDot, dot(mNormals[t], bounds.coneAxis));
+                }
+            }
+            if (minDot > 0.1f) {
+                bounds.coneCutoff = sqrtf(1.0f - minDot * minDot);
+            }
+        }
+        return bounds;
+    }
+
+    std::vector<UINT> mAdjacencyOffsets;
+    std::vector<UINT> mAdjacency;
+    std::vector<UINT> mLive;
+    std::vector<XMFLOAT3> mCentroids;
+    std::vector<XMFLOAT3> mNormals;
+    std::vector<UINT8> mUsed;
+    std::vector<UINT8> mSlots;
+    std::vector<UINT> mVertices;
+    std::vector<UINT> mTriangles;
+    std::vector<UINT> mPreviousVertices;
+    XMFLOAT3 mCentroidSum;
+    XMFLOAT3 mNormalSum;
+};
+
+// Builds every mesh's meshlets, one mesh per task on up to threadCount threads.
+void buildMeshletMeshes(const std::vector<MeshData>& meshes, UINT threadCount, std::vector<MeshletMesh>& out) {
+    out.resize(meshes.size());
+    std::atomic<UINT> next(0);
+    auto work = [&]() {
+        MeshletBuilder builder;
+        for (UINT mesh = next++; mesh < meshes.size(); mesh = next++) {
+            builder.build(meshes[mesh], out[mesh]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (UINT i = 1; i < std::min<UINT>(threadCount, (UINT)meshes.size()); i++) {
+        workers.push_back(std::thread(work));
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// The meshlets' triangles as a plain index buffer, in meshlet order, so meshlet m's indices
+// start at meshlets[m].triangleOffset * 3.
+void expandMeshletIndices(const MeshletMesh& mesh, std::vector<UINT>& indices) {
+    indices.clear();
+    for (const Meshlet& meshlet : mesh.meshlets) {
+        for (UINT t = 0; t < meshlet.triangleCount; t++) {
+            UINT triangle = mesh.triangles[meshlet.triangleOffset + t];
+            for (UINT corner = 0; corner < 3; corner++) {
+                indices.push_back(mesh.vertices[meshlet.vertexOffset + unpackMeshletIndex(triangle, corner)]);
+            }
+        }
+    }
+}
+
+struct Frustum {
+    XMFLOAT4 planes[6];
+};
+
+// From a row vector view-projection matrix, where clip = (x, y, z, 1) * m. Planes point
+// inward and are normalized, so plane distances compare against sphere radii.
+Frustum makeFrustum(const float m[16]) {
+    auto column = [m](UINT c) { return XMFLOAT4(m[c], m[4 + c], m[8 + c], m[12 + c]); };
+    auto add = [](const XMFLOAT4& a, const XMFLOAT4& b, float sign) { return XMFLOAT4(a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z, a.w + sign * b.w); };
+    const XMFLOAT4 x = column(0);
+    const XMFLOAT4 y = column(1);
+    const XMFLOAT4 z = column(2);
+    const XMFLOAT4 w = column(3);
+    Frustum frustum;
+    frustum.planes[0] = add(w, x, 1.0f);
+    frustum.planes[1] = add(w, x, -1.0f);
+    frustum.planes[2] = add(w, y, 1.0f);
+    frustum.planes[3] = add(w, y, -1.0f);
+    frustum.planes[4] = z;
+    frustum.planes[5] = add(w, z, -1.0f);
+    for (XMFLOAT4& p : frustum.planes) {
+        float l = sqrtf(p.x * p.x + p.y * p.y + p.z * p.z);
+        p = XMFLOAT4(p.x / l, p.y / l, p.z / l, p.w / l);
+    }
+    return frustum;
+}
+
+struct MeshletCullStats {
+    UINT64 meshlets = 0;
+    UINT64 frustumCulled = 0;
+    UINT64 coneCulled = 0;
+    UINT64 triangles = 0;
+    UINT64 drawnTriangles = 0;
+};
+
+// Which test, if any, removed a meshlet.
+enum MeshletCullResult {
+    MeshletVisible = 0,
+    MeshletFrustumCulled,
+    MeshletConeCulled,
+};
+
+// The CPU reference of a per-meshlet culling pass, for one object placed at position with a
+// uniform scale: each meshlet's sphere against the frustum, then its cone against the eye.
+// Appends the meshlets that survive to visible and, when results is given, records the
+// outcome of every meshlet in it.
+void cullMeshlets(const MeshletMesh& mesh, const XMFLOAT3& position, float scale, const Frustum& frustum, const XMFLOAT3& eye,
+    std::vector<UINT>& visible, MeshletCullStats& stats, std::vector<UINT8>* results = nullptr) {
+    if (results != nullptr) {
+        results->assign(mesh.meshlets.size(), MeshletVisible);
+    }
+    for (UINT m = 0; m < mesh.meshlets.size(); m++) {
+        const MeshletBounds& bounds = mesh.bounds[m];
+        const XMFLOAT3 center(bounds.center.x * scale + position.x, bounds.center.y * scale + position.y, bounds.center.z * scale + position.z);
+        const float radius = bounds.radius * scale;
+        stats.meshlets++;
+        stats.triangles += mesh.meshlets[m].triangleCount;
+
+        bool outside = false;
+        for (const XMFLOAT4& p : frustum.planes) {
+            outside = outside || p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius;
+        }
+        if (outside) {
+            stats.frustumCulled++;
+            if (results != nullptr) {
+                (*results)[m] = MeshletFrustumCulled;
+            }
+            continue;
+        }
+        const XMFLOAT3 toCenter = subtract(center, eye);
+        if (dot(toCenter, bounds.coneAxis) >= bounds.coneCutoff * length(toCenter) + radius) {
+            stats.coneCulled++;
+            if (results != nullptr) {
+                (*results)[m] = MeshletConeCulled;
+            }
+            continue;
+        }
+        visible.push_back(m);
+        stats.drawnTriangles += mesh.meshlets[m].triangleCount;
+    }
+}
+
+// Checks the meshlets of the standard meshes, with their triangles in the generated order and
+// shuffled: every triangle lands in exactly one meshlet within the limits, the bounds hold
+// every vertex and normal, and culling never drops a triangle that could be seen.
+bool simulateMeshlets(std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+    char line[256];
+
+    std::vector<MeshData> meshes = makeMeshletMeshes();
+    bool outward = true;
+    for (UINT mesh = 0; mesh < 3; mesh++) {
+        for (size_t i = 0; i < meshes[mesh].indices.size(); i += 3) {
+            const XMFLOAT3& a = meshes[mesh].vertices[meshes[mesh].indices[i + 0]].pos;
+            const XMFLOAT3& b = meshes[mesh].vertices[meshes[mesh].indices[i + 1]].pos;
+            const XMFLOAT3& c = meshes[mesh].vertices[meshes[mesh].indices[i + 2]].pos;
+            // Torus triangles face away from the ring's core circle rather than the origin.
+            XMFLOAT3 from(0.0f, 0.0f, 0.0f);
+            if (mesh == 1) {
+                float l = sqrtf(a.x * a.x + a.z * a.z);
+                from = XMFLOAT3(a.x / l * 0.7f, 0.0f, a.z / l * 0.7f);
+            }
+            // The pole triangles have no area and no direction to check.
+            XMFLOAT3 n = triangleNormal(a, b, c);
+            outward = outward && (length(n) < 1e-7f || dot(n, subtract(a, from)) >= 0.0f);
+        }
+    }
+    check(outward, "the closed meshes are wound to face outward");
+
+    // The same meshes with their triangles in random order: the builder should not lean on
+    // the input order for locality.
+    std::vector<MeshData> shuffled = meshes;
+    std::mt19937 random(7);
+    for (MeshData& mesh : shuffled) {
+        mesh.name += " shuffled";
+        std::vector<UINT> order(mesh.indices.size() / 3);
+        for (UINT t = 0; t < order.size(); t++) {
+            order[t] = t;
+        }
+        std::shuffle(order.begin(), order.end(), random);
+        std::vector<UINT> indices(mesh.indices.size());
+        for (UINT t = 0; t < order.size(); t++) {
+            // Rotating the corners keeps the winding.
+            for (UINT corner = 0; corner < 3; corner++) {
+                indices[t * 3 + corner] = mesh.indices[order[t] * 3 + (corner + t) % 3];
+            }
+        }
+        mesh.indices.swap(indices);
+    }
+    std::vector<MeshData> all = meshes;
+    all.insert(all.end(), shuffled.begin(), shuffled.end());
+    MeshData empty;
+    empty.name = "empty";
+    all.push_back(empty);
+
+    std::vector<MeshletMesh> built;
+    buildMeshletMeshes(all, 4, built);
+
+    bool complete = true;
+    bool limits = true;
+    bool contained = true;
+    bool coned = true;
+    for (UINT mesh = 0; mesh < all.size(); mesh++) {
+        const MeshData& source = all[mesh];
+        const MeshletMesh& meshlets = built[mesh];
+        // Each triangle rotated to start at its smallest index, so winding is compared too.
+        auto canonical = [](UINT a, UINT b, UINT c) {
+            if (b < a && b < c) {
+                return std::make_tuple(b, c, a);
+            }
+            if (c < a && c < b) {
+                return std::make_tuple(c, a, b);
+            }
+            return std::make_tuple(a, b, c);
+        };
+        std::vector<std::tuple<UINT, UINT, UINT>> expected;
+        for (size_t i = 0; i < source.indices.size(); i += 3) {
+            expected.push_back(canonical(source.indices[i], source.indices[i + 1], source.indices[i + 2]));
+        }
+        std::vector<UINT> indices;
+        expandMeshletIndices(meshlets, indices);
+        std::vector<std::tuple<UINT, UINT, UINT>> actual;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            actual.push_back(canonical(indices[i], indices[i + 1], indices[i + 2]));
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        complete = complete && expected == actual;
+
+        for (UINT m = 0; m < meshlets.meshlets.size(); m++) {
+            const Meshlet& meshlet = meshlets.meshlets[m];
+            const MeshletBounds& bounds = meshlets.bounds[m];
+            limits = limits && meshlet.vertexCount <= meshletMaxVertices && meshlet.triangleCount <= meshletMaxTriangles && meshlet.triangleCount > 0;
+            std::vector<UINT> vertices(meshlets.vertices.begin() + meshlet.vertexOffset, meshlets.vertices.begin() + meshlet.vertexOffset + meshlet.vertexCount);
+            for (UINT v : vertices) {
+                contained = contained && length(subtract(source.vertices[v].pos, bounds.center)) <= bounds.radius;
+            }
+            std::sort(vertices.begin(), vertices.end());
+            limits = limits && std::adjacent_find(vertices.begin(), vertices.end()) == vertices.end();
+            for (UINT t = 0; t < meshlet.triangleCount; t++) {
+                UINT triangle = meshlets.triangles[meshlet.triangleOffset + t];
+                XMFLOAT3 corners[3];
+                for (UINT corner = 0; corner < 3; corner++) {
+                    UINT local = unpackMeshletIndex(triangle, corner);
+                    limits = limits && local < meshlet.vertexCount;
+                    corners[corner] = source.vertices[meshlets.vertices[meshlet.vertexOffset + std::min(local, meshlet.vertexCount - 1)]].pos;
+                }
+                XMFLOAT3 n = triangleNormal(corners[0], corners[1], corners[2]);
+                if (bounds.coneCutoff < 1.0f && length(n) > 0.0f) {
+                    coned = coned && dot(n, bounds.coneAxis) / length(n) >= sqrtf(1.0f - bounds.coneCutoff * bounds.coneCutoff) - 1e-4f;
+                }
+            }
+        }
+    }
+    check(complete, "every triangle is in exactly one meshlet, wound as before");
+    check(limits, "meshlets keep to 64 vertices and 124 triangles, with distinct vertices");
+    check(contained, "bounding spheres hold every vertex of their meshlet");
+    check(coned, "normal cones hold every triangle normal of their meshlet");
+    check(built.back().meshlets.empty(), "an empty mesh has no meshlets");
+
+    // Fill and locality, in the generated order and shuffled. An 8 x 8 vertex patch of a grid
+    // holds 98 triangles, so on these meshes triangle fill tops out near 79%.
+    bool filled = true;
+    bool orderFree = true;
+    for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+        const MeshletMesh& ordered = built[mesh];
+        const MeshletMesh& reordered = built[mesh + meshes.size()];
+        double triangleFill = (double)ordered.triangles.size() / (ordered.meshlets.size() * meshletMaxTriangles);
+        double vertexFill = (double)ordered.vertices.size() / (ordered.meshlets.size() * meshletMaxVertices);
+        double shuffledFill = (double)reordered.triangles.size() / (reordered.meshlets.size() * meshletMaxTriangles);
+        snprintf(line, sizeof(line), "  %-8s %u meshlets, %.1f%% of triangles and %.1f%% of vertices filled, %u shuffled (%.1f%%)\n",
+            meshes[mesh].name.c_str(), (UINT)ordered.meshlets.size(), triangleFill * 100.0, vertexFill * 100.0, (UINT)reordered.meshlets.size(), shuffledFill * 100.0);
+        report += line;
+        filled = filled && vertexFill > 0.9 && triangleFill > 0.65;
+        orderFree = orderFree && reordered.meshlets.size() <= ordered.meshlets.size() * 1.1;
+    }
+    check(filled, "meshlets are at least 90% full of vertices and 65% full of triangles");
+    check(orderFree, "shuffled triangles make at most 10% more meshlets");
+
+    // Culling from cameras all around the meshes: a frustum culled meshlet lies wholly
+    // outside one plane, and a cone culled meshlet faces away in every triangle.
+    bool frustumSafe = true;
+    bool coneSafe = true;
+    MeshletCullStats stats;
+    for (UINT view = 0; view < 64; view++) {
+        const float angle = view * 0.7f;
+        const float distance = 1.5f + (view % 8) * 0.5f;
+        const XMFLOAT3 eye(distance * cosf(angle), 1.5f * sinf(view * 1.3f), distance * sinf(angle));
+        const XMFLOAT3 target(0.3f * sinf(view * 2.1f), 0.0f, 0.3f * cosf(view * 1.7f));
+        float viewProjection[16];
+        makeViewProjection(eye, target, meshletFovY, 4.0f / 3.0f, 0.1f, 100.0f, viewProjection);
+        const Frustum frustum = makeFrustum(viewProjection);
+        for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+            const MeshletMesh& meshlets = built[mesh];
+            const MeshData& source = meshes[mesh];
+            std::vector<UINT> visible;
+            std::vector<UINT8> results;
+            cullMeshlets(meshlets, XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f, frustum, eye, visible, stats, &results);
+            for (UINT m = 0; m < meshlets.meshlets.size(); m++) {
+                const Meshlet& meshlet = meshlets.meshlets[m];
+                if (results[m] == MeshletFrustumCulled) {
+                    bool outsideOne = false;
+                    for (const XMFLOAT4& p : frustum.planes) {
+                        bool outsideAll = true;
+                        for (UINT v = 0; v < meshlet.vertexCount; v++) {
+                            const XMFLOAT3& q = source.vertices[meshlets.vertices[meshlet.vertexOffset + v]].pos;
+                            outsideAll = outsideAll && p.x * q.x + p.y * q.y + p.z * q.z + p.w < 0.0f;
+                        }
+                        outsideOne = outsideOne || outsideAll;
+                    }
+                    frustumSafe = frustumSafe && outsideOne;
+                }
+                else if (results[m] == MeshletConeCulled) {
+                    for (UINT t = 0; t < meshlet.triangleCount; t++) {
+                        UINT triangle = meshlets.triangles[meshlet.triangleOffset + t];
+                        const XMFLOAT3& a = source.vertices[meshlets.vertices[meshlet.vertexOffset + unpackMeshletIndex(triangle, 0)]].pos;
+                        const XMFLOAT3& b = source.vertices[meshlets.vertices[meshlet.vertexOffset + unpackMeshletIndex(triangle, 1)]].pos;
+                        const XMFLOAT3& c = source.vertices[meshlets.vertices[meshlet.vertexOffset + unpackMeshletIndex(triangle, 2)]].pos;
+                        coneSafe = coneSafe && dot(triangleNormal(a, b, c), subtract(a, eye)) >= 0.0f;
+                    }
+                }
+            }
+        }
+    }
+    check(frustumSafe, "frustum culled meshlets lie wholly outside one plane");
+    check(coneSafe, "cone culled meshlets face away in every triangle");
+    check(stats.coneCulled > 0 && stats.frustumCulled > 0, "both tests cull something");
+    snprintf(line, sizeof(line), "  64 views: %.1f%% of meshlets frustum culled, %.1f%% cone culled, %.1f%% of triangles drawn\n",
+        100.0 * stats.frustumCulled / stats.meshlets, 100.0 * stats.coneCulled / stats.meshlets, 100.0 * stats.drawnTriangles / stats.triangles);
+    report += line;
+    return passed;
+}
+
+// Build throughput, fill, and what the CPU reference culling costs and saves against
+// per-triangle backface culling, from cameras orbiting each mesh.
+std::string benchmarkMeshlets() {
+    std::vector<MeshData> meshes = makeMeshletMeshes();
+    // Larger copies of the standard set, for throughput on meshes of a realistic size.
+    const UINT copies = 8;
+    std::vector<MeshData> large;
+    for (UINT copy = 0; copy < copies; copy++) {
+        for (const MeshData& mesh : meshes) {
+            large.push_back(mesh);
+        }
+    }
+    UINT64 largeTriangles = 0;
+    for (const MeshData& mesh : large) {
+        largeTriangles += mesh.indices.size() / 3;
+    }
+
+    std::string report = "Meshlets (64 vertices, 124 triangles):\n";
+    char line[256];
+    std::vector<MeshletMesh> built;
+    const UINT threadCounts[2] = { 1, std::max(1u, std::thread::hardware_concurrency()) };
+    for (UINT threads : threadCounts) {
+        double start = secondsNow();
+        buildMeshletMeshes(large, threads, built);
+        double seconds = secondsNow() - start;
+        snprintf(line, sizeof(line), "  build on %2u threads: %.1f ms for %.1fM triangles, %.2fM triangles/s\n",
+            threads, seconds * 1000.0, largeTriangles / 1e6, largeTriangles / seconds / 1e6);
+        report += line;
+    }
+
+    for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+        const MeshletMesh& meshlets = built[mesh];
+        const UINT triangles = (UINT)(meshes[mesh].indices.size() / 3);
+        UINT coned = 0;
+        for (const MeshletBounds& bounds : meshlets.bounds) {
+            coned += bounds.coneCutoff < 1.0f ? 1 : 0;
+        }
+        const size_t packedBytes = meshlets.meshlets.size() * (sizeof(Meshlet) + sizeof(MeshletBounds)) + meshlets.vertices.size() * sizeof(UINT) + meshlets.triangles.size() * sizeof(UINT);
+        snprintf(line, sizeof(line), "  %-8s %6u triangles, %4u meshlets: %.1f%% triangle fill, %.1f%% vertex fill, %.1f%% with a cone, %.2f bytes per triangle packed (%.1f ms)\n",
+            meshes[mesh].name.c_str(), triangles, (UINT)meshlets.meshlets.size(),
+            100.0 * meshlets.triangles.size() / (meshlets.meshlets.size() * meshletMaxTriangles),
+            100.0 * meshlets.vertices.size() / (meshlets.meshlets.size() * meshletMaxVertices),
+            100.0 * coned / meshlets.meshlets.size(), (double)packedBytes / triangles, meshlets.seconds * 1000.0);
+        report += line;
+    }
+
+    // Cameras orbiting the mesh, looking at it, so only the cone test culls much.
+    const UINT views = 256;
+    MeshletCullStats stats;
+    UINT64 backfacing = 0;
+    std::vector<UINT> visible;
+    double cullSeconds = 0.0;
+    for (UINT view = 0; view < views; view++) {
+        const float angle = view * 0.37f;
+        const XMFLOAT3 eye(3.0f * cosf(angle), 1.5f * sinf(view * 0.11f), 3.0f * sinf(angle));
+        float viewProjection[16];
+        makeViewProjection(eye, XMFLOAT3(0.0f, 0.0f, 0.0f), meshletFovY, 4.0f / 3.0f, 0.1f, 100.0f, viewProjection);
+        const Frustum frustum = makeFrustum(viewProjection);
+        for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+            visible.clear();
+            double start = secondsNow();
+            cullMeshlets(built[mesh], XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f, frustum, eye, visible, stats);
+            cullSeconds += secondsNow() - start;
+            const MeshData& source = meshes[mesh];
+            for (size_t i = 0; i < source.indices.size(); i += 3) {
+                const XMFLOAT3& a = source.vertices[source.indices[i]].pos;
+                const XMFLOAT3& b = source.vertices[source.indices[i + 1]].pos;
+                const XMFLOAT3& c = source.vertices[source.indices[i + 2]].pos;
+                backfacing += dot(triangleNormal(a, b, c), subtract(a, eye)) >= 0.0f ? 1 : 0;
+            }
+        }
+    }
+    snprintf(line, sizeof(line),
+        "  culling over %u orbiting views: %.1f%% of meshlets frustum culled, %.1f%% cone culled, %.1f%% of triangles drawn\n"
+        "  per-triangle backface culling would draw %.1f%%; %.1f ns per meshlet tested\n",
+        views, 100.0 * stats.frustumCulled / stats.meshlets, 100.0 * stats.coneCulled / stats.meshlets,
+        100.0 * stats.drawnTriangles / stats.triangles, 100.0 - 100.0 * backfacing / stats.triangles, cullSeconds * 1e9 / stats.meshlets);
+    report += line;
+    return report;
+}
+
+struct MeshletObject {
+    UINT mesh;
+    // Where the object's mesh starts in the shared vertex buffer
+    UINT baseVertex;
+    XMFLOAT3 position;
+    float scale;
+};
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+        // Create Depth Buffer
+        {
+            D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
+            dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+            dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+            dsvHeapDesc.NumDescriptors = 1;
+            _ThrowIfFailed(mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&mDSVHeap)));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+            D3D12_RESOURCE_DESC depthDesc = {};
+            depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            depthDesc.Width = windowWidth;
+            depthDesc.Height = windowHeight;
+            depthDesc.DepthOrArraySize = 1;
+            depthDesc.MipLevels = 1;
+            depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+            depthDesc.SampleDesc.Count = 1;
+            depthDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+            D3D12_CLEAR_VALUE clearValue = {};
+            clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+            clearValue.DepthStencil.Depth = 1.0f;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &depthDesc,
+                D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                &clearValue,
+                IID_PPV_ARGS(&mDepthBuffer)));
+            mDevice->CreateDepthStencilView(mDepthBuffer.Get(), nullptr, mDSVHeap->GetCPUDescriptorHandleForHeapStart());
+        }
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.0f;
+            mViewport.MaxDepth = 1.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        mStartTime = secondsNow();
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
+
+    void tick(float delta) {
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[1] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = 16;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = 1;
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/014-mesh-lod.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/014-mesh-lod.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            // Every mesh faces outward and the camera stays above the terrain.
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = TRUE;
+            psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+            psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+            psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        // Build Meshlets, one mesh per thread
+        std::vector<MeshData> meshes = makeMeshletMeshes();
+        {
+            double start = secondsNow();
+            buildMeshletMeshes(meshes, std::max(1u, std::thread::hardware_concurrency()), mMeshlets);
+            debugLog("Meshlets built in %.1f ms\n", (secondsNow() - start) * 1000.0);
+            for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+                const MeshletMesh& meshlets = mMeshlets[mesh];
+                debugLog("  %s: %u triangles in %u meshlets, %.1f%% triangle fill, %.1f%% vertex fill\n", meshes[mesh].name.c_str(),
+                    (UINT)meshlets.triangles.size(), (UINT)meshlets.meshlets.size(),
+                    100.0 * meshlets.triangles.size() / std::max<size_t>(meshlets.meshlets.size() * meshletMaxTriangles, 1),
+                    100.0 * meshlets.vertices.size() / std::max<size_t>(meshlets.meshlets.size() * meshletMaxVertices, 1));
+            }
+        }
+
+        // All meshes share one vertex buffer. Each mesh keeps its triangles in meshlet order
+        // on the CPU, so a visible meshlet is one contiguous run of indices to copy.
+        std::vector<Vertex> vertices;
+        std::vector<UINT> baseVertices(meshes.size());
+        mMeshletIndices.resize(meshes.size());
+        for (UINT mesh = 0; mesh < meshes.size(); mesh++) {
+            baseVertices[mesh] = (UINT)vertices.size();
+            vertices.insert(vertices.end(), meshes[mesh].vertices.begin(), meshes[mesh].vertices.end());
+            expandMeshletIndices(mMeshlets[mesh], mMeshletIndices[mesh]);
+        }
+
+        // A square of objects, the mesh kinds cycling along each row.
+        for (UINT row = 0; row < meshletObjectColumns; row++) {
+            for (UINT column = 0; column < meshletObjectColumns; column++) {
+                MeshletObject object = {};
+                object.mesh = (row + column) % meshes.size();
+                object.baseVertex = baseVertices[object.mesh];
+                object.position = XMFLOAT3((column - (meshletObjectColumns - 1) * 0.5f) * meshletObjectSpacing, 0.0f,
+                    (row - (meshletObjectColumns - 1) * 0.5f) * meshletObjectSpacing);
+                object.scale = 1.2f;
+                mObjects.push_back(object);
+                mIndexRegionSize += mMeshletIndices[object.mesh].size();
+            }
+        }
+
+        // Create Vertex Buffer
+        {
+            const UINT vertexBufferSize = (UINT)(vertices.size() * sizeof(Vertex));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = vertexBufferSize;
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, vertices.data(), vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer, one region per frame in flight that holds every object's
+        // triangles, mapped for good
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = (UINT64)frameBufferCount * mIndexRegionSize * sizeof(UINT);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, (void**)&mIndices));
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0xc0;    // R
+                        pData[n + 1] = 0xc0;    // G
+                        pData[n + 2] = 0xc0;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    void toggleCulling() {
+        mCulling = !mCulling;
+        debugLog("Meshlet culling %s\n", mCulling ? "on" : "off");
+    }
+
+    // Culls every object's meshlets against the camera and copies the indices of the
+    // survivors into this frame's index region, which the GPU finished reading when
+    // waitForNextFrame returned, then draws each object's run of them. With culling off every
+    // meshlet is copied, so both modes pay for the same upload.
+    void drawObjects() {
+        float time = (float)(secondsNow() - mStartTime);
+        const float fieldSize = meshletObjectColumns * meshletObjectSpacing;
+        const float angle = time * 0.2f;
+        // The camera circles the field looking ahead of itself, so objects keep entering and
+        // leaving the frustum while the cones cull the sides facing away.
+        XMFLOAT3 eye(fieldSize * 0.7f * cosf(angle), fieldSize * 0.3f, fieldSize * 0.7f * sinf(angle));
+        XMFLOAT3 target(fieldSize * 0.3f * cosf(angle + 1.2f), 0.0f, fieldSize * 0.3f * sinf(angle + 1.2f));
+        float m[16];
+        makeViewProjection(eye, target, meshletFovY, windowWidth / (float)windowHeight, 0.1f, 500.0f, m);
+        const Frustum frustum = makeFrustum(m);
+        XMFLOAT4X4 viewProjectionMatrix(m);
+        XMMATRIX viewProjection = XMLoadFloat4x4(&viewProjectionMatrix);
+
+        D3D12_INDEX_BUFFER_VIEW indexBufferView = {};
+        indexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress() + (UINT64)mFrameBufferIndex * mIndexRegionSize * sizeof(UINT);
+        indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+        indexBufferView.SizeInBytes = (UINT)(mIndexRegionSize * sizeof(UINT));
+        mCommandList->IASetIndexBuffer(&indexBufferView);
+
+        double start = secondsNow();
+        UINT* indices = mIndices + (UINT64)mFrameBufferIndex * mIndexRegionSize;
+        UINT indexCount = 0;
+        for (const MeshletObject& object : mObjects) {
+            const MeshletMesh& meshlets = mMeshlets[object.mesh];
+            const std::vector<UINT>& source = mMeshletIndices[object.mesh];
+            mVisible.clear();
+            if (mCulling) {
+                cullMeshlets(meshlets, object.position, object.scale, frustum, eye, mVisible, mStats);
+            }
+            else {
+                for (UINT i = 0; i < meshlets.meshlets.size(); i++) {
+                    mVisible.push_back(i);
+                }
+            }
+
+            // Neighbouring visible meshlets are neighbouring index runs; copy each span at once.
+            const UINT first = indexCount;
+            for (UINT i = 0; i < mVisible.size(); ) {
+                UINT end = i + 1;
+                while (end < mVisible.size() && mVisible[end] == mVisible[end - 1] + 1) {
+                    end++;
+                }
+                const Meshlet& begin = meshlets.meshlets[mVisible[i]];
+                const Meshlet& last = meshlets.meshlets[mVisible[end - 1]];
+                const UINT count = (last.triangleOffset + last.triangleCount - begin.triangleOffset) * 3;
+                memcpy(indices + indexCount, source.data() + begin.triangleOffset * 3, count * sizeof(UINT));
+                indexCount += count;
+                i = end;
+            }
+            mDrawnTriangles += (indexCount - first) / 3;
+            mTotalTriangles += source.size() / 3;
+            if (indexCount == first) {
+                continue;
+            }
+
+            XMMATRIX world = XMMatrixMultiply(XMMatrixScaling(object.scale, object.scale, object.scale),
+                XMMatrixTranslation(object.position.x, object.position.y, object.position.z));
+            XMFLOAT4X4 constants;
+            XMStoreFloat4x4(&constants, XMMatrixTranspose(XMMatrixMultiply(world, viewProjection)));
+            mCommandList->SetGraphicsRoot32BitConstants(1, 16, &constants, 0);
+            mCommandList->DrawIndexedInstanced(indexCount - first, 1, first, object.baseVertex, 0);
+        }
+        mCullSeconds += secondsNow() - start;
+
+        if (++mFrameCount % meshletReportFrames == 0) {
+            debugLog("Meshlet culling %s: %.1f%% of triangles drawn, %.1f%% of meshlets frustum culled, %.1f%% cone culled, %.3f ms per frame\n",
+                mCulling ? "on" : "off", 100.0 * mDrawnTriangles / std::max<UINT64>(mTotalTriangles, 1),
+                100.0 * mStats.frustumCulled / std::max<UINT64>(mStats.meshlets, 1), 100.0 * mStats.coneCulled / std::max<UINT64>(mStats.meshlets, 1),
+                mCullSeconds * 1000.0 / meshletReportFrames);
+            mStats = MeshletCullStats();
+            mCullSeconds = 0.0;
+            mDrawnTriangles = 0;
+            mTotalTriangles = 0;
+        }
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &onBegin);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle{ mDSVHeap->GetCPUDescriptorHandleForHeapStart() };
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        mCommandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        this->drawObjects();
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    UINT* mIndices = nullptr;
+    UINT64 mIndexRegionSize = 0;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+    ComPtr<ID3D12DescriptorHeap> mDSVHeap;
+    ComPtr<ID3D12Resource> mDepthBuffer;
+
+    std::vector<MeshletMesh> mMeshlets;
+    std::vector<std::vector<UINT>> mMeshletIndices;
+    std::vector<MeshletObject> mObjects;
+    std::vector<UINT> mVisible;
+    bool mCulling = true;
+    MeshletCullStats mStats;
+    double mCullSeconds = 0.0;
+    double mStartTime = 0.0;
+    UINT64 mFrameCount = 0;
+    UINT64 mDrawnTriangles = 0;
+    UINT64 mTotalTriangles = 0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string report;
+            bool passed = simulateMeshlets(report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+        if (strstr(lpCmdLine, "-benchmark") != nullptr) {
+            std::string report = benchmarkMeshlets();
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return 0;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_KEYDOWN && msg.wParam == 'M') {
+                    graphics.toggleCulling();
+                }
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
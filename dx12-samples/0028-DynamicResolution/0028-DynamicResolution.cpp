@@ -0,0 +1,1568 @@
+﻿// // 包含 SDKDDKVer.h 可定义可用的最高版本的 Windows 平台。
+// 如果希望为之前的 Windows 平台构建应用程序，在包含 SDKDDKVer.h 之前请先包含 WinSDKVer.h 并
+// 将 _WIN32_WINNT 宏设置为想要支持的平台。
+#include <SDKDDKVer.h>
+
+// 从 Windows 头文件中排除极少使用的内容
+#define WIN32_LEAN_AND_MEAN             
+#define NOMINMAX
+
+// Windows 头文件
+#include <windows.h>
+#include <strsafe.h>
+#include <comdef.h>
+#include <wrl.h>
+using namespace Microsoft;
+using namespace Microsoft::WRL;
+
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+using namespace DirectX;
+
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <d3dcompiler.h>
+
+#include "include/d3dx12/d3dx12.h"
+
+#pragma comment(lib, "dxguid.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d12.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+#if defined(_DEBUG)
+#include <dxgidebug.h>
+#endif
+
+// C 运行时头文件
+#include <stdlib.h>
+#include <malloc.h>
+#include <memory.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <tchar.h>
+#include <string>
+#include <exception>
+#include <vector>
+#include <map>
+#include <codecvt>
+#include <algorithm>
+#include <atomic>
+#include <random>
+
+class HRException : public std::exception
+{
+public:
+    HRException(HRESULT hr)
+        : std::exception(), m_error(hr)
+    {
+        const wchar_t* wcs = m_error.ErrorMessage();
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> convertor;
+        std::string mbs = convertor.to_bytes(wcs);
+        m_what = mbs;
+    }
+
+    const char* what() const noexcept override
+    {
+        return m_what.c_str();
+    }
+
+private:
+    _com_error m_error;
+    std::string m_what;
+};
+
+
+#define _ThrowIfFailed(hr) { HRESULT ret = (hr); if(FAILED(ret)) throw HRException(ret); }
+
+// 全局变量:
+HINSTANCE hInst;
+const char* windowTitle = "0028-DynamicResolution";
+const char* windowClass = "0028-DynamicResolution";
+const int windowWidth = 800;
+const int windowHeight = 600;
+
+const UINT frameBufferCount = 2;
+
+// Rounds of per-pixel work in the scene shader, cycled with L to load the GPU
+const UINT sceneLoads[] = { 0, 64, 256, 1024 };
+// Spinning cubes filling the view
+const UINT cubeColumns = 7;
+const UINT cubeRows = 5;
+// How often the resolution statistics go to the debug output
+const UINT64 resolutionReportFrames = 120;
+
+double secondsNow()
+{
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / (double)frequency.QuadPart;
+}
+
+struct Vertex {
+    XMFLOAT3 pos;
+    XMFLOAT4 color;
+    XMFLOAT2 uv;
+};
+
+// Root constants of the scene pass; the upscale pass reuses the first four values.
+struct SceneConstants {
+    XMFLOAT4X4 worldViewProjection;
+    UINT load;
+};
+
+void debugLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    OutputDebugStringA(buffer);
+}
+
+// One frame's measured cost: CPU time to record and submit it, GPU time between the
+// timestamps around its passes, and the render scale it was drawn at.
+struct FrameTiming {
+    float cpuMs;
+    float gpuMs;
+    float scale;
+};
+
+struct ResolutionSettings {
+    // Frame budget and the GPU time aimed for inside it, leaving headroom for noise
+    float budgetMs = 1000.0f / 60.0f;
+    float targetMs = 1000.0f / 60.0f * 0.8f;
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    // Velocity form PID gains on the log of target over GPU time, acting on log pixel count
+    float kp = 0.2f;
+    float ki = 0.3f;
+    float kd = 0.05f;
+    // Per frame limit on growing log pixel count; shrinking is not limited, so a spike is
+    // answered at once and recovery is gradual
+    float maxGrowth = 0.03f;
+    // Errors within about this fraction of the target leave the scale alone
+    float deadBand = 0.1f;
+    // The render size only changes once the controller has moved this far from it
+    float minScaleChange = 0.04f;
+    // Weight of the newest sample in the smoothed GPU and CPU times
+    float smoothing = 0.35f;
+};
+
+// Picks the render scale from frame timings. The GPU time, smoothed, is compared with the
+// target and a PID controller moves the log of the pixel count, which GPU time roughly
+// follows, so the same gains work at any scale. Hysteresis comes twice: inside the dead
+// band the controller holds, and the scale applied to the render target only changes once
+// the controller has moved past minScaleChange from it. Frames bound by the CPU are left
+// alone, as a smaller render target would not make them shorter.
+class ResolutionController {
+public:
+    explicit ResolutionController(const ResolutionSettings& settings = ResolutionSettings())
+        : mSettings(settings) {
+        this->reset();
+    }
+
+    void reset() {
+        mLogPixels = logf(mSettings.maxScale * mSettings.maxScale);
+        mScale = mSettings.maxScale;
+        mGpuMs = 0.0f;
+        mCpuMs = 0.0f;
+        mError = 0.0f;
+        mPreviousError = 0.0f;
+        mFrames = 0;
+    }
+
+    // Feeds one frame's timing and returns the scale to render the next frame at.
+    float update(const FrameTiming& timing) {
+        const float a = mFrames == 0 ? 1.0f : mSettings.smoothing;
+        mGpuMs += (timing.gpuMs - mGpuMs) * a;
+        mCpuMs += (timing.cpuMs - mCpuMs) * a;
+        mFrames++;
+
+        const float error = logf(mSettings.targetMs / std::max(mGpuMs, 0.01f));
+        const float previous = mError;
+        const float beforePrevious = mPreviousError;
+        mPreviousError = mError;
+        mError = error;
+        if (mCpuMs > mSettings.budgetMs && mCpuMs > mGpuMs) {
+            return mScale;
+        }
+        if (fabsf(error) < mSettings.deadBand) {
+            return mScale;
+        }
+
+        float step = mSettings.kp * (error - previous) + mSettings.ki * error + mSettings.kd * (error - 2.0f * previous + beforePrevious);
+        step = std::min(step, mSettings.maxGrowth);
+        const float minLog = logf(mSettings.minScale * mSettings.minScale);
+        const float maxLog = logf(mSettings.maxScale * mSettings.maxScale);
+        mLogPixels = std::min(std::max(mLogPixels + step, minLog), maxLog);
+
+        const float scale = expf(mLogPixels * 0.5f);
+        // The limits are always reachable, whatever the minimum change.
+        const bool atLimit = (scale <= mSettings.minScale * 1.0001f || scale >= mSettings.maxScale * 0.9999f) && scale != mScale;
+        if (fabsf(scale - mScale) >= mSettings.minScaleChange || atLimit) {
+            mScale = std::min(std::max(scale, mSettings.minScale), mSettings.maxScale);
+        }
+        return mScale;
+    }
+
+    float scale() const { return mScale; }
+    float smoothedGpuMs() const { return mGpuMs; }
+    float smoothedCpuMs() const { return mCpuMs; }
+    const ResolutionSettings& settings() const { return mSettings; }
+
+private:
+    ResolutionSettings mSettings;
+    float mLogPixels;
+    float mScale;
+    float mGpuMs;
+    float mCpuMs;
+    float mError;
+    float mPreviousError;
+    UINT64 mFrames;
+};
+
+// Render target size for a scale, in whole multiples of 8 pixels so neighbouring scales do
+// not land on sizes differing by a pixel or two.
+void scaledSize(float scale, UINT width, UINT height, UINT& scaledWidth, UINT& scaledHeight) {
+    scaledWidth = std::max(8u, std::min(width, (UINT)(width * scale / 8.0f + 0.5f) * 8));
+    scaledHeight = std::max(8u, std::min(height, (UINT)(height * scale / 8.0f + 0.5f) * 8));
+}
+
+// Frame timings as text, one "cpu gpu scale" line per frame, so traces recorded by the sample
+// can be edited and replayed.
+void saveFrameTrace(const std::string& path, const std::vector<FrameTiming>& trace) {
+    FILE* fd = NULL;
+    fopen_s(&fd, path.c_str(), "wb");
+    if (fd == NULL) {
+        throw std::exception("Open frame trace for writing failed.");
+    }
+    for (const FrameTiming& timing : trace) {
+        fprintf(fd, "%.4f %.4f %.4f\n", timing.cpuMs, timing.gpuMs, timing.scale);
+    }
+    fclose(fd);
+}
+
+std::vector<FrameTiming> loadFrameTrace(const std::string& path) {
+    FILE* fd = NULL;
+    fopen_s(&fd, path.c_str(), "rb");
+    if (fd == NULL) {
+        throw std::exception("Open frame trace failed.");
+    }
+    std::vector<FrameTiming> trace;
+    FrameTiming timing = {};
+    while (fscanf_s(fd, "%f %f %f", &timing.cpuMs, &timing.gpuMs, &timing.scale) == 3) {
+        if (timing.scale <= 0.0f || timing.cpuMs < 0.0f || timing.gpuMs < 0.0f) {
+            fclose(fd);
+            throw std::exception("The frame trace has an invalid frame.");
+        }
+        trace.push_back(timing);
+    }
+    fclose(fd);
+    return trace;
+}
+
+struct ResolutionRun {
+    UINT frames = 0;
+    UINT overBudget = 0;
+    UINT scaleChanges = 0;
+    // Changes of direction, a sign of oscillation
+    UINT reversals = 0;
+    float meanScale = 0.0f;
+    float minScale = 1.0f;
+    // Frames from the first over-budget frame until the GPU time is back under budget
+    UINT worstRecovery = 0;
+    std::vector<float> scales;
+    std::vector<float> gpuMs;
+};
+
+// Runs the controller in closed loop over a trace. Each frame's GPU time is taken back to
+// full resolution and replayed at the scale the controller chose, with pixelFraction of it
+// following the pixel count and the rest fixed. The controller sees each timing
+// latencyFrames late, as it would with that many frames in flight.
+ResolutionRun runResolutionTrace(const std::vector<FrameTiming>& trace, const ResolutionSettings& settings, float pixelFraction, UINT latencyFrames) {
+    ResolutionController controller(settings);
+    ResolutionRun run;
+    std::vector<FrameTiming> measured;
+    float scale = controller.scale();
+    float lastDirection = 0.0f;
+    UINT overRun = 0;
+    for (const FrameTiming& recorded : trace) {
+        const float cost = pixelFraction * scale * scale + (1.0f - pixelFraction);
+        const float recordedCost = pixelFraction * recorded.scale * recorded.scale + (1.0f - pixelFraction);
+        FrameTiming timing = { recorded.cpuMs, recorded.gpuMs / recordedCost * cost, scale };
+        measured.push_back(timing);
+
+        run.frames++;
+        run.meanScale += scale;
+        run.minScale = std::min(run.minScale, scale);
+        run.scales.push_back(scale);
+        run.gpuMs.push_back(timing.gpuMs);
+        if (std::max(timing.gpuMs, timing.cpuMs) > settings.budgetMs) {
+            run.overBudget++;
+        }
+        overRun = timing.gpuMs > settings.budgetMs ? overRun + 1 : 0;
+        run.worstRecovery = std::max(run.worstRecovery, overRun);
+
+        if (measured.size() > latencyFrames) {
+            const float next = controller.update(measured[measured.size() - 1 - latencyFrames]);
+            if (next != scale) {
+                const float direction = next > scale ? 1.0f : -1.0f;
+                run.reversals += direction * lastDirection < 0.0f ? 1 : 0;
+                lastDirection = direction;
+                run.scaleChanges++;
+                scale = next;
+            }
+        }
+    }
+    run.meanScale /= std::max(1u, run.frames);
+    return run;
+}
+
+// Synthetic traces at full resolution: a base GPU cost with spikes, ramps and noise, and a
+// steady CPU cost. Seeded, so the same trace comes out every time.
+std::vector<FrameTiming> makeFrameTrace(UINT frames, float cpuMs, float gpuMs, float noise, UINT seed) {
+    std::vector<FrameTiming> trace(frames);
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> jitter(-noise, noise);
+    for (FrameTiming& timing : trace) {
+        timing.cpuMs = cpuMs * (1.0f + jitter(random) * 0.5f);
+        timing.gpuMs = gpuMs * (1.0f + jitter(random));
+        timing.scale = 1.0f;
+    }
+    return trace;
+}
+
+void scaleFrameTrace(std::vector<FrameTiming>& trace, UINT begin, UINT end, float gpuFactor) {
+    for (UINT i = begin; i < std::min(end, (UINT)trace.size()); i++) {
+        trace[i].gpuMs *= gpuFactor;
+    }
+}
+
+std::string formatResolutionRun(const char* name, const ResolutionRun& run) {
+    char line[256];
+    snprintf(line, sizeof(line), "  %-22s %5u frames, %5.1f%% over budget, scale mean %.2f min %.2f, %3u changes, %2u reversals, worst overrun %u frames\n",
+        name, run.frames, 100.0 * run.overBudget / std::max(1u, run.frames), run.meanScale, run.minScale, run.scaleChanges, run.reversals, run.worstRecovery);
+    return line;
+}
+
+// Drives the controller through synthetic traces with the sample's two frames of latency:
+// light and heavy steady loads, a load spike, noise, a CPU bound stretch and a load beyond
+// what the lowest scale can absorb. A trace file, when given, is replayed and reported too.
+bool simulateDynamicResolution(const std::string& tracePath, std::string& report) {
+    bool passed = true;
+    auto check = [&](bool condition, const char* name) {
+        report += condition ? "PASS " : "FAIL ";
+        report += name;
+        report += "\n";
+        passed = passed && condition;
+    };
+
+    const ResolutionSettings settings;
+    const UINT latency = frameBufferCount;
+    const float pixelFraction = 0.9f;
+    // Frames for the controller to settle, after which the steady traces should sit still.
+    const UINT settle = 120;
+    auto changesAfter = [](const ResolutionRun& run, UINT from) {
+        UINT changes = 0;
+        for (UINT i = from + 1; i < run.scales.size(); i++) {
+            changes += run.scales[i] != run.scales[i - 1] ? 1 : 0;
+        }
+        return changes;
+    };
+    auto meanGpuAfter = [](const ResolutionRun& run, UINT from) {
+        double sum = 0.0;
+        for (UINT i = from; i < run.gpuMs.size(); i++) {
+            sum += run.gpuMs[i];
+        }
+        return (float)(sum / std::max<size_t>(1, run.gpuMs.size() - from));
+    };
+
+    ResolutionRun light = runResolutionTrace(makeFrameTrace(600, 6.0f, 9.0f, 0.05f, 1), settings, pixelFraction, latency);
+    report += formatResolutionRun("light", light);
+    check(light.minScale == settings.maxScale && light.scaleChanges == 0, "a light load stays at full resolution");
+
+    ResolutionRun heavy = runResolutionTrace(makeFrameTrace(600, 6.0f, 28.0f, 0.05f, 2), settings, pixelFraction, latency);
+    report += formatResolutionRun("heavy", heavy);
+    const float heavyGpu = meanGpuAfter(heavy, settle);
+    check(heavyGpu < settings.budgetMs && heavyGpu > settings.targetMs * 0.8f, "a heavy load settles under budget without giving up too much");
+    check(changesAfter(heavy, settle) <= 2 && heavy.reversals <= 2, "a heavy load settles without oscillating");
+
+    std::vector<FrameTiming> spikeTrace = makeFrameTrace(900, 6.0f, 11.0f, 0.05f, 3);
+    scaleFrameTrace(spikeTrace, 300, 600, 2.4f);
+    ResolutionRun spike = runResolutionTrace(spikeTrace, settings, pixelFraction, latency);
+    report += formatResolutionRun("spike", spike);
+    check(spike.worstRecovery <= 8, "a load spike is back under budget within 8 frames");
+    check(spike.scales[590] < 0.85f && spike.scales.back() == settings.maxScale, "the scale drops for the spike and recovers after it");
+
+    ResolutionRun noisy = runResolutionTrace(makeFrameTrace(1200, 6.0f, 20.0f, 0.15f, 4), settings, pixelFraction, latency);
+    ResolutionSettings noHysteresis = settings;
+    noHysteresis.deadBand = 0.0f;
+    noHysteresis.minScaleChange = 0.0f;
+    ResolutionRun noisyRaw = runResolutionTrace(makeFrameTrace(1200, 6.0f, 20.0f, 0.15f, 4), noHysteresis, pixelFraction, latency);
+    report += formatResolutionRun("noisy", noisy);
+    report += formatResolutionRun("noisy, no hysteresis", noisyRaw);
+    check(noisy.scaleChanges * 4 < noisyRaw.scaleChanges && noisy.scaleChanges <= 1200 / 30, "hysteresis keeps noise from changing the scale more than every 30 frames");
+    check(noisy.overBudget <= noisy.frames / 20, "noise pushes at most 5% of frames over budget");
+
+    std::vector<FrameTiming> cpuTrace = makeFrameTrace(600, 24.0f, 12.0f, 0.05f, 5);
+    ResolutionRun cpuBound = runResolutionTrace(cpuTrace, settings, pixelFraction, latency);
+    report += formatResolutionRun("cpu bound", cpuBound);
+    check(cpuBound.scaleChanges == 0, "a CPU bound trace keeps the scale");
+
+    std::vector<FrameTiming> overloadTrace = makeFrameTrace(900, 6.0f, 15.0f, 0.05f, 6);
+    scaleFrameTrace(overloadTrace, 200, 500, 6.0f);
+    ResolutionRun overload = runResolutionTrace(overloadTrace, settings, pixelFraction, latency);
+    report += formatResolutionRun("overload", overload);
+    check(overload.minScale == settings.minScale && overload.scales.back() > 0.9f, "an overload holds at the lowest scale and recovers");
+
+    bool sized = true;
+    for (float scale = 0.5f; scale <= 1.0f; scale += 0.01f) {
+        UINT width = 0;
+        UINT height = 0;
+        scaledSize(scale, windowWidth, windowHeight, width, height);
+        sized = sized && width % 8 == 0 && height % 8 == 0 && width <= (UINT)windowWidth && height <= (UINT)windowHeight;
+        sized = sized && fabsf(width - windowWidth * scale) <= 4.0f && fabsf(height - windowHeight * scale) <= 4.0f;
+    }
+    check(sized, "render sizes are multiples of 8 within 4 pixels of the scale");
+
+    if (!tracePath.empty()) {
+        std::vector<FrameTiming> trace = loadFrameTrace(tracePath);
+        ResolutionRun replay = runResolutionTrace(trace, settings, pixelFraction, latency);
+        report += formatResolutionRun(tracePath.c_str(), replay);
+        check(!trace.empty(), "the trace file has frames");
+    }
+    return passed;
+}
+
+// One unit cube with its faces shaded by direction, wound clockwise seen from outside.
+void makeCubeMesh(std::vector<Vertex>& vertices, std::vector<UINT>& indices) {
+    // Outward normal and the up direction of each face as seen from outside; right is up x -normal.
+    const int faces[6][6] = {
+        { 0, 0, -1, 0, 1, 0 }, { 0, 0, 1, 0, 1, 0 }, { -1, 0, 0, 0, 1, 0 },
+        { 1, 0, 0, 0, 1, 0 }, { 0, 1, 0, 0, 0, 1 }, { 0, -1, 0, 0, 0, 1 }
+    };
+    const float shades[6] = { 0.8f, 0.6f, 0.7f, 0.9f, 1.0f, 0.4f };
+    const int corners[4][2] = { { -1, 1 }, { 1, 1 }, { 1, -1 }, { -1, -1 } };
+    const XMFLOAT2 uvs[4] = { XMFLOAT2(0.0f, 0.0f), XMFLOAT2(1.0f, 0.0f), XMFLOAT2(1.0f, 1.0f), XMFLOAT2(0.0f, 1.0f) };
+    for (UINT f = 0; f < 6; f++) {
+        const int* n = faces[f];
+        const int* u = faces[f] + 3;
+        const int r[3] = { -(u[1] * n[2] - u[2] * n[1]), -(u[2] * n[0] - u[0] * n[2]), -(u[0] * n[1] - u[1] * n[0]) };
+        const UINT base = (UINT)vertices.size();
+        for (UINT c = 0; c < 4; c++) {
+            const XMFLOAT3 p(
+                (float)(n[0] + r[0] * corners[c][0] + u[0] * corners[c][1]),
+                (float)(n[1] + r[1] * corners[c][0] + u[1] * corners[c][1]),
+                (float)(n[2] + r[2] * corners[c][0] + u[2] * corners[c][1]));
+            vertices.push_back({ p, XMFLOAT4(shades[f], shades[f], shades[f], 1.0f), uvs[c] });
+        }
+        const UINT quad[6] = { 0, 1, 2, 2, 3, 0 };
+        for (UINT index : quad) {
+            indices.push_back(base + index);
+        }
+    }
+}
+
+class Graphics {
+
+public:
+    void init(HWND windowHandle) {
+        UINT dxgiFactoryFlags = 0U;
+
+#if defined(_DEBUG)
+        // Enable the debug layer (requires the Graphics Tools "optional feature").
+        // NOTE: Enabling the debug layer after device creation will invalidate the active device.
+        {
+            ComPtr<ID3D12Debug> dc;
+            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&dc)))) {
+                if (SUCCEEDED(dc->QueryInterface(IID_PPV_ARGS(&mDebugController)))) {
+                    mDebugController->EnableDebugLayer();
+                    mDebugController->SetEnableGPUBasedValidation(true);
+                }
+
+                // Enable additional debug layers.
+                dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
+            }
+        }
+#endif
+
+        // Create DXGI Factory
+        _ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mDXGIFactory)));
+        _ThrowIfFailed(mDXGIFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+
+
+        // Enum Adapter and Create Device
+        for(UINT adapterIndex = 0; DXGI_ERROR_NOT_FOUND != mDXGIFactory->EnumAdapters1(adapterIndex, &mDXGIAdapter); adapterIndex++) {
+            DXGI_ADAPTER_DESC1 desc = {};
+            mDXGIAdapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
+                continue;
+            }
+
+            _ThrowIfFailed(D3D12CreateDevice(mDXGIAdapter.Get(), mFeatureLevel, IID_PPV_ARGS(&mDevice)));
+#if defined(_DEBUG)
+            _ThrowIfFailed(mDevice->QueryInterface(IID_PPV_ARGS(&mDebugDevice)));
+#endif
+            break;
+        }
+        if (mDevice == nullptr) {
+            return;
+        }
+
+
+        // Create Command Queue
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        _ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
+
+
+        // Create Swap Chain
+        ComPtr<IDXGISwapChain> swapchain;
+        DXGI_SWAP_CHAIN_DESC swapchainDesc = {};
+        swapchainDesc.BufferCount = frameBufferCount;
+        swapchainDesc.BufferDesc.Width = windowWidth;
+        swapchainDesc.BufferDesc.Height = windowHeight;
+        swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapchainDesc.SampleDesc.Count = 1;
+        swapchainDesc.OutputWindow = windowHandle;
+        swapchainDesc.Windowed = TRUE;
+        _ThrowIfFailed(mDXGIFactory->CreateSwapChain(mCommandQueue.Get(), &swapchainDesc, &swapchain));
+        _ThrowIfFailed(swapchain.As(&mSwapChain));
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+
+        // Create RTV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        rtvHeapDesc.NumDescriptors = frameBufferCount + 1;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRTVHeap)));
+        mRTVHeapStride = mDevice->GetDescriptorHandleIncrementSize(rtvHeapDesc.Type);
+
+
+        // Get RenderTarget and Create RTV
+        mRenderTargets.resize(frameBufferCount);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mRenderTargets[i])));
+            mDevice->CreateRenderTargetView(mRenderTargets[i].Get(), nullptr, rtvHandle);
+            rtvHandle.ptr += mRTVHeapStride;
+        }
+
+        // Create Command Allocators
+        for (UINT i = 0; i < frameBufferCount; i++) {
+            _ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&mCommandAllocators[i])));
+        }
+    
+        // Create SRV Heap
+        D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
+        srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        srvHeapDesc.NumDescriptors = 2;
+        _ThrowIfFailed(mDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSRVHeap)));
+        mSRVHeapStride = mDevice->GetDescriptorHandleIncrementSize(srvHeapDesc.Type);
+
+        // Create Depth Buffer
+        {
+            D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
+            dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+            dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+            dsvHeapDesc.NumDescriptors = 1;
+            _ThrowIfFailed(mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&mDSVHeap)));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+            D3D12_RESOURCE_DESC depthDesc = {};
+            depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            depthDesc.Width = windowWidth;
+            depthDesc.Height = windowHeight;
+            depthDesc.DepthOrArraySize = 1;
+            depthDesc.MipLevels = 1;
+            depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+            depthDesc.SampleDesc.Count = 1;
+            depthDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            depthDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+            D3D12_CLEAR_VALUE clearValue = {};
+            clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+            clearValue.DepthStencil.Depth = 1.0f;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &depthDesc,
+                D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                &clearValue,
+                IID_PPV_ARGS(&mDepthBuffer)));
+            mDevice->CreateDepthStencilView(mDepthBuffer.Get(), nullptr, mDSVHeap->GetCPUDescriptorHandleForHeapStart());
+        }
+
+        // Create Scene Target. It has the window's size and the scene is drawn into its top
+        // left corner at the current scale, so changing the scale never reallocates anything.
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+            D3D12_RESOURCE_DESC targetDesc = {};
+            targetDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            targetDesc.Width = windowWidth;
+            targetDesc.Height = windowHeight;
+            targetDesc.DepthOrArraySize = 1;
+            targetDesc.MipLevels = 1;
+            targetDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            targetDesc.SampleDesc.Count = 1;
+            targetDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            targetDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+            D3D12_CLEAR_VALUE clearValue = {};
+            clearValue.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            clearValue.Color[0] = 0.0f;
+            clearValue.Color[1] = 0.2f;
+            clearValue.Color[2] = 0.4f;
+            clearValue.Color[3] = 1.0f;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &targetDesc,
+                D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+                &clearValue,
+                IID_PPV_ARGS(&mSceneTarget)));
+
+            D3D12_CPU_DESCRIPTOR_HANDLE sceneRtv(mRTVHeap->GetCPUDescriptorHandleForHeapStart());
+            sceneRtv.ptr += frameBufferCount * mRTVHeapStride;
+            mDevice->CreateRenderTargetView(mSceneTarget.Get(), nullptr, sceneRtv);
+
+            D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+            srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            srvDesc.Texture2D.MipLevels = 1;
+            D3D12_CPU_DESCRIPTOR_HANDLE sceneSrv(mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+            sceneSrv.ptr += mSRVHeapStride;
+            mDevice->CreateShaderResourceView(mSceneTarget.Get(), &srvDesc, sceneSrv);
+        }
+
+        // Create Timestamp Queries, a begin and end pair per frame in flight, resolved into a
+        // readback buffer that is read once the frame's fence has passed
+        {
+            D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+            queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+            queryHeapDesc.Count = frameBufferCount * 2;
+            _ThrowIfFailed(mDevice->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&mTimestampHeap)));
+            _ThrowIfFailed(mCommandQueue->GetTimestampFrequency(&mTimestampFrequency));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+            D3D12_RESOURCE_DESC bufferDesc = {};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = frameBufferCount * 2 * sizeof(UINT64);
+            bufferDesc.Height = 1;
+            bufferDesc.DepthOrArraySize = 1;
+            bufferDesc.MipLevels = 1;
+            bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &bufferDesc,
+                D3D12_RESOURCE_STATE_COPY_DEST,
+                nullptr,
+                IID_PPV_ARGS(&mTimestampBuffer)));
+        }
+
+
+        // Create Viewport and Scissor-Rect
+        {
+            mViewport.TopLeftX = 0;
+            mViewport.TopLeftY = 0;
+            mViewport.Width = windowWidth;
+            mViewport.Height = windowHeight;
+            mViewport.MinDepth = 0.0f;
+            mViewport.MaxDepth = 1.0f;
+
+            mScissorRect.left = 0;
+            mScissorRect.top = 0;
+            mScissorRect.right = windowWidth;
+            mScissorRect.bottom = windowHeight;
+        }
+
+        // Create Fence
+        memset(mFenceValues, 0, sizeof(UINT64) * frameBufferCount);
+        _ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameBufferIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+        mFenceValues[mFrameBufferIndex]++;
+        mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (mFenceEvent == nullptr) {
+            _ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+
+        mStartTime = secondsNow();
+
+        // Create Assets
+        this->createAssets();
+
+        this->waitForGPU();
+    }
+
+    void quit() {
+        this->waitForGPU();
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+        if (!mTracePath.empty()) {
+            saveFrameTrace(mTracePath, mTrace);
+            debugLog("Saved %u frame timings to %s\n", (UINT)mTrace.size(), mTracePath.c_str());
+        }
+    }
+
+    void tick(float delta) {
+        double start = secondsNow();
+        this->fillCommandList();
+
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+        mFrameTimings[mFrameBufferIndex].cpuMs = (float)((secondsNow() - start) * 1000.0);
+        mFrameTimings[mFrameBufferIndex].scale = mScale;
+        mFramePending[mFrameBufferIndex] = true;
+
+        _ThrowIfFailed(mSwapChain->Present(1, 0));
+
+        this->waitForNextFrame();
+        this->updateResolution();
+    }
+
+    void toggleDynamicResolution() {
+        mDynamic = !mDynamic;
+        debugLog("Dynamic resolution %s\n", mDynamic ? "on" : "off");
+    }
+
+    void cycleLoad() {
+        mLoad = (mLoad + 1) % _countof(sceneLoads);
+        debugLog("Scene load %u rounds per pixel\n", sceneLoads[mLoad]);
+    }
+
+    // Timings from now on are kept, to be written to path on quit.
+    void recordTrace(const std::string& path) {
+        mTracePath = path;
+    }
+
+    // The frame about to reuse this slot was submitted frameBufferCount frames ago and its
+    // fence has passed, so its timestamps are ready. Its timing goes to the controller, which
+    // picks the scale for the frame about to be recorded.
+    void updateResolution() {
+        if (!mFramePending[mFrameBufferIndex]) {
+            return;
+        }
+        mFramePending[mFrameBufferIndex] = false;
+
+        D3D12_RANGE readRange = { mFrameBufferIndex * 2 * sizeof(UINT64), (mFrameBufferIndex * 2 + 2) * sizeof(UINT64) };
+        UINT64* timestamps = nullptr;
+        _ThrowIfFailed(mTimestampBuffer->Map(0, &readRange, (void**)&timestamps));
+        const UINT64 begin = timestamps[mFrameBufferIndex * 2];
+        const UINT64 end = timestamps[mFrameBufferIndex * 2 + 1];
+        D3D12_RANGE writeRange = { 0, 0 };
+        mTimestampBuffer->Unmap(0, &writeRange);
+
+        FrameTiming& timing = mFrameTimings[mFrameBufferIndex];
+        timing.gpuMs = (float)((end - begin) * 1000.0 / mTimestampFrequency);
+        if (!mTracePath.empty()) {
+            mTrace.push_back(timing);
+        }
+        const float next = mController.update(timing);
+        mScale = mDynamic ? next : 1.0f;
+
+        mReportCpuMs += timing.cpuMs;
+        mReportGpuMs += timing.gpuMs;
+        mReportScale += timing.scale;
+        mOverBudget += std::max(timing.cpuMs, timing.gpuMs) > mController.settings().budgetMs ? 1 : 0;
+        if (++mFrameCount % resolutionReportFrames == 0) {
+            UINT width = 0;
+            UINT height = 0;
+            scaledSize(mScale, windowWidth, windowHeight, width, height);
+            debugLog("Resolution %s, load %u: GPU %.2f ms, CPU %.2f ms, scale %.2f on average, now %ux%u, %llu of %llu frames over budget\n",
+                mDynamic ? "dynamic" : "fixed", sceneLoads[mLoad], mReportGpuMs / resolutionReportFrames, mReportCpuMs / resolutionReportFrames,
+                mReportScale / resolutionReportFrames, width, height, mOverBudget, resolutionReportFrames);
+            mReportCpuMs = 0.0;
+            mReportGpuMs = 0.0;
+            mReportScale = 0.0;
+            mOverBudget = 0;
+        }
+    }
+
+    void createAssets() {
+        // Create Root Signature
+        {
+            D3D12_STATIC_SAMPLER_DESC samplers[2] = { {} };
+            samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+            samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            samplers[0].MipLODBias = 0;
+            samplers[0].MinLOD = 0.0f;
+            samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+            samplers[0].MaxAnisotropy = 0;
+            samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+            samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            samplers[0].ShaderRegister = 0;
+            samplers[0].RegisterSpace = 0;
+            samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+            // The upscale pass clamps, so the right and bottom edges do not wrap around.
+            samplers[1] = samplers[0];
+            samplers[1].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[1].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[1].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            samplers[1].ShaderRegister = 1;
+
+            D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
+            featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+            {
+                featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+            }
+
+            D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+            rootSignatureDesc.Version = featureData.HighestVersion;
+            if(rootSignatureDesc.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+                descriptorRanges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+
+                D3D12_ROOT_PARAMETER1 parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE1*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = sizeof(SceneConstants) / 4;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+                rootSignatureDesc.Desc_1_1.NumParameters = 2;
+                rootSignatureDesc.Desc_1_1.pParameters = parameters;
+                rootSignatureDesc.Desc_1_1.NumStaticSamplers = _countof(samplers);
+                rootSignatureDesc.Desc_1_1.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+            else
+            {
+                D3D12_DESCRIPTOR_RANGE descriptorRanges[1] = {};
+                descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                descriptorRanges[0].NumDescriptors = 1;
+                descriptorRanges[0].BaseShaderRegister = 0;
+                descriptorRanges[0].RegisterSpace = 0;
+
+                D3D12_ROOT_PARAMETER parameters[2] = {};
+                parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+                parameters[0].DescriptorTable.NumDescriptorRanges = 1;
+                parameters[0].DescriptorTable.pDescriptorRanges = (const D3D12_DESCRIPTOR_RANGE*)descriptorRanges;
+                parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+                parameters[1].Constants.ShaderRegister = 0;
+                parameters[1].Constants.Num32BitValues = sizeof(SceneConstants) / 4;
+                parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+                rootSignatureDesc.Desc_1_0.NumParameters = 2;
+                rootSignatureDesc.Desc_1_0.pParameters = parameters;
+                rootSignatureDesc.Desc_1_0.NumStaticSamplers = _countof(samplers);
+                rootSignatureDesc.Desc_1_0.pStaticSamplers = samplers;
+                rootSignatureDesc.Desc_1_0.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+            }
+
+            ComPtr<ID3DBlob> rootSignatureBlob;
+            ComPtr<ID3DBlob> errorBlob;
+            _ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &rootSignatureBlob, &errorBlob));
+            _ThrowIfFailed(mDevice->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+        }
+
+        // Compile Shader
+        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        ComPtr<ID3DBlob> vsCode;
+        ComPtr<ID3DBlob> psCode;
+        this->compileShader("../shaders/017-dynamic-resolution.hlsl", "vs_5_0", "VSMain", &vsCode);
+        this->compileShader("../shaders/017-dynamic-resolution.hlsl", "ps_5_0", "PSMain", &psCode);
+
+        // Create Pipeline State
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.InputLayout.pInputElementDescs = inputElementDescs;
+            psoDesc.InputLayout.NumElements = _countof(inputElementDescs);
+
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { vsCode->GetBufferPointer(), vsCode->GetBufferSize() };
+            psoDesc.PS = { psCode->GetBufferPointer(), psCode->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = TRUE;
+            psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+            psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+            psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mPipelineState)));
+        }
+
+        // Create Upscale Pipeline State: a screen covering triangle without vertex input
+        {
+            ComPtr<ID3DBlob> upscaleVs;
+            ComPtr<ID3DBlob> upscalePs;
+            this->compileShader("../shaders/018-upscale.hlsl", "vs_5_0", "VSMain", &upscaleVs);
+            this->compileShader("../shaders/018-upscale.hlsl", "ps_5_0", "PSMain", &upscalePs);
+
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+            psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            psoDesc.pRootSignature = mRootSignature.Get();
+            psoDesc.VS = { upscaleVs->GetBufferPointer(), upscaleVs->GetBufferSize() };
+            psoDesc.PS = { upscalePs->GetBufferPointer(), upscalePs->GetBufferSize() };
+
+            psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+            psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+
+            psoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+            psoDesc.BlendState.IndependentBlendEnable = FALSE;
+            psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+            psoDesc.DepthStencilState.DepthEnable = FALSE;
+            psoDesc.DepthStencilState.StencilEnable = FALSE;
+
+            psoDesc.NumRenderTargets = 1;
+            psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            psoDesc.SampleMask = UINT_MAX;
+            psoDesc.SampleDesc.Count = 1;
+
+            _ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&mUpscalePipelineState)));
+        }
+
+
+        // Create Command Allocator and Graphics Command List
+        _ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+            mCommandAllocators[mFrameBufferIndex].Get(),
+            mPipelineState.Get(),
+            IID_PPV_ARGS(&mCommandList)));
+        
+
+        std::vector<Vertex> vertices;
+        std::vector<UINT> indices;
+        makeCubeMesh(vertices, indices);
+        mCubeIndexCount = (UINT)indices.size();
+
+        // Create Vertex Buffer
+        {
+            const UINT vertexBufferSize = (UINT)(vertices.size() * sizeof(Vertex));
+
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC vbDesc = {};
+            vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            vbDesc.Alignment = 0;
+            vbDesc.Width = vertexBufferSize;
+            vbDesc.Height = 1;
+            vbDesc.DepthOrArraySize = 1;
+            vbDesc.MipLevels = 1;
+            vbDesc.Format = DXGI_FORMAT_UNKNOWN;
+            vbDesc.SampleDesc.Count = 1;
+            vbDesc.SampleDesc.Quality = 0;
+            vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &vbDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mVertexBuffer)));
+
+            void* vertexDataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mVertexBuffer->Map(0, &readRange, &vertexDataPtr));
+            memcpy(vertexDataPtr, vertices.data(), vertexBufferSize);
+            mVertexBuffer->Unmap(0, nullptr);
+
+            // Initialize the vertex buffer view.
+            mVertexBufferView.BufferLocation = mVertexBuffer->GetGPUVirtualAddress();
+            mVertexBufferView.StrideInBytes = sizeof(Vertex);
+            mVertexBufferView.SizeInBytes = vertexBufferSize;
+        }
+
+        // Create Index Buffer
+        {
+            D3D12_HEAP_PROPERTIES heapProperties = {};
+            heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+            D3D12_RESOURCE_DESC ibDesc = {};
+            ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            ibDesc.Alignment = 0;
+            ibDesc.Width = indices.size() * sizeof(UINT);
+            ibDesc.Height = 1;
+            ibDesc.DepthOrArraySize = 1;
+            ibDesc.MipLevels = 1;
+            ibDesc.Format = DXGI_FORMAT_UNKNOWN;
+            ibDesc.SampleDesc.Count = 1;
+            ibDesc.SampleDesc.Quality = 0;
+            ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+            _ThrowIfFailed(mDevice->CreateCommittedResource(
+                &heapProperties,
+                D3D12_HEAP_FLAG_NONE,
+                &ibDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ,
+                nullptr,
+                IID_PPV_ARGS(&mIndexBuffer)));
+
+
+            void* dataPtr = NULL;
+            D3D12_RANGE readRange = { 0, 0 };
+            _ThrowIfFailed(mIndexBuffer->Map(0, &readRange, &dataPtr));
+            memcpy(dataPtr, indices.data(), ibDesc.Width);
+            mIndexBuffer->Unmap(0, nullptr);
+
+            // Initialize the index buffer view.
+            mIndexBufferView.BufferLocation = mIndexBuffer->GetGPUVirtualAddress();
+            mIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+            mIndexBufferView.SizeInBytes = (UINT)ibDesc.Width;
+        }
+
+        // Texture
+        {
+            auto makeTextureData = [](std::vector<UINT8>& image, UINT textureWidth, UINT textureHeight)->void
+            {
+                const UINT rowPitch = textureWidth * 4;
+                const UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkboard texture.
+                const UINT cellHeight = textureWidth >> 3; // The height of a cell in the checkerboard texture.
+                const UINT textureSize = rowPitch * textureHeight;
+
+                image.resize(textureSize);
+    
+                UINT8* pData = (UINT8*)image.data();
+                for (UINT n = 0; n < textureSize; n += 4)
+                {
+                    UINT x = n % rowPitch;
+                    UINT y = n / rowPitch;
+                    UINT i = x / cellPitch;
+                    UINT j = y / cellHeight;
+
+                    if (i % 2 == j % 2)
+                    {
+                        pData[n + 0] = 0xc0;    // R
+                        pData[n + 1] = 0xc0;    // G
+                        pData[n + 2] = 0xc0;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                    else
+                    {
+                        pData[n + 0] = 0xff;    // R
+                        pData[n + 1] = 0xff;    // G
+                        pData[n + 2] = 0xff;    // B
+                        pData[n + 3] = 0xff;    // A
+                    }
+                }
+            };
+            
+            UINT width = 256;
+            UINT height = 256;
+            DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            std::vector<UINT8> image;
+            makeTextureData(image, width, height);
+
+            this->createTextureFromData(
+                mDevice.Get(), mCommandList.Get(), 
+                image, width, height, format, 
+                mTextureResource, mTextureBuffer);
+        }
+
+
+        _ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    }
+
+    // The cube field, turning, drawn into the scene target's scaled corner.
+    void drawScene() {
+        float time = (float)(secondsNow() - mStartTime);
+        XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, -17.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        XMMATRIX projection = XMMatrixPerspectiveFovLH(0.8f, windowWidth / (float)windowHeight, 0.1f, 100.0f);
+        XMMATRIX viewProjection = XMMatrixMultiply(view, projection);
+
+        for (UINT row = 0; row < cubeRows; row++) {
+            for (UINT column = 0; column < cubeColumns; column++) {
+                const float x = (column - (cubeColumns - 1) * 0.5f) * 2.6f;
+                const float y = (row - (cubeRows - 1) * 0.5f) * 2.6f;
+                XMMATRIX world = XMMatrixMultiply(
+                    XMMatrixRotationRollPitchYaw(time * 0.7f + x * 0.3f, time * 0.5f + y * 0.2f, 0.0f),
+                    XMMatrixTranslation(x, y, 0.0f));
+                SceneConstants constants = {};
+                XMStoreFloat4x4(&constants.worldViewProjection, XMMatrixTranspose(XMMatrixMultiply(world, viewProjection)));
+                constants.load = sceneLoads[mLoad];
+                mCommandList->SetGraphicsRoot32BitConstants(1, sizeof(SceneConstants) / 4, &constants, 0);
+                mCommandList->DrawIndexedInstanced(mCubeIndexCount, 1, 0, 0, 0);
+            }
+        }
+    }
+
+    void fillCommandList() {
+        _ThrowIfFailed(mCommandAllocators[mFrameBufferIndex]->Reset());
+        _ThrowIfFailed(mCommandList->Reset(mCommandAllocators[mFrameBufferIndex].Get(), mPipelineState.Get()));
+        mCommandList->EndQuery(mTimestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, mFrameBufferIndex * 2);
+
+        mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+
+        ID3D12DescriptorHeap* srvHeapList[] = { mSRVHeap.Get() };
+        mCommandList->SetDescriptorHeaps(_countof(srvHeapList), srvHeapList);
+        mCommandList->SetGraphicsRootDescriptorTable(0, mSRVHeap->GetGPUDescriptorHandleForHeapStart());
+
+        // The scene pass covers only the scaled corner of the scene target.
+        UINT sceneWidth = 0;
+        UINT sceneHeight = 0;
+        scaledSize(mScale, windowWidth, windowHeight, sceneWidth, sceneHeight);
+        D3D12_VIEWPORT sceneViewport = mViewport;
+        sceneViewport.Width = (float)sceneWidth;
+        sceneViewport.Height = (float)sceneHeight;
+        D3D12_RECT sceneRect = { 0, 0, (LONG)sceneWidth, (LONG)sceneHeight };
+        mCommandList->RSSetViewports(1, &sceneViewport);
+        mCommandList->RSSetScissorRects(1, &sceneRect);
+
+        D3D12_RESOURCE_BARRIER toTarget = {};
+        toTarget.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        toTarget.Transition.pResource = mSceneTarget.Get();
+        toTarget.Transition.Subresource = 0;
+        toTarget.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        toTarget.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        mCommandList->ResourceBarrier(1, &toTarget);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE sceneRtv{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        sceneRtv.ptr += frameBufferCount * mRTVHeapStride;
+        D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle{ mDSVHeap->GetCPUDescriptorHandleForHeapStart() };
+        mCommandList->OMSetRenderTargets(1, &sceneRtv, FALSE, &dsvHandle);
+
+        const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+        mCommandList->ClearRenderTargetView(sceneRtv, clearColor, 1, &sceneRect);
+        mCommandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 1, &sceneRect);
+        mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        mCommandList->IASetVertexBuffers(0, 1, &mVertexBufferView);
+        mCommandList->IASetIndexBuffer(&mIndexBufferView);
+        this->drawScene();
+
+        D3D12_RESOURCE_BARRIER toTexture = toTarget;
+        toTexture.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        toTexture.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        D3D12_RESOURCE_BARRIER onBegin = {};
+        onBegin.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onBegin.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onBegin.Transition.Subresource = 0;
+        onBegin.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
+        onBegin.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        D3D12_RESOURCE_BARRIER toUpscale[] = { toTexture, onBegin };
+        mCommandList->ResourceBarrier(_countof(toUpscale), toUpscale);
+
+        // Upscale: stretch the scaled corner over the whole back buffer with bilinear filtering.
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ mRTVHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandle.ptr += mFrameBufferIndex * mRTVHeapStride;
+        mCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+        mCommandList->RSSetViewports(1, &mViewport);
+        mCommandList->RSSetScissorRects(1, &mScissorRect);
+        mCommandList->SetPipelineState(mUpscalePipelineState.Get());
+        D3D12_GPU_DESCRIPTOR_HANDLE sceneSrv = mSRVHeap->GetGPUDescriptorHandleForHeapStart();
+        sceneSrv.ptr += mSRVHeapStride;
+        mCommandList->SetGraphicsRootDescriptorTable(0, sceneSrv);
+        const float upscale[4] = {
+            sceneWidth / (float)windowWidth, sceneHeight / (float)windowHeight,
+            (sceneWidth - 0.5f) / windowWidth, (sceneHeight - 0.5f) / windowHeight
+        };
+        mCommandList->SetGraphicsRoot32BitConstants(1, 4, upscale, 0);
+        mCommandList->DrawInstanced(3, 1, 0, 0);
+
+        D3D12_RESOURCE_BARRIER onEnd = {};
+        onEnd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onEnd.Transition.pResource = mRenderTargets[mFrameBufferIndex].Get();
+        onEnd.Transition.Subresource = 0;
+        onEnd.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        onEnd.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
+        mCommandList->ResourceBarrier(1, &onEnd);
+
+        mCommandList->EndQuery(mTimestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, mFrameBufferIndex * 2 + 1);
+        mCommandList->ResolveQueryData(mTimestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, mFrameBufferIndex * 2, 2,
+            mTimestampBuffer.Get(), mFrameBufferIndex * 2 * sizeof(UINT64));
+
+        _ThrowIfFailed(mCommandList->Close());
+    }
+
+    void waitForGPU() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        _ThrowIfFailed(mFence->SetEventOnCompletion(currentFenceValue, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, INFINITE);
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void waitForNextFrame() {
+        const UINT64 currentFenceValue = mFenceValues[mFrameBufferIndex];
+
+        _ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), currentFenceValue));
+        
+        mFrameBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
+
+        const UINT64 completed = mFence->GetCompletedValue();
+        if (completed < mFenceValues[mFrameBufferIndex])
+        {
+            _ThrowIfFailed(mFence->SetEventOnCompletion(mFenceValues[mFrameBufferIndex], mFenceEvent));
+            WaitForSingleObject(mFenceEvent, INFINITE);
+        }
+        
+        mFenceValues[mFrameBufferIndex] = currentFenceValue + 1;
+    }
+
+    void compileShader(const std::string& file, const char* target, const char* entry, ID3DBlob** code) {
+        const size_t maxShaderSize = 1024;
+
+        char buffer[maxShaderSize] = { 0 };
+        memset(buffer, 0, maxShaderSize);
+
+        FILE* fd = NULL;
+        fopen_s(&fd, file.c_str(), "rb");
+        if(fd == NULL) {
+            throw std::exception("Open shader file failed.");
+        }
+
+        fseek(fd, 0, SEEK_END);
+        size_t size = ftell(fd);
+        if (size > maxShaderSize) {
+            throw std::exception("The shader file is too large.");
+        }
+
+        fseek(fd, 0, SEEK_SET);
+        fread(buffer, size, 1, fd);
+        fclose(fd);
+
+        this->compileShader(file.c_str(), buffer, target, entry, code);
+    }
+
+    void compileShader(const std::string& name, const std::string& source, const char* target, const char* entry, ID3DBlob** code) {
+        UINT compileFlags = 0;
+#if defined(_DEBUG)
+        compileFlags |= D3DCOMPILE_DEBUG;
+        compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        ComPtr<ID3DBlob> error;
+        _ThrowIfFailed(D3DCompile(source.c_str(), source.size(), name.c_str(), nullptr, nullptr, entry, target, compileFlags, 0, code, &error));
+        if (error != nullptr) {
+            std::string str((const char*)error->GetBufferPointer(), error->GetBufferSize());
+            throw std::exception(str.c_str());
+        }
+    }
+
+    void createTextureFromData(
+        ID3D12Device* device,
+        ID3D12GraphicsCommandList* commandList,
+        const std::vector<UINT8>& imageData,
+        UINT width,
+        UINT height,
+        DXGI_FORMAT format,
+        ComPtr<ID3D12Resource>& textureResource,
+        ComPtr<ID3D12Resource>& uploadBuffer)
+    {
+        // 1. 准备纹理数据和描述符
+        D3D12_RESOURCE_DESC textureDesc = {};
+        textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        //textureDesc.Alignment = 0;
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.DepthOrArraySize = 1;
+        textureDesc.MipLevels = 1;
+        textureDesc.Format = format;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        // 2. 创建纹理资源
+        D3D12_HEAP_PROPERTIES textureHeapProps = {};
+        textureHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &textureHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &textureDesc,
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&textureResource)));
+
+        // 3. 创建上传堆
+        UINT subresourceIndex = 0;
+        UINT subresourceCount = 1;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint;
+        UINT64 uploadBufferSize;
+        UINT numRows;
+        UINT64 rowSizeInBytes;
+        device->GetCopyableFootprints(
+            &textureDesc, subresourceIndex, subresourceCount, 0, 
+            &uploadFootprint, &numRows, &rowSizeInBytes, &uploadBufferSize);
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        bufferDesc.Alignment = 0;
+        bufferDesc.Width = uploadBufferSize;
+        bufferDesc.Height = 1;
+        bufferDesc.DepthOrArraySize = 1;
+        bufferDesc.MipLevels = 1;
+        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        bufferDesc.SampleDesc.Count = 1;
+        bufferDesc.SampleDesc.Quality = 0;
+        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        D3D12_HEAP_PROPERTIES uploadHeapProps = {};
+        uploadHeapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+        _ThrowIfFailed(device->CreateCommittedResource(
+            &uploadHeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&uploadBuffer)));
+
+        // 4. 将数据从 std::vector<UINT8> 复制到上传堆中
+        const UINT8* srcPtr = imageData.data();
+        UINT8* dstPtr;
+        _ThrowIfFailed(uploadBuffer->Map(0, nullptr, (void**)&dstPtr));
+        for (UINT row = 0; row < numRows; ++row)
+        {
+            memcpy(dstPtr, srcPtr, rowSizeInBytes);
+            dstPtr += uploadFootprint.Footprint.RowPitch;
+            srcPtr += rowSizeInBytes;
+        }
+        uploadBuffer->Unmap(0, nullptr);
+
+        // 5. 将数据从上传堆复制到纹理资源中
+        D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+        srcLocation.pResource = uploadBuffer.Get();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        srcLocation.PlacedFootprint = uploadFootprint;
+
+        D3D12_TEXTURE_COPY_LOCATION dstLocation = {};
+        dstLocation.pResource = textureResource.Get();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        dstLocation.SubresourceIndex = 0;
+
+        commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+
+        D3D12_RESOURCE_BARRIER onFinish = {};
+        onFinish.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        onFinish.Transition.pResource = textureResource.Get();
+        onFinish.Transition.Subresource = 0;
+        onFinish.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        onFinish.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        mCommandList->ResourceBarrier(1, &onFinish);
+
+        // 6. 创建 SRV 描述符
+        // 在此处创建 SRV 描述符并将其绑定到纹理资源。请注意，您需要确定 SRV 描述符堆的偏移量。
+        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        srvDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(textureResource.Get(), &srvDesc, mSRVHeap->GetCPUDescriptorHandleForHeapStart());
+    }
+
+private:
+    ComPtr<ID3D12Debug1> mDebugController;
+    D3D_FEATURE_LEVEL mFeatureLevel = D3D_FEATURE_LEVEL_12_0;
+
+    ComPtr<IDXGIFactory7> mDXGIFactory;
+    ComPtr<IDXGIAdapter1> mDXGIAdapter;
+    ComPtr<ID3D12Device4> mDevice;
+    ComPtr<ID3D12DebugDevice> mDebugDevice;
+    ComPtr<ID3D12CommandQueue> mCommandQueue;
+    ComPtr<IDXGISwapChain3> mSwapChain;
+    UINT mFrameBufferIndex = 0;
+    
+    ComPtr<ID3D12DescriptorHeap> mRTVHeap;
+    UINT mRTVHeapStride = 0;
+    std::vector<ComPtr<ID3D12Resource>> mRenderTargets;
+    D3D12_VIEWPORT mViewport;
+    D3D12_RECT mScissorRect;
+
+    ComPtr<ID3D12DescriptorHeap> mSRVHeap;
+    UINT mSRVHeapStride = 0;
+
+    ComPtr<ID3D12Fence> mFence;
+    UINT64 mFenceValues[frameBufferCount];
+    HANDLE mFenceEvent;
+    
+    ComPtr<ID3D12RootSignature> mRootSignature;
+    ComPtr<ID3D12PipelineState> mPipelineState;
+    ComPtr<ID3D12PipelineState> mUpscalePipelineState;
+    ComPtr<ID3D12CommandAllocator> mCommandAllocators[frameBufferCount];
+    ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    ComPtr<ID3D12Resource> mVertexBuffer;
+    D3D12_VERTEX_BUFFER_VIEW mVertexBufferView;
+    ComPtr<ID3D12Resource> mIndexBuffer;
+    D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
+    ComPtr<ID3D12Resource> mTextureResource;
+    ComPtr<ID3D12Resource> mTextureBuffer;
+    ComPtr<ID3D12DescriptorHeap> mDSVHeap;
+    ComPtr<ID3D12Resource> mDepthBuffer;
+    ComPtr<ID3D12Resource> mSceneTarget;
+    ComPtr<ID3D12QueryHeap> mTimestampHeap;
+    ComPtr<ID3D12Resource> mTimestampBuffer;
+    UINT64 mTimestampFrequency = 1;
+
+    UINT mCubeIndexCount = 0;
+    UINT mLoad = 1;
+    ResolutionController mController;
+    bool mDynamic = true;
+    float mScale = 1.0f;
+    // Timing of the frame last recorded into each slot, waiting for its timestamps
+    FrameTiming mFrameTimings[frameBufferCount] = {};
+    bool mFramePending[frameBufferCount] = {};
+    std::string mTracePath;
+    std::vector<FrameTiming> mTrace;
+    double mStartTime = 0.0;
+    UINT64 mFrameCount = 0;
+    UINT64 mOverBudget = 0;
+    double mReportCpuMs = 0.0;
+    double mReportGpuMs = 0.0;
+    double mReportScale = 0.0;
+};
+
+
+LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+    case WM_CLOSE:
+    {
+        PostQuitMessage(0);
+        return 0;
+    }
+    default:
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+int APIENTRY WinMain(_In_ HINSTANCE hInstance,
+                     _In_opt_ HINSTANCE hPrevInstance,
+                     _In_ LPSTR    lpCmdLine,
+                     _In_ int       nCmdShow)
+{
+    try {
+        UNREFERENCED_PARAMETER(hPrevInstance);
+
+        hInst = hInstance; // 将实例句柄存储在全局变量中
+
+        if (strstr(lpCmdLine, "-simulate") != nullptr) {
+            std::string tracePath;
+            const char* trace = strstr(lpCmdLine, "-trace=");
+            if (trace != nullptr) {
+                trace += strlen("-trace=");
+                tracePath.assign(trace, strcspn(trace, " "));
+            }
+            std::string report;
+            bool passed = simulateDynamicResolution(tracePath, report);
+            debugLog("%s", report.c_str());
+            MessageBoxA(NULL, report.c_str(), windowTitle, 0);
+            return passed ? 0 : 1;
+        }
+
+        WNDCLASSEXA wcex;
+        wcex.cbSize = sizeof(WNDCLASSEXA);
+        wcex.style = CS_GLOBALCLASS;
+        wcex.lpfnWndProc = WndProc;
+        wcex.cbClsExtra = 0;
+        wcex.cbWndExtra = 0;
+        wcex.hInstance = hInstance;
+        wcex.hIcon = NULL;
+        wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+        wcex.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wcex.lpszMenuName = NULL;
+        wcex.lpszClassName = windowClass;
+        wcex.hIconSm = NULL;
+        RegisterClassExA(&wcex);
+
+        HWND hWnd = CreateWindowA(windowClass, windowTitle, WS_OVERLAPPEDWINDOW,
+            0, 0, windowWidth, windowHeight, nullptr, nullptr, hInstance, nullptr);
+        if (!hWnd)
+        {
+            return FALSE;
+        }
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+
+        Graphics graphics;
+        graphics.init(hWnd);
+        const char* record = strstr(lpCmdLine, "-record=");
+        if (record != nullptr) {
+            record += strlen("-record=");
+            graphics.recordTrace(std::string(record, strcspn(record, " ")));
+        }
+
+        MSG msg;
+        msg.message = static_cast<UINT>(~WM_QUIT);
+        while (msg.message != WM_QUIT)
+        {
+            if (PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_KEYDOWN && msg.wParam == 'D') {
+                    graphics.toggleDynamicResolution();
+                }
+                if (msg.message == WM_KEYDOWN && msg.wParam == 'L') {
+                    graphics.cycleLoad();
+                }
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+            }
+            else
+            {
+                graphics.tick(0);
+            }
+        }
+
+        graphics.quit();
+
+        return (int)msg.wParam;
+    }
+    catch (std::exception& e) {
+        MessageBoxA(NULL, e.what(), NULL, 0);
+        return 1;
+    }
+}
+
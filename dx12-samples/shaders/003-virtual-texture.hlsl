@@ -0,0 +1,64 @@
+
+cbuffer VTConstants : register(b0) {
+	uint gPagesPerSide;
+	uint gPageSize;
+	uint gSlotsPerSide;
+	uint gMaxMip;
+	uint gFeedbackWidth;
+	uint gFeedbackScale;
+	uint gFrameTag;
+	float gUVScale;
+	float2 gUVOffset;
+};
+
+Texture2D gPhysicalTexture : register(t0);
+Texture2D<uint4> gIndirection : register(t1);
+RWStructuredBuffer<uint> gFeedback : register(u1);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	ret.position = input.position;
+	ret.color = input.color;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	float2 uv = input.uv * gUVScale + gUVOffset;
+	float2 texel = uv * (gPagesPerSide * gPageSize);
+
+	// Pick the mip from the texel footprint of this pixel.
+	float2 dx = ddx(texel);
+	float2 dy = ddy(texel);
+	float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+	uint mip = (uint)clamp(floor(lod), 0.0, (float)gMaxMip);
+	uint2 page = min((uint2)(uv * gPagesPerSide), gPagesPerSide - 1) >> mip;
+
+	// Request the page; one pixel per feedback block writes, tagged with the frame.
+	uint2 pixel = (uint2)input.position.xy;
+	if (all(pixel % gFeedbackScale == 0)) {
+		uint2 cell = pixel / gFeedbackScale;
+		gFeedback[cell.y * gFeedbackWidth + cell.x] = (gFrameTag << 24) | (mip << 20) | (page.y << 10) | page.x;
+	}
+
+	// The indirection entry points at the page itself or its nearest resident ancestor.
+	uint4 entry = gIndirection.Load(int3(page, mip));
+	float2 pageUV = frac(texel / (float)(gPageSize << entry.z));
+	float2 physicalUV = (entry.xy + pageUV) / gSlotsPerSide;
+	return gPhysicalTexture.Sample(gMainSampler, physicalUV) * input.color;
+}
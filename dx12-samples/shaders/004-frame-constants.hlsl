@@ -0,0 +1,51 @@
+
+// Per-draw data, small enough to be passed as root constants.
+cbuffer DrawConstants : register(b0) {
+	float2 gOffset;
+	float gScale;
+	float gRotation;
+	uint gPaletteIndex;
+};
+
+cbuffer FrameConstants : register(b1) {
+	float4x4 gProjection;
+	float gTime;
+};
+
+cbuffer PaletteConstants : register(b2) {
+	float4 gPalette[16];
+};
+
+Texture2D gMainTexture : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	float s = sin(gRotation);
+	float c = cos(gRotation);
+	float2 p = input.position.xy * gScale;
+	p = float2(p.x * c - p.y * s, p.x * s + p.y * c) + gOffset;
+
+	ret.position = mul(float4(p, 0.0, 1.0), gProjection);
+	ret.color = input.color * gPalette[gPaletteIndex];
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	return gMainTexture.Sample(gMainSampler, input.uv) * input.color;
+}
@@ -0,0 +1,41 @@
+
+cbuffer ViewConstants : register(b0) {
+	float4x4 gProjection;
+};
+
+Texture2D gMainTexture : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+	float4 world0: WORLD0;
+	float4 world1: WORLD1;
+	float4 world2: WORLD2;
+	float4 world3: WORLD3;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	// World matrices are stored row by row, for row vectors.
+	float4x4 world = float4x4(input.world0, input.world1, input.world2, input.world3);
+	float4 position = mul(float4(input.position.xyz, 1.0), world);
+
+	ret.position = mul(position, gProjection);
+	ret.color = input.color;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	return gMainTexture.Sample(gMainSampler, input.uv) * input.color;
+}
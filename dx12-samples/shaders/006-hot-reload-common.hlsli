@@ -0,0 +1,25 @@
+
+cbuffer HotReloadConstants : register(b0) {
+	float gTime;
+};
+
+Texture2D gMainTexture : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+// Edit and save while the sample runs; every pipeline including this file is rebuilt.
+float4 shade(float2 uv) {
+	float pulse = 0.75 + 0.25 * sin(gTime * 2.0);
+	return gMainTexture.Sample(gMainSampler, uv) * pulse;
+}
@@ -0,0 +1,20 @@
+
+#include "006-hot-reload-common.hlsli"
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	ret.position = input.position;
+	ret.color = input.color;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	float4 color = shade(input.uv);
+#ifdef TINT
+	color *= input.color;
+#endif
+	return color;
+}
@@ -0,0 +1,51 @@
+
+// Permutation defines, always set to 0 or 1 by the shader build.
+#ifndef USE_TEXTURE
+#define USE_TEXTURE 0
+#endif
+#ifndef USE_VERTEX_COLOR
+#define USE_VERTEX_COLOR 0
+#endif
+#ifndef GRAYSCALE
+#define GRAYSCALE 0
+#endif
+
+Texture2D gMainTexture : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+// The vertex shader ignores every define, so all its permutations share one bytecode.
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	ret.position = input.position;
+	ret.color = input.color;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	float4 color = float4(1.0, 1.0, 1.0, 1.0);
+#if USE_TEXTURE
+	color *= gMainTexture.Sample(gMainSampler, input.uv);
+#endif
+#if USE_VERTEX_COLOR
+	color *= input.color;
+#endif
+#if GRAYSCALE
+	color.rgb = dot(color.rgb, float3(0.299, 0.587, 0.114));
+#endif
+	return color;
+}
@@ -0,0 +1,44 @@
+
+cbuffer DrawConstants : register(b0) {
+	float2 gOffset;
+	float gScale;
+	float gBlend;
+};
+
+cbuffer PaletteConstants : register(b1) {
+	float4 gPalette[16];
+};
+
+Texture2D gCheckerTexture : register(t0);
+Texture2D gGradientTexture : register(t1);
+Texture2D gUnusedTexture : register(t2); // Never sampled, so reflection leaves it out.
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float3 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	ret.position = float4(input.position.xy * gScale + gOffset, input.position.z, 1.0);
+	ret.color = input.color;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	float4 checker = gCheckerTexture.Sample(gMainSampler, input.uv);
+	float4 gradient = gGradientTexture.Sample(gMainSampler, input.uv);
+	uint index = min((uint)(input.uv.y * 16.0), 15);
+	return lerp(checker, gradient, gBlend) * gPalette[index];
+}
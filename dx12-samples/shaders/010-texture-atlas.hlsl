@@ -0,0 +1,32 @@
+
+Texture2DArray gAtlas : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float3 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+	float4 rect: RECT;
+	float4 uvRemap: UVREMAP;
+	uint page: PAGE;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float3 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	ret.position = float4(input.rect.xy + input.position.xy * input.rect.zw, 0.0, 1.0);
+	ret.color = input.color;
+	ret.uv = float3(input.uv * input.uvRemap.xy + input.uvRemap.zw, input.page);
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	return gAtlas.Sample(gMainSampler, input.uv) * input.color;
+}
@@ -0,0 +1,37 @@
+
+Texture2D<float> gGlyphAtlas : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+	float4 rect: RECT;
+	float4 uvRect: UVRECT;
+	float4 glyphColor: GLYPHCOLOR;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	// The unit quad is stretched over the glyph rect, already in clip space.
+	ret.position = float4(input.rect.xy + input.position.xy * input.rect.zw, 0.0, 1.0);
+	ret.color = input.glyphColor;
+	ret.uv = lerp(input.uvRect.xy, input.uvRect.zw, input.uv);
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	// 0.5 is the outline; fwidth keeps the edge about one pixel wide at any scale.
+	float distance = gGlyphAtlas.Sample(gMainSampler, input.uv);
+	float width = max(fwidth(distance), 1e-4);
+	float coverage = smoothstep(0.5 - width, 0.5 + width, distance);
+	return float4(input.color.rgb, input.color.a * coverage);
+}
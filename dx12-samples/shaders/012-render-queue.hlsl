@@ -0,0 +1,36 @@
+
+cbuffer DrawConstants : register(b0) {
+	float4 gRect;
+	float4 gTint;
+	float gDepth;
+};
+
+Texture2D gMainTexture : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	// The unit quad is placed over gRect (left, bottom, width, height) in clip space.
+	ret.position = float4(gRect.xy + input.position.xy * gRect.zw, gDepth, 1.0);
+	ret.color = input.color * gTint;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	return gMainTexture.Sample(gMainSampler, input.uv) * input.color;
+}
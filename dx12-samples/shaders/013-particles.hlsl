@@ -0,0 +1,39 @@
+
+cbuffer ParticleConstants : register(b0) {
+	// Clip-space size of one world unit; x carries the inverse aspect ratio so sprites stay round.
+	float2 gSpriteScale;
+};
+
+Texture2D gSprite : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+	float2 center: CENTER;
+	float size: SIZE;
+	float4 tint: TINT;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	// The unit quad is centred on the particle and scaled by its size.
+	float2 world = input.center + input.position.xy * input.size;
+	ret.position = float4(world * gSpriteScale, 0.0, 1.0);
+	ret.color = input.tint;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	return gSprite.Sample(gMainSampler, input.uv) * input.color;
+}
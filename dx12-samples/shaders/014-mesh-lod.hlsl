@@ -0,0 +1,33 @@
+
+cbuffer ObjectConstants : register(b0) {
+	float4x4 gWorldViewProjection;
+};
+
+Texture2D gMainTexture : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	ret.position = mul(float4(input.position.xyz, 1.0), gWorldViewProjection);
+	ret.color = input.color;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	return gMainTexture.Sample(gMainSampler, input.uv) * input.color;
+}
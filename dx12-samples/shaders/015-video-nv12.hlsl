@@ -0,0 +1,37 @@
+
+Texture2D<float> gLuma : register(t0);
+Texture2D<float2> gChroma : register(t1);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	ret.position = input.position;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+// BT.709, limited range: luma 16-235, chroma 16-240 around 128.
+float4 PSMain(Varying input) : SV_TARGET{
+	float y = (gLuma.Sample(gMainSampler, input.uv) - 16.0 / 255.0) * (255.0 / 219.0);
+	float2 uv = (gChroma.Sample(gMainSampler, input.uv) - 128.0 / 255.0) * (255.0 / 224.0);
+
+	float3 rgb = float3(
+		y + 1.5748 * uv.y,
+		y - 0.1873 * uv.x - 0.4681 * uv.y,
+		y + 1.8556 * uv.x);
+
+	return float4(saturate(rgb), 1.0);
+}
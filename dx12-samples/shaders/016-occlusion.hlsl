@@ -0,0 +1,38 @@
+
+cbuffer FrameConstants : register(b0) {
+	float4x4 gViewProjection;
+};
+
+Texture2D gMainTexture : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+	float3 center: CENTER;
+	float3 extent: EXTENT;
+	float4 tint: TINT;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	// The unit cube is stretched over the object's bounds; the vertex color carries the face shading.
+	float3 world = input.center + input.position.xyz * input.extent;
+	ret.position = mul(float4(world, 1.0), gViewProjection);
+	ret.color = input.color * input.tint;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+float4 PSMain(Varying input) : SV_TARGET{
+	return gMainTexture.Sample(gMainSampler, input.uv) * input.color;
+}
@@ -0,0 +1,39 @@
+
+cbuffer SceneConstants : register(b0) {
+	float4x4 gWorldViewProjection;
+	uint gLoad;
+};
+
+Texture2D gMainTexture : register(t0);
+SamplerState gMainSampler : register(s0);
+
+struct Vertex {
+	float4 position: POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float4 color: COLOR;
+	float2 uv: TEXCOORD;
+};
+
+Varying VSMain(Vertex input) {
+	Varying ret;
+
+	ret.position = mul(float4(input.position.xyz, 1.0), gWorldViewProjection);
+	ret.color = input.color;
+	ret.uv = input.uv;
+
+	return ret;
+}
+
+// gLoad rounds of hashing per pixel stand in for expensive shading.
+float4 PSMain(Varying input) : SV_TARGET{
+	float noise = 0.0;
+	for (uint i = 0; i < gLoad; i++) {
+		noise = frac(sin(dot(input.uv, float2(12.9898, 78.233)) + noise + i) * 43758.5453);
+	}
+	return gMainTexture.Sample(gMainSampler, input.uv) * input.color * (0.95 + 0.05 * noise);
+}
@@ -0,0 +1,30 @@
+
+cbuffer UpscaleConstants : register(b0) {
+	float2 gUvScale;
+	float2 gUvMax;
+};
+
+Texture2D gSceneTexture : register(t0);
+SamplerState gSceneSampler : register(s1);
+
+struct Varying {
+	float4 position: SV_POSITION;
+	float2 uv: TEXCOORD;
+};
+
+// One triangle covering the screen, made from the vertex index alone.
+Varying VSMain(uint id : SV_VertexID) {
+	Varying ret;
+
+	float2 uv = float2((id << 1) & 2, id & 2);
+	ret.position = float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+	ret.uv = uv;
+
+	return ret;
+}
+
+// The scene fills the top left gUvScale of its texture; gUvMax keeps the bilinear
+// footprint off the stale texels beyond it.
+float4 PSMain(Varying input) : SV_TARGET{
+	return gSceneTexture.Sample(gSceneSampler, min(input.uv * gUvScale, gUvMax));
+}